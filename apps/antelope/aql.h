@@ -91,19 +91,20 @@ enum token {
   WHERE = 33,
   COUNT = 34,
   INDEX = 35,
-  INSERT = 36,
-  SELECT = 37,
-  REMOVE = 38,
-  CREATE = 39,
-  MEDIAN = 40,
-  DOMAIN = 41,
-  STRING = 42,
-  INLINE = 43,
-  PROJECT = 44,
-  MAXHEAP = 45,
-  MEMHASH = 46,
-  RELATION = 47,
-  ATTRIBUTE = 48,
+  BTREE = 36,
+  INSERT = 37,
+  SELECT = 38,
+  REMOVE = 39,
+  CREATE = 40,
+  MEDIAN = 41,
+  DOMAIN = 42,
+  STRING = 43,
+  INLINE = 44,
+  PROJECT = 45,
+  MAXHEAP = 46,
+  MEMHASH = 47,
+  RELATION = 48,
+  ATTRIBUTE = 49,
 
   INTEGER_VALUE = 251,
   FLOAT_VALUE = 252,
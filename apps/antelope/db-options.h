@@ -49,6 +49,13 @@
 #define DB_FEATURE_JOIN			1
 #endif /* DB_FEATURE_JOIN */
 
+/* The maximum number of tuples of the right relation that a hash join
+   keeps in memory at a time. A larger relation is joined in several
+   passes over the left relation. */
+#ifndef DB_JOIN_HASH_ENTRIES
+#define DB_JOIN_HASH_ENTRIES		16
+#endif /* DB_JOIN_HASH_ENTRIES */
+
 /* Support tuple removals. */
 #ifndef DB_FEATURE_REMOVE
 #define DB_FEATURE_REMOVE		1
@@ -69,6 +76,12 @@
 #define DB_FEATURE_INTEGRITY		0
 #endif /* DB_FEATURE_INTEGRITY */
 
+/* Support the B+-tree index type. Its node cache takes about 1 kB of
+   RAM with the default node size. */
+#ifndef DB_FEATURE_BTREE
+#define DB_FEATURE_BTREE		0
+#endif /* DB_FEATURE_BTREE */
+
 /*----------------------------------------------------------------------------*/
 
 /* Configuration parameters that may be trimmed to save space. */
@@ -104,6 +117,12 @@
 #endif /* DB_MAX_ELEMENT_SIZE */
 
 
+/* The size of the buffer that holds a batch of rows when a selection
+   scans a relation. The buffer holds at least one row. */
+#ifndef DB_SCAN_BUFFER_SIZE
+#define DB_SCAN_BUFFER_SIZE		128
+#endif /* DB_SCAN_BUFFER_SIZE */
+
 /* The maximum size of the LVM bytecode compiled from a
    single database query. */
 #ifndef DB_VM_BYTECODE_SIZE
@@ -206,6 +225,28 @@
 #define DB_HEAP_CACHE_LIMIT		1
 #endif /* DB_HEAP_CACHE_LIMIT */
 
+/* The maximum number of B+-tree indexes. */
+#ifndef DB_BTREE_INDEX_LIMIT
+#define DB_BTREE_INDEX_LIMIT		1
+#endif /* DB_BTREE_INDEX_LIMIT */
+
+/* The maximum number of B+-tree nodes cached in RAM. At least two
+   nodes are required, because a split modifies a node and its parent. */
+#ifndef DB_BTREE_CACHE_LIMIT
+#define DB_BTREE_CACHE_LIMIT		3
+#endif /* DB_BTREE_CACHE_LIMIT */
+
+/* The size of a B+-tree node in storage. Preferably a multiple of the
+   flash page size. */
+#ifndef DB_BTREE_NODE_SIZE
+#define DB_BTREE_NODE_SIZE		256
+#endif /* DB_BTREE_NODE_SIZE */
+
+/* The maximum number of nodes in a B+-tree index file. */
+#ifndef DB_BTREE_NODE_LIMIT
+#define DB_BTREE_NODE_LIMIT		512
+#endif /* DB_BTREE_NODE_LIMIT */
+
 /*----------------------------------------------------------------------------*/
 
 /* LVM options. */
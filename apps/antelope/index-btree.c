@@ -0,0 +1,841 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *     B+-tree - An ordered index for flash memory.
+ *
+ *     The B+-tree index stores its entries in fixed-size nodes in a
+ *     single file. Like the MaxHeap index, it never overwrites data
+ *     that has been written once: entries are appended to the free
+ *     slots of a node, and a node that fills up is replaced by new
+ *     nodes that are appended to the file. Hence, the entries of a
+ *     node are unsorted, and the index can be stored on flash memory
+ *     without an erase operation per update.
+ *
+ *     An inner node routes a key to the entry with the largest key
+ *     that does not exceed it. If two entries have the same key, the
+ *     one written last takes precedence, which makes it possible to
+ *     replace a child by appending a new entry to its parent. The
+ *     entries that are left behind in a replaced node are ignored
+ *     because they fall outside the key range of the node.
+ *
+ *     Each key is combined with its tuple ID, which makes all keys
+ *     unique and allows any full node to be split. The leaves are
+ *     visited in key order when iterating over a range of values.
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cfs/cfs.h"
+#include "lib/memb.h"
+
+#include "db-options.h"
+#include "index.h"
+#include "result.h"
+#include "storage.h"
+
+#define DEBUG DEBUG_NONE
+#include "net/ip/uip-debug.h"
+
+#if DB_FEATURE_BTREE
+
+#if DB_BTREE_CACHE_LIMIT < 2
+#error "DB_BTREE_CACHE_LIMIT must be at least 2."
+#endif
+
+/* The number of root pointers in the beginning of the file. A new
+   root pointer is written each time the tree grows by one level. */
+#define ROOT_SLOTS		32
+
+#define NODE_USED		0x01
+#define NODE_HEADER_SIZE	4
+
+typedef int32_t btree_value_t;
+typedef uint16_t btree_node_id_t;
+
+/* Tuple IDs are stored incremented by one, so that an unwritten
+   slot in a leaf can be recognized by its zero tuple ID. */
+struct btree_key {
+  btree_value_t value;
+  tuple_id_t tuple;
+};
+
+struct btree_entry {
+  struct btree_key key;
+  btree_node_id_t child;
+};
+
+#define LEAF_CAPACITY	 ((DB_BTREE_NODE_SIZE - NODE_HEADER_SIZE) / \
+			  sizeof(struct btree_key))
+#define BRANCH_CAPACITY	 ((DB_BTREE_NODE_SIZE - NODE_HEADER_SIZE) / \
+			  sizeof(struct btree_entry))
+
+#define HEADER_SIZE	(ROOT_SLOTS * sizeof(btree_node_id_t))
+#define NODE_OFFSET(id)	(HEADER_SIZE + \
+			 ((unsigned long)(id) - 1) * DB_BTREE_NODE_SIZE)
+
+#define IS_LEAF(node)		((node)->level == 0)
+#define EMPTY_KEY(key)		((key)->tuple == 0)
+#define EMPTY_ENTRY(entry)	((entry)->child == 0)
+
+struct btree_node {
+  uint8_t flags;
+  uint8_t level;
+  uint8_t unused[NODE_HEADER_SIZE - 2];
+  union {
+    struct btree_key keys[LEAF_CAPACITY];
+    struct btree_entry entries[BRANCH_CAPACITY];
+  } u;
+};
+
+/* The key range [low, high) that a node covers. The range has no
+   upper limit unless the bounded flag is set. */
+struct bounds {
+  struct btree_key low;
+  struct btree_key high;
+  uint8_t bounded;
+};
+
+struct btree {
+  db_storage_id_t storage;
+  btree_node_id_t root;
+  btree_node_id_t node_count;
+  uint8_t root_slot;
+};
+typedef struct btree btree_t;
+
+struct node_cache {
+  btree_t *tree;
+  btree_node_id_t node_id;
+  uint8_t count;
+  uint16_t last_use;
+  struct btree_node node;
+};
+
+static const struct btree_key min_key = {INT32_MIN, 0};
+
+/* Keep a cache of nodes read from storage. */
+static struct node_cache node_cache[DB_BTREE_CACHE_LIMIT];
+static uint16_t cache_clock;
+/* A node under construction during a split. */
+static struct btree_node new_node;
+MEMB(btrees, btree_t, DB_BTREE_INDEX_LIMIT);
+
+static db_result_t create(index_t *);
+static db_result_t destroy(index_t *);
+static db_result_t load(index_t *);
+static db_result_t release(index_t *);
+static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
+static db_result_t delete(index_t *, attribute_value_t *);
+static tuple_id_t get_next(index_iterator_t *);
+
+index_api_t index_btree = {
+  INDEX_BTREE,
+  INDEX_API_EXTERNAL | INDEX_API_RANGE_QUERIES,
+  create,
+  destroy,
+  load,
+  release,
+  insert,
+  delete,
+  get_next
+};
+
+static int
+key_compare(const struct btree_key *a, const struct btree_key *b)
+{
+  if(a->value != b->value) {
+    return a->value < b->value ? -1 : 1;
+  }
+  if(a->tuple != b->tuple) {
+    return a->tuple < b->tuple ? -1 : 1;
+  }
+  return 0;
+}
+
+static int
+in_bounds(const struct btree_key *key, const struct bounds *bounds)
+{
+  return key_compare(key, &bounds->low) >= 0 &&
+    (!bounds->bounded || key_compare(key, &bounds->high) < 0);
+}
+
+static const struct btree_key *
+node_key(const struct btree_node *node, int slot)
+{
+  return IS_LEAF(node) ? &node->u.keys[slot] : &node->u.entries[slot].key;
+}
+
+static int
+node_capacity(const struct btree_node *node)
+{
+  return IS_LEAF(node) ? LEAF_CAPACITY : BRANCH_CAPACITY;
+}
+
+static unsigned
+node_size(const struct btree_node *node, int count)
+{
+  return NODE_HEADER_SIZE + count *
+    (IS_LEAF(node) ? sizeof(struct btree_key) : sizeof(struct btree_entry));
+}
+
+static void
+invalidate_cache(btree_t *tree)
+{
+  int i;
+
+  for(i = 0; i < DB_BTREE_CACHE_LIMIT; i++) {
+    if(node_cache[i].tree == tree) {
+      node_cache[i].tree = NULL;
+    }
+  }
+}
+
+static struct node_cache *
+node_load(btree_t *tree, btree_node_id_t node_id)
+{
+  struct node_cache *cache;
+  int i;
+
+  cache = &node_cache[0];
+  for(i = 0; i < DB_BTREE_CACHE_LIMIT; i++) {
+    if(node_cache[i].tree == tree && node_cache[i].node_id == node_id) {
+      node_cache[i].last_use = ++cache_clock;
+      return &node_cache[i];
+    }
+    /* Replace the least recently used node. */
+    if(node_cache[i].tree == NULL ||
+       (cache->tree != NULL &&
+        (uint16_t)(cache_clock - node_cache[i].last_use) >
+        (uint16_t)(cache_clock - cache->last_use))) {
+      cache = &node_cache[i];
+    }
+  }
+
+  cache->tree = NULL;
+  if(node_id == 0 || node_id > tree->node_count ||
+     DB_ERROR(storage_read(tree->storage, &cache->node,
+                           NODE_OFFSET(node_id), sizeof(cache->node)))) {
+    PRINTF("DB: Failed to read B+-tree node %u\n", (unsigned)node_id);
+    return NULL;
+  }
+
+  for(i = 0; i < node_capacity(&cache->node); i++) {
+    if(IS_LEAF(&cache->node) ? EMPTY_KEY(&cache->node.u.keys[i]) :
+       EMPTY_ENTRY(&cache->node.u.entries[i])) {
+      break;
+    }
+  }
+
+  cache->tree = tree;
+  cache->node_id = node_id;
+  cache->count = i;
+  cache->last_use = ++cache_clock;
+
+  return cache;
+}
+
+static btree_node_id_t
+node_write(btree_t *tree, struct btree_node *node, int count)
+{
+  btree_node_id_t node_id;
+
+  if(tree->node_count >= DB_BTREE_NODE_LIMIT) {
+    PRINTF("DB: No more B+-tree nodes available\n");
+    return 0;
+  }
+
+  node_id = tree->node_count + 1;
+  node->flags = NODE_USED;
+  if(DB_ERROR(storage_write(tree->storage, node, NODE_OFFSET(node_id),
+                            node_size(node, count)))) {
+    return 0;
+  }
+
+  tree->node_count = node_id;
+  return node_id;
+}
+
+static int
+node_append(btree_t *tree, struct node_cache *cache,
+            const struct btree_key *key, btree_node_id_t child)
+{
+  struct btree_node *node;
+  unsigned long offset;
+  void *slot;
+  unsigned size;
+
+  node = &cache->node;
+  if(cache->count >= node_capacity(node)) {
+    PRINTF("DB: Invalid write attempt to the full node %u\n",
+           (unsigned)cache->node_id);
+    return 0;
+  }
+
+  if(IS_LEAF(node)) {
+    node->u.keys[cache->count] = *key;
+    slot = &node->u.keys[cache->count];
+    size = sizeof(struct btree_key);
+  } else {
+    node->u.entries[cache->count].key = *key;
+    node->u.entries[cache->count].child = child;
+    slot = &node->u.entries[cache->count];
+    size = sizeof(struct btree_entry);
+  }
+
+  offset = NODE_OFFSET(cache->node_id) + node_size(node, cache->count);
+  if(DB_ERROR(storage_write(tree->storage, slot, offset, size))) {
+    cache->tree = NULL;
+    return 0;
+  }
+
+  cache->count++;
+  return 1;
+}
+
+static int
+set_root(btree_t *tree, btree_node_id_t node_id)
+{
+  if(tree->root_slot >= ROOT_SLOTS) {
+    PRINTF("DB: No more B+-tree root slots available\n");
+    return 0;
+  }
+
+  if(DB_ERROR(storage_write(tree->storage, &node_id,
+                            tree->root_slot * sizeof(node_id),
+                            sizeof(node_id)))) {
+    return 0;
+  }
+
+  tree->root = node_id;
+  tree->root_slot++;
+  return 1;
+}
+
+/* Select the child of an inner node that covers the key, and narrow
+   the bounds to the key range of that child. */
+static int
+select_child(struct node_cache *cache, const struct btree_key *key,
+             struct bounds *bounds)
+{
+  struct btree_entry *entries;
+  int best;
+  int next;
+  int i;
+
+  entries = cache->node.u.entries;
+  best = -1;
+  for(i = 0; i < cache->count; i++) {
+    if(in_bounds(&entries[i].key, bounds) &&
+       key_compare(&entries[i].key, key) <= 0 &&
+       (best < 0 || key_compare(&entries[i].key, &entries[best].key) >= 0)) {
+      best = i;
+    }
+  }
+
+  if(best < 0) {
+    PRINTF("DB: No child in B+-tree node %u\n", (unsigned)cache->node_id);
+    return -1;
+  }
+
+  next = -1;
+  for(i = 0; i < cache->count; i++) {
+    if(in_bounds(&entries[i].key, bounds) &&
+       key_compare(&entries[i].key, &entries[best].key) > 0 &&
+       (next < 0 || key_compare(&entries[i].key, &entries[next].key) < 0)) {
+      next = i;
+    }
+  }
+
+  bounds->low = entries[best].key;
+  if(next >= 0) {
+    bounds->high = entries[next].key;
+    bounds->bounded = 1;
+  }
+
+  return best;
+}
+
+static int
+needs_split(struct node_cache *cache)
+{
+  /* An inner node must be able to take the two entries of a split. */
+  return cache->count + (IS_LEAF(&cache->node) ? 0 : 1) >=
+    node_capacity(&cache->node);
+}
+
+/* Sort the slots of the live entries in a node by key. If an inner
+   node has several entries with the same key, only the last one
+   is live. */
+static int
+sort_live_entries(struct node_cache *cache, const struct bounds *bounds,
+                  uint8_t *order)
+{
+  const struct btree_key *key;
+  int count;
+  int i, j;
+  int cmp;
+
+  count = 0;
+  cmp = 1;
+  for(i = 0; i < cache->count; i++) {
+    key = node_key(&cache->node, i);
+    if(!in_bounds(key, bounds)) {
+      continue;
+    }
+
+    for(j = count; j > 0; j--) {
+      cmp = key_compare(node_key(&cache->node, order[j - 1]), key);
+      if(cmp <= 0) {
+        break;
+      }
+    }
+
+    if(j > 0 && cmp == 0) {
+      order[j - 1] = i;
+      continue;
+    }
+    memmove(&order[j + 1], &order[j], count - j);
+    order[j] = i;
+    count++;
+  }
+
+  return count;
+}
+
+static btree_node_id_t
+copy_entries(btree_t *tree, struct node_cache *cache,
+             const uint8_t *order, int count)
+{
+  int i;
+
+  new_node.level = cache->node.level;
+  for(i = 0; i < count; i++) {
+    if(IS_LEAF(&new_node)) {
+      new_node.u.keys[i] = cache->node.u.keys[order[i]];
+    } else {
+      new_node.u.entries[i] = cache->node.u.entries[order[i]];
+    }
+  }
+
+  return node_write(tree, &new_node, count);
+}
+
+/*
+ * Replace a full child by writing new nodes, and append entries for
+ * them to the parent. Appending in key order is the common case for
+ * indexed attributes such as timestamps, so a key that is larger than
+ * all keys in the child is given a new node instead of splitting the
+ * child in half.
+ */
+static int
+node_split(btree_t *tree, struct node_cache *parent,
+           struct node_cache *child, const struct bounds *bounds,
+           const struct btree_key *key)
+{
+  uint8_t order[LEAF_CAPACITY > BRANCH_CAPACITY ?
+                LEAF_CAPACITY : BRANCH_CAPACITY];
+  const struct btree_key *last;
+  struct btree_key split_key;
+  btree_node_id_t low_id;
+  btree_node_id_t high_id;
+  int capacity;
+  int count;
+  int half;
+
+  capacity = node_capacity(&child->node);
+  count = sort_live_entries(child, bounds, order);
+  last = count > 0 ? node_key(&child->node, order[count - 1]) : NULL;
+
+  PRINTF("DB: Split B+-tree node %u with %d live entries\n",
+         (unsigned)child->node_id, count);
+
+  if(last != NULL && count > capacity / 2 && key_compare(key, last) > 0) {
+    if(IS_LEAF(&child->node)) {
+      split_key = *key;
+      high_id = copy_entries(tree, child, order, 0);
+    } else {
+      split_key = *last;
+      high_id = copy_entries(tree, child, &order[count - 1], 1);
+    }
+    return high_id != 0 && node_append(tree, parent, &split_key, high_id);
+  }
+
+  if(count <= capacity / 2) {
+    /* Most entries are stale, so a copy of the live entries suffices. */
+    low_id = copy_entries(tree, child, order, count);
+    return low_id != 0 && node_append(tree, parent, &bounds->low, low_id);
+  }
+
+  half = count / 2;
+  split_key = *node_key(&child->node, order[half]);
+  low_id = copy_entries(tree, child, order, half);
+  high_id = copy_entries(tree, child, &order[half], count - half);
+
+  return low_id != 0 && high_id != 0 &&
+    node_append(tree, parent, &bounds->low, low_id) &&
+    node_append(tree, parent, &split_key, high_id);
+}
+
+static int
+insert_key(btree_t *tree, const struct btree_key *key)
+{
+  struct node_cache *cache;
+  struct node_cache *child;
+  struct bounds bounds;
+  struct bounds child_bounds;
+  btree_node_id_t node_id;
+  int i;
+
+  cache = node_load(tree, tree->root);
+  if(cache == NULL) {
+    return 0;
+  }
+
+  if(needs_split(cache)) {
+    /* Grow the tree by one level. */
+    new_node.level = cache->node.level + 1;
+    new_node.u.entries[0].key = min_key;
+    new_node.u.entries[0].child = tree->root;
+    node_id = node_write(tree, &new_node, 1);
+    if(node_id == 0 || set_root(tree, node_id) == 0) {
+      return 0;
+    }
+    cache = node_load(tree, tree->root);
+    if(cache == NULL) {
+      return 0;
+    }
+  }
+
+  bounds.low = min_key;
+  bounds.bounded = 0;
+
+  while(!IS_LEAF(&cache->node)) {
+    child_bounds = bounds;
+    i = select_child(cache, key, &child_bounds);
+    if(i < 0) {
+      return 0;
+    }
+
+    child = node_load(tree, cache->node.u.entries[i].child);
+    if(child == NULL) {
+      return 0;
+    }
+
+    if(needs_split(child)) {
+      if(node_split(tree, cache, child, &child_bounds, key) == 0) {
+        return 0;
+      }
+      /* Select one of the new children. */
+      continue;
+    }
+
+    cache = child;
+    bounds = child_bounds;
+  }
+
+  return node_append(tree, cache, key, 0);
+}
+
+static btree_node_id_t
+find_leaf(btree_t *tree, const struct btree_key *key, struct bounds *bounds)
+{
+  struct node_cache *cache;
+  btree_node_id_t node_id;
+  int i;
+
+  bounds->low = min_key;
+  bounds->bounded = 0;
+
+  node_id = tree->root;
+  for(;;) {
+    cache = node_load(tree, node_id);
+    if(cache == NULL) {
+      return 0;
+    }
+    if(IS_LEAF(&cache->node)) {
+      return node_id;
+    }
+
+    i = select_child(cache, key, bounds);
+    if(i < 0) {
+      return 0;
+    }
+    node_id = cache->node.u.entries[i].child;
+  }
+}
+
+static int
+tree_open(index_t *index, btree_t *tree)
+{
+  btree_node_id_t roots[ROOT_SLOTS];
+  btree_node_id_t low;
+  btree_node_id_t high;
+  btree_node_id_t middle;
+  uint8_t flags;
+
+  tree->storage = storage_open(index->descriptor_file);
+  if(tree->storage < 0) {
+    return 0;
+  }
+
+  if(DB_ERROR(storage_read(tree->storage, roots, 0, sizeof(roots)))) {
+    storage_close(tree->storage);
+    return 0;
+  }
+
+  for(tree->root_slot = 0; tree->root_slot < ROOT_SLOTS; tree->root_slot++) {
+    if(roots[tree->root_slot] == 0) {
+      break;
+    }
+  }
+  tree->root = tree->root_slot > 0 ? roots[tree->root_slot - 1] : 0;
+
+  /* Nodes are allocated in sequence, so the number of nodes can be
+     found by a binary search for the first unused node. */
+  low = 0;
+  high = DB_BTREE_NODE_LIMIT;
+  while(low < high) {
+    middle = low + (high - low + 1) / 2;
+    if(DB_ERROR(storage_read(tree->storage, &flags, NODE_OFFSET(middle),
+                             sizeof(flags))) || !(flags & NODE_USED)) {
+      high = middle - 1;
+    } else {
+      low = middle;
+    }
+  }
+  tree->node_count = low;
+
+  return 1;
+}
+
+static db_result_t
+create(index_t *index)
+{
+  char *filename;
+  btree_t *tree;
+
+  filename = storage_generate_file("btree", HEADER_SIZE +
+				   (unsigned long)DB_BTREE_NODE_LIMIT * DB_BTREE_NODE_SIZE);
+  if(filename == NULL) {
+    PRINTF("DB: Failed to generate a B+-tree file\n");
+    return DB_INDEX_ERROR;
+  }
+
+  memcpy(index->descriptor_file, filename,
+	 sizeof(index->descriptor_file));
+
+  index->opaque_data = tree = memb_alloc(&btrees);
+  if(tree == NULL) {
+    PRINTF("DB: Failed to allocate a B+-tree\n");
+    cfs_remove(index->descriptor_file);
+    index->descriptor_file[0] = '\0';
+    return DB_ALLOCATION_ERROR;
+  }
+
+  if(tree_open(index, tree) == 0) {
+    memb_free(&btrees, tree);
+    cfs_remove(index->descriptor_file);
+    index->descriptor_file[0] = '\0';
+    return DB_STORAGE_ERROR;
+  }
+
+  /* The tree starts with a single, empty leaf. */
+  new_node.level = 0;
+  if(node_write(tree, &new_node, 0) == 0 ||
+     set_root(tree, tree->node_count) == 0) {
+    storage_close(tree->storage);
+    memb_free(&btrees, tree);
+    cfs_remove(index->descriptor_file);
+    index->descriptor_file[0] = '\0';
+    return DB_STORAGE_ERROR;
+  }
+
+  PRINTF("DB: Created a B+-tree index in the file \"%s\"\n",
+	 index->descriptor_file);
+
+  return DB_OK;
+}
+
+static db_result_t
+destroy(index_t *index)
+{
+  if(index->descriptor_file[0] != '\0') {
+    cfs_remove(index->descriptor_file);
+  }
+  return DB_OK;
+}
+
+static db_result_t
+load(index_t *index)
+{
+  btree_t *tree;
+
+  index->opaque_data = tree = memb_alloc(&btrees);
+  if(tree == NULL) {
+    PRINTF("DB: Failed to allocate a B+-tree\n");
+    return DB_ALLOCATION_ERROR;
+  }
+
+  if(tree_open(index, tree) == 0 || tree->root == 0) {
+    memb_free(&btrees, tree);
+    return DB_STORAGE_ERROR;
+  }
+
+  PRINTF("DB: Loaded a B+-tree index from file %s with %u nodes\n",
+	 index->descriptor_file, (unsigned)tree->node_count);
+
+  return DB_OK;
+}
+
+static db_result_t
+release(index_t *index)
+{
+  btree_t *tree;
+
+  tree = index->opaque_data;
+
+  invalidate_cache(tree);
+  storage_close(tree->storage);
+  memb_free(&btrees, tree);
+  return DB_OK;
+}
+
+static db_result_t
+insert(index_t *index, attribute_value_t *value, tuple_id_t tuple_id)
+{
+  btree_t *tree;
+  struct btree_key key;
+
+  tree = (btree_t *)index->opaque_data;
+
+  key.value = (btree_value_t)db_value_to_long(value);
+  key.tuple = tuple_id + 1;
+
+  if(insert_key(tree, &key) == 0) {
+    PRINTF("DB: Failed to insert key %ld into a B+-tree index\n",
+           (long)key.value);
+    return DB_INDEX_ERROR;
+  }
+  return DB_OK;
+}
+
+static db_result_t
+delete(index_t *index, attribute_value_t *value)
+{
+  return DB_INDEX_ERROR;
+}
+
+static tuple_id_t
+get_next(index_iterator_t *iterator)
+{
+  struct iteration_cache {
+    index_iterator_t *index_iterator;
+    tuple_id_t found_items;
+    struct btree_key position;
+    uint8_t inclusive;
+    btree_node_id_t leaf_id;
+    struct bounds bounds;
+  };
+  static struct iteration_cache cache;
+  struct node_cache *leaf;
+  const struct btree_key *key;
+  const struct btree_key *next;
+  btree_t *tree;
+  long max;
+  int cmp;
+  int i;
+
+  tree = (btree_t *)iterator->index->opaque_data;
+  max = db_value_to_long(&iterator->max_value);
+
+  if(cache.index_iterator != iterator || iterator->next_item_no == 0) {
+    /* Initialize the cache for a new search. */
+    cache.index_iterator = iterator;
+    cache.found_items = 0;
+    cache.position.value = (btree_value_t)db_value_to_long(&iterator->min_value);
+    cache.position.tuple = 0;
+    cache.inclusive = 1;
+    cache.leaf_id = find_leaf(tree, &cache.position, &cache.bounds);
+  }
+
+  while(cache.leaf_id != 0) {
+    leaf = node_load(tree, cache.leaf_id);
+    if(leaf == NULL) {
+      break;
+    }
+
+    /* Because keys are stored in an unsorted order in the leaf, we
+       search for the smallest key after the current position. */
+    next = NULL;
+    for(i = 0; i < leaf->count; i++) {
+      key = &leaf->node.u.keys[i];
+      cmp = key_compare(key, &cache.position);
+      if((cmp > 0 || (cmp == 0 && cache.inclusive)) &&
+         in_bounds(key, &cache.bounds) &&
+         (next == NULL || key_compare(key, next) < 0)) {
+        next = key;
+      }
+    }
+
+    if(next == NULL) {
+      /* Continue with the leaf that covers the next key range. */
+      if(!cache.bounds.bounded || cache.bounds.high.value > max) {
+        break;
+      }
+      cache.position = cache.bounds.high;
+      cache.inclusive = 1;
+      cache.leaf_id = find_leaf(tree, &cache.position, &cache.bounds);
+      continue;
+    }
+
+    if(next->value > max) {
+      break;
+    }
+
+    cache.position = *next;
+    cache.inclusive = 0;
+    if(cache.found_items++ == iterator->next_item_no) {
+      iterator->next_item_no++;
+      PRINTF("DB: Found key %ld with tuple %lu\n", (long)next->value,
+             (unsigned long)(next->tuple - 1));
+      return next->tuple - 1;
+    }
+  }
+
+  PRINTF("DB: No more keys in the B+-tree range\n");
+  return INVALID_TUPLE;
+}
+#endif /* DB_FEATURE_BTREE */
@@ -49,7 +49,11 @@
 #include "storage.h"
 
 static index_api_t *index_components[] = {&index_inline,
-	&index_maxheap};
+	&index_maxheap
+#if DB_FEATURE_BTREE
+	, &index_btree
+#endif /* DB_FEATURE_BTREE */
+};
 
 LIST(indices);
 MEMB(index_memb, index_t, DB_INDEX_POOL_SIZE);
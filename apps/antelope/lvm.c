@@ -472,6 +472,24 @@ lvm_set_variable_value(char *name, operand_value_t value)
   return TRUE;
 }
 
+/* Look up a registered variable, so that its value can be set for
+   each tuple without comparing names. */
+lvm_status_t
+lvm_get_variable_id(char *name, variable_id_t *id)
+{
+  *id = lookup(name);
+  if(*id >= LVM_MAX_VARIABLE_ID - 1 || variables[*id].name[0] == '\0') {
+    return INVALID_IDENTIFIER;
+  }
+  return TRUE;
+}
+
+void
+lvm_set_variable_id_value(variable_id_t id, operand_value_t value)
+{
+  variables[id].value = value;
+}
+
 void
 lvm_set_variable(lvm_instance_t *p, char *name)
 {
@@ -57,13 +57,16 @@
  * data in a source row and in the corresponding destination row. The 
  * structure is calculated just before processing a relational 
  * selection, and then used to improve the performance when processing 
- * each row.
+ * each row. Attributes that the predicate uses are also mapped to
+ * their LVM variables.
 */
 struct source_dest_map {
   attribute_t *from_attr;
   attribute_t *to_attr;
   unsigned from_offset;
   unsigned to_offset;
+  variable_id_t variable_id;
+  uint8_t is_variable;
 };
 
 static struct source_dest_map attr_map[AQL_ATTRIBUTE_LIMIT];
@@ -79,6 +82,30 @@ struct source_map {
 };
 
 static struct source_map source_map[AQL_ATTRIBUTE_LIMIT];
+
+/*
+ * A hash join keeps the join attribute values of a block of tuples
+ * from the right relation in a chained hash table. The left relation
+ * is scanned once for each block.
+ */
+struct join_entry {
+  long value;
+  tuple_id_t tuple_id;
+  uint16_t next;
+};
+
+/* The domains whose values db_value_to_long() keeps intact */
+#define JOIN_HASHABLE(attr) \
+  ((attr)->domain == DOMAIN_INT || (attr)->domain == DOMAIN_LONG)
+
+static struct join_entry join_entries[DB_JOIN_HASH_ENTRIES];
+static uint16_t join_buckets[DB_JOIN_HASH_ENTRIES];
+static tuple_id_t join_block_start;
+static tuple_id_t join_block_end;
+static uint16_t join_next;
+static long join_value;
+static int join_left_offset;
+static int join_right_offset;
 #endif /* DB_FEATURE_JOIN */
 
 static unsigned char row[DB_MAX_ATTRIBUTES_PER_RELATION * DB_MAX_ELEMENT_SIZE];
@@ -88,6 +115,13 @@ static unsigned char * const left_row = row;
 static unsigned char * const right_row = extra_row;
 static unsigned char * const join_row = result_row;
 
+/* A batch of rows read while scanning a relation in a selection. */
+#define SCAN_BUFFER_SIZE (DB_SCAN_BUFFER_SIZE > sizeof(row) ? \
+                          DB_SCAN_BUFFER_SIZE : sizeof(row))
+static unsigned char scan_buffer[SCAN_BUFFER_SIZE];
+static tuple_id_t scan_start;
+static tuple_id_t scan_count;
+
 LIST(relations);
 MEMB(relations_memb, relation_t, DB_RELATION_POOL_SIZE);
 MEMB(attributes_memb, attribute_t, DB_ATTRIBUTE_POOL_SIZE);
@@ -619,6 +653,9 @@ generate_attribute_map(struct source_dest_map *attr_map, unsigned attribute_coun
     }
     attr_map_ptr->from_offset = offset;
     attr_map_ptr->to_offset = size_sum;
+    attr_map_ptr->is_variable =
+      (to_attr->domain == DOMAIN_INT || to_attr->domain == DOMAIN_LONG) &&
+      lvm_get_variable_id(to_attr->name, &attr_map_ptr->variable_id) == TRUE;
 
     size_sum += to_attr->element_size;
     attr_map_ptr++;
@@ -703,6 +740,7 @@ generate_selection_result(db_handle_t *handle, relation_t *rel, aql_adt_t *adt)
     }
   }
 
+  scan_count = 0;
   handle->flags |= DB_HANDLE_FLAG_PROCESSING;
 
   return DB_OK;
@@ -731,6 +769,83 @@ relation_process_remove(void *handle_ptr)
 }
 #endif
 
+static db_result_t
+process_row(db_handle_t *handle, aql_adt_t *adt, unsigned char *from_row)
+{
+  struct source_dest_map *attr_map_ptr, *attr_map_end;
+  attribute_t *result_attr;
+  unsigned char *from_ptr;
+  operand_value_t operand_value;
+  attribute_value_t value;
+  lvm_status_t wanted_result;
+  db_result_t result;
+
+  attr_map_end = attr_map + handle->result_rel->attribute_count;
+
+  /* Update the internal state of the PLE with the values of the
+     attributes that the predicate uses. */
+  for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+    if(!attr_map_ptr->is_variable) {
+      continue;
+    }
+
+    from_ptr = from_row + attr_map_ptr->from_offset;
+    if(attr_map_ptr->to_attr->domain == DOMAIN_INT) {
+      operand_value.l = from_ptr[0] << 8 | from_ptr[1];
+    } else {
+      operand_value.l = (uint32_t)from_ptr[0] << 24 |
+                        (uint32_t)from_ptr[1] << 16 |
+                        (uint32_t)from_ptr[2] << 8 |
+                        from_ptr[3];
+    }
+    lvm_set_variable_id_value(attr_map_ptr->variable_id, operand_value);
+  }
+
+  wanted_result = TRUE;
+  if(AQL_GET_FLAGS(adt) & AQL_FLAG_INVERSE_LOGIC) {
+    wanted_result = FALSE;
+  }
+
+  /* Check whether the given predicate is true for this tuple. */
+  if(adt->lvm_instance != NULL &&
+     lvm_execute(adt->lvm_instance) != wanted_result) {
+    return DB_OK;
+  }
+
+  if(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) {
+    for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+      from_ptr = from_row + attr_map_ptr->from_offset;
+      result = db_phy_to_value(&value, attr_map_ptr->to_attr, from_ptr);
+      if(DB_ERROR(result)) {
+        return result;
+      }
+      aggregate(attr_map_ptr->to_attr, &value);
+    }
+    return DB_OK;
+  }
+
+  /* Copy the projected attributes of the selected tuple into the
+     resulting tuple. */
+  for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+    result_attr = attr_map_ptr->to_attr;
+    if(result_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
+      /* The attribute is used just for the predicate. */
+      continue;
+    }
+    memcpy(result_row + attr_map_ptr->to_offset,
+           from_row + attr_map_ptr->from_offset, result_attr->element_size);
+  }
+
+  if(AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN) {
+    if(DB_ERROR(storage_put_row(handle->result_rel, result_row))) {
+      PRINTF("DB: Failed to store a row in the result relation!\n");
+      return DB_STORAGE_ERROR;
+    }
+  }
+  handle->current_row++;
+  return DB_GOT_ROW;
+}
+
 db_result_t
 relation_process_select(void *handle_ptr)
 {
@@ -742,10 +857,8 @@ relation_process_select(void *handle_ptr)
   attribute_t *result_attr;
   unsigned char *from_ptr;
   unsigned char *to_ptr;
-  operand_value_t operand_value;
   uint8_t intbuf[2];
-  attribute_value_t value;
-  lvm_status_t wanted_result;
+  uint8_t batch_read;
 
   handle = (db_handle_t *)handle_ptr;
   adt = (aql_adt_t *)handle->adt;
@@ -767,82 +880,62 @@ relation_process_select(void *handle_ptr)
 
       return DB_FINISHED;
     }
-  }
-
-  /* Put the tuples fulfilling the given condition into a new relation.
-     The tuples may be projected. */
-  result = storage_get_row(handle->rel, &handle->tuple_id, row);
-  handle->tuple_id++;
-  if(DB_ERROR(result)) {
-    PRINTF("DB: Failed to get a row in relation %s!\n", handle->rel->name);
-    return result;
-  } else if(result == DB_FINISHED) {
-    if(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) {
-      goto end_aggregation;
-    }
-    return DB_FINISHED;
-  }
-
-  /* Process the attributes in the result relation. */
-  for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-    from_ptr = row + attr_map_ptr->from_offset;
-    result_attr = attr_map_ptr->to_attr;
-
-    /* Update the internal state of the PLE. */
-    if(result_attr->domain == DOMAIN_INT) {
-      operand_value.l = from_ptr[0] << 8 | from_ptr[1];
-      lvm_set_variable_value(result_attr->name, operand_value);
-    } else if(result_attr->domain == DOMAIN_LONG) {
-      operand_value.l = (uint32_t)from_ptr[0] << 24 |
-                        (uint32_t)from_ptr[1] << 16 |
-                        (uint32_t)from_ptr[2] << 8 |
-                        from_ptr[3];
-      lvm_set_variable_value(result_attr->name, operand_value);
-    }
 
-    if(result_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
-      /* The attribute is used just for the predicate,
-         so do not copy the current value into the result. */
-      continue;
+    result = storage_get_row(handle->rel, &handle->tuple_id, row);
+    handle->tuple_id++;
+    if(DB_ERROR(result)) {
+      PRINTF("DB: Failed to get a row in relation %s!\n", handle->rel->name);
+      return result;
+    } else if(result == DB_FINISHED) {
+      if(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) {
+        goto end_aggregation;
+      }
+      return DB_FINISHED;
     }
 
-    if(!(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE)) {
-      /* No aggregators. Copy the original value into the resulting tuple. */
-      memcpy(result_row + attr_map_ptr->to_offset, from_ptr,
-             result_attr->element_size);
-    }
+    return process_row(handle, adt, row);
   }
 
-  wanted_result = TRUE;
-  if(AQL_GET_FLAGS(adt) & AQL_FLAG_INVERSE_LOGIC) {
-    wanted_result = FALSE;
-  }
+  /*
+   * Put the tuples fulfilling the given condition into a new relation.
+   * The tuples may be projected. The relation is read in batches of
+   * rows, and each call processes at most one batch, so that a long
+   * selection can still be interleaved with other processes.
+   */
+  for(batch_read = 0;;) {
+    if(handle->tuple_id - scan_start >= scan_count) {
+      if(batch_read) {
+        return DB_OK;
+      }
 
-  /* Check whether the given predicate is true for this tuple. */
-  if(adt->lvm_instance == NULL ||
-     lvm_execute(adt->lvm_instance) == wanted_result) {
-    if(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) {
-      for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-        from_ptr = row + attr_map_ptr->from_offset;
-        result = db_phy_to_value(&value, attr_map_ptr->to_attr, from_ptr);
-        if(DB_ERROR(result)) {
-	  return result;
-        }
-        aggregate(attr_map_ptr->to_attr, &value);
+      scan_start = handle->tuple_id;
+      scan_count = sizeof(scan_buffer) / handle->rel->row_length;
+      result = storage_get_rows(handle->rel, &scan_start, scan_buffer,
+                                &scan_count);
+      if(result != DB_OK) {
+        scan_count = 0;
       }
-    } else {
-      if(AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN) {
-        if(DB_ERROR(storage_put_row(handle->result_rel, result_row))) {
-          PRINTF("DB: Failed to store a row in the result relation!\n");
-          return DB_STORAGE_ERROR;
+      if(DB_ERROR(result)) {
+        PRINTF("DB: Failed to get rows in relation %s!\n", handle->rel->name);
+        return result;
+      } else if(result == DB_FINISHED) {
+        if(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) {
+          goto end_aggregation;
         }
+        return DB_FINISHED;
       }
-      handle->current_row++;
-      return DB_GOT_ROW;
+      batch_read = 1;
     }
-  }
 
-  return DB_OK;
+    from_ptr = scan_buffer + (handle->tuple_id - scan_start) *
+      handle->rel->row_length;
+    handle->tuple_id++;
+
+    result = process_row(handle, adt, from_ptr);
+    if(result != DB_OK) {
+      return result;
+    }
+  }
 
 end_aggregation:
   /* Generate aggregated result if requested. */
@@ -959,6 +1052,155 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
 }
 
 #if DB_FEATURE_JOIN
+static db_result_t
+join_put_row(db_handle_t *handle)
+{
+  relation_t *join_rel;
+  unsigned char *join_next_attribute_ptr;
+  size_t element_size;
+  int i;
+
+  join_rel = handle->join_rel;
+
+  /* Use the source attribute map to fill in the physical representation
+     of the resulting tuple. */
+  join_next_attribute_ptr = join_row;
+
+  for(i = 0; i < join_rel->attribute_count; i++) {
+    element_size = source_map[i].attr->element_size;
+
+    memcpy(join_next_attribute_ptr, source_map[i].from_ptr, element_size);
+    join_next_attribute_ptr += element_size;
+  }
+
+  if(((aql_adt_t *)handle->adt)->flags & AQL_FLAG_ASSIGN) {
+    if(DB_ERROR(storage_put_row(join_rel, join_row))) {
+      return DB_STORAGE_ERROR;
+    }
+  }
+
+  handle->current_row++;
+  return DB_GOT_ROW;
+}
+
+/* Fill the hash table with the next block of tuples in the right
+   relation. */
+static db_result_t
+join_build(db_handle_t *handle)
+{
+  db_result_t result;
+  attribute_value_t value;
+  struct join_entry *entry;
+  unsigned char *row_ptr;
+  tuple_id_t count;
+  tuple_id_t i;
+  uint16_t bucket;
+  uint16_t entries;
+
+  memset(join_buckets, 0, sizeof(join_buckets));
+  join_block_start = join_block_end;
+  entries = 0;
+
+  /* The rows are read in batches through the scan buffer. */
+  scan_count = 0;
+  while(entries < DB_JOIN_HASH_ENTRIES) {
+    count = sizeof(scan_buffer) / handle->right_rel->row_length;
+    if(count > DB_JOIN_HASH_ENTRIES - entries) {
+      count = DB_JOIN_HASH_ENTRIES - entries;
+    }
+    result = storage_get_rows(handle->right_rel, &join_block_end,
+                              scan_buffer, &count);
+    if(DB_ERROR(result)) {
+      return result;
+    } else if(result == DB_FINISHED) {
+      break;
+    }
+
+    for(i = 0; i < count; i++) {
+      row_ptr = scan_buffer + i * handle->right_rel->row_length;
+      result = db_phy_to_value(&value, handle->right_join_attr,
+                               row_ptr + join_right_offset);
+      if(DB_ERROR(result)) {
+        return result;
+      }
+
+      entry = &join_entries[entries];
+      entry->value = db_value_to_long(&value);
+      entry->tuple_id = join_block_end + i;
+      bucket = (unsigned long)entry->value % DB_JOIN_HASH_ENTRIES;
+      entry->next = join_buckets[bucket];
+      join_buckets[bucket] = ++entries;
+    }
+    join_block_end += count;
+  }
+
+  PRINTF("DB: Built a join hash table over tuples %lu to %lu\n",
+         (unsigned long)join_block_start, (unsigned long)join_block_end);
+
+  return entries > 0 ? DB_OK : DB_FINISHED;
+}
+
+static db_result_t
+process_hash_join(db_handle_t *handle)
+{
+  db_result_t result;
+  attribute_value_t value;
+  struct join_entry *entry;
+  tuple_id_t right_tuple_id;
+
+  if(join_block_start == join_block_end) {
+    return DB_FINISHED;
+  }
+
+  for(;;) {
+    /* Return the remaining matches for the current left tuple. */
+    while(join_next != 0) {
+      entry = &join_entries[join_next - 1];
+      join_next = entry->next;
+      if(entry->value != join_value) {
+        continue;
+      }
+
+      right_tuple_id = entry->tuple_id;
+      result = storage_get_row(handle->right_rel, &right_tuple_id, right_row);
+      if(DB_ERROR(result)) {
+        PRINTF("DB: Failed to get a row in right relation %s!\n",
+               handle->right_rel->name);
+        return result;
+      } else if(result == DB_FINISHED) {
+        return DB_IMPLEMENTATION_ERROR;
+      }
+
+      return join_put_row(handle);
+    }
+
+    result = storage_get_row(handle->left_rel, &handle->tuple_id, left_row);
+    if(DB_ERROR(result)) {
+      PRINTF("DB: Failed to get a row in left relation %s!\n",
+             handle->left_rel->name);
+      return result;
+    } else if(result == DB_FINISHED) {
+      /* Continue with the next block of the right relation. */
+      result = join_build(handle);
+      if(result != DB_OK) {
+        join_block_start = join_block_end;
+        return result;
+      }
+      handle->tuple_id = 0;
+      continue;
+    }
+    handle->tuple_id++;
+
+    result = db_phy_to_value(&value, handle->left_join_attr,
+                             left_row + join_left_offset);
+    if(DB_ERROR(result)) {
+      return result;
+    }
+    join_value = db_value_to_long(&value);
+    join_next = join_buckets[(unsigned long)join_value % DB_JOIN_HASH_ENTRIES];
+  }
+}
+
 db_result_t
 relation_process_join(void *handle_ptr)
 {
@@ -966,17 +1208,16 @@ relation_process_join(void *handle_ptr)
   db_result_t result;
   relation_t *left_rel;
   relation_t *right_rel;
-  relation_t *join_rel;
-  unsigned char *join_next_attribute_ptr;
-  size_t element_size;
   tuple_id_t right_tuple_id;
   attribute_value_t value;
-  int i;
 
   handle = (db_handle_t *)handle_ptr;
   left_rel = handle->left_rel;
   right_rel = handle->right_rel;
-  join_rel = handle->join_rel;
+
+  if(handle->flags & DB_HANDLE_FLAG_HASH_JOIN) {
+    return process_hash_join(handle);
+  }
 
   if(!(handle->flags & DB_HANDLE_FLAG_INDEX_STEP)) {
     goto inner_loop;
@@ -1030,25 +1271,7 @@ inner_loop:
         return DB_IMPLEMENTATION_ERROR;
       }
 
-      /* Use the source attribute map to fill in the physical representation
-	 of the resulting tuple. */
-      join_next_attribute_ptr = join_row;
-
-      for(i = 0; i < join_rel->attribute_count; i++) {
-	element_size = source_map[i].attr->element_size;
-
-	memcpy(join_next_attribute_ptr, source_map[i].from_ptr, element_size);
-	join_next_attribute_ptr += element_size;
-      }
-
-      if(((aql_adt_t *)handle->adt)->flags & AQL_FLAG_ASSIGN) {
-        if(DB_ERROR(storage_put_row(join_rel, join_row))) {
-          return DB_STORAGE_ERROR;
-        }
-      }
-
-      handle->current_row++;
-      return DB_GOT_ROW;
+      return join_put_row(handle);
     }
   }
 
@@ -1120,6 +1343,7 @@ relation_join(void *query_result, void *adt_ptr)
   int i;
   char *attribute_name;
   attribute_t *attr;
+  db_result_t result;
 
   adt = (aql_adt_t *)adt_ptr;
 
@@ -1158,9 +1382,33 @@ relation_join(void *query_result, void *adt_ptr)
     return DB_RELATIONAL_ERROR;
   }
 
+  join_left_offset = get_attribute_value_offset(left_rel,
+                                                handle->left_join_attr);
+  join_right_offset = get_attribute_value_offset(right_rel,
+                                                 handle->right_join_attr);
+  if(join_left_offset < 0 || join_right_offset < 0) {
+    return DB_IMPLEMENTATION_ERROR;
+  }
+
   if(!index_exists(handle->right_join_attr)) {
-    PRINTF("DB: The attribute to join on is not indexed\n");
-    return DB_INDEX_ERROR;
+    /* The hash table holds integer values only. */
+    if(!JOIN_HASHABLE(handle->left_join_attr) ||
+       !JOIN_HASHABLE(handle->right_join_attr)) {
+      PRINTF("DB: The attribute to join on is not indexed\n");
+      return DB_INDEX_ERROR;
+    }
+
+    /* Without an index to look up matching tuples in the right relation,
+       we build a hash table over blocks of the right relation. */
+    PRINTF("DB: The attribute to join on is not indexed; using a hash join\n");
+    handle->flags = DB_HANDLE_FLAG_HASH_JOIN;
+    handle->tuple_id = 0;
+    join_block_end = 0;
+    join_next = 0;
+    result = join_build(handle);
+    if(DB_ERROR(result)) {
+      return result;
+    }
   }
 
   /*
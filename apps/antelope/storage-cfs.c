@@ -437,6 +437,53 @@ storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t row)
   return DB_OK;
 }
 
+db_result_t
+storage_get_rows(relation_t *rel, tuple_id_t *tuple_id, storage_row_t rows,
+                 tuple_id_t *count)
+{
+  int r;
+  tuple_id_t i;
+  tuple_id_t nrows;
+
+  if(DB_ERROR(storage_get_row_amount(rel, &nrows))) {
+    return DB_STORAGE_ERROR;
+  }
+
+  if(*tuple_id >= nrows) {
+    return DB_FINISHED;
+  }
+
+  if(*count > nrows - *tuple_id) {
+    *count = nrows - *tuple_id;
+  }
+
+  if(cfs_seek(rel->tuple_storage, *tuple_id * rel->row_length, CFS_SEEK_SET) ==
+              (cfs_offset_t)-1) {
+    return DB_STORAGE_ERROR;
+  }
+
+  /* Read as many complete rows as possible in a single request. */
+  r = cfs_read(rel->tuple_storage, rows, *count * rel->row_length);
+  if(r < 0) {
+    PRINTF("DB: Reading failed on fd %d\n", rel->tuple_storage);
+    return DB_STORAGE_ERROR;
+  }
+
+  *count = r / rel->row_length;
+  if(*count == 0) {
+    return DB_FINISHED;
+  }
+
+  for(i = 1; i <= *count; i++) {
+    rows[i * rel->row_length - 1] ^= ROW_XOR;
+  }
+
+  PRINTF("DB: Read %lu rows from relation %s\n", (unsigned long)*count,
+         rel->name);
+
+  return DB_OK;
+}
+
 db_result_t
 storage_put_row(relation_t *rel, storage_row_t row)
 {
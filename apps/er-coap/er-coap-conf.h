@@ -68,6 +68,11 @@
 #define COAP_MAX_OBSERVERS    COAP_MAX_OPEN_TRANSACTIONS - 1
 #endif /* COAP_MAX_OBSERVERS */
 
+/* Number of hash buckets for looking up transactions by MID, and observers by MID and token */
+#ifndef COAP_HASH_BUCKETS
+#define COAP_HASH_BUCKETS     4
+#endif /* COAP_HASH_BUCKETS */
+
 /* Interval in notifies in which NON notifies are changed to CON notifies to check client. */
 #define COAP_OBSERVE_REFRESH_INTERVAL  20
 
@@ -53,11 +53,50 @@
 #endif
 
 /*---------------------------------------------------------------------------*/
-MEMB(observers_memb, coap_observer_t, COAP_MAX_OBSERVERS);
+MEMB_FREELIST(observers_memb, coap_observer_t, COAP_MAX_OBSERVERS);
 LIST(observers_list);
+
+/* The observers, hashed by their token and by the MID of their last
+   notification */
+static coap_observer_t *observers_by_token[COAP_HASH_BUCKETS];
+static coap_observer_t *observers_by_mid[COAP_HASH_BUCKETS];
+#define MID_BUCKET(mid) (&observers_by_mid[(mid) % COAP_HASH_BUCKETS])
 /*---------------------------------------------------------------------------*/
 /*- Internal API ------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
+static coap_observer_t **
+token_bucket(const uint8_t *token, size_t token_len)
+{
+  unsigned int hash = 0;
+
+  while(token_len-- > 0) {
+    hash = hash * 31 + *token++;
+  }
+  return &observers_by_token[hash % COAP_HASH_BUCKETS];
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_from_mid_bucket(coap_observer_t *o)
+{
+  coap_observer_t **p;
+
+  for(p = MID_BUCKET(o->last_mid); *p; p = &(*p)->mid_next) {
+    if(*p == o) {
+      *p = o->mid_next;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_last_mid(coap_observer_t *o, uint16_t mid)
+{
+  remove_from_mid_bucket(o);
+  o->last_mid = mid;
+  o->mid_next = *MID_BUCKET(mid);
+  *MID_BUCKET(mid) = o;
+}
+/*---------------------------------------------------------------------------*/
 static coap_observer_t *
 add_observer(uip_ipaddr_t *addr, uint16_t port, const uint8_t *token,
              size_t token_len, const char *uri, int uri_len)
@@ -66,6 +105,7 @@ add_observer(uip_ipaddr_t *addr, uint16_t port, const uint8_t *token,
   coap_remove_observer_by_uri(addr, port, uri);
 
   coap_observer_t *o = memb_alloc(&observers_memb);
+  coap_observer_t **bucket;
 
   if(o) {
     int max = sizeof(o->url) - 1;
@@ -79,6 +119,11 @@ add_observer(uip_ipaddr_t *addr, uint16_t port, const uint8_t *token,
     o->token_len = token_len;
     memcpy(o->token, token, token_len);
     o->last_mid = 0;
+    o->mid_next = *MID_BUCKET(0);
+    *MID_BUCKET(0) = o;
+    bucket = token_bucket(o->token, o->token_len);
+    o->token_next = *bucket;
+    *bucket = o;
 
     PRINTF("Adding observer (%u/%u) for /%s [0x%02X%02X]\n",
            list_length(observers_list) + 1, COAP_MAX_OBSERVERS,
@@ -89,16 +134,31 @@ add_observer(uip_ipaddr_t *addr, uint16_t port, const uint8_t *token,
   return o;
 }
 /*---------------------------------------------------------------------------*/
+list_t
+coap_get_observers(void)
+{
+  return observers_list;
+}
+/*---------------------------------------------------------------------------*/
 /*- Removal -----------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 void
 coap_remove_observer(coap_observer_t *o)
 {
+  coap_observer_t **p;
+
   PRINTF("Removing observer for /%s [0x%02X%02X]\n", o->url, o->token[0],
          o->token[1]);
 
-  memb_free(&observers_memb, o);
   list_remove(observers_list, o);
+  remove_from_mid_bucket(o);
+  for(p = token_bucket(o->token, o->token_len); *p; p = &(*p)->token_next) {
+    if(*p == o) {
+      *p = o->token_next;
+      break;
+    }
+  }
+  memb_free(&observers_memb, o);
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -106,9 +166,10 @@ coap_remove_observer_by_client(uip_ipaddr_t *addr, uint16_t port)
 {
   int removed = 0;
   coap_observer_t *obs = NULL;
+  coap_observer_t *next;
 
-  for(obs = (coap_observer_t *)list_head(observers_list); obs;
-      obs = obs->next) {
+  for(obs = (coap_observer_t *)list_head(observers_list); obs; obs = next) {
+    next = obs->next;
     PRINTF("Remove check client ");
     PRINT6ADDR(addr);
     PRINTF(":%u\n", port);
@@ -126,9 +187,10 @@ coap_remove_observer_by_token(uip_ipaddr_t *addr, uint16_t port,
 {
   int removed = 0;
   coap_observer_t *obs = NULL;
+  coap_observer_t *next;
 
-  for(obs = (coap_observer_t *)list_head(observers_list); obs;
-      obs = obs->next) {
+  for(obs = *token_bucket(token, token_len); obs; obs = next) {
+    next = obs->token_next;
     PRINTF("Remove check Token 0x%02X%02X\n", token[0], token[1]);
     if(uip_ipaddr_cmp(&obs->addr, addr) && obs->port == port
        && obs->token_len == token_len
@@ -146,9 +208,10 @@ coap_remove_observer_by_uri(uip_ipaddr_t *addr, uint16_t port,
 {
   int removed = 0;
   coap_observer_t *obs = NULL;
+  coap_observer_t *next;
 
-  for(obs = (coap_observer_t *)list_head(observers_list); obs;
-      obs = obs->next) {
+  for(obs = (coap_observer_t *)list_head(observers_list); obs; obs = next) {
+    next = obs->next;
     PRINTF("Remove check URL %p\n", uri);
     if((addr == NULL
         || (uip_ipaddr_cmp(&obs->addr, addr) && obs->port == port))
@@ -165,9 +228,10 @@ coap_remove_observer_by_mid(uip_ipaddr_t *addr, uint16_t port, uint16_t mid)
 {
   int removed = 0;
   coap_observer_t *obs = NULL;
+  coap_observer_t *next;
 
-  for(obs = (coap_observer_t *)list_head(observers_list); obs;
-      obs = obs->next) {
+  for(obs = *MID_BUCKET(mid); obs; obs = next) {
+    next = obs->mid_next;
     PRINTF("Remove check MID %u\n", mid);
     if(uip_ipaddr_cmp(&obs->addr, addr) && obs->port == port
        && obs->last_mid == mid) {
@@ -180,6 +244,46 @@ coap_remove_observer_by_mid(uip_ipaddr_t *addr, uint16_t port, uint16_t mid)
 /*---------------------------------------------------------------------------*/
 /*- Notification ------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
+/* Copies the serialized notification into the transaction for an
+   observer, with its token and Observe option, and sends it. */
+static void
+send_notification(coap_transaction_t *transaction, coap_observer_t *obs,
+                  const uint8_t *message, size_t message_len, uint8_t code)
+{
+  coap_message_type_t type;
+  int32_t observe;
+
+  type = COAP_TYPE_NON;
+  if(obs->obs_counter % COAP_OBSERVE_REFRESH_INTERVAL == 0) {
+    PRINTF("           Force Confirmable for\n");
+    type = COAP_TYPE_CON;
+  }
+
+  PRINTF("           Observer ");
+  PRINT6ADDR(&obs->addr);
+  PRINTF(":%u\n", obs->port);
+
+  /* update last MID for RST matching */
+  set_last_mid(obs, transaction->mid);
+
+  observe = -1;
+  if(code < BAD_REQUEST_4_00) {
+    observe = (obs->obs_counter)++;
+    /* mask out to keep the CoAP observe option length <= 3 bytes */
+    obs->obs_counter &= 0xffffff;
+  }
+
+  transaction->packet_len =
+    coap_copy_message(transaction->packet, message, message_len, type,
+                      transaction->mid, obs->token, obs->token_len, observe);
+  if(transaction->packet_len == 0) {
+    coap_clear_transaction(transaction);
+    return;
+  }
+
+  coap_send_transaction(transaction);
+}
+/*---------------------------------------------------------------------------*/
 void
 coap_notify_observers(resource_t *resource)
 {
@@ -194,6 +298,12 @@ coap_notify_observers_sub(resource_t *resource, const char *subpath)
   coap_observer_t *obs = NULL;
   int url_len, obs_url_len;
   char url[COAP_OBSERVER_URL_LEN];
+  /* the notification is serialized once, without a token and an Observe
+     option, into the transaction of the first observer, copied from
+     there for each other observer, and finally copied in place */
+  coap_transaction_t *first = NULL;
+  coap_observer_t *first_obs = NULL;
+  size_t message_len = 0;
 
   url_len = strlen(resource->url);
   strncpy(url, resource->url, COAP_OBSERVER_URL_LEN - 1);
@@ -228,39 +338,32 @@ coap_notify_observers_sub(resource_t *resource, const char *subpath)
       /*TODO implement special transaction for CON, sharing the same buffer to allow for more observers */
 
       if((transaction = coap_new_transaction(coap_get_mid(), &obs->addr, obs->port))) {
-        if(obs->obs_counter % COAP_OBSERVE_REFRESH_INTERVAL == 0) {
-          PRINTF("           Force Confirmable for\n");
-          notification->type = COAP_TYPE_CON;
-        }
-
-        PRINTF("           Observer ");
-        PRINT6ADDR(&obs->addr);
-        PRINTF(":%u\n", obs->port);
-
-        /* update last MID for RST matching */
-        obs->last_mid = transaction->mid;
-
-        /* prepare response */
-        notification->mid = transaction->mid;
-
-        resource->get_handler(request, notification,
-                              transaction->packet + COAP_MAX_HEADER_SIZE,
-                              REST_MAX_CHUNK_SIZE, NULL);
-
-        if(notification->code < BAD_REQUEST_4_00) {
-          coap_set_header_observe(notification, (obs->obs_counter)++);
-          /* mask out to keep the CoAP observe option length <= 3 bytes */
-          obs->obs_counter &= 0xffffff;
+        if(first == NULL) {
+          /* prepare response */
+          resource->get_handler(request, notification,
+                                transaction->packet + COAP_MAX_HEADER_SIZE,
+                                REST_MAX_CHUNK_SIZE, NULL);
+          message_len = coap_serialize_message(notification,
+                                               transaction->packet);
+          if(message_len == 0) {
+            PRINTF("Observe: Failed to serialize the notification\n");
+            coap_clear_transaction(transaction);
+            return;
+          }
+          first = transaction;
+          first_obs = obs;
+        } else {
+          send_notification(transaction, obs, first->packet, message_len,
+                            notification->code);
         }
-        coap_set_token(notification, obs->token, obs->token_len);
-
-        transaction->packet_len =
-          coap_serialize_message(notification, transaction->packet);
-
-        coap_send_transaction(transaction);
       }
     }
   }
+
+  if(first != NULL) {
+    send_notification(first, first_obs, first->packet, message_len,
+                      notification->code);
+  }
 }
 /*---------------------------------------------------------------------------*/
 void
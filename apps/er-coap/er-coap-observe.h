@@ -55,6 +55,8 @@ typedef struct coap_observable {
 
 typedef struct coap_observer {
   struct coap_observer *next;   /* for LIST */
+  struct coap_observer *token_next;     /* for the token hash table */
+  struct coap_observer *mid_next;       /* for the MID hash table */
 
   char url[COAP_OBSERVER_URL_LEN];
   uip_ipaddr_t addr;
@@ -54,9 +54,13 @@
 #endif
 
 /*---------------------------------------------------------------------------*/
-MEMB(transactions_memb, coap_transaction_t, COAP_MAX_OPEN_TRANSACTIONS);
+MEMB_FREELIST(transactions_memb, coap_transaction_t, COAP_MAX_OPEN_TRANSACTIONS);
 LIST(transactions_list);
 
+/* The open transactions, hashed by their MID */
+static coap_transaction_t *transactions_by_mid[COAP_HASH_BUCKETS];
+#define MID_BUCKET(mid) (&transactions_by_mid[(mid) % COAP_HASH_BUCKETS])
+
 static struct process *transaction_handler_process = NULL;
 
 /*---------------------------------------------------------------------------*/
@@ -81,6 +85,8 @@ coap_new_transaction(uint16_t mid, uip_ipaddr_t *addr, uint16_t port)
     t->port = port;
 
     list_add(transactions_list, t); /* list itself makes sure same element is not added twice */
+    t->mid_next = *MID_BUCKET(mid);
+    *MID_BUCKET(mid) = t;
   }
 
   return t;
@@ -141,11 +147,19 @@ coap_send_transaction(coap_transaction_t *t)
 void
 coap_clear_transaction(coap_transaction_t *t)
 {
+  coap_transaction_t **p;
+
   if(t) {
     PRINTF("Freeing transaction %u: %p\n", t->mid, t);
 
     etimer_stop(&t->retrans_timer);
     list_remove(transactions_list, t);
+    for(p = MID_BUCKET(t->mid); *p; p = &(*p)->mid_next) {
+      if(*p == t) {
+        *p = t->mid_next;
+        break;
+      }
+    }
     memb_free(&transactions_memb, t);
   }
 }
@@ -154,7 +168,7 @@ coap_get_transaction_by_mid(uint16_t mid)
 {
   coap_transaction_t *t = NULL;
 
-  for(t = (coap_transaction_t *)list_head(transactions_list); t; t = t->next) {
+  for(t = *MID_BUCKET(mid); t; t = t->mid_next) {
     if(t->mid == mid) {
       PRINTF("Found transaction for MID %u: %p\n", t->mid, t);
       return t;
@@ -167,8 +181,11 @@ void
 coap_check_transactions()
 {
   coap_transaction_t *t = NULL;
+  coap_transaction_t *next;
 
-  for(t = (coap_transaction_t *)list_head(transactions_list); t; t = t->next) {
+  /* A transaction that times out is freed, so get the next one first */
+  for(t = (coap_transaction_t *)list_head(transactions_list); t; t = next) {
+    next = t->next;
     if(etimer_expired(&t->retrans_timer)) {
       ++(t->retrans_counter);
       PRINTF("Retransmitting %u (%u)\n", t->mid, t->retrans_counter);
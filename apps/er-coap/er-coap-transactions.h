@@ -51,6 +51,7 @@
 /* container for transactions with message buffer and retransmission info */
 typedef struct coap_transaction {
   struct coap_transaction *next;        /* for LIST */
+  struct coap_transaction *mid_next;    /* for the MID hash table */
 
   uint16_t mid;
   struct etimer retrans_timer;
@@ -217,6 +217,32 @@ coap_serialize_array_option(unsigned int number, unsigned int current_number,
   return i;
 }
 /*---------------------------------------------------------------------------*/
+static size_t
+coap_get_option_header(const uint8_t *buffer, unsigned int *delta,
+                       size_t *length)
+{
+  size_t read = 1;
+
+  *delta = buffer[0] >> 4;
+  *length = buffer[0] & 0x0F;
+
+  if(*delta == 13) {
+    *delta += buffer[read++];
+  } else if(*delta == 14) {
+    *delta = 269 + (buffer[read] << 8) + buffer[read + 1];
+    read += 2;
+  }
+
+  if(*length == 13) {
+    *length += buffer[read++];
+  } else if(*length == 14) {
+    *length = 269 + (buffer[read] << 8) + buffer[read + 1];
+    read += 2;
+  }
+
+  return read;
+}
+/*---------------------------------------------------------------------------*/
 static void
 coap_merge_multi_option(char **dst, size_t *dst_len, uint8_t *option,
                         size_t option_len, char separator)
@@ -422,6 +448,82 @@ coap_serialize_message(void *packet, uint8_t *buffer)
   return (option - buffer) + coap_pkt->payload_len; /* packet length */
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * Copies a message that was serialized without a token and an Observe
+ * option, with the given type, MID and token, and with an Observe option
+ * unless observe is negative. This way, a notification is serialized once
+ * and copied for every observer. The buffer may be the message itself, and
+ * must hold COAP_MAX_PACKET_SIZE bytes.
+ */
+size_t
+coap_copy_message(uint8_t *buffer, const uint8_t *message, size_t message_len,
+                  coap_message_type_t type, uint16_t mid,
+                  const uint8_t *token, size_t token_len, int32_t observe)
+{
+  /* The Observe option, and the header of the option after it */
+  uint8_t observe_option[1 + 4 + 5];
+  size_t observe_len = 0;
+  unsigned int current_number = 0;
+  unsigned int delta;
+  size_t option_len;
+  size_t header_len;
+  size_t options_end;
+  size_t rest;
+  size_t length;
+
+  /* Find where the Observe option goes among the options */
+  options_end = COAP_HEADER_LEN;
+  while(options_end < message_len && message[options_end] != 0xFF) {
+    header_len = coap_get_option_header(&message[options_end], &delta,
+                                        &option_len);
+    if(current_number + delta > COAP_OPTION_OBSERVE) {
+      break;
+    }
+    current_number += delta;
+    options_end += header_len + option_len;
+  }
+  rest = options_end;
+
+  if(observe >= 0) {
+    observe_len = coap_serialize_int_option(COAP_OPTION_OBSERVE,
+                                            current_number, observe_option,
+                                            observe);
+    /* The delta of the next option now counts from the Observe option */
+    if(rest < message_len && message[rest] != 0xFF) {
+      header_len = coap_get_option_header(&message[rest], &delta,
+                                          &option_len);
+      observe_len +=
+        coap_set_option_header(current_number + delta - COAP_OPTION_OBSERVE,
+                               option_len, &observe_option[observe_len]);
+      rest += header_len;
+    }
+  }
+
+  length = options_end + token_len + observe_len + message_len - rest;
+  if(token_len > COAP_TOKEN_LEN || length > COAP_MAX_PACKET_SIZE) {
+    coap_error_message = "Copied message exceeds COAP_MAX_PACKET_SIZE";
+    return 0;
+  }
+
+  /* Copy from the end, so that a message copied in place is only
+     overwritten where it has already been copied. */
+  memmove(&buffer[length - (message_len - rest)], &message[rest],
+          message_len - rest);
+  memcpy(&buffer[options_end + token_len], observe_option, observe_len);
+  memmove(&buffer[COAP_HEADER_LEN + token_len], &message[COAP_HEADER_LEN],
+          options_end - COAP_HEADER_LEN);
+  memcpy(&buffer[COAP_HEADER_LEN], token, token_len);
+
+  buffer[0] = (message[0] & COAP_HEADER_VERSION_MASK)
+    | (COAP_HEADER_TYPE_MASK & type << COAP_HEADER_TYPE_POSITION)
+    | (COAP_HEADER_TOKEN_LEN_MASK & token_len << COAP_HEADER_TOKEN_LEN_POSITION);
+  buffer[1] = message[1];
+  buffer[2] = (uint8_t)(mid >> 8);
+  buffer[3] = (uint8_t)mid;
+
+  return length;
+}
+/*---------------------------------------------------------------------------*/
 void
 coap_send_message(uip_ipaddr_t *addr, uint16_t port, uint8_t *data,
                   uint16_t length)
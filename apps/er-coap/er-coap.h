@@ -182,6 +182,10 @@ uint16_t coap_get_mid(void);
 void coap_init_message(void *packet, coap_message_type_t type, uint8_t code,
                        uint16_t mid);
 size_t coap_serialize_message(void *packet, uint8_t *buffer);
+size_t coap_copy_message(uint8_t *buffer, const uint8_t *message,
+                         size_t message_len, coap_message_type_t type,
+                         uint16_t mid, const uint8_t *token, size_t token_len,
+                         int32_t observe);
 void coap_send_message(uip_ipaddr_t *addr, uint16_t port, uint8_t *data,
                        uint16_t length);
 coap_status_t coap_parse_message(void *request, uint8_t *data,
@@ -58,6 +58,88 @@ PROCESS(rest_engine_process, "REST Engine");
 /*---------------------------------------------------------------------------*/
 LIST(restful_services);
 LIST(restful_periodic_services);
+
+/* The active resources, hashed by their URI path */
+static resource_t *resources_by_url[REST_RESOURCE_HASH_SIZE];
+/*---------------------------------------------------------------------------*/
+#define URL_HASH_INIT 5381
+#define URL_HASH_NEXT(hash, c) ((hash) * 33 + (unsigned char)(c))
+/*---------------------------------------------------------------------------*/
+static resource_t **
+url_bucket(unsigned int hash)
+{
+  return &resources_by_url[hash % REST_RESOURCE_HASH_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+static unsigned int
+url_hash(const char *url)
+{
+  unsigned int hash = URL_HASH_INIT;
+
+  while(*url != '\0') {
+    hash = URL_HASH_NEXT(hash, *url++);
+  }
+  return hash;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the first activated resource with the URI path url[0..url_len),
+   only considering resources with sub-resources if parent is set */
+static resource_t *
+find_resource(unsigned int hash, const char *url, int url_len, int parent)
+{
+  resource_t *resource;
+
+  for(resource = *url_bucket(hash); resource;
+      resource = resource->hash_next) {
+    if((!parent || (resource->flags & HAS_SUB_RESOURCES))
+       && strncmp(resource->url, url, url_len) == 0
+       && resource->url[url_len] == '\0') {
+      return resource;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns whichever of two resources was activated first */
+static resource_t *
+first_activated(resource_t *a, resource_t *b)
+{
+  resource_t *resource;
+
+  if(a == NULL || b == NULL) {
+    return a != NULL ? a : b;
+  }
+  for(resource = (resource_t *)list_head(restful_services);
+      resource; resource = resource->next) {
+    if(resource == a || resource == b) {
+      return resource;
+    }
+  }
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Returns the resource for a URI path: the one with the same path, or a
+ * parent resource with sub-resources whose path is followed by a '/'. If
+ * several resources match, the one that was activated first handles the
+ * request. The hash of every parent path is computed on the way to the
+ * hash of the whole path.
+ */
+static resource_t *
+lookup_resource(const char *url, int url_len)
+{
+  resource_t *found = NULL;
+  unsigned int hash = URL_HASH_INIT;
+  int i;
+
+  for(i = 0; i < url_len; i++) {
+    if(url[i] == '/') {
+      found = first_activated(found, find_resource(hash, url, i, 1));
+    }
+    hash = URL_HASH_NEXT(hash, url[i]);
+  }
+  return first_activated(found, find_resource(hash, url, url_len, 0));
+}
 /*---------------------------------------------------------------------------*/
 /*- REST Engine API ---------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -80,6 +162,7 @@ rest_init_engine(void)
   initialized = 1;
 
   list_init(restful_services);
+  memset(resources_by_url, 0, sizeof(resources_by_url));
 
   REST.set_service_callback(rest_invoke_restful_service);
 
@@ -102,9 +185,29 @@ rest_init_engine(void)
 void
 rest_activate_resource(resource_t *resource, char *path)
 {
+  resource_t **bucket;
+
+  if(resource->url != NULL) {
+    /* activated again, maybe under another path */
+    for(bucket = url_bucket(url_hash(resource->url)); *bucket;
+        bucket = &(*bucket)->hash_next) {
+      if(*bucket == resource) {
+        *bucket = resource->hash_next;
+        break;
+      }
+    }
+  }
+
   resource->url = path;
   list_add(restful_services, resource);
 
+  /* Resources with the same path are looked up in the order they were
+     activated in */
+  for(bucket = url_bucket(url_hash(path)); *bucket;
+      bucket = &(*bucket)->hash_next);
+  resource->hash_next = NULL;
+  *bucket = resource;
+
   PRINTF("Activating: %s\n", resource->url);
 
   /* Only add periodic resources with a periodic_handler and a period > 0. */
@@ -141,44 +244,36 @@ rest_invoke_restful_service(void *request, void *response, uint8_t *buffer,
 
   resource_t *resource = NULL;
   const char *url = NULL;
-  int url_len, res_url_len;
+  int url_len;
 
   url_len = REST.get_url(request, &url);
-  for(resource = (resource_t *)list_head(restful_services);
-      resource; resource = resource->next) {
+  resource = lookup_resource(url, url_len);
+
+  /* if the web service handles that kind of requests and urls matches */
+  if(resource != NULL) {
+    found = 1;
+    rest_resource_flags_t method = REST.get_method_type(request);
 
-    /* if the web service handles that kind of requests and urls matches */
-    res_url_len = strlen(resource->url);
-    if((url_len == res_url_len
-        || (url_len > res_url_len
-            && (resource->flags & HAS_SUB_RESOURCES)
-            && url[res_url_len] == '/'))
-       && strncmp(resource->url, url, res_url_len) == 0) {
-      found = 1;
-      rest_resource_flags_t method = REST.get_method_type(request);
-
-      PRINTF("/%s, method %u, resource->flags %u\n", resource->url,
-             (uint16_t)method, resource->flags);
-
-      if((method & METHOD_GET) && resource->get_handler != NULL) {
-        /* call handler function */
-        resource->get_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_POST) && resource->post_handler != NULL) {
-        /* call handler function */
-        resource->post_handler(request, response, buffer, buffer_size,
+    PRINTF("/%s, method %u, resource->flags %u\n", resource->url,
+           (uint16_t)method, resource->flags);
+
+    if((method & METHOD_GET) && resource->get_handler != NULL) {
+      /* call handler function */
+      resource->get_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_POST) && resource->post_handler != NULL) {
+      /* call handler function */
+      resource->post_handler(request, response, buffer, buffer_size,
+                             offset);
+    } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
+      /* call handler function */
+      resource->put_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
+      /* call handler function */
+      resource->delete_handler(request, response, buffer, buffer_size,
                                offset);
-      } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
-        /* call handler function */
-        resource->put_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
-        /* call handler function */
-        resource->delete_handler(request, response, buffer, buffer_size,
-                                 offset);
-      } else {
-        allowed = 0;
-        REST.set_response_status(response, REST.status.METHOD_NOT_ALLOWED);
-      }
-      break;
+    } else {
+      allowed = 0;
+      REST.set_response_status(response, REST.status.METHOD_NOT_ALLOWED);
     }
   }
   if(!found) {
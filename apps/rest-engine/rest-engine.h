@@ -62,6 +62,13 @@
 #define REST_MAX_CHUNK_SIZE     64
 #endif
 
+/*
+ * The number of buckets in the table that maps URI paths to resources.
+ */
+#ifndef REST_RESOURCE_HASH_SIZE
+#define REST_RESOURCE_HASH_SIZE 16
+#endif
+
 struct resource_s;
 struct periodic_resource_s;
 
@@ -95,6 +102,7 @@ struct resource_s {
     restful_trigger_handler trigger;
     restful_trigger_handler resume;
   };
+  struct resource_s *hash_next;   /* next resource in the same hash bucket */
 };
 typedef struct resource_s resource_t;
 
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Shell command for the per-neighbor queue statistics of CSMA
+ */
+
+#include "contiki.h"
+#include "shell-csma.h"
+#include "net/mac/csma.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define BUFLEN 100
+
+/*---------------------------------------------------------------------------*/
+PROCESS(shell_csma_stats_process, "csma-stats");
+SHELL_COMMAND(csma_stats_command,
+	      "csma-stats",
+	      "csma-stats [reset]: show or clear the CSMA queue statistics of each neighbor",
+	      &shell_csma_stats_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_csma_stats_process, ev, data)
+{
+  const struct csma_neighbor_stats *s;
+  const linkaddr_t *addr;
+  const char *args;
+  char buf[BUFLEN];
+  unsigned long done;
+  int i, len;
+
+  PROCESS_BEGIN();
+
+  args = data;
+  if(args != NULL && strcmp(args, "reset") == 0) {
+    csma_stats_reset();
+    PROCESS_EXIT();
+  }
+
+  shell_output_str(&csma_stats_command,
+                   "neighbor queue max sent failed dropped retx ",
+                   "avg-delay-ms max-delay-ms");
+  for(s = csma_stats_head(); s != NULL; s = csma_stats_next(s)) {
+    addr = csma_stats_addr(s);
+    len = 0;
+    for(i = 0; i < LINKADDR_SIZE; i++) {
+      len += snprintf(buf + len, BUFLEN - len, i == 0 ? "%02x" : ":%02x",
+                      addr->u8[i]);
+    }
+    done = s->sent + s->failed;
+    snprintf(buf + len, BUFLEN - len, " %u %u %lu %lu %lu %lu %lu %lu",
+             s->queue_len, s->max_queue_len,
+             (unsigned long)s->sent, (unsigned long)s->failed,
+             (unsigned long)s->dropped, (unsigned long)s->retransmissions,
+             /* Converted to ms with 64 bits, as total_delay * 1000
+                may not fit in 32 bits */
+             done > 0 ? (unsigned long)((uint64_t)s->total_delay * 1000 /
+                                        CLOCK_SECOND / done) : 0,
+             (unsigned long)((uint64_t)s->max_delay * 1000 / CLOCK_SECOND));
+    shell_output_str(&csma_stats_command, buf, "");
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+shell_csma_init(void)
+{
+  shell_register_command(&csma_stats_command);
+}
+/*---------------------------------------------------------------------------*/
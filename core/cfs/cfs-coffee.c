@@ -58,6 +58,9 @@
 #include "cfs/cfs.h"
 #include "cfs-coffee-arch.h"
 #include "cfs/cfs-coffee.h"
+#if COFFEE_GC_PROCESS
+#include "sys/process.h"
+#endif /* COFFEE_GC_PROCESS */
 
 /* Micro logs enable modifications on storage types that do not support
    in-place updates. This applies primarily to flash memories. */
@@ -84,6 +87,49 @@
 #define COFFEE_EXTENDED_WEAR_LEVELLING  1
 #endif
 
+/*
+ * Keep an index from file names to file pages in RAM, together with
+ * the end offset of each file, so that opening a file does not scan
+ * the storage. COFFEE_NAME_INDEX_SIZE is the number of index slots
+ * and must be a power of two. When more than three quarters of them
+ * would be used, files that do not fit are found by scanning.
+ */
+#ifndef COFFEE_NAME_INDEX
+#define COFFEE_NAME_INDEX 0
+#endif
+
+#ifndef COFFEE_NAME_INDEX_SIZE
+#define COFFEE_NAME_INDEX_SIZE 32
+#endif
+
+#if COFFEE_NAME_INDEX && (COFFEE_NAME_INDEX_SIZE & (COFFEE_NAME_INDEX_SIZE - 1))
+#error COFFEE_NAME_INDEX_SIZE must be a power of two.
+#endif
+
+/*
+ * Collect garbage in a process, one sector at a time, whenever fewer
+ * than COFFEE_GC_WATERMARK pages are free. Otherwise, garbage is only
+ * collected when a file cannot be reserved, and then every erasable
+ * sector is erased while the caller waits.
+ */
+#ifndef COFFEE_GC_PROCESS
+#define COFFEE_GC_PROCESS 0
+#endif
+
+#ifndef COFFEE_GC_WATERMARK
+#define COFFEE_GC_WATERMARK (2 * COFFEE_PAGES_PER_SECTOR)
+#endif
+
+/*
+ * Cache COFFEE_CACHE_PAGES pages of storage in RAM for small reads,
+ * and combine consecutive small writes into one. Metadata is written
+ * at once, file data when cfs_close() or cfs_coffee_flush() is
+ * called, or when a write does not continue the previous one.
+ */
+#ifndef COFFEE_CACHE_PAGES
+#define COFFEE_CACHE_PAGES 0
+#endif
+
 #if COFFEE_START & (COFFEE_SECTOR_SIZE - 1)
 #error COFFEE_START must point to the first byte in a sector.
 #endif
@@ -111,6 +157,8 @@
 #define GC_GREEDY         0
 /* "Reluctant" garbage collection stops after erasing one sector. */
 #define GC_RELUCTANT      1
+/* Erase the first erasable sector with obsolete pages. */
+#define GC_STEP           2
 
 /* File descriptor macros. */
 #define FD_VALID(fd)      ((fd) >= 0 && (fd) < COFFEE_FD_SET_SIZE && \
@@ -168,6 +216,9 @@ struct file {
   int16_t record_count;
   uint8_t references;
   uint8_t flags;
+#if COFFEE_NAME_INDEX
+  uint16_t name_hash;
+#endif /* COFFEE_NAME_INDEX */
 };
 
 /* The file descriptor structure. */
@@ -206,18 +257,199 @@ static struct file_desc coffee_fd_set[COFFEE_FD_SET_SIZE];
 static coffee_page_t next_free;
 static char gc_wait;
 
+#if COFFEE_GC_PROCESS
+PROCESS(coffee_gc_process, "Coffee GC");
+static char gc_all;
+#endif /* COFFEE_GC_PROCESS */
+
+#if COFFEE_NAME_INDEX
+/* A name index slot, empty when page is INVALID_PAGE. Slots are
+   found by linear probing from name_hash. */
+struct name_index_entry {
+  cfs_offset_t end;
+  coffee_page_t page;
+  uint16_t name_hash;
+};
+
+#define NAME_INDEX_MASK  (COFFEE_NAME_INDEX_SIZE - 1)
+#define NAME_INDEX_LIMIT (COFFEE_NAME_INDEX_SIZE - COFFEE_NAME_INDEX_SIZE / 4)
+
+/* Until the index is built, it holds nothing. When some file did not
+   fit, a name that is not in the index may still be on storage. */
+#define NAME_INDEX_UNBUILT    0
+#define NAME_INDEX_COMPLETE   1
+#define NAME_INDEX_INCOMPLETE 2
+
+static struct name_index_entry name_index[COFFEE_NAME_INDEX_SIZE];
+static int name_index_count;
+static uint8_t name_index_state;
+#endif /* COFFEE_NAME_INDEX */
+
+#if COFFEE_CACHE_PAGES
+struct cache_line {
+  unsigned long used;
+  coffee_page_t page;
+  unsigned char data[COFFEE_PAGE_SIZE];
+};
+
+static struct cache_line cache[COFFEE_CACHE_PAGES];
+static unsigned long cache_clock;
+static struct cfs_coffee_cache_stats cache_stats;
+
+/* The pending write, which later consecutive writes are added to */
+static unsigned char write_buf[COFFEE_PAGE_SIZE];
+static cfs_offset_t write_offset;
+static unsigned write_size;
+#endif /* COFFEE_CACHE_PAGES */
+
+/*---------------------------------------------------------------------------*/
+static void
+flush_writes(void)
+{
+#if COFFEE_CACHE_PAGES
+  if(write_size > 0) {
+    COFFEE_WRITE(write_buf, write_size, write_offset);
+    cache_stats.flushes++;
+    write_size = 0;
+  }
+#endif /* COFFEE_CACHE_PAGES */
+}
+#if COFFEE_CACHE_PAGES
+/*---------------------------------------------------------------------------*/
+static void
+flush_overlapping(cfs_offset_t offset, unsigned size)
+{
+  if(write_size > 0 && offset < write_offset + write_size &&
+     write_offset < offset + size) {
+    flush_writes();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static struct cache_line *
+cache_lookup(coffee_page_t page)
+{
+  struct cache_line *line, *victim;
+
+  victim = &cache[0];
+  for(line = cache; line < &cache[COFFEE_CACHE_PAGES]; line++) {
+    if(line->used != 0 && line->page == page) {
+      line->used = ++cache_clock;
+      cache_stats.hits++;
+      return line;
+    }
+    if(line->used < victim->used) {
+      victim = line;
+    }
+  }
+
+  /* Pending data must reach the storage before the page is read. */
+  flush_overlapping(page * COFFEE_PAGE_SIZE, COFFEE_PAGE_SIZE);
+  COFFEE_READ(victim->data, COFFEE_PAGE_SIZE, page * COFFEE_PAGE_SIZE);
+  victim->page = page;
+  victim->used = ++cache_clock;
+  cache_stats.misses++;
+  return victim;
+}
+#endif /* COFFEE_CACHE_PAGES */
+/*---------------------------------------------------------------------------*/
+static void
+coffee_read(void *buf, unsigned size, cfs_offset_t offset)
+{
+#if COFFEE_CACHE_PAGES
+  struct cache_line *line;
+  unsigned chunk, in_page;
+
+  /* Large reads, such as whole pages, would only evict small ones. */
+  if(size >= COFFEE_PAGE_SIZE) {
+    flush_overlapping(offset, size);
+    COFFEE_READ(buf, size, offset);
+    return;
+  }
+
+  while(size > 0) {
+    line = cache_lookup(offset / COFFEE_PAGE_SIZE);
+    in_page = offset % COFFEE_PAGE_SIZE;
+    chunk = MIN(size, COFFEE_PAGE_SIZE - in_page);
+    memcpy(buf, line->data + in_page, chunk);
+    buf = (char *)buf + chunk;
+    offset += chunk;
+    size -= chunk;
+  }
+#else /* COFFEE_CACHE_PAGES */
+  COFFEE_READ(buf, size, offset);
+#endif /* COFFEE_CACHE_PAGES */
+}
+/*---------------------------------------------------------------------------*/
+static void
+coffee_write(const void *buf, unsigned size, cfs_offset_t offset)
+{
+#if COFFEE_CACHE_PAGES
+  struct cache_line *line;
+  cfs_offset_t start, end;
+
+  cache_stats.writes++;
+
+  /* Keep cached pages equal to what the storage will hold. */
+  for(line = cache; line < &cache[COFFEE_CACHE_PAGES]; line++) {
+    if(line->used == 0) {
+      continue;
+    }
+    start = MAX(offset, line->page * COFFEE_PAGE_SIZE);
+    end = MIN(offset + size, (line->page + 1) * COFFEE_PAGE_SIZE);
+    if(start < end) {
+      memcpy(line->data + start % COFFEE_PAGE_SIZE,
+             (const char *)buf + (start - offset), end - start);
+    }
+  }
+
+  if(write_size > 0 && offset == write_offset + write_size &&
+     write_size + size <= sizeof(write_buf)) {
+    memcpy(write_buf + write_size, buf, size);
+    write_size += size;
+    return;
+  }
+
+  /* Writes reach the storage in the order they were made. */
+  flush_writes();
+  if(size < sizeof(write_buf)) {
+    memcpy(write_buf, buf, size);
+    write_offset = offset;
+    write_size = size;
+    return;
+  }
+  cache_stats.flushes++;
+#endif /* COFFEE_CACHE_PAGES */
+  COFFEE_WRITE(buf, size, offset);
+}
+/*---------------------------------------------------------------------------*/
+static void
+coffee_erase(coffee_page_t sector)
+{
+#if COFFEE_CACHE_PAGES
+  struct cache_line *line;
+
+  flush_writes();
+  for(line = cache; line < &cache[COFFEE_CACHE_PAGES]; line++) {
+    if(line->page / COFFEE_PAGES_PER_SECTOR == sector) {
+      line->used = 0;
+    }
+  }
+#endif /* COFFEE_CACHE_PAGES */
+  COFFEE_ERASE(sector);
+}
 /*---------------------------------------------------------------------------*/
 static void
 write_header(struct file_header *hdr, coffee_page_t page)
 {
   hdr->flags |= HDR_FLAG_VALID;
-  COFFEE_WRITE(hdr, sizeof(*hdr), page * COFFEE_PAGE_SIZE);
+  coffee_write(hdr, sizeof(*hdr), page * COFFEE_PAGE_SIZE);
+  flush_writes();
 }
 /*---------------------------------------------------------------------------*/
 static void
 read_header(struct file_header *hdr, coffee_page_t page)
 {
-  COFFEE_READ(hdr, sizeof(*hdr), page * COFFEE_PAGE_SIZE);
+  coffee_read(hdr, sizeof(*hdr), page * COFFEE_PAGE_SIZE);
   if(DEBUG && HDR_ACTIVE(*hdr) && !HDR_VALID(*hdr)) {
     PRINTF("Coffee: Invalid header at page %u!\n", (unsigned)page);
   }
@@ -348,19 +580,43 @@ isolate_pages(coffee_page_t start, coffee_page_t skip_pages)
          (unsigned)skip_pages, (int)start / COFFEE_PAGES_PER_SECTOR);
 }
 /*---------------------------------------------------------------------------*/
-static void
+static coffee_page_t
+count_free_pages(coffee_page_t *reclaimable)
+{
+  coffee_page_t sector;
+  coffee_page_t free;
+  struct sector_status stats;
+
+  free = 0;
+  if(reclaimable != NULL) {
+    *reclaimable = 0;
+  }
+  for(sector = 0; sector < COFFEE_SECTOR_COUNT; sector++) {
+    get_sector_status(sector, &stats);
+    free += stats.free;
+    if(reclaimable != NULL && stats.active == 0) {
+      *reclaimable += stats.obsolete;
+    }
+  }
+  return free;
+}
+/*---------------------------------------------------------------------------*/
+static int
 collect_garbage(int mode)
 {
   coffee_page_t sector;
   struct sector_status stats;
   coffee_page_t first_page, isolation_count;
+  int erased;
 
   PRINTF("Coffee: Running the garbage collector in %s mode\n",
-         mode == GC_RELUCTANT ? "reluctant" : "greedy");
+         mode == GC_RELUCTANT ? "reluctant" :
+         mode == GC_STEP ? "step" : "greedy");
   /*
    * The garbage collector erases as many sectors as possible. A sector is
    * erasable if there are only free or obsolete pages in it.
    */
+  erased = 0;
   for(sector = 0; sector < COFFEE_SECTOR_COUNT; sector++) {
     isolation_count = get_sector_status(sector, &stats);
     PRINTF("Coffee: Sector %u has %u active, %u obsolete, and %u free pages.\n",
@@ -372,7 +628,7 @@ collect_garbage(int mode)
     }
 
     if((mode == GC_RELUCTANT && stats.free == 0) ||
-       (mode == GC_GREEDY && stats.obsolete > 0)) {
+       (mode != GC_RELUCTANT && stats.obsolete > 0)) {
       first_page = sector * COFFEE_PAGES_PER_SECTOR;
       if(first_page < next_free) {
         next_free = first_page;
@@ -382,16 +638,50 @@ collect_garbage(int mode)
         isolate_pages(first_page + COFFEE_PAGES_PER_SECTOR, isolation_count);
       }
 
-      COFFEE_ERASE(sector);
+      coffee_erase(sector);
       PRINTF("Coffee: Erased sector %d!\n", sector);
+      erased++;
+      gc_wait = 0;
 
-      if(mode == GC_RELUCTANT && isolation_count > 0) {
+      if((mode == GC_RELUCTANT && isolation_count > 0) || mode == GC_STEP) {
         break;
       }
     }
   }
+
+  return erased;
+}
+#if COFFEE_GC_PROCESS
+/*---------------------------------------------------------------------------*/
+static void
+poll_gc_process(void)
+{
+  if(!process_is_running(&coffee_gc_process)) {
+    process_start(&coffee_gc_process, NULL);
+  }
+  process_poll(&coffee_gc_process);
 }
 /*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_gc_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+
+    /* Erase one sector per run, so that file operations in between
+       wait for one sector erasure at most. */
+    while((gc_all || count_free_pages(NULL) < COFFEE_GC_WATERMARK) &&
+          collect_garbage(GC_STEP) > 0) {
+      PROCESS_PAUSE();
+    }
+    gc_all = 0;
+  }
+
+  PROCESS_END();
+}
+#endif /* COFFEE_GC_PROCESS */
+/*---------------------------------------------------------------------------*/
 static coffee_page_t
 next_file(coffee_page_t page, struct file_header *hdr)
 {
@@ -412,12 +702,121 @@ next_file(coffee_page_t page, struct file_header *hdr)
   }
   return page + hdr->max_pages;
 }
+#if COFFEE_NAME_INDEX
+/*---------------------------------------------------------------------------*/
+static uint16_t
+name_hash(const char *name)
+{
+  uint16_t hash;
+  int i;
+
+  /* Names are stored truncated to COFFEE_NAME_LENGTH - 1 characters. */
+  hash = 0;
+  for(i = 0; i < COFFEE_NAME_LENGTH - 1 && name[i] != '\0'; i++) {
+    hash = (hash << 5) + hash + (uint8_t)name[i];
+  }
+  return hash;
+}
+/*---------------------------------------------------------------------------*/
+static struct name_index_entry *
+name_index_find(coffee_page_t page, uint16_t hash)
+{
+  int i;
+
+  /* An index that is not built holds no empty slot to stop at. */
+  if(name_index_state == NAME_INDEX_UNBUILT) {
+    return NULL;
+  }
+
+  for(i = hash & NAME_INDEX_MASK;
+      name_index[i].page != INVALID_PAGE;
+      i = (i + 1) & NAME_INDEX_MASK) {
+    if(name_index[i].page == page) {
+      return &name_index[i];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_add(coffee_page_t page, const char *name, cfs_offset_t end)
+{
+  uint16_t hash;
+  int i;
+
+  if(name_index_state == NAME_INDEX_UNBUILT) {
+    return;
+  }
+
+  if(name_index_count >= NAME_INDEX_LIMIT) {
+    name_index_state = NAME_INDEX_INCOMPLETE;
+    return;
+  }
+
+  hash = name_hash(name);
+  for(i = hash & NAME_INDEX_MASK;
+      name_index[i].page != INVALID_PAGE;
+      i = (i + 1) & NAME_INDEX_MASK);
+  name_index[i].page = page;
+  name_index[i].name_hash = hash;
+  name_index[i].end = end;
+  name_index_count++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_remove(coffee_page_t page, const char *name)
+{
+  struct name_index_entry *e;
+  int i, j, home;
+
+  e = name_index_find(page, name_hash(name));
+  if(e == NULL) {
+    return;
+  }
+  name_index_count--;
+
+  /* Move later entries of the probe sequence into the hole, so that
+     lookups need no deletion markers. */
+  i = e - name_index;
+  for(j = (i + 1) & NAME_INDEX_MASK;
+      name_index[j].page != INVALID_PAGE;
+      j = (j + 1) & NAME_INDEX_MASK) {
+    home = name_index[j].name_hash & NAME_INDEX_MASK;
+    if(((j - home) & NAME_INDEX_MASK) >= ((j - i) & NAME_INDEX_MASK)) {
+      name_index[i] = name_index[j];
+      i = j;
+    }
+  }
+  name_index[i].page = INVALID_PAGE;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_build(void)
+{
+  struct file_header hdr;
+  coffee_page_t page;
+
+  memset(name_index, 0xff, sizeof(name_index));
+  name_index_count = 0;
+  name_index_state = NAME_INDEX_COMPLETE;
+
+  for(page = 0; page < COFFEE_PAGE_COUNT; page = next_file(page, &hdr)) {
+    read_header(&hdr, page);
+    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr)) {
+      name_index_add(page, hdr.name, UNKNOWN_OFFSET);
+    }
+  }
+}
+#endif /* COFFEE_NAME_INDEX */
 /*---------------------------------------------------------------------------*/
 static struct file *
 load_file(coffee_page_t start, struct file_header *hdr)
 {
   int i, unreferenced, free;
   struct file *file;
+#if COFFEE_NAME_INDEX
+  struct name_index_entry *e;
+#endif /* COFFEE_NAME_INDEX */
 
   /*
    * We prefer to overwrite a free slot since unreferenced ones
@@ -442,8 +841,21 @@ load_file(coffee_page_t start, struct file_header *hdr)
   }
 
   file = &coffee_files[i];
-  file->page = start;
+#if COFFEE_NAME_INDEX
+  /* Keep the end offset of the file that this slot held. */
+  if(!FILE_FREE(file)) {
+    e = name_index_find(file->page, file->name_hash);
+    if(e != NULL) {
+      e->end = file->end;
+    }
+  }
+  file->name_hash = name_hash(hdr->name);
+  e = name_index_find(start, file->name_hash);
+  file->end = e != NULL ? e->end : UNKNOWN_OFFSET;
+#else /* COFFEE_NAME_INDEX */
   file->end = UNKNOWN_OFFSET;
+#endif /* COFFEE_NAME_INDEX */
+  file->page = start;
   file->max_pages = hdr->max_pages;
   file->flags = HDR_MODIFIED(*hdr) ? COFFEE_FILE_MODIFIED : 0;
   /* We don't know the amount of records yet. */
@@ -459,6 +871,38 @@ find_file(const char *name)
   struct file_header hdr;
   coffee_page_t page;
 
+#if COFFEE_NAME_INDEX
+  uint16_t hash;
+
+  if(name_index_state == NAME_INDEX_UNBUILT) {
+    name_index_build();
+  }
+
+  hash = name_hash(name);
+  for(i = hash & NAME_INDEX_MASK;
+      name_index[i].page != INVALID_PAGE;
+      i = (i + 1) & NAME_INDEX_MASK) {
+    if(name_index[i].name_hash != hash) {
+      continue;
+    }
+
+    page = name_index[i].page;
+    read_header(&hdr, page);
+    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr) && strcmp(name, hdr.name) == 0) {
+      for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
+        if(!FILE_FREE(&coffee_files[i]) && coffee_files[i].page == page) {
+          return &coffee_files[i];
+        }
+      }
+      return load_file(page, &hdr);
+    }
+  }
+
+  if(name_index_state == NAME_INDEX_COMPLETE) {
+    return NULL;
+  }
+#endif /* COFFEE_NAME_INDEX */
+
   /* First check if the file metadata is cached. */
   for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
     if(FILE_FREE(&coffee_files[i])) {
@@ -501,7 +945,7 @@ file_end(coffee_page_t start)
    */
 
   for(page = hdr.max_pages - 1; page >= 0; page--) {
-    COFFEE_READ(buf, sizeof(buf), (start + page) * COFFEE_PAGE_SIZE);
+    coffee_read(buf, sizeof(buf), (start + page) * COFFEE_PAGE_SIZE);
     for(i = COFFEE_PAGE_SIZE - 1; i >= 0; i--) {
       if(buf[i] != 0) {
         if(page == 0 && i < sizeof(hdr)) {
@@ -516,6 +960,35 @@ file_end(coffee_page_t start)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+static cfs_offset_t
+file_size(coffee_page_t start, struct file_header *hdr)
+{
+#if COFFEE_NAME_INDEX
+  struct name_index_entry *e;
+  int i;
+
+  for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
+    if(!FILE_FREE(&coffee_files[i]) && coffee_files[i].page == start &&
+       coffee_files[i].end != UNKNOWN_OFFSET) {
+      return coffee_files[i].end;
+    }
+  }
+
+  /* Listing files after a boot keeps their sizes in the index. */
+  if(name_index_state == NAME_INDEX_UNBUILT) {
+    name_index_build();
+  }
+  e = name_index_find(start, name_hash(hdr->name));
+  if(e != NULL) {
+    if(e->end == UNKNOWN_OFFSET) {
+      e->end = file_end(start);
+    }
+    return e->end;
+  }
+#endif /* COFFEE_NAME_INDEX */
+  return file_end(start);
+}
+/*---------------------------------------------------------------------------*/
 static coffee_page_t
 find_contiguous_pages(coffee_page_t amount)
 {
@@ -573,6 +1046,12 @@ remove_by_page(coffee_page_t page, int remove_log,
   hdr.flags |= HDR_FLAG_OBSOLETE;
   write_header(&hdr, page);
 
+#if COFFEE_NAME_INDEX
+  if(!HDR_LOG(hdr)) {
+    name_index_remove(page, hdr.name);
+  }
+#endif /* COFFEE_NAME_INDEX */
+
   gc_wait = 0;
 
   /* Close all file descriptors that reference the removed file. */
@@ -592,9 +1071,13 @@ remove_by_page(coffee_page_t page, int remove_log,
     }
   }
 
+#if COFFEE_GC_PROCESS
+  poll_gc_process();
+#else /* COFFEE_GC_PROCESS */
   if(!COFFEE_EXTENDED_WEAR_LEVELLING && gc_allowed) {
     collect_garbage(GC_RELUCTANT);
   }
+#endif /* COFFEE_GC_PROCESS */
 
   return 0;
 }
@@ -640,6 +1123,16 @@ reserve(const char *name, coffee_page_t pages,
   PRINTF("Coffee: Reserved %u pages starting from %u for file %s\n",
          (unsigned)pages, (unsigned)page, name);
 
+#if COFFEE_GC_PROCESS
+  poll_gc_process();
+#endif /* COFFEE_GC_PROCESS */
+
+#if COFFEE_NAME_INDEX
+  if(!HDR_LOG(hdr)) {
+    name_index_add(page, hdr.name, 0);
+  }
+#endif /* COFFEE_NAME_INDEX */
+
   file = load_file(page, &hdr);
   if(file != NULL) {
     file->end = 0;
@@ -703,7 +1196,7 @@ get_record_index(coffee_page_t log_page, uint16_t search_records,
       }
 
       base -= batch_size * sizeof(indices[0]);
-      COFFEE_READ(&indices, sizeof(indices[0]) * batch_size, base);
+      coffee_read(&indices, sizeof(indices[0]) * batch_size, base);
 
       for(i = batch_size - 1; i >= 0; i--) {
         if(indices[i] - 1 == region) {
@@ -744,7 +1237,7 @@ read_log_page(struct file_header *hdr, int16_t record_count,
   base = absolute_offset(hdr->log_page, log_records * sizeof(region));
   base += (cfs_offset_t)match_index * log_record_size;
   base += lp->offset;
-  COFFEE_READ(lp->buf, lp->size, base);
+  coffee_read(lp->buf, lp->size, base);
 
   return lp->size;
 }
@@ -814,7 +1307,7 @@ merge_log(coffee_page_t file_page, int extend)
       cfs_close(fd);
       return -1;
     } else if(n > 0) {
-      COFFEE_WRITE(buf, n, absolute_offset(new_file->page, offset));
+      coffee_write(buf, n, absolute_offset(new_file->page, offset));
       offset += n;
     }
   } while(n != 0);
@@ -871,7 +1364,7 @@ find_next_record(struct file *file, coffee_page_t log_page,
       batch_size = log_records - processed >= preferred_batch_size ?
         preferred_batch_size : log_records - processed;
 
-      COFFEE_READ(&indices, batch_size * sizeof(indices[0]),
+      coffee_read(&indices, batch_size * sizeof(indices[0]),
                   absolute_offset(log_page, processed * sizeof(indices[0])));
       for(log_record = 0; log_record < batch_size; log_record++) {
         if(indices[log_record] == 0) {
@@ -935,7 +1428,7 @@ write_log_page(struct file *file, struct log_param *lp)
 
     if((lp->offset > 0 || lp->size != log_record_size) &&
        read_log_page(&hdr, log_record, &lp_out) < 0) {
-      COFFEE_READ(copy_buf, sizeof(copy_buf),
+      coffee_read(copy_buf, sizeof(copy_buf),
                   absolute_offset(file->page, offset));
     }
 
@@ -947,11 +1440,11 @@ write_log_page(struct file *file, struct log_param *lp)
      */
     offset = absolute_offset(log_page, 0);
     ++region;
-    COFFEE_WRITE(&region, sizeof(region),
+    coffee_write(&region, sizeof(region),
                  offset + log_record * sizeof(region));
 
     offset += log_records * sizeof(region);
-    COFFEE_WRITE(copy_buf, sizeof(copy_buf),
+    coffee_write(copy_buf, sizeof(copy_buf),
                  offset + log_record * log_record_size);
     file->record_count = log_record + 1;
   }
@@ -1014,6 +1507,7 @@ void
 cfs_close(int fd)
 {
   if(FD_VALID(fd)) {
+    flush_writes();
     coffee_fd_set[fd].flags = COFFEE_FD_FREE;
     coffee_fd_set[fd].file->references--;
     coffee_fd_set[fd].file = NULL;
@@ -1105,7 +1599,7 @@ cfs_read(int fd, void *buf, unsigned size)
 
   /* If the file is not modified, read directly from the file extent. */
   if(!FILE_MODIFIED(file)) {
-    COFFEE_READ(buf, size, absolute_offset(file->page, fdp->offset));
+    coffee_read(buf, size, absolute_offset(file->page, fdp->offset));
     fdp->offset += size;
     return size;
   }
@@ -1126,7 +1620,7 @@ cfs_read(int fd, void *buf, unsigned size)
 
     /* Read from the original file if we cannot find the data in the log. */
     if(r < 0) {
-      COFFEE_READ(buf, lp.size, absolute_offset(file->page, fdp->offset));
+      coffee_read(buf, lp.size, absolute_offset(file->page, fdp->offset));
       r = lp.size;
     }
     fdp->offset += r;
@@ -1209,7 +1703,7 @@ cfs_write(int fd, const void *buf, unsigned size)
        * corresponding end offset in the original extent to ensure that
        * the correct file size is calculated when opening the file again.
        */
-      COFFEE_WRITE(dummy, 1, absolute_offset(file->page, fdp->offset - 1));
+      coffee_write(dummy, 1, absolute_offset(file->page, fdp->offset - 1));
     }
   } else {
 #endif /* COFFEE_MICRO_LOGS */
@@ -1217,7 +1711,7 @@ cfs_write(int fd, const void *buf, unsigned size)
       return -1;
     }
 
-    COFFEE_WRITE(buf, size, absolute_offset(file->page, fdp->offset));
+    coffee_write(buf, size, absolute_offset(file->page, fdp->offset));
     fdp->offset += size;
 #if COFFEE_MICRO_LOGS
   }
@@ -1253,9 +1747,10 @@ cfs_readdir(struct cfs_dir *dir, struct cfs_dirent *record)
   while(page < COFFEE_PAGE_COUNT) {
     read_header(&hdr, page);
     if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr)) {
-      memcpy(record->name, hdr.name, sizeof(record->name));
+      memcpy(record->name, hdr.name,
+             MIN(sizeof(record->name), sizeof(hdr.name)));
       record->name[sizeof(record->name) - 1] = '\0';
-      record->size = file_end(page);
+      record->size = file_size(page, &hdr);
 
       next_page = next_file(page, &hdr);
       memcpy(dir->state, &next_page, sizeof(coffee_page_t));
@@ -1321,6 +1816,54 @@ cfs_coffee_set_io_semantics(int fd, unsigned flags)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+void
+cfs_coffee_get_space(unsigned long *free_bytes,
+                     unsigned long *reclaimable_bytes)
+{
+  coffee_page_t free, reclaimable;
+
+  free = count_free_pages(&reclaimable);
+  if(free_bytes != NULL) {
+    *free_bytes = (unsigned long)free * COFFEE_PAGE_SIZE;
+  }
+  if(reclaimable_bytes != NULL) {
+    *reclaimable_bytes = (unsigned long)reclaimable * COFFEE_PAGE_SIZE;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_coffee_gc_step(void)
+{
+  return collect_garbage(GC_STEP);
+}
+/*---------------------------------------------------------------------------*/
+void
+cfs_coffee_gc_start(void)
+{
+#if COFFEE_GC_PROCESS
+  gc_all = 1;
+  poll_gc_process();
+#else /* COFFEE_GC_PROCESS */
+  collect_garbage(GC_GREEDY);
+#endif /* COFFEE_GC_PROCESS */
+}
+/*---------------------------------------------------------------------------*/
+void
+cfs_coffee_flush(void)
+{
+  flush_writes();
+}
+/*---------------------------------------------------------------------------*/
+void
+cfs_coffee_get_cache_stats(struct cfs_coffee_cache_stats *stats)
+{
+#if COFFEE_CACHE_PAGES
+  memcpy(stats, &cache_stats, sizeof(*stats));
+#else /* COFFEE_CACHE_PAGES */
+  memset(stats, 0, sizeof(*stats));
+#endif /* COFFEE_CACHE_PAGES */
+}
+/*---------------------------------------------------------------------------*/
 int
 cfs_coffee_format(void)
 {
@@ -1328,8 +1871,13 @@ cfs_coffee_format(void)
 
   PRINTF("Coffee: Formatting %u sectors", (unsigned)COFFEE_SECTOR_COUNT);
 
+#if COFFEE_CACHE_PAGES
+  /* Formatting discards pending data. */
+  write_size = 0;
+#endif /* COFFEE_CACHE_PAGES */
+
   for(i = 0; i < COFFEE_SECTOR_COUNT; i++) {
-    COFFEE_ERASE(i);
+    coffee_erase(i);
     PRINTF(".");
   }
 
@@ -1338,6 +1886,12 @@ cfs_coffee_format(void)
   memset(&coffee_fd_set, 0, sizeof(coffee_fd_set));
   next_free = 0;
   gc_wait = 1;
+#if COFFEE_NAME_INDEX
+  /* The storage is empty, so the index need not be built. */
+  memset(name_index, 0xff, sizeof(name_index));
+  name_index_count = 0;
+  name_index_state = NAME_INDEX_COMPLETE;
+#endif /* COFFEE_NAME_INDEX */
 
   PRINTF(" done!\n");
 
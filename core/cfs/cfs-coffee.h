@@ -140,6 +140,65 @@ int cfs_coffee_set_io_semantics(int fd, unsigned flags);
  */
 int cfs_coffee_format(void);
 
+/**
+ * \brief Get the amount of free and reclaimable storage.
+ * \param free_bytes Set to the number of bytes in free pages, if not NULL.
+ * \param reclaimable_bytes Set to the number of bytes in obsolete pages
+ *        that the garbage collector can erase, if not NULL.
+ *
+ * The counts are found by reading file headers, sector by sector.
+ */
+void cfs_coffee_get_space(unsigned long *free_bytes,
+                          unsigned long *reclaimable_bytes);
+
+/**
+ * \brief Erase one sector of obsolete pages.
+ * \return 1 if a sector was erased, 0 if no sector could be erased.
+ *
+ * Coffee collects garbage when a file cannot be reserved, and then
+ * erases every sector that it can. Calling this function between file
+ * operations spreads the erasures out instead.
+ */
+int cfs_coffee_gc_step(void);
+
+/**
+ * \brief Erase every sector of obsolete pages.
+ *
+ * When Coffee is built with COFFEE_GC_PROCESS, this returns at once
+ * and a process erases one sector each time it runs. That process
+ * also runs by itself when fewer than COFFEE_GC_WATERMARK pages are
+ * free. Otherwise, the sectors are erased before this returns.
+ */
+void cfs_coffee_gc_start(void);
+
+/** \brief Counters of the Coffee page cache. */
+struct cfs_coffee_cache_stats {
+  /** Reads of a page that was in the cache. */
+  unsigned long hits;
+  /** Reads of a page that had to be read from storage. */
+  unsigned long misses;
+  /** Writes to the cache. */
+  unsigned long writes;
+  /** Writes to storage. */
+  unsigned long flushes;
+};
+
+/**
+ * \brief Write pending file data to storage.
+ *
+ * When Coffee is built with a page cache (COFFEE_CACHE_PAGES), a small
+ * write is kept in RAM until a write that does not continue it, or
+ * until cfs_close() or this function is called.
+ */
+void cfs_coffee_flush(void);
+
+/**
+ * \brief Get the counters of the Coffee page cache.
+ * \param stats Set to the counters since boot, or to zero when Coffee
+ *        is built without a page cache.
+ */
+void cfs_coffee_get_cache_stats(struct cfs_coffee_cache_stats *stats);
+
 /** @} */
 /** @} */
 
@@ -42,11 +42,12 @@
 #define BUF ((struct uip_tcpip_hdr *)&uip_buf[UIP_LLH_LEN])
 
 #include "dev/slip.h"
+#include "lib/slip-codec.h"
 
-#define SLIP_END     0300
-#define SLIP_ESC     0333
-#define SLIP_ESC_END 0334
-#define SLIP_ESC_ESC 0335
+#define SLIP_END     SLIP_CODEC_END
+#define SLIP_ESC     SLIP_CODEC_ESC
+#define SLIP_ESC_END SLIP_CODEC_ESC_END
+#define SLIP_ESC_ESC SLIP_CODEC_ESC_ESC
 
 PROCESS(slip_process, "SLIP driver");
 
@@ -99,54 +100,33 @@ slip_set_input_callback(void (*c)(void))
 uint8_t
 slip_send(void)
 {
-  uint16_t i;
-  uint8_t *ptr;
-  uint8_t c;
+  struct slip_codec_iov iov;
 
-  slip_arch_writeb(SLIP_END);
-
-  ptr = &uip_buf[UIP_LLH_LEN];
-  for(i = 0; i < uip_len; ++i) {
-    c = *ptr++;
-    if(c == SLIP_END) {
-      slip_arch_writeb(SLIP_ESC);
-      c = SLIP_ESC_END;
-    } else if(c == SLIP_ESC) {
-      slip_arch_writeb(SLIP_ESC);
-      c = SLIP_ESC_ESC;
-    }
-    slip_arch_writeb(c);
-  }
-  slip_arch_writeb(SLIP_END);
+  iov.data = &uip_buf[UIP_LLH_LEN];
+  iov.len = uip_len;
+  slip_codec_write(slip_arch_writeb, &iov, 1, 0);
 
   return UIP_FW_OK;
 }
 /*---------------------------------------------------------------------------*/
 uint8_t
-slip_write(const void *_ptr, int len)
+slip_write(const void *ptr, int len)
 {
-  const uint8_t *ptr = _ptr;
-  uint16_t i;
-  uint8_t c;
+  struct slip_codec_iov iov;
 
-  slip_arch_writeb(SLIP_END);
-
-  for(i = 0; i < len; ++i) {
-    c = *ptr++;
-    if(c == SLIP_END) {
-      slip_arch_writeb(SLIP_ESC);
-      c = SLIP_ESC_END;
-    } else if(c == SLIP_ESC) {
-      slip_arch_writeb(SLIP_ESC);
-      c = SLIP_ESC_ESC;
-    }
-    slip_arch_writeb(c);
-  }
-  slip_arch_writeb(SLIP_END);
+  iov.data = ptr;
+  iov.len = len;
+  slip_codec_write(slip_arch_writeb, &iov, 1, 0);
 
   return len;
 }
 /*---------------------------------------------------------------------------*/
+void
+slip_writev(const struct slip_codec_iov *iov, uint8_t iovcnt)
+{
+  slip_codec_write(slip_arch_writeb, iov, iovcnt, 0);
+}
+/*---------------------------------------------------------------------------*/
 static void
 rxbuf_init(void)
 {
@@ -209,80 +189,28 @@ slip_poll_handler(uint8_t *outbuf, uint16_t blen)
    * If pkt_end != begin it will not change again.
    */
   if(begin != pkt_end) {
-    uint16_t len;
+    static const uint8_t end = SLIP_END;
+    struct slip_codec_decoder decoder;
+    const uint8_t *ptr;
+    int len;
     uint16_t cur_next_free;
     uint16_t cur_ptr;
-    int esc = 0;
 
+    /* The packet may wrap around the end of rxbuf. The decoder picks
+       up where it left off, and is then given the SLIP_END. */
+    slip_codec_decoder_init(&decoder, outbuf, blen);
+    ptr = &rxbuf[begin];
     if(begin < pkt_end) {
-      uint16_t i;
-      len = 0;
-      for(i = begin; i < pkt_end; ++i) {
-        if(len > blen) {
-          len = 0;
-          break;
-        }
-        if (esc) {
-          if(rxbuf[i] == SLIP_ESC_ESC) {
-            outbuf[len] = SLIP_ESC;
-            len++;
-          } else if(rxbuf[i] == SLIP_ESC_END) {
-            outbuf[len] = SLIP_END;
-            len++;
-          }
-          esc = 0;
-        } else if(rxbuf[i] == SLIP_ESC) {
-          esc = 1;
-        } else {
-          outbuf[len] = rxbuf[i];
-          len++;
-        }
-      }
+      slip_codec_decode(&decoder, &ptr, &rxbuf[pkt_end]);
     } else {
-      uint16_t i;
+      slip_codec_decode(&decoder, &ptr, &rxbuf[RX_BUFSIZE]);
+      ptr = rxbuf;
+      slip_codec_decode(&decoder, &ptr, &rxbuf[pkt_end]);
+    }
+    ptr = &end;
+    len = slip_codec_decode(&decoder, &ptr, &end + 1);
+    if(len < 0) {
       len = 0;
-      for(i = begin; i < RX_BUFSIZE; ++i) {
-        if(len > blen) {
-          len = 0;
-          break;
-        }
-        if (esc) {
-          if(rxbuf[i] == SLIP_ESC_ESC) {
-            outbuf[len] = SLIP_ESC;
-            len++;
-          } else if(rxbuf[i] == SLIP_ESC_END) {
-            outbuf[len] = SLIP_END;
-            len++;
-          }
-          esc = 0;
-        } else if(rxbuf[i] == SLIP_ESC) {
-          esc = 1;
-        } else {
-          outbuf[len] = rxbuf[i];
-          len++;
-        }
-      }
-      for(i = 0; i < pkt_end; ++i) {
-        if(len > blen) {
-          len = 0;
-          break;
-        }
-        if (esc) {
-          if(rxbuf[i] == SLIP_ESC_ESC) {
-            outbuf[len] = SLIP_ESC;
-            len++;
-          } else if(rxbuf[i] == SLIP_ESC_END) {
-            outbuf[len] = SLIP_END;
-            len++;
-          }
-          esc = 0;
-        } else if(rxbuf[i] == SLIP_ESC) {
-          esc = 1;
-        } else {
-          outbuf[len] = rxbuf[i];
-          len++;
-        }
-      }
     }
 
     /* Remove data from buffer together with the copied packet. */
@@ -35,6 +35,7 @@
 #define SLIP_H_
 
 #include "contiki.h"
+#include "lib/slip-codec.h"
 
 PROCESS_NAME(slip_process);
 
@@ -64,6 +65,12 @@ int slip_input_byte(unsigned char c);
 
 uint8_t slip_write(const void *ptr, int len);
 
+/**
+ * Send a frame made of several pieces with SLIP, such as a header and
+ * a packet, without copying them together first.
+ */
+void slip_writev(const struct slip_codec_iov *iov, uint8_t iovcnt);
+
 /* Did we receive any bytes lately? */
 extern uint8_t slip_active;
 
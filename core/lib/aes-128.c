@@ -64,7 +64,17 @@ static const uint8_t sbox[256] =   {
 0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
 0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16 };
 
+#if AES_128_KEY_CACHE
+static struct {
+  uint8_t key[AES_128_KEY_LENGTH];
+  uint8_t round_keys[11][AES_128_KEY_LENGTH];
+} key_cache[AES_128_KEY_CACHE];
+static uint8_t key_cache_len;
+static uint8_t key_cache_next;
+static uint8_t (*round_keys)[AES_128_KEY_LENGTH] = key_cache[0].round_keys;
+#else /* AES_128_KEY_CACHE */
 static uint8_t round_keys[11][AES_128_KEY_LENGTH];
+#endif /* AES_128_KEY_CACHE */
 
 /*---------------------------------------------------------------------------*/
 /* multiplies by 2 in GF(2) */
@@ -76,7 +86,7 @@ galois_mul2(uint8_t value)
 }
 /*---------------------------------------------------------------------------*/
 static void
-set_key(const uint8_t *key)
+expand_key(uint8_t round_keys[][AES_128_KEY_LENGTH], const uint8_t *key)
 {
   uint8_t i;
   uint8_t j;
@@ -97,6 +107,33 @@ set_key(const uint8_t *key)
 }
 /*---------------------------------------------------------------------------*/
 static void
+set_key(const uint8_t *key)
+{
+#if AES_128_KEY_CACHE
+  uint8_t i;
+
+  for(i = 0; i < key_cache_len; i++) {
+    if(memcmp(key_cache[i].key, key, AES_128_KEY_LENGTH) == 0) {
+      round_keys = key_cache[i].round_keys;
+      return;
+    }
+  }
+
+  /* Miss: fill a free slot, or evict round-robin */
+  i = key_cache_next;
+  key_cache_next = (key_cache_next + 1) % AES_128_KEY_CACHE;
+  if(key_cache_len < AES_128_KEY_CACHE) {
+    key_cache_len++;
+  }
+  memcpy(key_cache[i].key, key, AES_128_KEY_LENGTH);
+  expand_key(key_cache[i].round_keys, key);
+  round_keys = key_cache[i].round_keys;
+#else /* AES_128_KEY_CACHE */
+  expand_key(round_keys, key);
+#endif /* AES_128_KEY_CACHE */
+}
+/*---------------------------------------------------------------------------*/
+static void
 encrypt(uint8_t *state)
 {
   uint8_t buf1, buf2, buf3, buf4, round, i;
@@ -51,6 +51,15 @@
 #define AES_128            aes_128_driver
 #endif /* AES_128_CONF */
 
+/* Number of expanded keys that software drivers keep around, so that
+   switching between a few link keys does not rerun the key schedule.
+   0 expands the key on every set_key(). */
+#ifdef AES_128_CONF_KEY_CACHE
+#define AES_128_KEY_CACHE  AES_128_CONF_KEY_CACHE
+#else /* AES_128_CONF_KEY_CACHE */
+#define AES_128_KEY_CACHE  1
+#endif /* AES_128_CONF_KEY_CACHE */
+
 /**
  * Structure of AES drivers.
  */
@@ -74,4 +83,7 @@ void aes_128_set_padded_key(uint8_t *key, uint8_t key_len);
 
 extern const struct aes_128_driver AES_128;
 
+/* The software implementation, also used as a fallback by other drivers */
+extern const struct aes_128_driver aes_128_driver;
+
 #endif /* AES_128_H_ */
@@ -79,4 +79,7 @@ struct ccm_star_driver {
 
 extern const struct ccm_star_driver CCM_STAR;
 
+/* The AES_128-based implementation */
+extern const struct ccm_star_driver ccm_star_driver;
+
 #endif /* CCM_STAR_H_ */
@@ -51,8 +51,29 @@
 void
 memb_init(struct memb *m)
 {
+#if MEMB_WITH_FREELIST
+  unsigned short i;
+#endif /* MEMB_WITH_FREELIST */
+
   memset(m->count, 0, m->num);
   memset(m->mem, 0, m->size * m->num);
+
+#if MEMB_WITH_FREELIST
+  if(m->flags & MEMB_FLAG_FREELIST) {
+    /* Chain all blocks in order, the last one pointing past the end. */
+    for(i = 0; i < m->num; ++i) {
+      m->next[i] = i + 1;
+    }
+    m->free = 0;
+    m->numfree = m->num;
+    m->flags |= MEMB_FLAG_READY;
+  }
+#endif /* MEMB_WITH_FREELIST */
+
+#if MEMB_STATS
+  m->used = 0;
+  m->high_water = 0;
+#endif /* MEMB_STATS */
 }
 /*---------------------------------------------------------------------------*/
 void *
@@ -60,12 +81,39 @@ memb_alloc(struct memb *m)
 {
   int i;
 
+#if MEMB_WITH_FREELIST
+  if(m->flags & MEMB_FLAG_FREELIST) {
+    if(!(m->flags & MEMB_FLAG_READY)) {
+      /* Not initialized yet: all blocks are still free. */
+      memb_init(m);
+    }
+    if(m->free >= m->num) {
+      return NULL;
+    }
+    i = m->free;
+    m->free = m->next[i];
+    --m->numfree;
+    ++(m->count[i]);
+#if MEMB_STATS
+    if(++m->used > m->high_water) {
+      m->high_water = m->used;
+    }
+#endif /* MEMB_STATS */
+    return (void *)((char *)m->mem + (i * m->size));
+  }
+#endif /* MEMB_WITH_FREELIST */
+
   for(i = 0; i < m->num; ++i) {
     if(m->count[i] == 0) {
       /* If this block was unused, we increase the reference count to
 	 indicate that it now is used and return a pointer to the
 	 memory block. */
       ++(m->count[i]);
+#if MEMB_STATS
+      if(++m->used > m->high_water) {
+        m->high_water = m->used;
+      }
+#endif /* MEMB_STATS */
       return (void *)((char *)m->mem + (i * m->size));
     }
   }
@@ -81,6 +129,30 @@ memb_free(struct memb *m, void *ptr)
   int i;
   char *ptr2;
 
+#if MEMB_WITH_FREELIST
+  if(m->flags & MEMB_FLAG_FREELIST) {
+    ptr2 = (char *)ptr;
+    if(!memb_inmemb(m, ptr) ||
+       (ptr2 - (char *)m->mem) % m->size != 0) {
+      return -1;
+    }
+    i = (ptr2 - (char *)m->mem) / m->size;
+    if(m->count[i] > 0) {
+      /* Make sure that we don't deallocate free memory, which would
+         put the block on the free list twice. */
+      if(--(m->count[i]) == 0) {
+        m->next[i] = m->free;
+        m->free = i;
+        ++m->numfree;
+#if MEMB_STATS
+        --m->used;
+#endif /* MEMB_STATS */
+      }
+    }
+    return m->count[i];
+  }
+#endif /* MEMB_WITH_FREELIST */
+
   /* Walk through the list of blocks and try to find the block to
      which the pointer "ptr" points to. */
   ptr2 = (char *)m->mem;
@@ -92,6 +164,11 @@ memb_free(struct memb *m, void *ptr)
       if(m->count[i] > 0) {
 	/* Make sure that we don't deallocate free memory. */
 	--(m->count[i]);
+#if MEMB_STATS
+        if(m->count[i] == 0) {
+          --m->used;
+        }
+#endif /* MEMB_STATS */
       }
       return m->count[i];
     }
@@ -113,6 +190,12 @@ memb_numfree(struct memb *m)
   int i;
   int num_free = 0;
 
+#if MEMB_WITH_FREELIST
+  if(m->flags & MEMB_FLAG_READY) {
+    return m->numfree;
+  }
+#endif /* MEMB_WITH_FREELIST */
+
   for(i = 0; i < m->num; ++i) {
     if(m->count[i] == 0) {
       ++num_free;
@@ -121,4 +204,12 @@ memb_numfree(struct memb *m)
 
   return num_free;
 }
+/*---------------------------------------------------------------------------*/
+#if MEMB_STATS
+int
+memb_high_water(struct memb *m)
+{
+  return m->high_water;
+}
+#endif /* MEMB_STATS */
 /** @} */
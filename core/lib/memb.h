@@ -65,6 +65,34 @@
 
 #include "sys/cc.h"
 
+/**
+ * \brief Compile in support for free-list memory blocks
+ *
+ * When set, memory blocks declared with MEMB_FREELIST() keep their
+ * free blocks in a list, so that memb_alloc(), memb_free() and
+ * memb_numfree() run in constant time instead of scanning the
+ * block. This adds a few bytes of RAM to every struct memb, and an
+ * unsigned short per block to every MEMB_FREELIST() block. When not
+ * set, MEMB_FREELIST() declares an ordinary memory block.
+ */
+#ifdef MEMB_CONF_WITH_FREELIST
+#define MEMB_WITH_FREELIST MEMB_CONF_WITH_FREELIST
+#else
+#define MEMB_WITH_FREELIST 0
+#endif
+
+/**
+ * \brief Keep track of the number of blocks in use
+ *
+ * When set, every memory block counts its allocated blocks and the
+ * largest number allocated at once, see memb_high_water().
+ */
+#ifdef MEMB_CONF_STATS
+#define MEMB_STATS MEMB_CONF_STATS
+#else
+#define MEMB_STATS 0
+#endif
+
 /**
  * Declare a memory block.
  *
@@ -93,11 +121,47 @@ MEMB(connections, struct connection, 16);
                                           CC_CONCAT(name,_memb_count), \
                                           (void *)CC_CONCAT(name,_memb_mem)}
 
+#if MEMB_WITH_FREELIST
+/**
+ * Declare a memory block with constant-time allocation.
+ *
+ * Used like MEMB(). The free blocks are linked through an array of
+ * their own, so memb_alloc() and memb_free() do not touch the
+ * contents of a block, as with MEMB(). A freed block can still be
+ * read, for example to follow its next pointer in a list that is
+ * being walked.
+ */
+#define MEMB_FREELIST(name, structure, num) \
+        static char CC_CONCAT(name,_memb_count)[num]; \
+        static structure CC_CONCAT(name,_memb_mem)[num]; \
+        static unsigned short CC_CONCAT(name,_memb_next)[num]; \
+        static struct memb name = {sizeof(structure), num, \
+                                          CC_CONCAT(name,_memb_count), \
+                                          (void *)CC_CONCAT(name,_memb_mem), \
+                                          CC_CONCAT(name,_memb_next), \
+                                          MEMB_FLAG_FREELIST}
+#else /* MEMB_WITH_FREELIST */
+#define MEMB_FREELIST(name, structure, num) MEMB(name, structure, num)
+#endif /* MEMB_WITH_FREELIST */
+
+#define MEMB_FLAG_FREELIST 1
+#define MEMB_FLAG_READY    2
+
 struct memb {
   unsigned short size;
   unsigned short num;
   char *count;
   void *mem;
+#if MEMB_WITH_FREELIST
+  unsigned short *next;
+  unsigned char flags;
+  unsigned short free;
+  unsigned short numfree;
+#endif /* MEMB_WITH_FREELIST */
+#if MEMB_STATS
+  unsigned short used;
+  unsigned short high_water;
+#endif /* MEMB_STATS */
 };
 
 /**
@@ -132,6 +196,16 @@ int memb_inmemb(struct memb *m, void *ptr);
 
 int  memb_numfree(struct memb *m);
 
+#if MEMB_STATS
+/**
+ * Get the largest number of blocks that have been allocated at
+ * once since the memory block was initialized.
+ *
+ * \param m A memory block previously declared with MEMB().
+ */
+int  memb_high_water(struct memb *m);
+#endif /* MEMB_STATS */
+
 /** @} */
 /** @} */
 
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         SLIP codec implementation
+ */
+
+#include "lib/slip-codec.h"
+#include <string.h>
+
+#define STATE_ESC  0x01
+#define STATE_DROP 0x02
+
+#define NEEDS_ESCAPE(c, flags)                                  \
+  ((c) == SLIP_CODEC_END || (c) == SLIP_CODEC_ESC ||            \
+   (((flags) & SLIP_CODEC_XONXOFF) &&                           \
+    ((c) == SLIP_CODEC_XON || (c) == SLIP_CODEC_XOFF)))
+/*---------------------------------------------------------------------------*/
+uint16_t
+slip_codec_encode(uint8_t *out, const uint8_t *data, uint16_t len,
+                  uint8_t flags)
+{
+  const uint8_t *p, *end, *run;
+  uint8_t *o;
+
+  o = out;
+  p = data;
+  end = data + len;
+  while(p < end) {
+    /* Copy the run of bytes up to the next one to escape */
+    run = p;
+    while(p < end && !NEEDS_ESCAPE(*p, flags)) {
+      p++;
+    }
+    if(p > run) {
+      memcpy(o, run, p - run);
+      o += p - run;
+    }
+    if(p == end) {
+      break;
+    }
+
+    *o++ = SLIP_CODEC_ESC;
+    switch(*p++) {
+    case SLIP_CODEC_END:
+      *o++ = SLIP_CODEC_ESC_END;
+      break;
+    case SLIP_CODEC_ESC:
+      *o++ = SLIP_CODEC_ESC_ESC;
+      break;
+    case SLIP_CODEC_XON:
+      *o++ = SLIP_CODEC_ESC_XON;
+      break;
+    default:
+      *o++ = SLIP_CODEC_ESC_XOFF;
+      break;
+    }
+  }
+  return o - out;
+}
+/*---------------------------------------------------------------------------*/
+void
+slip_codec_decoder_init(struct slip_codec_decoder *d,
+                        uint8_t *buf, uint16_t size)
+{
+  d->buf = buf;
+  d->size = size;
+  d->len = 0;
+  d->state = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+append(struct slip_codec_decoder *d, const uint8_t *data, uint16_t len)
+{
+  if(len > d->size - d->len) {
+    /* Drop the rest of the frame, but keep counting its length */
+    d->state |= STATE_DROP;
+  } else if(!(d->state & STATE_DROP)) {
+    memcpy(d->buf + d->len, data, len);
+  }
+  d->len += len;
+}
+/*---------------------------------------------------------------------------*/
+int
+slip_codec_decode(struct slip_codec_decoder *d,
+                  const uint8_t **input, const uint8_t *end)
+{
+  const uint8_t *p, *run;
+  uint8_t c;
+  uint16_t len;
+
+  p = *input;
+  while(p < end) {
+    if(d->state & STATE_ESC) {
+      d->state &= ~STATE_ESC;
+      c = *p++;
+      switch(c) {
+      case SLIP_CODEC_ESC_END:
+        c = SLIP_CODEC_END;
+        break;
+      case SLIP_CODEC_ESC_ESC:
+        c = SLIP_CODEC_ESC;
+        break;
+      case SLIP_CODEC_ESC_XON:
+        c = SLIP_CODEC_XON;
+        break;
+      case SLIP_CODEC_ESC_XOFF:
+        c = SLIP_CODEC_XOFF;
+        break;
+      }
+      /* Any other escaped byte stands for itself */
+      append(d, &c, 1);
+      continue;
+    }
+
+    run = p;
+    while(p < end && *p != SLIP_CODEC_END && *p != SLIP_CODEC_ESC) {
+      p++;
+    }
+    if(p > run) {
+      append(d, run, p - run);
+    }
+    if(p == end) {
+      break;
+    }
+
+    if(*p++ == SLIP_CODEC_ESC) {
+      d->state |= STATE_ESC;
+      continue;
+    }
+
+    /* SLIP_CODEC_END */
+    len = d->len;
+    d->len = 0;
+    if(d->state & STATE_DROP) {
+      d->state = 0;
+      *input = p;
+      return SLIP_CODEC_TOO_LONG;
+    }
+    if(len > 0) {
+      *input = p;
+      return len;
+    }
+  }
+  *input = p;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+slip_codec_queue_init(struct slip_codec_queue *q, uint8_t *buf, uint16_t size)
+{
+  q->buf = buf;
+  q->size = size;
+  q->begin = q->end = 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+slip_codec_queue_putv(struct slip_codec_queue *q,
+                      const struct slip_codec_iov *iov, uint8_t iovcnt,
+                      uint8_t flags)
+{
+  uint16_t len;
+  uint8_t i;
+
+  len = 0;
+  for(i = 0; i < iovcnt; i++) {
+    len += iov[i].len;
+  }
+  if(!slip_codec_queue_has_room(q, len)) {
+    return 0;
+  }
+  if(q->size - q->end < SLIP_CODEC_ENCODED_MAX(len) + 1) {
+    /* Move what has not been sent yet to the start of the buffer */
+    memmove(q->buf, q->buf + q->begin, q->end - q->begin);
+    q->end -= q->begin;
+    q->begin = 0;
+  }
+  for(i = 0; i < iovcnt; i++) {
+    q->end += slip_codec_encode(q->buf + q->end, iov[i].data, iov[i].len,
+                                flags);
+  }
+  q->buf[q->end++] = SLIP_CODEC_END;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+slip_codec_queue_put(struct slip_codec_queue *q,
+                     const uint8_t *data, uint16_t len, uint8_t flags)
+{
+  struct slip_codec_iov iov;
+
+  iov.data = data;
+  iov.len = len;
+  return slip_codec_queue_putv(q, &iov, 1, flags);
+}
+/*---------------------------------------------------------------------------*/
+void
+slip_codec_queue_remove(struct slip_codec_queue *q, uint16_t len)
+{
+  q->begin += len;
+  if(q->begin >= q->end) {
+    q->begin = q->end = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+slip_codec_write(void (*writeb)(unsigned char c),
+                 const struct slip_codec_iov *iov, uint8_t iovcnt,
+                 uint8_t flags)
+{
+  const uint8_t *p, *end;
+  uint8_t i;
+
+  writeb(SLIP_CODEC_END);
+  for(i = 0; i < iovcnt; i++) {
+    p = iov[i].data;
+    end = p + iov[i].len;
+    for(; p < end; p++) {
+      if(!NEEDS_ESCAPE(*p, flags)) {
+        writeb(*p);
+        continue;
+      }
+      writeb(SLIP_CODEC_ESC);
+      switch(*p) {
+      case SLIP_CODEC_END:
+        writeb(SLIP_CODEC_ESC_END);
+        break;
+      case SLIP_CODEC_ESC:
+        writeb(SLIP_CODEC_ESC_ESC);
+        break;
+      case SLIP_CODEC_XON:
+        writeb(SLIP_CODEC_ESC_XON);
+        break;
+      default:
+        writeb(SLIP_CODEC_ESC_XOFF);
+        break;
+      }
+    }
+  }
+  writeb(SLIP_CODEC_END);
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Header file for the SLIP codec
+ */
+
+/** \addtogroup lib
+ * @{ */
+
+/**
+ * \defgroup slip-codec SLIP encoding and decoding
+ *
+ * The SLIP codec frames data as in RFC 1055, a block at a time rather
+ * than a byte at a time. Runs of bytes that need no escaping are
+ * copied with memcpy(). The decoder is fed whatever a read() returned
+ * and picks up where it left off, also in the middle of an escape
+ * sequence. The output queue holds any number of encoded frames, so
+ * that a writer can keep a serial line busy.
+ *
+ * A frame can be given in pieces, such as a command header and a
+ * packet, which are encoded one after the other without first being
+ * copied together. Serial drivers that take a byte at a time write
+ * frames with slip_codec_write().
+ *
+ * The codec uses no Contiki services, and the host tools build it as
+ * it is.
+ *
+ * @{
+ */
+
+#ifndef SLIP_CODEC_H_
+#define SLIP_CODEC_H_
+
+#include <stdint.h>
+
+#define SLIP_CODEC_END      0300
+#define SLIP_CODEC_ESC      0333
+#define SLIP_CODEC_ESC_END  0334
+#define SLIP_CODEC_ESC_ESC  0335
+#define SLIP_CODEC_ESC_XON  0336
+#define SLIP_CODEC_ESC_XOFF 0337
+#define SLIP_CODEC_XON      17
+#define SLIP_CODEC_XOFF     19
+
+/** Flag to also escape the XON and XOFF characters. */
+#define SLIP_CODEC_XONXOFF  0x01
+
+/** The largest number of bytes that len bytes of data encode into. */
+#define SLIP_CODEC_ENCODED_MAX(len) (2 * (len))
+
+/** Returned by slip_codec_decode() for a frame that did not fit. */
+#define SLIP_CODEC_TOO_LONG -1
+
+/** A piece of a frame, for the scatter-gather functions. */
+struct slip_codec_iov {
+  const void *data;
+  uint16_t len;
+};
+
+struct slip_codec_decoder {
+  uint8_t *buf;
+  uint16_t size;
+  uint16_t len;
+  uint8_t state;
+};
+
+struct slip_codec_queue {
+  uint8_t *buf;
+  uint16_t size;
+  uint16_t begin;
+  uint16_t end;
+};
+
+/**
+ * \brief      Escape a block of data.
+ * \param out  The output buffer, of at least SLIP_CODEC_ENCODED_MAX(len) bytes
+ * \param data The data
+ * \param len  The length of the data
+ * \param flags SLIP_CODEC_XONXOFF, or zero
+ * \return     The number of bytes written to out
+ *
+ *             The encoded data is not followed by SLIP_CODEC_END.
+ */
+uint16_t slip_codec_encode(uint8_t *out, const uint8_t *data, uint16_t len,
+                           uint8_t flags);
+
+/**
+ * \brief      Initialize a decoder.
+ * \param d    The decoder
+ * \param buf  The buffer that frames are decoded into
+ * \param size The size of the buffer
+ */
+void slip_codec_decoder_init(struct slip_codec_decoder *d,
+                             uint8_t *buf, uint16_t size);
+
+/**
+ * \brief      Decode input up to the end of the next frame.
+ * \param d    The decoder
+ * \param input Pointer to the input, which is advanced past the decoded bytes
+ * \param end  The end of the input
+ * \return     The length of the frame, zero if the input ran out first,
+ *             or SLIP_CODEC_TOO_LONG
+ *
+ *             A frame that is returned lies at the start of the
+ *             buffer of the decoder, until the next call. Empty
+ *             frames are skipped. The bytes of a frame that has not
+ *             ended yet are d->buf[0] to d->buf[d->len - 1].
+ */
+int slip_codec_decode(struct slip_codec_decoder *d,
+                      const uint8_t **input, const uint8_t *end);
+
+/**
+ * \brief      Initialize an output queue.
+ * \param q    The queue
+ * \param buf  The buffer that holds the encoded frames
+ * \param size The size of the buffer
+ */
+void slip_codec_queue_init(struct slip_codec_queue *q,
+                           uint8_t *buf, uint16_t size);
+
+/**
+ * \brief      Encode a frame at the end of an output queue.
+ * \param q    The queue
+ * \param data The frame
+ * \param len  The length of the frame, which may be zero
+ * \param flags SLIP_CODEC_XONXOFF, or zero
+ * \return     Non-zero if the frame was queued, zero if there was no room
+ *
+ *             The frame is followed by SLIP_CODEC_END. Queueing an
+ *             empty frame sends SLIP_CODEC_END alone.
+ */
+int slip_codec_queue_put(struct slip_codec_queue *q,
+                         const uint8_t *data, uint16_t len, uint8_t flags);
+
+/**
+ * \brief      Encode a frame made of several pieces at the end of an output queue.
+ * \param q    The queue
+ * \param iov  The pieces of the frame
+ * \param iovcnt The number of pieces
+ * \param flags SLIP_CODEC_XONXOFF, or zero
+ * \return     Non-zero if the frame was queued, zero if there was no room
+ */
+int slip_codec_queue_putv(struct slip_codec_queue *q,
+                          const struct slip_codec_iov *iov, uint8_t iovcnt,
+                          uint8_t flags);
+
+/**
+ * \brief      Remove bytes from the start of an output queue.
+ * \param q    The queue
+ * \param len  The number of bytes, for example as written to a serial line
+ */
+void slip_codec_queue_remove(struct slip_codec_queue *q, uint16_t len);
+
+/**
+ * \brief      Write a frame made of several pieces a byte at a time.
+ * \param writeb The function that writes a byte, such as slip_arch_writeb()
+ * \param iov  The pieces of the frame
+ * \param iovcnt The number of pieces
+ * \param flags SLIP_CODEC_XONXOFF, or zero
+ *
+ *             The frame is preceded and followed by SLIP_CODEC_END,
+ *             as the Contiki SLIP drivers send it.
+ */
+void slip_codec_write(void (*writeb)(unsigned char c),
+                      const struct slip_codec_iov *iov, uint8_t iovcnt,
+                      uint8_t flags);
+
+/** The bytes at the start of an output queue. */
+#define slip_codec_queue_data(q) ((q)->buf + (q)->begin)
+
+/** The number of bytes in an output queue. */
+#define slip_codec_queue_len(q) ((uint16_t)((q)->end - (q)->begin))
+
+/** Whether a frame of len bytes certainly fits in an output queue. */
+#define slip_codec_queue_has_room(q, len) \
+  ((q)->size - slip_codec_queue_len(q) >= SLIP_CODEC_ENCODED_MAX(len) + 1)
+
+#endif /* SLIP_CODEC_H_ */
+
+/** @} */
+/** @} */
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Internet checksum, portable implementation
+ */
+
+#include "net/ip/ip-chksum.h"
+
+/*---------------------------------------------------------------------------*/
+#if !IP_CHKSUM_ARCH
+uint16_t
+ip_chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint32_t acc;
+  const uint8_t *last_word;
+
+  /* Accumulate into 32 bits and fold the carries once at the end. A
+     uint16_t length cannot overflow the accumulator. */
+  acc = sum;
+  last_word = data + (len & ~1);
+  while(data + 8 <= last_word) {
+    acc += ((uint16_t)data[0] << 8) + data[1];
+    acc += ((uint16_t)data[2] << 8) + data[3];
+    acc += ((uint16_t)data[4] << 8) + data[5];
+    acc += ((uint16_t)data[6] << 8) + data[7];
+    data += 8;
+  }
+  while(data < last_word) {
+    acc += ((uint16_t)data[0] << 8) + data[1];
+    data += 2;
+  }
+  if(len & 1) {
+    acc += (uint16_t)data[0] << 8;
+  }
+
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc += acc >> 16;
+
+  /* Return sum in host byte order. */
+  return (uint16_t)acc;
+}
+#endif /* !IP_CHKSUM_ARCH */
+/*---------------------------------------------------------------------------*/
+uint16_t
+ip_chksum_add(uint16_t a, uint16_t b)
+{
+  uint32_t acc;
+
+  acc = (uint32_t)a + b;
+  return (uint16_t)((acc >> 16) + (acc & 0xffff));
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+ip_chksum_adjust(uint16_t chksum, uint16_t old_sum, uint16_t new_sum)
+{
+  /* HC' = ~(~HC + ~m + m') */
+  return (uint16_t)~ip_chksum_add(ip_chksum_add(~chksum, ~old_sum), new_sum);
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Internet checksum (RFC 1071) with incremental updates (RFC 1624).
+ *
+ *         All sums are one's complement sums in host byte order, as
+ *         used by uIP: a checksum field holds the complement of the sum,
+ *         converted with uip_htons().
+ */
+
+#ifndef IP_CHKSUM_H_
+#define IP_CHKSUM_H_
+
+#include "contiki.h"
+
+/* Set by CPUs that provide their own ip_chksum() */
+#ifdef IP_CHKSUM_CONF_ARCH
+#define IP_CHKSUM_ARCH IP_CHKSUM_CONF_ARCH
+#else /* IP_CHKSUM_CONF_ARCH */
+#define IP_CHKSUM_ARCH 0
+#endif /* IP_CHKSUM_CONF_ARCH */
+
+/**
+ * \brief Adds the 16-bit big-endian words of a buffer to a sum.
+ * \param sum  The sum so far, 0 to start a new sum
+ * \param data The buffer; need not be aligned
+ * \param len  Length in bytes; an odd last byte is padded with zero
+ * \return     The one's complement sum, 0 only if all words are 0
+ */
+uint16_t ip_chksum(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/**
+ * \brief One's complement addition of two sums.
+ */
+uint16_t ip_chksum_add(uint16_t a, uint16_t b);
+
+/**
+ * \brief Updates a checksum after part of the data it covers changed.
+ * \param chksum  The old checksum field, in host byte order
+ * \param old_sum ip_chksum() of the data that was removed or replaced
+ * \param new_sum ip_chksum() of the data that took its place
+ * \return        The new checksum field, in host byte order
+ *
+ * This is equation 3 of RFC 1624. UDP callers must still replace a
+ * 0x0000 result with 0xffff.
+ */
+uint16_t ip_chksum_adjust(uint16_t chksum, uint16_t old_sum, uint16_t new_sum);
+
+#endif /* IP_CHKSUM_H_ */
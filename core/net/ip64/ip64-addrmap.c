@@ -32,7 +32,6 @@
 #include "ip64-addrmap.h"
 
 #include "lib/memb.h"
-#include "lib/list.h"
 
 #include "ip64-conf.h"
 
@@ -46,45 +45,238 @@
 #define NUM_ENTRIES 32
 #endif /* IP64_ADDRMAP_CONF_ENTRIES */
 
-MEMB(entrymemb, struct ip64_addrmap_entry, NUM_ENTRIES);
-LIST(entrylist);
+/* Number of buckets in each of the two hash indexes; a power of two */
+#ifdef IP64_ADDRMAP_CONF_HASH_SIZE
+#define HASH_SIZE IP64_ADDRMAP_CONF_HASH_SIZE
+#else /* IP64_ADDRMAP_CONF_HASH_SIZE */
+#define HASH_SIZE 32
+#endif /* IP64_ADDRMAP_CONF_HASH_SIZE */
+
+#if HASH_SIZE & (HASH_SIZE - 1)
+#error IP64_ADDRMAP_CONF_HASH_SIZE must be a power of two
+#endif
+
+/* Number of distinct lifetimes that get an aging queue of their own.
+   ip64.c uses three, plus the zero lifetime of a new mapping. */
+#ifdef IP64_ADDRMAP_CONF_LIFETIMES
+#define NUM_LIFETIMES IP64_ADDRMAP_CONF_LIFETIMES
+#else /* IP64_ADDRMAP_CONF_LIFETIMES */
+#define NUM_LIFETIMES 4
+#endif /* IP64_ADDRMAP_CONF_LIFETIMES */
 
 #define FIRST_MAPPED_PORT 10000
 #define LAST_MAPPED_PORT  20000
 static uint16_t mapped_port = FIRST_MAPPED_PORT;
 
+#if NUM_ENTRIES >= LAST_MAPPED_PORT - FIRST_MAPPED_PORT
+#error IP64_ADDRMAP_CONF_ENTRIES exceeds the mapped port range
+#endif
+
+MEMB_FREELIST(entrymemb, struct ip64_addrmap_entry, NUM_ENTRIES);
+
+static struct ip64_addrmap_entry *tuple_hash[HASH_SIZE];
+static struct ip64_addrmap_entry *port_hash[HASH_SIZE];
+
+/* Mappings with the same lifetime expire in the order their lifetime
+   was set, so each lifetime, recyclable or not, has a queue with the
+   next mapping to expire at its head. The queues are consecutive
+   segments of the list of all mappings. */
+#define NUM_QUEUES (2 * NUM_LIFETIMES)
+#define QUEUE(lifetime_index, flags) \
+  (2 * (lifetime_index) + ((flags) & FLAGS_RECYCLABLE))
+
+static struct {
+  struct ip64_addrmap_entry *head, *tail;
+} queues[NUM_QUEUES];
+static clock_time_t lifetimes[NUM_LIFETIMES];
+static uint8_t num_lifetimes;
+static struct ip64_addrmap_entry *entries;
+
 #define printf(...)
 
 /*---------------------------------------------------------------------------*/
 struct ip64_addrmap_entry *
 ip64_addrmap_list(void)
 {
-  return list_head(entrylist);
+  return entries;
 }
 /*---------------------------------------------------------------------------*/
 void
 ip64_addrmap_init(void)
 {
   memb_init(&entrymemb);
-  list_init(entrylist);
+  memset(tuple_hash, 0, sizeof(tuple_hash));
+  memset(port_hash, 0, sizeof(port_hash));
+  memset(queues, 0, sizeof(queues));
+  num_lifetimes = 0;
+  entries = NULL;
   mapped_port = FIRST_MAPPED_PORT;
 }
 /*---------------------------------------------------------------------------*/
+static unsigned
+hash_tuple(const uip_ip6addr_t *ip6addr, uint16_t ip6port,
+           const uip_ip4addr_t *ip4addr, uint16_t ip4port,
+           uint8_t protocol)
+{
+  uint32_t h;
+  int i;
+
+  h = protocol;
+  h = h * 31 + ip6port;
+  h = h * 31 + ip4port;
+  for(i = 0; i < 8; i++) {
+    h = h * 31 + ip6addr->u16[i];
+  }
+  h = h * 31 + ip4addr->u16[0];
+  h = h * 31 + ip4addr->u16[1];
+  h ^= h >> 16;
+  return h & (HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+hash_port(uint16_t port)
+{
+  return port & (HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+remaining(struct ip64_addrmap_entry *m)
+{
+  return timer_expired(&m->timer) ? 0 : timer_remaining(&m->timer);
+}
+/*---------------------------------------------------------------------------*/
+/* Links m into the list of all mappings after p, or first if p is NULL */
+static void
+link_after(struct ip64_addrmap_entry *p, struct ip64_addrmap_entry *m)
+{
+  m->prev = p;
+  if(p == NULL) {
+    m->next = entries;
+    entries = m;
+  } else {
+    m->next = p->next;
+    p->next = m;
+  }
+  if(m->next != NULL) {
+    m->next->prev = m;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+dequeue(struct ip64_addrmap_entry *m)
+{
+  uint8_t q = m->queue;
+
+  if(queues[q].head == m && queues[q].tail == m) {
+    queues[q].head = queues[q].tail = NULL;
+  } else if(queues[q].head == m) {
+    queues[q].head = m->next;
+  } else if(queues[q].tail == m) {
+    queues[q].tail = m->prev;
+  }
+
+  if(m->prev != NULL) {
+    m->prev->next = m->next;
+  } else {
+    entries = m->next;
+  }
+  if(m->next != NULL) {
+    m->next->prev = m->prev;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+lifetime_index(clock_time_t lifetime)
+{
+  uint8_t i;
+
+  for(i = 0; i < num_lifetimes; i++) {
+    if(lifetimes[i] == lifetime) {
+      return i;
+    }
+  }
+  if(num_lifetimes < NUM_LIFETIMES) {
+    lifetimes[num_lifetimes] = lifetime;
+    return num_lifetimes++;
+  }
+  /* Further lifetimes share the last queue, which enqueue() keeps
+     sorted at a higher cost. */
+  return NUM_LIFETIMES - 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+enqueue(struct ip64_addrmap_entry *m)
+{
+  uint8_t q;
+  int i;
+  clock_time_t left;
+  struct ip64_addrmap_entry *p;
+
+  q = QUEUE(lifetime_index(m->timer.interval), m->flags);
+  m->queue = q;
+  left = remaining(m);
+
+  /* Usually m expires last and goes to the tail straight away */
+  p = queues[q].tail;
+  while(p != NULL && remaining(p) > left) {
+    p = p == queues[q].head ? NULL : p->prev;
+  }
+
+  if(p != NULL) {
+    link_after(p, m);
+    if(queues[q].tail == p) {
+      queues[q].tail = m;
+    }
+    return;
+  }
+
+  /* m goes first in its queue, right after the preceding queues */
+  if(queues[q].head != NULL) {
+    p = queues[q].head->prev;
+  } else {
+    for(i = q - 1; i >= 0 && queues[i].tail == NULL; i--);
+    p = i >= 0 ? queues[i].tail : NULL;
+  }
+  link_after(p, m);
+  queues[q].head = m;
+  if(queues[q].tail == NULL) {
+    queues[q].tail = m;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_entry(struct ip64_addrmap_entry *m)
+{
+  struct ip64_addrmap_entry **pp;
+
+  dequeue(m);
+
+  pp = &tuple_hash[hash_tuple(&m->ip6addr, m->ip6port,
+                              &m->ip4addr, m->ip4port, m->protocol)];
+  while(*pp != m) {
+    pp = &(*pp)->tuple_next;
+  }
+  *pp = m->tuple_next;
+
+  pp = &port_hash[hash_port(m->mapped_port)];
+  while(*pp != m) {
+    pp = &(*pp)->port_next;
+  }
+  *pp = m->port_next;
+
+  memb_free(&entrymemb, m);
+}
+/*---------------------------------------------------------------------------*/
 static void
 check_age(void)
 {
-  struct ip64_addrmap_entry *m;
+  uint8_t q;
 
-  /* Walk through the list of address mappings, throw away the ones
-     that are too old. */
-  m = list_head(entrylist);
-  while(m != NULL) {
-    if(timer_expired(&m->timer)) {
-      list_remove(entrylist, m);
-      memb_free(&entrymemb, m);
-      m = list_head(entrylist);
-    } else {
-      m = list_item_next(m);
+  /* Throw away the mappings that are too old, which are at the heads
+     of the queues. */
+  for(q = 0; q < NUM_QUEUES; q++) {
+    while(queues[q].head != NULL && timer_expired(&queues[q].head->timer)) {
+      remove_entry(queues[q].head);
     }
   }
 }
@@ -94,31 +286,21 @@ recycle(void)
 {
   /* Find the oldest recyclable mapping and remove it. */
   struct ip64_addrmap_entry *m, *oldest;
+  uint8_t i;
 
-  /* Walk through the list of address mappings, throw away the ones
-     that are too old. */
-
+  /* The oldest one is at the head of one of the recyclable queues */
   oldest = NULL;
-  for(m = list_head(entrylist);
-      m != NULL;
-      m = list_item_next(m)) {
-    if(m->flags & FLAGS_RECYCLABLE) {
-      if(oldest == NULL) {
-        oldest = m;
-      } else {
-        if(timer_remaining(&m->timer) <
-           timer_remaining(&oldest->timer)) {
-          oldest = m;
-        }
-      }
+  for(i = 0; i < NUM_LIFETIMES; i++) {
+    m = queues[QUEUE(i, FLAGS_RECYCLABLE)].head;
+    if(m != NULL && (oldest == NULL || remaining(m) < remaining(oldest))) {
+      oldest = m;
     }
   }
 
   /* If we found an oldest recyclable entry, remove it and return
      non-zero. */
   if(oldest != NULL) {
-    list_remove(entrylist, oldest);
-    memb_free(&entrymemb, oldest);
+    remove_entry(oldest);
     return 1;
   }
 
@@ -137,13 +319,9 @@ ip64_addrmap_lookup(const uip_ip6addr_t *ip6addr,
   printf("lookup ip4port %d ip6port %d\n", uip_htons(ip4port),
 	 uip_htons(ip6port));
   check_age();
-  for(m = list_head(entrylist); m != NULL; m = list_item_next(m)) {
-    printf("protocol %d %d, ip4port %d %d, ip6port %d %d, ip4 %d ip6 %d\n",
-	   m->protocol, protocol,
-	   m->ip4port, ip4port,
-	   m->ip6port, ip6port,
-	   uip_ip4addr_cmp(&m->ip4addr, ip4addr),
-	   uip_ip6addr_cmp(&m->ip6addr, ip6addr));
+  for(m = tuple_hash[hash_tuple(ip6addr, ip6port, ip4addr, ip4port, protocol)];
+      m != NULL;
+      m = m->tuple_next) {
     if(m->protocol == protocol &&
        m->ip4port == ip4port &&
        m->ip6port == ip6port &&
@@ -162,7 +340,7 @@ ip64_addrmap_lookup_port(uint16_t mapped_port, uint8_t protocol)
   struct ip64_addrmap_entry *m;
 
   check_age();
-  for(m = list_head(entrylist); m != NULL; m = list_item_next(m)) {
+  for(m = port_hash[hash_port(mapped_port)]; m != NULL; m = m->port_next) {
     printf("mapped port %d %d, protocol %d %d\n",
 	   m->mapped_port, mapped_port,
 	   m->protocol, protocol);
@@ -175,6 +353,19 @@ ip64_addrmap_lookup_port(uint16_t mapped_port, uint8_t protocol)
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+static int
+mapped_port_in_use(uint16_t port)
+{
+  struct ip64_addrmap_entry *m;
+
+  for(m = port_hash[hash_port(port)]; m != NULL; m = m->port_next) {
+    if(m->mapped_port == port) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
 static void
 increase_mapped_port(void)
 {
@@ -190,6 +381,7 @@ ip64_addrmap_create(const uip_ip6addr_t *ip6addr,
 		    uint8_t protocol)
 {
   struct ip64_addrmap_entry *m;
+  unsigned h;
 
   check_age();
   m = memb_alloc(&entrymemb);
@@ -211,25 +403,22 @@ ip64_addrmap_create(const uip_ip6addr_t *ip6addr,
     m->ip4to6 = 0;
     timer_set(&m->timer, 0);
 
-    /* Pick a new, unused local port. First make sure that the
-       mapped_port number does not belong to any active connection. If
-       so, we keep increasing the mapped_port until we're free. */
-    {
-      struct ip64_addrmap_entry *n;
-      n = list_head(entrylist);
-      while(n != NULL) {
-	if(n->mapped_port == mapped_port) {
-	  increase_mapped_port();
-	  n = list_head(entrylist);
-	} else {
-	  n = list_item_next(m);
-	}
-      }
+    /* Pick a new, unused local port. If the mapped_port number
+       belongs to an active connection, we keep picking new ones until
+       we find a free one. */
+    while(mapped_port_in_use(mapped_port)) {
+      increase_mapped_port();
     }
     m->mapped_port = mapped_port;
     increase_mapped_port();
 
-    list_add(entrylist, m);
+    h = hash_tuple(ip6addr, ip6port, ip4addr, ip4port, protocol);
+    m->tuple_next = tuple_hash[h];
+    tuple_hash[h] = m;
+    h = hash_port(m->mapped_port);
+    m->port_next = port_hash[h];
+    port_hash[h] = m;
+    enqueue(m);
     return m;
   }
   return NULL;
@@ -241,14 +430,18 @@ ip64_addrmap_set_lifetime(struct ip64_addrmap_entry *e,
 {
   if(e != NULL) {
     timer_set(&e->timer, time);
+    dequeue(e);
+    enqueue(e);
   }
 }
 /*---------------------------------------------------------------------------*/
 void
 ip64_addrmap_set_recycleble(struct ip64_addrmap_entry *e)
 {
-  if(e != NULL) {
+  if(e != NULL && !(e->flags & FLAGS_RECYCLABLE)) {
     e->flags |= FLAGS_RECYCLABLE;
+    dequeue(e);
+    enqueue(e);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -37,7 +37,9 @@
 #include "net/ip/uip.h"
 
 struct ip64_addrmap_entry {
-  struct ip64_addrmap_entry *next;
+  struct ip64_addrmap_entry *next, *prev;
+  /* Hash chains for ip64_addrmap_lookup() and ip64_addrmap_lookup_port() */
+  struct ip64_addrmap_entry *tuple_next, *port_next;
   struct timer timer;
   uip_ip6addr_t ip6addr;
   uip_ip4addr_t ip4addr;
@@ -47,6 +49,7 @@ struct ip64_addrmap_entry {
   uint16_t ip4port;
   uint8_t protocol;
   uint8_t flags;
+  uint8_t queue;
 };
 
 #define FLAGS_NONE       0
@@ -97,7 +100,9 @@ void ip64_addrmap_set_lifetime(struct ip64_addrmap_entry *e,
 void ip64_addrmap_set_recycleble(struct ip64_addrmap_entry *e);
 
 /**
- * Obtain the list of all address mappings.
+ * Obtain the list of all address mappings, linked through the next
+ * field. Mappings are grouped by lifetime and, within a group, sorted
+ * by expiry.
  */
 struct ip64_addrmap_entry *ip64_addrmap_list(void);
 #endif /* IP64_ADDRMAP_H */
@@ -60,6 +60,7 @@
 #include "ip64-eth-interface.h"
 #include "ip64-slip-interface.h"
 #include "ip64-dns64.h"
+#include "net/ip/ip-chksum.h"
 #include "net/ipv6/uip-ds6.h"
 #include "ip64-ipv4-dhcp.h"
 #include "contiki-net.h"
@@ -269,68 +270,54 @@ ip64_set_ipv6_address(const uip_ip6addr_t *addr)
 }
 /*---------------------------------------------------------------------------*/
 static uint16_t
-chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+ipv4_checksum(struct ipv4_hdr *hdr)
 {
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
-
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  while(dataptr < last_byte) {	/* At least two more bytes */
-    t = (dataptr[0] << 8) + dataptr[1];
-    sum += t;
-    if(sum < t) {
-      sum++;		/* carry */
-    }
-    dataptr += 2;
-  }
+  uint16_t sum;
 
-  if(dataptr == last_byte) {
-    t = (dataptr[0] << 8) + 0;
-    sum += t;
-    if(sum < t) {
-      sum++;		/* carry */
-    }
+  sum = ip_chksum(0, (uint8_t *)hdr, IPV4_HDRLEN);
+  return (sum == 0) ? 0xffff : uip_htons(sum);
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+ipv4_pseudo_header_sum(const uint8_t *packet, uint16_t len, uint8_t proto)
+{
+  const struct ipv4_hdr *v4hdr = (const struct ipv4_hdr *)packet;
+
+  if(proto == IP_PROTO_ICMPV4) {
+    /* ping replies' checksums are calculated over the icmp-part only */
+    return 0;
   }
 
-  /* Return sum in host byte order. */
-  return sum;
+  /* IP protocol and length fields, which cannot carry, and the IP
+     source and destination addresses. */
+  return ip_chksum(len - IPV4_HDRLEN + proto,
+                   (const uint8_t *)&v4hdr->srcipaddr,
+                   2 * sizeof(uip_ip4addr_t));
 }
 /*---------------------------------------------------------------------------*/
 static uint16_t
-ipv4_checksum(struct ipv4_hdr *hdr)
+ipv6_pseudo_header_sum(const uint8_t *packet, uint16_t len, uint8_t proto)
 {
+  const struct ipv6_hdr *v6hdr = (const struct ipv6_hdr *)packet;
   uint16_t sum;
 
-  sum = chksum(0, (uint8_t *)hdr, IPV4_HDRLEN);
-  return (sum == 0) ? 0xffff : uip_htons(sum);
+  /* IP protocol and length fields. This addition cannot carry. */
+  sum = len - IPV6_HDRLEN + proto;
+  /* Sum IP source and destination addresses. */
+  sum = ip_chksum(sum, (const uint8_t *)&v6hdr->srcipaddr, sizeof(uip_ip6addr_t));
+  return ip_chksum(sum, (const uint8_t *)&v6hdr->destipaddr, sizeof(uip_ip6addr_t));
 }
 /*---------------------------------------------------------------------------*/
 static uint16_t
 ipv4_transport_checksum(const uint8_t *packet, uint16_t len, uint8_t proto)
 {
-  uint16_t transport_layer_len;
   uint16_t sum;
-  struct ipv4_hdr *v4hdr = (struct ipv4_hdr *)packet;
-
-  transport_layer_len = len - IPV4_HDRLEN;
 
   /* First sum pseudoheader. */
-
-  if(proto != IP_PROTO_ICMPV4) {
-    /* IP protocol and length fields. This addition cannot carry. */
-    sum = transport_layer_len + proto;
-    /* Sum IP source and destination addresses. */
-    sum = chksum(sum, (uint8_t *)&v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t));
-  } else {
-    /* ping replies' checksums are calculated over the icmp-part only */
-    sum = 0;
-  }
+  sum = ipv4_pseudo_header_sum(packet, len, proto);
 
   /* Sum transport layer header and data. */
-  sum = chksum(sum, &packet[IPV4_HDRLEN], transport_layer_len);
+  sum = ip_chksum(sum, &packet[IPV4_HDRLEN], len - IPV4_HDRLEN);
 
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -338,26 +325,52 @@ ipv4_transport_checksum(const uint8_t *packet, uint16_t len, uint8_t proto)
 static uint16_t
 ipv6_transport_checksum(const uint8_t *packet, uint16_t len, uint8_t proto)
 {
-  uint16_t transport_layer_len;
   uint16_t sum;
-  struct ipv6_hdr *v6hdr = (struct ipv6_hdr *)packet;
-
-  transport_layer_len = len - IPV6_HDRLEN;
 
   /* First sum pseudoheader. */
-
-  /* IP protocol and length fields. This addition cannot carry. */
-  sum = transport_layer_len + proto;
-  /* Sum IP source and destination addresses. */
-  sum = chksum(sum, (uint8_t *)&v6hdr->srcipaddr, sizeof(uip_ip6addr_t));
-  sum = chksum(sum, (uint8_t *)&v6hdr->destipaddr, sizeof(uip_ip6addr_t));
+  sum = ipv6_pseudo_header_sum(packet, len, proto);
 
   /* Sum transport layer header and data. */
-  sum = chksum(sum, &packet[IPV6_HDRLEN], transport_layer_len);
+  sum = ip_chksum(sum, &packet[IPV6_HDRLEN], len - IPV6_HDRLEN);
 
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
 /*---------------------------------------------------------------------------*/
+/* The parts of a packet that translation may change, apart from the
+   payload: the pseudo header, and the port numbers of TCP and UDP or
+   the type and code of ICMP. */
+static uint16_t
+translated_fields_sum(const uint8_t *packet, uint16_t len, uint8_t proto,
+                      int ipv6)
+{
+  const uint8_t *transport;
+  uint16_t sum;
+
+  if(ipv6) {
+    sum = ipv6_pseudo_header_sum(packet, len, proto);
+    transport = &packet[IPV6_HDRLEN];
+  } else {
+    sum = ipv4_pseudo_header_sum(packet, len, proto);
+    transport = &packet[IPV4_HDRLEN];
+  }
+
+  if(proto == IP_PROTO_ICMPV4 || proto == IP_PROTO_ICMPV6) {
+    return ip_chksum(sum, transport, 2);
+  }
+  return ip_chksum(sum, transport, 4);
+}
+/*---------------------------------------------------------------------------*/
+/* Updates a transport checksum, in network byte order, for the changed
+   fields instead of summing the whole payload again. A checksum that
+   was wrong on the way in stays wrong, so the receiver still drops the
+   packet. */
+static uint16_t
+adjust_checksum(uint16_t chksum, uint16_t old_sum, uint16_t new_sum)
+{
+  return uip_htons(ip_chksum_adjust(uip_ntohs(chksum), old_sum, new_sum));
+}
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
 int
 ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
 	  uint8_t *resultpacket)
@@ -369,9 +382,12 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
   struct icmpv4_hdr *icmpv4hdr;
   struct icmpv6_hdr *icmpv6hdr;
   uint16_t ipv6len, ipv4len;
+  uint16_t old_sum, new_sum;
+  int payload_rewritten;
   struct ip64_addrmap_entry *m;
 
   v6hdr = (struct ipv6_hdr *)ipv6packet;
+  payload_rewritten = 0;
   v4hdr = (struct ipv4_hdr *)resultpacket;
 
   if((v6hdr->len[0] << 8) + v6hdr->len[1] <= ipv6packet_len) {
@@ -425,13 +441,14 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
     PRINTF("ip64_6to4: TCP header\n");
     v4hdr->proto = IP_PROTO_TCP;
 
-    /* Compute and check the TCP checksum - since we're going to
-       recompute it ourselves, we must ensure that it was correct in
-       the first place. */
+#if DEBUG
+    /* The checksum is updated rather than recomputed, so a bad one
+       is passed on for the receiver to drop. */
     if(ipv6_transport_checksum(ipv6packet, ipv6len,
                                IP_PROTO_TCP) != 0xffff) {
-      PRINTF("Bad TCP checksum, dropping packet\n");
+      PRINTF("Bad TCP checksum\n");
     }
+#endif /* DEBUG */
 
     break;
 
@@ -446,14 +463,14 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
                       ipv6len - IPV6_HDRLEN - sizeof(struct udp_hdr),
                       (uint8_t *)udphdr + sizeof(struct udp_hdr),
                       BUFSIZE - IPV4_HDRLEN - sizeof(struct udp_hdr));
+      payload_rewritten = 1;
     }
-    /* Compute and check the UDP checksum - since we're going to
-       recompute it ourselves, we must ensure that it was correct in
-       the first place. */
+#if DEBUG
     if(ipv6_transport_checksum(ipv6packet, ipv6len,
                                IP_PROTO_UDP) != 0xffff) {
-      PRINTF("Bad UDP checksum, dropping packet\n");
+      PRINTF("Bad UDP checksum\n");
     }
+#endif /* DEBUG */
     break;
 
   case IP_PROTO_ICMPV6:
@@ -614,27 +631,34 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
 
 
 
+  /* Unless DNS64 rewrote the payload, only the pseudo header and the
+     fields in translated_fields_sum() differ from the IPv6 packet, so
+     the transport checksum is updated for those (RFC 1624). */
+  old_sum = translated_fields_sum(ipv6packet, ipv6len, v6hdr->nxthdr, 1);
+  new_sum = translated_fields_sum(resultpacket, ipv4len, v4hdr->proto, 0);
+
   /* The checksum is in different places in the different protocol
      headers, so we need to be sure that we update the correct
      field. */
   switch(v4hdr->proto) {
   case IP_PROTO_TCP:
-    tcphdr->tcpchksum = 0;
-    tcphdr->tcpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
-						  IP_PROTO_TCP));
+    tcphdr->tcpchksum = adjust_checksum(tcphdr->tcpchksum, old_sum, new_sum);
     break;
   case IP_PROTO_UDP:
-    udphdr->udpchksum = 0;
-    udphdr->udpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
-						  IP_PROTO_UDP));
+    if(payload_rewritten) {
+      udphdr->udpchksum = 0;
+      udphdr->udpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
+                                                    IP_PROTO_UDP));
+    } else {
+      udphdr->udpchksum = adjust_checksum(udphdr->udpchksum, old_sum, new_sum);
+    }
     if(udphdr->udpchksum == 0) {
       udphdr->udpchksum = 0xffff;
     }
     break;
   case IP_PROTO_ICMPV4:
-    icmpv4hdr->icmpchksum = 0;
-    icmpv4hdr->icmpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
-						      IP_PROTO_ICMPV4));
+    icmpv4hdr->icmpchksum = adjust_checksum(icmpv4hdr->icmpchksum,
+                                            old_sum, new_sum);
     break;
 
   default:
@@ -658,9 +682,12 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
   struct icmpv4_hdr *icmpv4hdr;
   struct icmpv6_hdr *icmpv6hdr;
   uint16_t ipv4len, ipv6len, ipv6_packet_len;
+  uint16_t old_sum, new_sum;
+  int payload_rewritten;
   struct ip64_addrmap_entry *m;
 
   v6hdr = (struct ipv6_hdr *)resultpacket;
+  payload_rewritten = 0;
   v4hdr = (struct ipv4_hdr *)ipv4packet;
 
   if((v4hdr->len[0] << 8) + v4hdr->len[1] <= ipv4packet_len) {
@@ -741,7 +768,7 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
       v6hdr->len[0] = ipv6_packet_len >> 8;
       v6hdr->len[1] = ipv6_packet_len & 0xff;
       ipv6len = ipv6_packet_len + IPV6_HDRLEN;
-
+      payload_rewritten = 1;
     }
     break;
 
@@ -849,31 +876,36 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
     }
   }
 
+  /* As in ip64_6to4(), update the transport checksum for the changed
+     fields, unless DNS64 rewrote the payload or the IPv4 sender did
+     not compute a UDP checksum. */
+  old_sum = translated_fields_sum(ipv4packet, ipv4len, v4hdr->proto, 0);
+  new_sum = translated_fields_sum(resultpacket, ipv6len, v6hdr->nxthdr, 1);
+
   /* The checksum is in different places in the different protocol
      headers, so we need to be sure that we update the correct
      field. */
   switch(v6hdr->nxthdr) {
   case IP_PROTO_TCP:
-    tcphdr->tcpchksum = 0;
-    tcphdr->tcpchksum = ~(ipv6_transport_checksum(resultpacket,
-						  ipv6len,
-						  IP_PROTO_TCP));
+    tcphdr->tcpchksum = adjust_checksum(tcphdr->tcpchksum, old_sum, new_sum);
     break;
   case IP_PROTO_UDP:
-    udphdr->udpchksum = 0;
-    udphdr->udpchksum = ~(ipv6_transport_checksum(resultpacket,
-						  ipv6len,
-						  IP_PROTO_UDP));
+    if(payload_rewritten || udphdr->udpchksum == 0) {
+      udphdr->udpchksum = 0;
+      udphdr->udpchksum = ~(ipv6_transport_checksum(resultpacket,
+                                                    ipv6len,
+                                                    IP_PROTO_UDP));
+    } else {
+      udphdr->udpchksum = adjust_checksum(udphdr->udpchksum, old_sum, new_sum);
+    }
     if(udphdr->udpchksum == 0) {
       udphdr->udpchksum = 0xffff;
     }
     break;
 
   case IP_PROTO_ICMPV6:
-    icmpv6hdr->icmpchksum = 0;
-    icmpv6hdr->icmpchksum = ~(ipv6_transport_checksum(resultpacket,
-                                                ipv6len,
-                                                IP_PROTO_ICMPV6));
+    icmpv6hdr->icmpchksum = adjust_checksum(icmpv6hdr->icmpchksum,
+                                            old_sum, new_sum);
     break;
   default:
     PRINTF("ip64_4to6: transport protocol %d not implemented\n", v4hdr->proto);
@@ -220,6 +220,12 @@ static int last_rssi;
 #if SICSLOWPAN_CONF_FRAG
 static uint16_t my_tag;
 
+/* Attributes of the packet being fragmented. The MAC layer may change
+   the packetbuf while sending a fragment, so they are restored before
+   the next fragment is built. */
+static struct packetbuf_attr frag_attrs[PACKETBUF_NUM_ATTRS];
+static struct packetbuf_addr frag_addrs[PACKETBUF_NUM_ADDRS];
+
 /** The total length of the IPv6 packet in the sicslowpan_buf. */
 
 /* This needs to be defined in NBR / Nodes depending on available RAM   */
@@ -287,6 +293,53 @@ struct sicslowpan_frag_buf {
 
 static struct sicslowpan_frag_buf frag_buf[SICSLOWPAN_FRAGMENT_BUFFERS];
 
+/* FRAG_FORWARD sets the number of datagrams that can be forwarded
+ * fragment by fragment at the same time, without reassembling them
+ * (a virtual reassembly buffer, as in RFC 8930). The first fragment
+ * of a datagram that is not for us goes through the IP stack on its
+ * own to find the next hop; the following fragments are then relayed
+ * as they arrive, with their datagram tag switched. Zero disables
+ * fragment forwarding, so that all datagrams are reassembled.
+ **/
+#ifdef SICSLOWPAN_CONF_FRAG_FORWARD
+#define SICSLOWPAN_FRAG_FORWARD SICSLOWPAN_CONF_FRAG_FORWARD
+#else
+#define SICSLOWPAN_FRAG_FORWARD 0
+#endif
+
+#if SICSLOWPAN_FRAG_FORWARD
+#if UIP_CONF_IPV6_QUEUE_PKT
+/* A first fragment queued for address resolution would later be sent
+   as a whole datagram */
+#error "SICSLOWPAN_CONF_FRAG_FORWARD requires UIP_CONF_IPV6_QUEUE_PKT 0"
+#endif /* UIP_CONF_IPV6_QUEUE_PKT */
+
+/* A datagram being forwarded fragment by fragment */
+struct sicslowpan_frag_forward {
+  /** The neighbor we receive the fragments from */
+  linkaddr_t sender;
+  /** The next hop we send the fragments to */
+  linkaddr_t receiver;
+  /** The datagram tag used by the sender */
+  uint16_t tag;
+  /** The datagram tag we use towards the next hop */
+  uint16_t out_tag;
+  /** Total length of the datagram, zero if the entry is unused */
+  uint16_t len;
+  /** Entries of lost datagrams are reused after the reassembly timeout */
+  struct timer timer;
+};
+
+static struct sicslowpan_frag_forward frag_forward[SICSLOWPAN_FRAG_FORWARD];
+
+/* The first fragment handed to the IP stack, and what became of it */
+static struct sicslowpan_frag_forward *fwd;
+static struct sicslowpan_frag_info *fwd_info;
+static enum {
+  FWD_IDLE, FWD_PENDING, FWD_SENT, FWD_REASSEMBLE
+} fwd_state;
+#endif /* SICSLOWPAN_FRAG_FORWARD */
+
 /*---------------------------------------------------------------------------*/
 static int
 clear_fragments(uint8_t frag_info_index)
@@ -1261,6 +1314,162 @@ send_packet(linkaddr_t *dest)
      watchdog know that we are still alive. */
   watchdog_periodic();
 }
+#if SICSLOWPAN_CONF_FRAG && SICSLOWPAN_FRAG_FORWARD
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Try to forward a datagram without reassembling it.
+ * \param context The reassembly context holding the first fragment
+ * \retval 1 The datagram was taken care of by the IP stack, which sent
+ * the first fragment on or dropped it
+ * \retval 0 The datagram must be reassembled
+ *
+ * The first fragment is put in uip_buf as if it were the whole
+ * datagram, with the missing part zeroed, and passed to the IP
+ * stack. output() recognizes it and sends only the first fragment,
+ * unless the IP stack changed the length of the datagram on its way.
+ */
+static int
+forward_first_fragment(int context)
+{
+  struct sicslowpan_frag_info *info = &frag_info[context];
+  uip_ipaddr_t *destipaddr;
+  int i;
+
+  destipaddr = &SICSLOWPAN_IP_BUF(info->first_frag)->destipaddr;
+  if(uip_is_addr_mcast(destipaddr) || uip_ds6_is_my_addr(destipaddr) ||
+     uip_ds6_is_my_aaddr(destipaddr) ||
+     info->len > UIP_BUFSIZE - UIP_LLH_LEN) {
+    return 0;
+  }
+
+  fwd = NULL;
+  for(i = 0; i < SICSLOWPAN_FRAG_FORWARD; i++) {
+    if(frag_forward[i].len > 0 &&
+       (timer_expired(&frag_forward[i].timer) ||
+        (frag_forward[i].tag == info->tag &&
+         linkaddr_cmp(&frag_forward[i].sender, &info->sender)))) {
+      /* Lost, or replaced by a new datagram with the same tag */
+      frag_forward[i].len = 0;
+    }
+    if(fwd == NULL && frag_forward[i].len == 0) {
+      fwd = &frag_forward[i];
+    }
+  }
+  if(fwd == NULL) {
+    PRINTFI("sicslowpan input: no room to forward tag %d\n", info->tag);
+    return 0;
+  }
+  linkaddr_copy(&fwd->sender, &info->sender);
+  fwd->tag = info->tag;
+
+  memcpy((uint8_t *)UIP_IP_BUF, info->first_frag, info->first_frag_len);
+  memset((uint8_t *)UIP_IP_BUF + info->first_frag_len, 0,
+         info->len - info->first_frag_len);
+  uip_len = info->len;
+  fwd_info = info;
+  fwd_state = FWD_PENDING;
+
+  tcpip_input();
+
+  i = fwd_state != FWD_REASSEMBLE;
+  fwd_state = FWD_IDLE;
+  return i;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Send the first fragment of a datagram being forwarded.
+ * \param dest The next hop
+ * \param max_payload The room left in the frame after the MAC header
+ *
+ * Called by output() with the IP header compressed in packetbuf. The
+ * first fragment carries exactly the part of the datagram we have
+ * received, so that the offsets of the following fragments stay
+ * valid.
+ */
+static uint8_t
+forward_output(linkaddr_t *dest, int max_payload)
+{
+  packetbuf_payload_len = fwd_info->first_frag_len - uncomp_hdr_len;
+  if(fwd_info->first_frag_len <= uncomp_hdr_len ||
+     packetbuf_hdr_len + SICSLOWPAN_FRAG1_HDR_LEN + packetbuf_payload_len >
+     max_payload) {
+    /* Our header compression does not leave room for the data */
+    fwd_state = FWD_REASSEMBLE;
+    return 0;
+  }
+
+  memmove(packetbuf_ptr + SICSLOWPAN_FRAG1_HDR_LEN, packetbuf_ptr,
+          packetbuf_hdr_len);
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+        ((SICSLOWPAN_DISPATCH_FRAG1 << 8) | uip_len));
+  fwd->out_tag = my_tag++;
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, fwd->out_tag);
+  packetbuf_hdr_len += SICSLOWPAN_FRAG1_HDR_LEN;
+  memcpy(packetbuf_ptr + packetbuf_hdr_len,
+         (uint8_t *)UIP_IP_BUF + uncomp_hdr_len, packetbuf_payload_len);
+  packetbuf_set_datalen(packetbuf_payload_len + packetbuf_hdr_len);
+
+  PRINTFO("sicslowpan output: forwarding tag %d as %d\n",
+          fwd->tag, fwd->out_tag);
+  linkaddr_copy(&fwd->receiver, dest);
+  fwd->len = uip_len;
+  timer_set(&fwd->timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+  fwd_state = FWD_SENT;
+
+  send_packet(dest);
+  return 1;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Relay a subsequent fragment of a datagram being forwarded.
+ * \param tag The datagram tag of the fragment
+ * \param frag_size The datagram size of the fragment
+ * \param offset The offset of the fragment, in units of 8 bytes
+ * \retval 1 The fragment was relayed
+ * \retval 0 The fragment is not part of a forwarded datagram
+ */
+static int
+forward_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
+{
+  struct sicslowpan_frag_forward *f;
+  uint8_t *ptr;
+  int len;
+  int i;
+
+  f = NULL;
+  for(i = 0; i < SICSLOWPAN_FRAG_FORWARD; i++) {
+    if(frag_forward[i].len == frag_size && frag_forward[i].tag == tag &&
+       linkaddr_cmp(&frag_forward[i].sender,
+                    packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
+      f = &frag_forward[i];
+      break;
+    }
+  }
+  if(f == NULL) {
+    return 0;
+  }
+
+  /* Only the datagram tag changes. packetbuf_clear() leaves the data
+     in place, so the fragment is moved back to the start of packetbuf
+     with its reception attributes cleared. */
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, f->out_tag);
+  ptr = packetbuf_dataptr();
+  len = packetbuf_datalen();
+  packetbuf_clear();
+  memmove(packetbuf_dataptr(), ptr, len);
+  packetbuf_set_datalen(len);
+
+  if((offset << 3) + len - SICSLOWPAN_FRAGN_HDR_LEN >= frag_size) {
+    /* The last fragment */
+    f->len = 0;
+  }
+
+  PRINTFI("sicslowpan input: relaying tag %d as %d, offset %d\n",
+          tag, f->out_tag, offset);
+  send_packet(&f->receiver);
+  return 1;
+}
+#endif /* SICSLOWPAN_CONF_FRAG && SICSLOWPAN_FRAG_FORWARD */
 /*--------------------------------------------------------------------*/
 /** \brief Take an IP packet and format it to be sent on an 802.15.4
  *  network using 6lowpan.
@@ -1352,12 +1561,28 @@ output(const uip_lladdr_t *localdest)
 #endif /* USE_FRAMER_HDRLEN */
 
   max_payload = MAC_MAX_PAYLOAD - framer_hdrlen;
+#if SICSLOWPAN_CONF_FRAG && SICSLOWPAN_FRAG_FORWARD
+  if(fwd_state == FWD_PENDING &&
+     uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr,
+                    &SICSLOWPAN_IP_BUF(fwd_info->first_frag)->srcipaddr) &&
+     uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr,
+                    &SICSLOWPAN_IP_BUF(fwd_info->first_frag)->destipaddr)) {
+    if(uip_len != fwd_info->len) {
+      /* The IP stack changed the length of the datagram, e.g. by
+         inserting a RPL header, so the zeroed part would be sent and
+         the offsets of the following fragments would be wrong */
+      fwd_state = FWD_REASSEMBLE;
+      return 0;
+    }
+    /* The first fragment of a datagram we forward without reassembly */
+    return forward_output(&dest, max_payload);
+  }
+#endif /* SICSLOWPAN_CONF_FRAG && SICSLOWPAN_FRAG_FORWARD */
   if((int)uip_len - (int)uncomp_hdr_len > max_payload - (int)packetbuf_hdr_len) {
 #if SICSLOWPAN_CONF_FRAG
     /* Number of bytes processed. */
     uint16_t processed_ip_out_len;
 
-    struct queuebuf *q;
     uint16_t frag_tag;
 
     /*
@@ -1368,7 +1593,7 @@ output(const uip_lladdr_t *localdest)
      * The following fragments contain only the fragn dispatch.
      */
     int estimated_fragments = ((int)uip_len) / (max_payload - SICSLOWPAN_FRAGN_HDR_LEN) + 1;
-    int freebuf = queuebuf_numfree() - 1;
+    int freebuf = queuebuf_numfree();
     PRINTFO("uip_len: %d, fragments: %d, free bufs: %d\n", uip_len, estimated_fragments, freebuf);
     if(freebuf < estimated_fragments) {
       PRINTFO("Dropping packet, not enough free bufs\n");
@@ -1404,15 +1629,8 @@ output(const uip_lladdr_t *localdest)
     memcpy(packetbuf_ptr + packetbuf_hdr_len,
            (uint8_t *)UIP_IP_BUF + uncomp_hdr_len, packetbuf_payload_len);
     packetbuf_set_datalen(packetbuf_payload_len + packetbuf_hdr_len);
-    q = queuebuf_new_from_packetbuf();
-    if(q == NULL) {
-      PRINTFO("could not allocate queuebuf for first fragment, dropping packet\n");
-      return 0;
-    }
+    packetbuf_attr_copyto(frag_attrs, frag_addrs);
     send_packet(&dest);
-    queuebuf_to_packetbuf(q);
-    queuebuf_free(q);
-    q = NULL;
 
     /* Check tx result. */
     if((last_tx_status == MAC_TX_COLLISION) ||
@@ -1427,17 +1645,21 @@ output(const uip_lladdr_t *localdest)
 
     /*
      * Create following fragments
-     * Datagram tag is already in the buffer, we need to set the
-     * FRAGN dispatch and for each fragment, the offset
+     * The following fragments only hold the FRAGN dispatch, the
+     * datagram tag and the offset, so instead of restoring the first
+     * fragment we rebuild the header in a cleared packetbuf.
      */
     packetbuf_hdr_len = SICSLOWPAN_FRAGN_HDR_LEN;
-/*     PACKETBUF_FRAG_BUF->dispatch_size = */
-/*       uip_htons((SICSLOWPAN_DISPATCH_FRAGN << 8) | uip_len); */
-    SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
-          ((SICSLOWPAN_DISPATCH_FRAGN << 8) | uip_len));
     packetbuf_payload_len = (max_payload - packetbuf_hdr_len) & 0xfffffff8;
     while(processed_ip_out_len < uip_len) {
       PRINTFO("sicslowpan output: fragment ");
+      packetbuf_clear();
+      packetbuf_attr_copyfrom(frag_attrs, frag_addrs);
+/*     PACKETBUF_FRAG_BUF->dispatch_size = */
+/*       uip_htons((SICSLOWPAN_DISPATCH_FRAGN << 8) | uip_len); */
+      SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+            ((SICSLOWPAN_DISPATCH_FRAGN << 8) | uip_len));
+      SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, frag_tag);
       PACKETBUF_FRAG_PTR[PACKETBUF_FRAG_OFFSET] = processed_ip_out_len >> 3;
 
       /* Copy payload and send */
@@ -1450,15 +1672,7 @@ output(const uip_lladdr_t *localdest)
       memcpy(packetbuf_ptr + packetbuf_hdr_len,
              (uint8_t *)UIP_IP_BUF + processed_ip_out_len, packetbuf_payload_len);
       packetbuf_set_datalen(packetbuf_payload_len + packetbuf_hdr_len);
-      q = queuebuf_new_from_packetbuf();
-      if(q == NULL) {
-        PRINTFO("could not allocate queuebuf, dropping fragment\n");
-        return 0;
-      }
       send_packet(&dest);
-      queuebuf_to_packetbuf(q);
-      queuebuf_free(q);
-      q = NULL;
       processed_ip_out_len += packetbuf_payload_len;
 
       /* Check tx result. */
@@ -1583,6 +1797,12 @@ input(void)
       PRINTFI("last_fragment?: packetbuf_payload_len %d frag_size %d\n",
               packetbuf_datalen() - packetbuf_hdr_len, frag_size);
 
+#if SICSLOWPAN_FRAG_FORWARD
+      if(forward_fragment(frag_tag, frag_size, frag_offset)) {
+        return;
+      }
+#endif /* SICSLOWPAN_FRAG_FORWARD */
+
       /* Add the fragment to the fragmentation context (this will also
          copy the payload) */
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
@@ -1680,6 +1900,12 @@ input(void)
     if(first_fragment != 0) {
       frag_info[frag_context].reassembled_len = uncomp_hdr_len + packetbuf_payload_len;
       frag_info[frag_context].first_frag_len = uncomp_hdr_len + packetbuf_payload_len;
+#if SICSLOWPAN_FRAG_FORWARD
+      if(forward_first_fragment(frag_context)) {
+        clear_fragments(frag_context);
+        return;
+      }
+#endif /* SICSLOWPAN_FRAG_FORWARD */
     }
     /* For the last fragment, we are OK if there is extrenous bytes at
        the end of the packet. */
@@ -64,17 +64,36 @@ void NETSTACK_CONF_ROUTING_NEIGHBOR_REMOVED_CALLBACK(const linkaddr_t *addr);
    so that it will be maintained along with the rest of the neighbor
    tables in the system. */
 NBR_TABLE_GLOBAL(struct uip_ds6_route_neighbor_routes, nbr_routes);
-MEMB(neighborroutememb, struct uip_ds6_route_neighbor_route, UIP_DS6_ROUTE_NB);
+MEMB_FREELIST(neighborroutememb, struct uip_ds6_route_neighbor_route, UIP_DS6_ROUTE_NB);
 
 /* Each route is repressented by a uip_ds6_route_t structure and
    memory for each route is allocated from the routememb memory
    block. These routes are maintained on the routelist. */
 LIST(routelist);
-MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
+MEMB_FREELIST(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 
 static int num_routes = 0;
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 
+#if UIP_DS6_ROUTE_TRIE
+/* The route trie is a path-compressed binary trie over the route
+   prefixes. A node either holds a route whose prefix is exactly the
+   node prefix, or is a branching point with two children. There are
+   never more branching nodes than routes, so twice the number of
+   routes bounds the number of nodes. */
+struct route_trie_node {
+  struct route_trie_node *child[2];
+  uip_ds6_route_t *route;
+  uip_ipaddr_t prefix;
+  uint8_t length;
+};
+MEMB_FREELIST(routetriememb, struct route_trie_node, 2 * UIP_DS6_ROUTE_NB);
+static struct route_trie_node *route_trie_root;
+#if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+static uint32_t route_use_counter;
+#endif /* UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
+#endif /* UIP_DS6_ROUTE_TRIE */
+
 #endif /* (UIP_CONF_MAX_ROUTES != 0) */
 
 /* Default routes are held on the defaultrouterlist and their
@@ -118,6 +137,191 @@ assert_nbr_routes_list_sane(void)
   }
 }
 #endif /* DEBUG != DEBUG_NONE */
+#if (UIP_CONF_MAX_ROUTES != 0) && UIP_DS6_ROUTE_TRIE
+/*---------------------------------------------------------------------------*/
+static int
+trie_bit(const uip_ipaddr_t *addr, uint8_t pos)
+{
+  return (addr->u8[pos >> 3] >> (7 - (pos & 7))) & 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Number of leading bits, at most len, that a and b have in common */
+static uint8_t
+trie_common_length(const uip_ipaddr_t *a, const uip_ipaddr_t *b, uint8_t len)
+{
+  uint8_t i;
+  uint8_t diff;
+  uint8_t common;
+
+  for(i = 0; i < sizeof(uip_ipaddr_t); i++) {
+    diff = a->u8[i] ^ b->u8[i];
+    if(diff != 0) {
+      common = i << 3;
+      while((diff & 0x80) == 0) {
+        diff <<= 1;
+        common++;
+      }
+      return common < len ? common : len;
+    }
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+trie_prefix_match(const uip_ipaddr_t *addr, const struct route_trie_node *n)
+{
+  uint8_t bytes = n->length >> 3;
+  uint8_t bits = n->length & 7;
+
+  if(memcmp(addr, &n->prefix, bytes) != 0) {
+    return 0;
+  }
+  if(bits != 0 &&
+     ((addr->u8[bytes] ^ n->prefix.u8[bytes]) & (0xff << (8 - bits))) != 0) {
+    return 0;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static struct route_trie_node *
+trie_node_alloc(const uip_ipaddr_t *prefix, uint8_t length,
+                uip_ds6_route_t *route)
+{
+  struct route_trie_node *n;
+
+  n = memb_alloc(&routetriememb);
+  if(n != NULL) {
+    n->child[0] = n->child[1] = NULL;
+    n->route = route;
+    uip_ipaddr_copy(&n->prefix, prefix);
+    n->length = length;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+/* Find the route with exactly the given prefix, if any */
+static uip_ds6_route_t *
+trie_find(const uip_ipaddr_t *prefix, uint8_t length)
+{
+  struct route_trie_node *n;
+
+  n = route_trie_root;
+  while(n != NULL && n->length <= length && trie_prefix_match(prefix, n)) {
+    if(n->length == length) {
+      return n->route;
+    }
+    n = n->child[trie_bit(prefix, n->length)];
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+trie_lookup(const uip_ipaddr_t *addr)
+{
+  struct route_trie_node *n;
+  uip_ds6_route_t *found;
+
+  found = NULL;
+  n = route_trie_root;
+  while(n != NULL && trie_prefix_match(addr, n)) {
+    if(n->route != NULL) {
+      found = n->route;
+    }
+    if(n->length == 128) {
+      break;
+    }
+    n = n->child[trie_bit(addr, n->length)];
+  }
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+static int
+trie_insert(uip_ds6_route_t *route)
+{
+  struct route_trie_node **link;
+  struct route_trie_node *n;
+  struct route_trie_node *leaf;
+  struct route_trie_node *branch;
+  const uip_ipaddr_t *prefix = &route->ipaddr;
+  uint8_t length = route->length;
+  uint8_t common;
+
+  for(link = &route_trie_root; (n = *link) != NULL;
+      link = &n->child[trie_bit(prefix, n->length)]) {
+    common = trie_common_length(&n->prefix, prefix,
+                                n->length < length ? n->length : length);
+    if(common < n->length) {
+      /* The new prefix leaves the path to n: split the edge. */
+      leaf = trie_node_alloc(prefix, length, route);
+      if(leaf == NULL) {
+        return 0;
+      }
+      if(common == length) {
+        /* The new prefix is a prefix of n. */
+        leaf->child[trie_bit(&n->prefix, length)] = n;
+        *link = leaf;
+        return 1;
+      }
+      branch = trie_node_alloc(prefix, common, NULL);
+      if(branch == NULL) {
+        memb_free(&routetriememb, leaf);
+        return 0;
+      }
+      branch->child[trie_bit(prefix, common)] = leaf;
+      branch->child[trie_bit(&n->prefix, common)] = n;
+      *link = branch;
+      return 1;
+    }
+    if(n->length == length) {
+      n->route = route;
+      return 1;
+    }
+  }
+
+  *link = trie_node_alloc(prefix, length, route);
+  return *link != NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+trie_remove(uip_ds6_route_t *route)
+{
+  struct route_trie_node **link;
+  struct route_trie_node **parent_link;
+  struct route_trie_node *n;
+  struct route_trie_node *parent;
+  const uip_ipaddr_t *prefix = &route->ipaddr;
+
+  parent_link = NULL;
+  link = &route_trie_root;
+  while((n = *link) != NULL && n->length < route->length &&
+        trie_prefix_match(prefix, n)) {
+    parent_link = link;
+    link = &n->child[trie_bit(prefix, n->length)];
+  }
+  if(n == NULL || n->route != route) {
+    return;
+  }
+
+  n->route = NULL;
+  if(n->child[0] != NULL && n->child[1] != NULL) {
+    /* Still needed as a branching point. */
+    return;
+  }
+  *link = n->child[0] != NULL ? n->child[0] : n->child[1];
+  memb_free(&routetriememb, n);
+
+  if(*link == NULL && parent_link != NULL) {
+    /* A leaf went away: a parent without a route of its own is now
+       left with a single child and can be spliced out as well. */
+    parent = *parent_link;
+    if(parent->route == NULL) {
+      *parent_link = parent->child[0] != NULL ?
+        parent->child[0] : parent->child[1];
+      memb_free(&routetriememb, parent);
+    }
+  }
+}
+#endif /* (UIP_CONF_MAX_ROUTES != 0) && UIP_DS6_ROUTE_TRIE */
 /*---------------------------------------------------------------------------*/
 #if UIP_DS6_NOTIFICATIONS
 static void
@@ -162,6 +366,10 @@ uip_ds6_route_init(void)
 #if (UIP_CONF_MAX_ROUTES != 0)
   memb_init(&routememb);
   list_init(routelist);
+#if UIP_DS6_ROUTE_TRIE
+  memb_init(&routetriememb);
+  route_trie_root = NULL;
+#endif /* UIP_DS6_ROUTE_TRIE */
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 #endif /* (UIP_CONF_MAX_ROUTES != 0) */
@@ -254,15 +462,25 @@ uip_ds6_route_t *
 uip_ds6_route_lookup(uip_ipaddr_t *addr)
 {
 #if (UIP_CONF_MAX_ROUTES != 0)
-  uip_ds6_route_t *r;
   uip_ds6_route_t *found_route;
+#if !UIP_DS6_ROUTE_TRIE
+  uip_ds6_route_t *r;
   uint8_t longestmatch;
+#endif /* !UIP_DS6_ROUTE_TRIE */
 
   PRINTF("uip-ds6-route: Looking up route for ");
   PRINT6ADDR(addr);
   PRINTF("\n");
 
 
+#if UIP_DS6_ROUTE_TRIE
+  found_route = trie_lookup(addr);
+#if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  if(found_route != NULL) {
+    found_route->last_used = ++route_use_counter;
+  }
+#endif /* UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
+#else /* UIP_DS6_ROUTE_TRIE */
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
@@ -278,6 +496,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_TRIE */
 
   if(found_route != NULL) {
     PRINTF("uip-ds6-route: Found route: ");
@@ -289,6 +508,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     PRINTF("uip-ds6-route: No route found\n");
   }
 
+#if !UIP_DS6_ROUTE_TRIE
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -298,6 +518,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* !UIP_DS6_ROUTE_TRIE */
 
   return found_route;
 #else /* (UIP_CONF_MAX_ROUTES != 0) */
@@ -343,6 +564,11 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
 
     uip_ds6_route_rm(r);
   }
+#if UIP_DS6_ROUTE_TRIE
+  /* The trie holds a single route per prefix, so also drop a route
+     for the same prefix that the longest match above did not return. */
+  uip_ds6_route_rm(trie_find(ipaddr, length));
+#endif /* UIP_DS6_ROUTE_TRIE */
   {
     struct uip_ds6_route_neighbor_routes *routes;
     /* If there is no routing entry, create one. We first need to
@@ -353,9 +579,20 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
       uip_ds6_route_t *oldest;
       oldest = NULL;
 #if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+#if UIP_DS6_ROUTE_TRIE
+      /* Lookups do not reorder the route list when the trie is in
+         use, so search for the route with the oldest use stamp. */
+      for(r = list_head(routelist); r != NULL; r = list_item_next(r)) {
+        if(oldest == NULL ||
+           (int32_t)(r->last_used - oldest->last_used) < 0) {
+          oldest = r;
+        }
+      }
+#else /* UIP_DS6_ROUTE_TRIE */
       /* Removing the oldest route entry from the route table. The
          least recently used route is the first route on the list. */
       oldest = list_tail(routelist);
+#endif /* UIP_DS6_ROUTE_TRIE */
 #endif
       if(oldest == NULL) {
         return NULL;
@@ -437,6 +674,19 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
 
+#if UIP_DS6_ROUTE_TRIE
+#if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  r->last_used = ++route_use_counter;
+#endif /* UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
+  if(!trie_insert(r)) {
+    /* This should not happen, as the trie memory block is sized for
+       the worst case of the route table. */
+    PRINTF("uip_ds6_route_add: could not allocate route trie node\n");
+    uip_ds6_route_rm(r);
+    return NULL;
+  }
+#endif /* UIP_DS6_ROUTE_TRIE */
+
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
 #endif
@@ -479,6 +729,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_TRIE
+    trie_remove(route);
+#endif /* UIP_DS6_ROUTE_TRIE */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
@@ -88,6 +88,18 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define UIP_DS6_ROUTE_NB 4
 #endif /* UIP_CONF_MAX_ROUTES */
 
+/* Index the routing table with a path-compressed binary trie so that
+   uip_ds6_route_lookup() costs O(prefix length) instead of a scan of
+   the whole route list. Meant for storing-mode RPL roots that hold
+   many downward routes; each route costs up to two trie nodes. Unlike
+   the list scan, which compares prefixes in whole bytes, the trie
+   matches prefixes bit by bit. */
+#ifdef UIP_DS6_ROUTE_CONF_TRIE
+#define UIP_DS6_ROUTE_TRIE UIP_DS6_ROUTE_CONF_TRIE
+#else /* UIP_DS6_ROUTE_CONF_TRIE */
+#define UIP_DS6_ROUTE_TRIE 0
+#endif /* UIP_DS6_ROUTE_CONF_TRIE */
+
 /** \brief define some additional RPL related route state and
  *  neighbor callback for RPL - if not a DS6_ROUTE_STATE is already set */
 #ifndef UIP_DS6_ROUTE_STATE_TYPE
@@ -156,6 +168,11 @@ typedef struct uip_ds6_route {
   uip_ipaddr_t ipaddr;
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   UIP_DS6_ROUTE_STATE_TYPE state;
+#endif
+#if UIP_DS6_ROUTE_TRIE && UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  /* With the trie, lookups do not reorder the route list; the least
+     recently used route is found through this stamp instead. */
+  uint32_t last_used;
 #endif
   uint8_t length;
 } uip_ds6_route_t;
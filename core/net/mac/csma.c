@@ -40,6 +40,7 @@
 #include "net/mac/csma.h"
 #include "net/packetbuf.h"
 #include "net/queuebuf.h"
+#include "net/nbr-table.h"
 
 #include "sys/ctimer.h"
 #include "sys/clock.h"
@@ -98,6 +99,9 @@ struct qbuf_metadata {
   mac_callback_t sent;
   void *cptr;
   uint8_t max_transmissions;
+#if CSMA_STATS
+  clock_time_t queued_at;
+#endif /* CSMA_STATS */
 };
 
 /* Every neighbor has its own packet queue */
@@ -107,9 +111,24 @@ struct neighbor_queue {
   struct ctimer transmit_timer;
   uint8_t transmissions;
   uint8_t collisions;
+#if CSMA_WITH_NBR_TABLE
+  /* The neighbor table entry, or NULL if the queue is not indexed */
+  struct csma_neighbor *nbr;
+#endif /* CSMA_WITH_NBR_TABLE */
   LIST_STRUCT(queued_packet_list);
 };
 
+#if CSMA_WITH_NBR_TABLE
+/* The neighbor table entry of a neighbor with a queue */
+struct csma_neighbor {
+#if CSMA_STATS
+  /* First, so that the statistics and the entry share their address */
+  struct csma_neighbor_stats stats;
+#endif /* CSMA_STATS */
+  struct neighbor_queue *queue;
+};
+#endif /* CSMA_WITH_NBR_TABLE */
+
 /* The maximum number of co-existing neighbor queues */
 #ifdef CSMA_CONF_MAX_NEIGHBOR_QUEUES
 #define CSMA_MAX_NEIGHBOR_QUEUES CSMA_CONF_MAX_NEIGHBOR_QUEUES
@@ -130,13 +149,41 @@ MEMB(packet_memb, struct rdc_buf_list, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
 LIST(neighbor_list);
 
+#if CSMA_WITH_NBR_TABLE
+NBR_TABLE(struct csma_neighbor, csma_neighbors);
+/* The number of queues that are not in the neighbor table, such as the
+   broadcast queue. Only these are looked for in neighbor_list. */
+static uint8_t unindexed_queues;
+#endif /* CSMA_WITH_NBR_TABLE */
+
+#if CSMA_BURST
+/* The queue that a burst is being sent from, and the status of its
+   latest transmission */
+static struct neighbor_queue *burst_queue;
+static int burst_status;
+#endif /* CSMA_BURST */
+
 static void packet_sent(void *ptr, int status, int num_transmissions);
 static void transmit_packet_list(void *ptr);
+static void schedule_transmission(struct neighbor_queue *n);
 /*---------------------------------------------------------------------------*/
 static struct neighbor_queue *
 neighbor_queue_from_addr(const linkaddr_t *addr)
 {
-  struct neighbor_queue *n = list_head(neighbor_list);
+  struct neighbor_queue *n;
+#if CSMA_WITH_NBR_TABLE
+  struct csma_neighbor *nbr;
+
+  nbr = nbr_table_get_from_lladdr(csma_neighbors, addr);
+  if(nbr != NULL && nbr->queue != NULL) {
+    return nbr->queue;
+  }
+  if(unindexed_queues == 0) {
+    return NULL;
+  }
+#endif /* CSMA_WITH_NBR_TABLE */
+
+  n = list_head(neighbor_list);
   while(n != NULL) {
     if(linkaddr_cmp(&n->addr, addr)) {
       return n;
@@ -146,6 +193,110 @@ neighbor_queue_from_addr(const linkaddr_t *addr)
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+#if CSMA_WITH_NBR_TABLE
+static void
+index_neighbor_queue(struct neighbor_queue *n)
+{
+  struct csma_neighbor *nbr;
+
+  nbr = NULL;
+  if(!linkaddr_cmp(&n->addr, &linkaddr_null)) {
+    nbr = nbr_table_get_from_lladdr(csma_neighbors, &n->addr);
+    if(nbr == NULL) {
+      nbr = nbr_table_add_lladdr(csma_neighbors, &n->addr,
+                                 NBR_TABLE_REASON_MAC, NULL);
+    }
+  }
+
+  n->nbr = nbr;
+  if(nbr != NULL) {
+    nbr->queue = n;
+    /* Keep the entry for as long as there is a queue */
+    nbr_table_lock(csma_neighbors, nbr);
+  } else {
+    unindexed_queues++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Called when a neighbor is removed from the neighbor table */
+static void
+neighbor_removed(void *item)
+{
+  struct csma_neighbor *nbr = item;
+
+  if(nbr->queue != NULL) {
+    /* Locked neighbors are not evicted, but nbr_table_update_lladdr()
+       may remove one. The queue is then found in neighbor_list. */
+    nbr->queue->nbr = NULL;
+    unindexed_queues++;
+  }
+}
+#endif /* CSMA_WITH_NBR_TABLE */
+/*---------------------------------------------------------------------------*/
+static void
+free_neighbor_queue(struct neighbor_queue *n)
+{
+#if CSMA_WITH_NBR_TABLE
+  if(n->nbr != NULL) {
+    n->nbr->queue = NULL;
+#if CSMA_STATS
+    /* Keep the statistics, but let the entry go if room is needed */
+    nbr_table_unlock(csma_neighbors, n->nbr);
+#else /* CSMA_STATS */
+    nbr_table_remove(csma_neighbors, n->nbr);
+#endif /* CSMA_STATS */
+  } else {
+    unindexed_queues--;
+  }
+#endif /* CSMA_WITH_NBR_TABLE */
+#if CSMA_BURST
+  if(burst_queue == n) {
+    burst_queue = NULL;
+  }
+#endif /* CSMA_BURST */
+  list_remove(neighbor_list, n);
+  memb_free(&neighbor_memb, n);
+}
+/*---------------------------------------------------------------------------*/
+#if CSMA_STATS
+static struct csma_neighbor_stats *
+neighbor_stats(const linkaddr_t *addr)
+{
+  struct csma_neighbor *nbr;
+
+  nbr = nbr_table_get_from_lladdr(csma_neighbors, addr);
+  return nbr != NULL ? &nbr->stats : NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+stats_packet_done(struct neighbor_queue *n, struct qbuf_metadata *metadata,
+                  int status, uint8_t ntx)
+{
+  struct csma_neighbor_stats *stats;
+  clock_time_t delay;
+
+  if(n->nbr == NULL) {
+    return;
+  }
+  stats = &n->nbr->stats;
+
+  stats->queue_len--;
+  if(status == MAC_TX_OK) {
+    stats->sent++;
+  } else {
+    stats->failed++;
+  }
+  if(ntx > 1) {
+    stats->retransmissions += ntx - 1;
+  }
+  delay = clock_time() - metadata->queued_at;
+  stats->total_delay += delay;
+  if(delay > stats->max_delay) {
+    stats->max_delay = delay;
+  }
+}
+#endif /* CSMA_STATS */
+/*---------------------------------------------------------------------------*/
 static clock_time_t
 backoff_period(void)
 {
@@ -163,6 +314,54 @@ backoff_period(void)
   return time;
 }
 /*---------------------------------------------------------------------------*/
+#if CSMA_BURST
+/* Set the frame pending bit on all but the last of the first len
+   packets in a queue */
+static void
+mark_burst(struct rdc_buf_list *q, uint8_t len)
+{
+  for(; q != NULL && len > 0; q = list_item_next(q), len--) {
+    queuebuf_set_attr(q->buf, PACKETBUF_ATTR_PENDING,
+                      len > 1 && list_item_next(q) != NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_burst(struct neighbor_queue *n)
+{
+  uint8_t sent;
+
+  /* Most RDC layers send only the first packet of the list, so they
+     are given the rest of the burst one packet at a time */
+  burst_queue = n;
+  for(sent = 0; sent < CSMA_BURST_MAX; sent++) {
+    mark_burst(list_head(n->queued_packet_list), CSMA_BURST_MAX - sent);
+    /* Stays deferred if the RDC layer does not call back before returning */
+    burst_status = MAC_TX_DEFERRED;
+    NETSTACK_RDC.send_list(packet_sent, n, list_head(n->queued_packet_list));
+    if(burst_queue != n || burst_status != MAC_TX_OK ||
+       list_head(n->queued_packet_list) == NULL) {
+      break;
+    }
+  }
+
+  if(burst_queue != n) {
+    /* All packets were sent, and the queue was freed */
+    return;
+  }
+  burst_queue = NULL;
+
+  /* Back off before the next burst. A packet that was not acknowledged
+     has already been scheduled for retransmission, and one that was
+     deferred will be called back for later. */
+  if(burst_status != MAC_TX_DEFERRED &&
+     list_head(n->queued_packet_list) != NULL &&
+     ctimer_expired(&n->transmit_timer)) {
+    schedule_transmission(n);
+  }
+}
+#endif /* CSMA_BURST */
+/*---------------------------------------------------------------------------*/
 static void
 transmit_packet_list(void *ptr)
 {
@@ -172,8 +371,12 @@ transmit_packet_list(void *ptr)
     if(q != NULL) {
       PRINTF("csma: preparing number %d %p, queue len %d\n", n->transmissions, q,
           list_length(n->queued_packet_list));
+#if CSMA_BURST
+      send_burst(n);
+#else /* CSMA_BURST */
       /* Send packets in the neighbor's list */
       NETSTACK_RDC.send_list(packet_sent, n, q);
+#endif /* CSMA_BURST */
     }
   }
 }
@@ -214,13 +417,18 @@ free_packet(struct neighbor_queue *n, struct rdc_buf_list *p, int status)
       /* There is a next packet. We reset current tx information */
       n->transmissions = 0;
       n->collisions = CSMA_MIN_BE;
-      /* Schedule next transmissions */
-      schedule_transmission(n);
+      /* Schedule next transmissions, unless the packet was sent in a
+         burst, which goes on with the next packet */
+#if CSMA_BURST
+      if(n != burst_queue)
+#endif /* CSMA_BURST */
+      {
+        schedule_transmission(n);
+      }
     } else {
       /* This was the last packet in the queue, we free the neighbor */
       ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
-      memb_free(&neighbor_memb, n);
+      free_neighbor_queue(n);
     }
   }
 }
@@ -252,6 +460,10 @@ tx_done(int status, struct rdc_buf_list *q, struct neighbor_queue *n)
     break;
   }
 
+#if CSMA_STATS
+  stats_packet_done(n, metadata, status, ntx);
+#endif /* CSMA_STATS */
+
   free_packet(n, q, status);
   mac_call_sent_callback(sent, cptr, status, ntx);
 }
@@ -344,6 +556,12 @@ packet_sent(void *ptr, int status, int num_transmissions)
     return;
   }
 
+#if CSMA_BURST
+  if(n == burst_queue) {
+    burst_status = status;
+  }
+#endif /* CSMA_BURST */
+
   switch(status) {
   case MAC_TX_OK:
     tx_ok(q, n, num_transmissions);
@@ -367,6 +585,9 @@ send_packet(mac_callback_t sent, void *ptr)
 {
   struct rdc_buf_list *q;
   struct neighbor_queue *n;
+#if CSMA_STATS
+  struct csma_neighbor_stats *stats;
+#endif /* CSMA_STATS */
   static uint8_t initialized = 0;
   static uint16_t seqno;
   const linkaddr_t *addr = packetbuf_addr(PACKETBUF_ADDR_RECEIVER);
@@ -398,6 +619,9 @@ send_packet(mac_callback_t sent, void *ptr)
       LIST_STRUCT_INIT(n, queued_packet_list);
       /* Add neighbor to the list */
       list_add(neighbor_list, n);
+#if CSMA_WITH_NBR_TABLE
+      index_neighbor_queue(n);
+#endif /* CSMA_WITH_NBR_TABLE */
     }
   }
 
@@ -421,6 +645,16 @@ send_packet(mac_callback_t sent, void *ptr)
             }
             metadata->sent = sent;
             metadata->cptr = ptr;
+#if CSMA_STATS
+            metadata->queued_at = clock_time();
+            if(n->nbr != NULL) {
+              stats = &n->nbr->stats;
+              stats->queue_len++;
+              if(stats->queue_len > stats->max_queue_len) {
+                stats->max_queue_len = stats->queue_len;
+              }
+            }
+#endif /* CSMA_STATS */
 #if PACKETBUF_WITH_PACKET_TYPE
             if(packetbuf_attr(PACKETBUF_ATTR_PACKET_TYPE) ==
                PACKETBUF_ATTR_PACKET_TYPE_ACK) {
@@ -447,8 +681,7 @@ send_packet(mac_callback_t sent, void *ptr)
       }
       /* The packet allocation failed. Remove and free neighbor entry if empty. */
       if(list_length(n->queued_packet_list) == 0) {
-        list_remove(neighbor_list, n);
-        memb_free(&neighbor_memb, n);
+        free_neighbor_queue(n);
       }
     } else {
       PRINTF("csma: Neighbor queue full\n");
@@ -457,6 +690,12 @@ send_packet(mac_callback_t sent, void *ptr)
   } else {
     PRINTF("csma: could not allocate neighbor, dropping packet\n");
   }
+#if CSMA_STATS
+  stats = neighbor_stats(addr);
+  if(stats != NULL) {
+    stats->dropped++;
+  }
+#endif /* CSMA_STATS */
   mac_call_sent_callback(sent, ptr, MAC_TX_ERR, 1);
 }
 /*---------------------------------------------------------------------------*/
@@ -493,6 +732,56 @@ init(void)
   memb_init(&packet_memb);
   memb_init(&metadata_memb);
   memb_init(&neighbor_memb);
+#if CSMA_WITH_NBR_TABLE
+  nbr_table_register(csma_neighbors, neighbor_removed);
+#endif /* CSMA_WITH_NBR_TABLE */
+}
+/*---------------------------------------------------------------------------*/
+const struct csma_neighbor_stats *
+csma_stats_head(void)
+{
+#if CSMA_STATS
+  return nbr_table_head(csma_neighbors);
+#else /* CSMA_STATS */
+  return NULL;
+#endif /* CSMA_STATS */
+}
+/*---------------------------------------------------------------------------*/
+const struct csma_neighbor_stats *
+csma_stats_next(const struct csma_neighbor_stats *s)
+{
+#if CSMA_STATS
+  return nbr_table_next(csma_neighbors, (nbr_table_item_t *)s);
+#else /* CSMA_STATS */
+  return NULL;
+#endif /* CSMA_STATS */
+}
+/*---------------------------------------------------------------------------*/
+const linkaddr_t *
+csma_stats_addr(const struct csma_neighbor_stats *s)
+{
+#if CSMA_STATS
+  return nbr_table_get_lladdr(csma_neighbors, s);
+#else /* CSMA_STATS */
+  return NULL;
+#endif /* CSMA_STATS */
+}
+/*---------------------------------------------------------------------------*/
+void
+csma_stats_reset(void)
+{
+#if CSMA_STATS
+  struct csma_neighbor *nbr;
+  uint16_t queue_len;
+
+  for(nbr = nbr_table_head(csma_neighbors); nbr != NULL;
+      nbr = nbr_table_next(csma_neighbors, nbr)) {
+    queue_len = nbr->stats.queue_len;
+    memset(&nbr->stats, 0, sizeof(nbr->stats));
+    nbr->stats.queue_len = queue_len;
+    nbr->stats.max_queue_len = queue_len;
+  }
+#endif /* CSMA_STATS */
 }
 /*---------------------------------------------------------------------------*/
 const struct mac_driver csma_driver = {
@@ -42,10 +42,102 @@
 #define CSMA_H_
 
 #include "net/mac/mac.h"
+#include "net/linkaddr.h"
 #include "dev/radio.h"
+#include "sys/clock.h"
+
+/* Keep per-neighbor queue statistics: queue length, queueing delay,
+ * retransmissions and drops. They are kept in the neighbor table, and
+ * last as long as the neighbor stays in it. */
+#ifdef CSMA_CONF_STATS
+#define CSMA_STATS CSMA_CONF_STATS
+#else /* CSMA_CONF_STATS */
+#define CSMA_STATS 0
+#endif /* CSMA_CONF_STATS */
+
+/* Index the neighbor queues by their neighbor table entry, instead of
+ * scanning all queues on every send and transmission callback. With
+ * NBR_TABLE_CONF_WITH_HASH, a queue is found in constant time. */
+#ifdef CSMA_CONF_WITH_NBR_TABLE
+#define CSMA_WITH_NBR_TABLE CSMA_CONF_WITH_NBR_TABLE
+#else /* CSMA_CONF_WITH_NBR_TABLE */
+#define CSMA_WITH_NBR_TABLE CSMA_STATS
+#endif /* CSMA_CONF_WITH_NBR_TABLE */
+
+#if CSMA_STATS && !CSMA_WITH_NBR_TABLE
+#error CSMA_CONF_STATS requires CSMA_CONF_WITH_NBR_TABLE
+#endif
+
+/* Send the packets queued for a neighbor in bursts, back to back after
+ * a single backoff, with the frame pending bit set on all but the last
+ * frame of a burst. Meant for always-on links, where the per-packet
+ * backoff wastes channel time. A burst ends early when a frame is not
+ * acknowledged. */
+#ifdef CSMA_CONF_BURST
+#define CSMA_BURST CSMA_CONF_BURST
+#else /* CSMA_CONF_BURST */
+#define CSMA_BURST 0
+#endif /* CSMA_CONF_BURST */
+
+/* The largest number of packets in a burst. RDC layers that send the
+ * whole list they are given, such as nullrdc, may send more. */
+#ifdef CSMA_CONF_BURST_MAX
+#define CSMA_BURST_MAX CSMA_CONF_BURST_MAX
+#else /* CSMA_CONF_BURST_MAX */
+#define CSMA_BURST_MAX 8
+#endif /* CSMA_CONF_BURST_MAX */
+
+/* Queue statistics of a neighbor. Broadcasts are not counted. */
+struct csma_neighbor_stats {
+  /* Packets in the queue now, and at most */
+  uint16_t queue_len;
+  uint16_t max_queue_len;
+  /* Packets sent and acknowledged */
+  uint32_t sent;
+  /* Packets given up on after the last transmission attempt */
+  uint32_t failed;
+  /* Packets dropped because there was no room in the queue */
+  uint32_t dropped;
+  /* Transmissions beyond the first one, of all packets */
+  uint32_t retransmissions;
+  /* Time from queueing to the end of the last transmission, in clock
+     ticks, in total and at most */
+  uint32_t total_delay;
+  clock_time_t max_delay;
+};
 
 extern const struct mac_driver csma_driver;
 
 const struct mac_driver *csma_init(const struct mac_driver *r);
 
+/**
+ * \brief      Get the statistics of the first neighbor.
+ * \return     The statistics, or NULL if there are none
+ *
+ *             Loop through the neighbors with csma_stats_next(). Without
+ *             CSMA_CONF_STATS, there are no statistics.
+ */
+const struct csma_neighbor_stats *csma_stats_head(void);
+
+/**
+ * \brief      Get the statistics of the next neighbor.
+ * \param s    The statistics of the current neighbor
+ * \return     The statistics, or NULL if there are no more
+ */
+const struct csma_neighbor_stats *csma_stats_next(const struct csma_neighbor_stats *s);
+
+/**
+ * \brief      Get the address of the neighbor of some statistics.
+ * \param s    The statistics
+ * \return     The link-layer address of the neighbor
+ */
+const linkaddr_t *csma_stats_addr(const struct csma_neighbor_stats *s);
+
+/**
+ * \brief      Clear the statistics of all neighbors.
+ *
+ *             The current queue lengths are kept.
+ */
+void csma_stats_reset(void);
+
 #endif /* CSMA_H_ */
@@ -69,7 +69,7 @@
 #endif
 
 /* We have as many packets are there are queuebuf in the system */
-MEMB(packet_memb, struct tsch_packet, QUEUEBUF_NUM);
+MEMB_FREELIST(packet_memb, struct tsch_packet, QUEUEBUF_NUM);
 MEMB(neighbor_memb, struct tsch_neighbor, TSCH_QUEUE_MAX_NEIGHBOR_QUEUES);
 LIST(neighbor_list);
 
@@ -69,6 +69,93 @@ MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_WITH_INDEX
+/* All links, grouped by slotframe and sorted by timeslot within each
+ * slotframe. Each slotframe knows where its group starts. */
+static struct tsch_link *link_index[TSCH_SCHEDULE_MAX_LINKS];
+static uint16_t link_index_len;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
+
+#if TSCH_SCHEDULE_STATS
+struct tsch_schedule_stats tsch_schedule_stats;
+#endif /* TSCH_SCHEDULE_STATS */
+
+#if TSCH_SCHEDULE_WITH_INDEX
+/*---------------------------------------------------------------------------*/
+/* Returns the position in the index of the first link of a slotframe
+ * with a timeslot after the given one (or the end of its group) */
+static uint16_t
+index_search(struct tsch_slotframe *sf, uint16_t timeslot)
+{
+  uint16_t lo = sf->index_start;
+  uint16_t hi = sf->index_start + sf->index_count;
+  uint16_t mid;
+
+  while(lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    if(link_index[mid]->timeslot > timeslot) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+/*---------------------------------------------------------------------------*/
+/* Adds a link to the index. Call with the lock taken. */
+static void
+index_add(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  struct tsch_slotframe *other;
+  uint16_t end = sf->index_start + sf->index_count;
+  uint16_t pos = index_search(sf, l->timeslot);
+
+  memmove(&link_index[pos + 1], &link_index[pos],
+          (link_index_len - pos) * sizeof(link_index[0]));
+  link_index[pos] = l;
+  link_index_len++;
+  sf->index_count++;
+
+  /* Move up the groups of the slotframes that follow */
+  for(other = list_head(slotframe_list); other != NULL;
+      other = list_item_next(other)) {
+    if(other != sf && other->index_start >= end) {
+      other->index_start++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Removes a link from the index. Call with the lock taken. */
+static void
+index_remove(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  struct tsch_slotframe *other;
+  uint16_t end = sf->index_start + sf->index_count;
+  uint16_t pos;
+
+  for(pos = sf->index_start; pos < end; pos++) {
+    if(link_index[pos] == l) {
+      break;
+    }
+  }
+  if(pos == end) {
+    return;
+  }
+
+  memmove(&link_index[pos], &link_index[pos + 1],
+          (link_index_len - pos - 1) * sizeof(link_index[0]));
+  link_index_len--;
+  sf->index_count--;
+
+  for(other = list_head(slotframe_list); other != NULL;
+      other = list_item_next(other)) {
+    if(other != sf && other->index_start >= end) {
+      other->index_start--;
+    }
+  }
+}
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
+
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -89,6 +176,10 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
       sf->handle = handle;
       TSCH_ASN_DIVISOR_INIT(sf->size, size);
       LIST_STRUCT_INIT(sf, links_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+      sf->index_start = link_index_len;
+      sf->index_count = 0;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       /* Add the slotframe to the global list */
       list_add(slotframe_list, sf);
     }
@@ -209,6 +300,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
           address = &linkaddr_null;
         }
         linkaddr_copy(&l->addr, address);
+#if TSCH_SCHEDULE_WITH_INDEX
+        index_add(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
 
         PRINTF("TSCH-schedule: add_link %u %u %u %u %u %u\n",
                slotframe->handle, link_options, link_type, timeslot, channel_offset, TSCH_LOG_ID_FROM_LINKADDR(address));
@@ -256,6 +350,9 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
              TSCH_LOG_ID_FROM_LINKADDR(&l->addr));
 
       list_remove(slotframe->links_list, l);
+#if TSCH_SCHEDULE_WITH_INDEX
+      index_remove(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       memb_free(&link_memb, l);
 
       /* Release the lock before we update the neighbor (will take the lock) */
@@ -319,13 +416,29 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
   turns out useless when the time comes. For instance, for a Tx-only link, if there is
   no outgoing packet in queue. In that case, run the backup link instead. The backup link
   must have Rx flag set. */
+#if TSCH_SCHEDULE_STATS
+  rtimer_clock_t start = RTIMER_NOW();
+#endif /* TSCH_SCHEDULE_STATS */
   if(!tsch_is_locked()) {
     struct tsch_slotframe *sf = list_head(slotframe_list);
     /* For each slotframe, look for the earliest occurring link */
     while(sf != NULL) {
       /* Get timeslot from ASN, given the slotframe length */
       uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+#if TSCH_SCHEDULE_WITH_INDEX
+      /* Only the first link after the current timeslot, or else the
+       * first link of the slotframe, can be the earliest one */
+      struct tsch_link *l = NULL;
+      if(sf->index_count > 0) {
+        uint16_t pos = index_search(sf, timeslot);
+        if(pos == sf->index_start + sf->index_count) {
+          pos = sf->index_start;
+        }
+        l = link_index[pos];
+      }
+#else /* TSCH_SCHEDULE_WITH_INDEX */
       struct tsch_link *l = list_head(sf->links_list);
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       while(l != NULL) {
         uint16_t time_to_timeslot =
           l->timeslot > timeslot ?
@@ -369,7 +482,11 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
           }
         }
 
+#if TSCH_SCHEDULE_WITH_INDEX
+        l = NULL;
+#else /* TSCH_SCHEDULE_WITH_INDEX */
         l = list_item_next(l);
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       }
       sf = list_item_next(sf);
     }
@@ -380,6 +497,13 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
   if(backup_link != NULL) {
     *backup_link = curr_backup;
   }
+#if TSCH_SCHEDULE_STATS
+  tsch_schedule_stats.lookups++;
+  start = RTIMER_NOW() - start;
+  if(start > tsch_schedule_stats.lookup_max) {
+    tsch_schedule_stats.lookup_max = start;
+  }
+#endif /* TSCH_SCHEDULE_STATS */
   return curr_best;
 }
 /*---------------------------------------------------------------------------*/
@@ -391,6 +515,9 @@ tsch_schedule_init(void)
     memb_init(&link_memb);
     memb_init(&slotframe_memb);
     list_init(slotframe_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+    link_index_len = 0;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
     tsch_release_lock();
     return 1;
   } else {
@@ -443,6 +570,11 @@ tsch_schedule_print(void)
     }
 
     printf("Schedule: end of slotframe list\n");
+#if TSCH_SCHEDULE_STATS
+    printf("Schedule: %lu lookups, longest %u rtimer ticks\n",
+           (unsigned long)tsch_schedule_stats.lookups,
+           (unsigned)tsch_schedule_stats.lookup_max);
+#endif /* TSCH_SCHEDULE_STATS */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -72,6 +72,23 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Keep the links of each slotframe in an array sorted by timeslot, so
+ * that the next active link is found with a binary search instead of
+ * a scan of all links. The array is updated when links are added or
+ * removed. */
+#ifdef TSCH_SCHEDULE_CONF_WITH_INDEX
+#define TSCH_SCHEDULE_WITH_INDEX TSCH_SCHEDULE_CONF_WITH_INDEX
+#else
+#define TSCH_SCHEDULE_WITH_INDEX 0
+#endif
+
+/* Measure the time taken by tsch_schedule_get_next_active_link() */
+#ifdef TSCH_SCHEDULE_CONF_STATS
+#define TSCH_SCHEDULE_STATS TSCH_SCHEDULE_CONF_STATS
+#else
+#define TSCH_SCHEDULE_STATS 0
+#endif
+
 /********** Constants *********/
 
 /* Link options */
@@ -122,8 +139,24 @@ struct tsch_slotframe {
   struct tsch_asn_divisor_t size;
   /* List of links belonging to this slotframe */
   LIST_STRUCT(links_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+  /* Position and number of the links of this slotframe in the index */
+  uint16_t index_start;
+  uint16_t index_count;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
+};
+
+#if TSCH_SCHEDULE_STATS
+struct tsch_schedule_stats {
+  /* Number of calls to tsch_schedule_get_next_active_link() */
+  uint32_t lookups;
+  /* Longest time taken by a call, in rtimer ticks */
+  rtimer_clock_t lookup_max;
 };
 
+extern struct tsch_schedule_stats tsch_schedule_stats;
+#endif /* TSCH_SCHEDULE_STATS */
+
 /********** Functions *********/
 
 /* Module initialization, call only once at startup. Returns 1 is success, 0 if failure. */
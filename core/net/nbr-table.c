@@ -83,6 +83,24 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_WITH_HASH
+#if NBR_TABLE_HASH_SIZE & (NBR_TABLE_HASH_SIZE - 1)
+#error "NBR_TABLE_HASH_SIZE must be a power of two"
+#endif
+#if NBR_TABLE_HASH_SIZE <= NBR_TABLE_MAX_NEIGHBORS
+#error "NBR_TABLE_HASH_SIZE must be larger than NBR_TABLE_MAX_NEIGHBORS"
+#endif
+/* Hash slots hold the neighbor index plus one, zero marks a free slot.
+ * Collisions are resolved by linear probing. */
+#if NBR_TABLE_MAX_NEIGHBORS < 255
+typedef uint8_t nbr_hash_slot_t;
+#else
+typedef uint16_t nbr_hash_slot_t;
+#endif
+static nbr_hash_slot_t hash_slots[NBR_TABLE_HASH_SIZE];
+#define HASH_MASK (NBR_TABLE_HASH_SIZE - 1)
+#endif /* NBR_TABLE_WITH_HASH */
+
 /*---------------------------------------------------------------------------*/
 /* Get a key from a neighbor index */
 static nbr_table_key_t *
@@ -126,16 +144,93 @@ key_from_item(nbr_table_t *table, const nbr_table_item_t *item)
   return key_from_index(index_from_item(table, item));
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_WITH_HASH
+/* 32-bit FNV-1a, which spreads addresses that differ only in their
+ * last bytes over the whole table */
+static unsigned
+hash_lladdr(const linkaddr_t *lladdr)
+{
+  uint32_t h;
+  int i;
+
+  h = 2166136261UL;
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h = (h ^ lladdr->u8[i]) * 16777619UL;
+  }
+  return (unsigned)h & HASH_MASK;
+}
+/*---------------------------------------------------------------------------*/
+/* Add a neighbor to the hash index. The index can never be full, as it
+ * has more slots than there are neighbors. */
+static void
+hash_insert(int index)
+{
+  unsigned slot;
+
+  slot = hash_lladdr(&key_from_index(index)->lladdr);
+  while(hash_slots[slot] != 0) {
+    slot = (slot + 1) & HASH_MASK;
+  }
+  hash_slots[slot] = index + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a neighbor from the hash index. Must be called before the
+ * link-layer address of the neighbor is changed. */
+static void
+hash_remove(int index)
+{
+  unsigned i, j, k;
+
+  i = hash_lladdr(&key_from_index(index)->lladdr);
+  while(hash_slots[i] != index + 1) {
+    if(hash_slots[i] == 0) {
+      return;
+    }
+    i = (i + 1) & HASH_MASK;
+  }
+
+  /* Shift back the following entries of the probe sequence that would
+   * no longer be reachable from their home slot, so that no tombstones
+   * are needed. */
+  j = i;
+  for(;;) {
+    j = (j + 1) & HASH_MASK;
+    if(hash_slots[j] == 0) {
+      break;
+    }
+    k = hash_lladdr(&key_from_index(hash_slots[j] - 1)->lladdr);
+    if(((j - k) & HASH_MASK) >= ((j - i) & HASH_MASK)) {
+      hash_slots[i] = hash_slots[j];
+      i = j;
+    }
+  }
+  hash_slots[i] = 0;
+}
+#endif /* NBR_TABLE_WITH_HASH */
+/*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
   nbr_table_key_t *key;
+#if NBR_TABLE_WITH_HASH
+  unsigned slot;
+#endif /* NBR_TABLE_WITH_HASH */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_WITH_HASH
+  slot = hash_lladdr(lladdr);
+  while(hash_slots[slot] != 0) {
+    key = key_from_index(hash_slots[slot] - 1);
+    if(linkaddr_cmp(lladdr, &key->lladdr)) {
+      return hash_slots[slot] - 1;
+    }
+    slot = (slot + 1) & HASH_MASK;
+  }
+#else /* NBR_TABLE_WITH_HASH */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -143,6 +238,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     }
     key = list_item_next(key);
   }
+#endif /* NBR_TABLE_WITH_HASH */
   return -1;
 }
 /*---------------------------------------------------------------------------*/
@@ -193,6 +289,9 @@ remove_key(nbr_table_key_t *least_used_key)
   }
   /* Empty used map */
   used_map[index_from_key(least_used_key)] = 0;
+#if NBR_TABLE_WITH_HASH
+  hash_remove(index_from_key(least_used_key));
+#endif /* NBR_TABLE_WITH_HASH */
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, least_used_key);
 }
@@ -359,6 +458,9 @@ nbr_table_add_lladdr(nbr_table_t *table, const linkaddr_t *lladdr, nbr_table_rea
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_WITH_HASH
+    hash_insert(index);
+#endif /* NBR_TABLE_WITH_HASH */
   }
 
   /* Get item in the current table */
@@ -446,11 +548,17 @@ nbr_table_update_lladdr(const linkaddr_t *old_addr, const linkaddr_t *new_addr,
     return 0;
   }
   key = key_from_index(index);
+#if NBR_TABLE_WITH_HASH
+  hash_remove(index);
+#endif /* NBR_TABLE_WITH_HASH */
   /**
    * Copy the new lladdr into the key - since we know that there is no
    * conflicting entry.
    */
   memcpy(&key->lladdr, new_addr, sizeof(linkaddr_t));
+#if NBR_TABLE_WITH_HASH
+  hash_insert(index);
+#endif /* NBR_TABLE_WITH_HASH */
   return 1;
 }
 /*---------------------------------------------------------------------------*/
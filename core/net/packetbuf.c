@@ -46,6 +46,7 @@
 
 #include "contiki-net.h"
 #include "net/packetbuf.h"
+#include "net/queuebuf.h"
 #include "net/rime/rime.h"
 #include "sys/cc.h"
 
@@ -56,12 +57,41 @@ struct packetbuf_addr packetbuf_addrs[PACKETBUF_NUM_ADDRS];
 static uint16_t buflen, bufptr;
 static uint8_t hdrlen;
 
+#if PACKETBUF_HEADROOM
+/* Offset of the header in the packet buffer: the headroom that is
+   still free in front of it */
+static uint8_t hdrstart;
+#define HDRSTART hdrstart
+#else /* PACKETBUF_HEADROOM */
+#define HDRSTART 0
+#endif /* PACKETBUF_HEADROOM */
+
+#if PACKETBUF_STATS
+struct packetbuf_stats packetbuf_stats;
+#define STATS_ADD(field, len) do {              \
+    packetbuf_stats.field++;                    \
+    packetbuf_stats.bytes += (len);             \
+  } while(0)
+#else /* PACKETBUF_STATS */
+#define STATS_ADD(field, len)
+#endif /* PACKETBUF_STATS */
+
+#if QUEUEBUF_SHARE
+/* The block that holds the packet, which queuebufs may share, and the
+   block to continue in when the packetbuf leaves a shared block. A
+   shared block always has a spare. */
+static struct packetbuf_block first_block = { NULL, 1 };
+static struct packetbuf_block *block = &first_block;
+static struct packetbuf_block *spare;
+static uint8_t *packetbuf = (uint8_t *)first_block.data;
+#else /* QUEUEBUF_SHARE */
 /* The declarations below ensure that the packet buffer is aligned on
    an even 32-bit boundary. On some platforms (most notably the
    msp430 or OpenRISC), having a potentially misaligned packet buffer may lead to
    problems when accessing words. */
-static uint32_t packetbuf_aligned[(PACKETBUF_SIZE + 3) / 4];
+static uint32_t packetbuf_aligned[(PACKETBUF_HEADROOM + PACKETBUF_SIZE + 3) / 4];
 static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
+#endif /* QUEUEBUF_SHARE */
 
 #define DEBUG 0
 #if DEBUG
@@ -71,12 +101,40 @@ static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
 #define PRINTF(...)
 #endif
 
+/*---------------------------------------------------------------------------*/
+#if QUEUEBUF_SHARE
+/* Leaves the block to the queuebufs that share it and continues in the
+   spare block, with a copy of the packet if keep is set */
+static void
+unshare(int keep)
+{
+  if(block->refs > 1) {
+    if(keep) {
+      memcpy((uint8_t *)spare->data + HDRSTART, packetbuf + HDRSTART,
+             packetbuf_totlen());
+      STATS_ADD(moves, packetbuf_totlen());
+    }
+    block->refs--;
+    block = spare;
+    block->refs = 1;
+    spare = NULL;
+    packetbuf = (uint8_t *)block->data;
+  }
+}
+#define UNSHARE(keep) unshare(keep)
+#else /* QUEUEBUF_SHARE */
+#define UNSHARE(keep)
+#endif /* QUEUEBUF_SHARE */
 /*---------------------------------------------------------------------------*/
 void
 packetbuf_clear(void)
 {
+  UNSHARE(0);
   buflen = bufptr = 0;
   hdrlen = 0;
+#if PACKETBUF_HEADROOM
+  hdrstart = PACKETBUF_HEADROOM;
+#endif /* PACKETBUF_HEADROOM */
 
   packetbuf_attr_clear();
 }
@@ -88,21 +146,20 @@ packetbuf_copyfrom(const void *from, uint16_t len)
 
   packetbuf_clear();
   l = MIN(PACKETBUF_SIZE, len);
-  memcpy(packetbuf, from, l);
+  memcpy(packetbuf + HDRSTART, from, l);
   buflen = l;
+  STATS_ADD(copyfrom, l);
   return l;
 }
 /*---------------------------------------------------------------------------*/
 void
 packetbuf_compact(void)
 {
-  int16_t i;
-
   if(bufptr) {
+    UNSHARE(1);
     /* shift data to the left */
-    for(i = 0; i < buflen; i++) {
-      packetbuf[hdrlen + i] = packetbuf[packetbuf_hdrlen() + i];
-    }
+    memmove(packetbuf + HDRSTART + hdrlen, packetbuf_dataptr(), buflen);
+    STATS_ADD(moves, buflen);
     bufptr = 0;
   }
 }
@@ -115,22 +172,50 @@ packetbuf_copyto(void *to)
   }
   memcpy(to, packetbuf_hdrptr(), hdrlen);
   memcpy((uint8_t *)to + hdrlen, packetbuf_dataptr(), buflen);
+  STATS_ADD(copyto, hdrlen + buflen);
   return hdrlen + buflen;
 }
 /*---------------------------------------------------------------------------*/
+#if QUEUEBUF_SHARE
+struct packetbuf_block *
+packetbuf_share(struct packetbuf_block **free_block)
+{
+  packetbuf_compact();
+  if(spare == NULL) {
+    if(*free_block == NULL) {
+      return NULL;
+    }
+    spare = *free_block;
+    *free_block = NULL;
+  }
+  block->refs++;
+  return block;
+}
+#endif /* QUEUEBUF_SHARE */
+/*---------------------------------------------------------------------------*/
 int
 packetbuf_hdralloc(int size)
 {
-  int16_t i;
-
   if(size + packetbuf_totlen() > PACKETBUF_SIZE) {
     return 0;
   }
 
-  /* shift data to the right */
-  for(i = packetbuf_totlen() - 1; i >= 0; i--) {
-    packetbuf[i + size] = packetbuf[i];
+#if PACKETBUF_HEADROOM
+  if(size <= hdrstart) {
+    /* the header fits in the headroom */
+    hdrstart -= size;
+    hdrlen += size;
+    return 1;
   }
+#endif /* PACKETBUF_HEADROOM */
+
+  /* shift data to the right */
+  UNSHARE(1);
+  memmove(packetbuf + size, packetbuf_hdrptr(), packetbuf_totlen());
+  STATS_ADD(moves, packetbuf_totlen());
+#if PACKETBUF_HEADROOM
+  hdrstart = 0;
+#endif /* PACKETBUF_HEADROOM */
   hdrlen += size;
   return 1;
 }
@@ -157,13 +242,13 @@ packetbuf_set_datalen(uint16_t len)
 void *
 packetbuf_dataptr(void)
 {
-  return packetbuf + packetbuf_hdrlen();
+  return packetbuf + HDRSTART + packetbuf_hdrlen();
 }
 /*---------------------------------------------------------------------------*/
 void *
 packetbuf_hdrptr(void)
 {
-  return packetbuf;
+  return packetbuf + HDRSTART;
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
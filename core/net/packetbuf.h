@@ -66,6 +66,58 @@
 #define PACKETBUF_SIZE 128
 #endif
 
+/**
+ * \brief      Space reserved in front of the packetbuf, in bytes
+ *
+ *             With headroom, packetbuf_hdralloc() prepends headers
+ *             by moving the start of the header backwards instead of
+ *             moving the whole packet forwards, and pointers into the
+ *             data stay valid. Enough headroom for the MAC header
+ *             saves one pass over every outgoing frame. Should be a
+ *             multiple of four to keep the data word-aligned.
+ */
+#ifdef PACKETBUF_CONF_HEADROOM
+#define PACKETBUF_HEADROOM PACKETBUF_CONF_HEADROOM
+#else
+#define PACKETBUF_HEADROOM 0
+#endif
+
+#ifdef PACKETBUF_CONF_STATS
+#define PACKETBUF_STATS PACKETBUF_CONF_STATS
+#else
+#define PACKETBUF_STATS 0
+#endif
+
+#if PACKETBUF_STATS
+/** Counters for the data that the packetbuf copies and moves */
+struct packetbuf_stats {
+  /** Number of packets copied into the packetbuf */
+  uint32_t copyfrom;
+  /** Number of packets copied out of the packetbuf */
+  uint32_t copyto;
+  /** Number of times packet data was moved inside the packetbuf */
+  uint32_t moves;
+  /** Total number of bytes copied or moved */
+  uint32_t bytes;
+};
+
+extern struct packetbuf_stats packetbuf_stats;
+#endif /* PACKETBUF_STATS */
+
+/**
+ * \brief      A reference-counted block that holds a packet
+ *
+ *             The packetbuf keeps its packet in a block. With
+ *             QUEUEBUF_CONF_SHARE, a queuebuf made from the packetbuf
+ *             takes a reference to the block instead of a copy of
+ *             the packet.
+ */
+struct packetbuf_block {
+  struct packetbuf_block *next;
+  uint8_t refs;
+  uint32_t data[(PACKETBUF_HEADROOM + PACKETBUF_SIZE + 3) / 4];
+};
+
 #ifdef PACKETBUF_CONF_WITH_PACKET_TYPE
 #define PACKETBUF_WITH_PACKET_TYPE PACKETBUF_CONF_WITH_PACKET_TYPE
 #else
@@ -183,6 +235,26 @@ int packetbuf_copyfrom(const void *from, uint16_t len);
  */
 int packetbuf_copyto(void *to);
 
+/**
+ * \brief      Share the block that holds the packetbuf
+ * \param spare A pointer to a free block, or to NULL. If the packetbuf
+ *             takes the block, the pointer is set to NULL.
+ * \retval     The block, with a reference taken for the caller, or
+ *             NULL if the packetbuf has no block to continue in
+ *
+ *             This function is used by queuebufs to hold the packet
+ *             in the packetbuf without copying it. The packet is
+ *             compacted first, so that it starts at packetbuf_hdrptr()
+ *             and is packetbuf_totlen() bytes long.
+ *
+ *             The packetbuf keeps the packet. When it is next cleared,
+ *             or before it moves the packet, it leaves the shared block
+ *             and continues in the spare block. Until then, the data
+ *             of the packet must not be changed in place.
+ *
+ */
+struct packetbuf_block *packetbuf_share(struct packetbuf_block **spare);
+
 /**
  * \brief      Extend the header of the packetbuf, for outbound packets
  * \param size The number of bytes the header should be extended
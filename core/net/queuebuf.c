@@ -72,14 +72,27 @@ struct queuebuf {
 
 /* The actual queuebuf data */
 struct queuebuf_data {
+#if QUEUEBUF_SHARE
+  struct packetbuf_block *block;
+  uint8_t *data;
+#else /* QUEUEBUF_SHARE */
   uint8_t data[PACKETBUF_SIZE];
+#endif /* QUEUEBUF_SHARE */
   uint16_t len;
   struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
   struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
 };
 
-MEMB(bufmem, struct queuebuf, QUEUEBUF_NUM);
-MEMB(buframmem, struct queuebuf_data, QUEUEBUFRAM_NUM);
+MEMB_FREELIST(bufmem, struct queuebuf, QUEUEBUF_NUM);
+MEMB_FREELIST(buframmem, struct queuebuf_data, QUEUEBUFRAM_NUM);
+
+#if QUEUEBUF_SHARE
+/* The blocks that hold the queued packets. The first block of the
+   packetbuf joins them when the last queuebuf that shares it is
+   freed. */
+static struct packetbuf_block blocks[QUEUEBUFRAM_NUM];
+LIST(free_blocks);
+#endif /* QUEUEBUF_SHARE */
 
 #if WITH_SWAP
 
@@ -275,12 +288,46 @@ queuebuf_load_to_ram(struct queuebuf *b)
   return b->ram_ptr;
 }
 #endif /* WITH_SWAP */
+#if QUEUEBUF_SHARE
+/*---------------------------------------------------------------------------*/
+/* Makes the queuebuf data hold the packet in the packetbuf by sharing
+   its block */
+static int
+share_packetbuf(struct queuebuf_data *d)
+{
+  struct packetbuf_block *spare;
+  struct packetbuf_block *b;
+
+  spare = list_pop(free_blocks);
+  b = packetbuf_share(&spare);
+  if(spare != NULL) {
+    list_push(free_blocks, spare);
+  }
+  if(b == NULL) {
+    return 0;
+  }
+  d->block = b;
+  d->data = packetbuf_hdrptr();
+  d->len = packetbuf_totlen();
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+release_block(struct packetbuf_block *b)
+{
+  if(--b->refs == 0) {
+    list_push(free_blocks, b);
+  }
+}
+#endif /* QUEUEBUF_SHARE */
 /*---------------------------------------------------------------------------*/
 void
 queuebuf_init(void)
 {
-#if WITH_SWAP
+#if WITH_SWAP || QUEUEBUF_SHARE
   int i;
+#endif
+#if WITH_SWAP
   for(i=0; i<NQBUF_FILES; i++) {
     qbuf_files[i].renewable = 1;
     qbuf_renew_file(i);
@@ -288,6 +335,12 @@ queuebuf_init(void)
 #endif
   memb_init(&buframmem);
   memb_init(&bufmem);
+#if QUEUEBUF_SHARE
+  list_init(free_blocks);
+  for(i = 0; i < QUEUEBUFRAM_NUM; i++) {
+    list_push(free_blocks, &blocks[i]);
+  }
+#endif /* QUEUEBUF_SHARE */
 #if QUEUEBUF_STATS
   queuebuf_max_len = 0;
 #endif /* QUEUEBUF_STATS */
@@ -339,7 +392,19 @@ queuebuf_new_from_packetbuf(void)
     buframptr = buf->ram_ptr;
 #endif
 
+#if QUEUEBUF_SHARE
+    if(!share_packetbuf(buframptr)) {
+      PRINTF("queuebuf_new_from_packetbuf: could not share the packetbuf\n");
+      memb_free(&buframmem, buframptr);
+      memb_free(&bufmem, buf);
+#if QUEUEBUF_DEBUG
+      list_remove(queuebuf_list, buf);
+#endif /* QUEUEBUF_DEBUG */
+      return NULL;
+    }
+#else /* QUEUEBUF_SHARE */
     buframptr->len = packetbuf_copyto(buframptr->data);
+#endif /* QUEUEBUF_SHARE */
     packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
 
 #if WITH_SWAP
@@ -383,7 +448,21 @@ queuebuf_update_from_packetbuf(struct queuebuf *buf)
 {
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
   packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
+#if QUEUEBUF_SHARE
+  {
+    struct packetbuf_block *old = buframptr->block;
+    if(share_packetbuf(buframptr)) {
+      release_block(old);
+    } else if(old->refs == 1) {
+      /* No block for the packetbuf to continue in: copy into our own */
+      buframptr->len = packetbuf_copyto(buframptr->data);
+    } else {
+      PRINTF("queuebuf_update_from_packetbuf: could not share the packetbuf\n");
+    }
+  }
+#else /* QUEUEBUF_SHARE */
   buframptr->len = packetbuf_copyto(buframptr->data);
+#endif /* QUEUEBUF_SHARE */
 #if WITH_SWAP
   if(buf->location == IN_CFS) {
     queuebuf_flush_tmpdata();
@@ -402,6 +481,9 @@ queuebuf_free(struct queuebuf *buf)
       queuebuf_remove_from_file(buf->swap_id);
     }
 #else
+#if QUEUEBUF_SHARE
+    release_block(buf->ram_ptr->block);
+#endif /* QUEUEBUF_SHARE */
     memb_free(&buframmem, buf->ram_ptr);
 #endif
     memb_free(&bufmem, buf);
@@ -457,6 +539,18 @@ queuebuf_attr(struct queuebuf *b, uint8_t type)
 }
 /*---------------------------------------------------------------------------*/
 void
+queuebuf_set_attr(struct queuebuf *b, uint8_t type, packetbuf_attr_t val)
+{
+  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+  buframptr->attrs[type].val = val;
+#if WITH_SWAP
+  if(b->location == IN_CFS) {
+    queuebuf_flush_tmpdata();
+  }
+#endif
+}
+/*---------------------------------------------------------------------------*/
+void
 queuebuf_debug_print(void)
 {
 #if QUEUEBUF_DEBUG
@@ -79,6 +79,21 @@
   #define WITH_SWAP 0
 #endif /* QUEUEBUFRAM_CONF_NUM */
 
+/* With QUEUEBUF_CONF_SHARE, a queuebuf made from the packetbuf holds a
+   reference to the block of the packetbuf instead of a copy of the
+   packet, and the packetbuf continues in another block. Packets must
+   then not be changed in place once they are queued. Needs all
+   queuebufs to be stored in RAM. */
+#ifdef QUEUEBUF_CONF_SHARE
+#define QUEUEBUF_SHARE QUEUEBUF_CONF_SHARE
+#else /* QUEUEBUF_CONF_SHARE */
+#define QUEUEBUF_SHARE 0
+#endif /* QUEUEBUF_CONF_SHARE */
+
+#if QUEUEBUF_SHARE && WITH_SWAP
+#error "QUEUEBUF_CONF_SHARE cannot be used with QUEUEBUFRAM_CONF_NUM < QUEUEBUF_NUM"
+#endif
+
 #ifdef QUEUEBUF_CONF_DEBUG
 #define QUEUEBUF_DEBUG QUEUEBUF_CONF_DEBUG
 #else /* QUEUEBUF_CONF_DEBUG */
@@ -106,6 +121,7 @@ int queuebuf_datalen(struct queuebuf *b);
 
 linkaddr_t *queuebuf_addr(struct queuebuf *b, uint8_t type);
 packetbuf_attr_t queuebuf_attr(struct queuebuf *b, uint8_t type);
+void queuebuf_set_attr(struct queuebuf *b, uint8_t type, packetbuf_attr_t val);
 
 void queuebuf_debug_print(void);
 
@@ -54,6 +54,217 @@ static clock_time_t next_expiration;
 
 PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
+#if ETIMER_HEAP
+/*
+ * The pending timers are kept in a pairing heap rooted at
+ * timerlist. Each timer points to its first child, the next pointer
+ * links siblings, and the prev pointer points to the previous sibling
+ * or, for the first child, to the parent. Timers that are not in the
+ * heap have a NULL prev pointer, except for the root.
+ */
+#define CLOCK_HALF_RANGE ((clock_time_t)~(clock_time_t)0 >> 1)
+
+static int
+expires_before(struct etimer *a, struct etimer *b)
+{
+  clock_time_t diff;
+
+  diff = etimer_expiration_time(b) - etimer_expiration_time(a);
+  return diff != 0 && diff <= CLOCK_HALF_RANGE;
+}
+/*---------------------------------------------------------------------------*/
+static struct etimer *
+meld(struct etimer *a, struct etimer *b)
+{
+  struct etimer *t;
+
+  if(a == NULL) {
+    return b;
+  }
+  if(b == NULL) {
+    return a;
+  }
+  if(expires_before(b, a)) {
+    t = a;
+    a = b;
+    b = t;
+  }
+  b->prev = a;
+  b->next = a->child;
+  if(a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+static struct etimer *
+merge_pairs(struct etimer *first)
+{
+  struct etimer *a, *b, *m, *pairs;
+
+  /* First pass: meld the subheaps pairwise from left to right,
+     keeping the results on a stack linked through the next pointer. */
+  pairs = NULL;
+  while(first != NULL) {
+    a = first;
+    b = a->next;
+    if(b != NULL) {
+      first = b->next;
+      b->next = b->prev = NULL;
+    } else {
+      first = NULL;
+    }
+    a->next = a->prev = NULL;
+    m = meld(a, b);
+    m->next = pairs;
+    pairs = m;
+  }
+
+  /* Second pass: meld the pairs from right to left. */
+  m = NULL;
+  while(pairs != NULL) {
+    a = pairs;
+    pairs = a->next;
+    a->next = NULL;
+    m = meld(m, a);
+  }
+  return m;
+}
+/*---------------------------------------------------------------------------*/
+static int
+is_pending(struct etimer *timer)
+{
+  return timer->p != PROCESS_NONE &&
+    (timer == timerlist || timer->prev != NULL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+insert_timer(struct etimer *timer)
+{
+  timer->child = timer->next = timer->prev = NULL;
+  timerlist = meld(timerlist, timer);
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_timer(struct etimer *timer)
+{
+  if(timer == timerlist) {
+    timerlist = merge_pairs(timer->child);
+  } else {
+    if(timer->prev->child == timer) {
+      timer->prev->child = timer->next;
+    } else {
+      timer->prev->next = timer->next;
+    }
+    if(timer->next != NULL) {
+      timer->next->prev = timer->prev;
+    }
+    timerlist = meld(timerlist, merge_pairs(timer->child));
+  }
+  timer->child = timer->next = timer->prev = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static struct etimer *
+find_process_timer(struct process *p)
+{
+  struct etimer *t, *parent;
+
+  /* Walk the heap in pre-order, using the prev pointers to climb. */
+  t = timerlist;
+  while(t != NULL) {
+    if(t->p == p) {
+      return t;
+    }
+    if(t->child != NULL) {
+      t = t->child;
+    } else if(t->next != NULL) {
+      t = t->next;
+    } else {
+      for(;;) {
+        parent = t->prev;
+        if(parent == NULL) {
+          return NULL;
+        }
+        if(parent->child == t && parent->next != NULL) {
+          t = parent->next;
+          break;
+        }
+        t = parent;
+      }
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_time(void)
+{
+  if(timerlist == NULL) {
+    next_expiration = 0;
+  } else {
+    next_expiration = etimer_expiration_time(timerlist);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_process_timers(struct process *p)
+{
+  struct etimer *t, *c, *work, *kept;
+
+  if(find_process_timer(p) == NULL) {
+    return;
+  }
+
+  /* Take the heap apart in a single pass: the children of each timer
+     join the list of timers still to visit, and the timers of other
+     processes are kept as single-timer heaps to be paired again. */
+  kept = NULL;
+  work = timerlist;
+  while(work != NULL) {
+    t = work;
+    work = t->next;
+    if(t->child != NULL) {
+      for(c = t->child; c->next != NULL; c = c->next);
+      c->next = work;
+      work = t->child;
+    }
+    t->child = t->prev = NULL;
+    if(t->p == p) {
+      t->next = NULL;
+    } else {
+      t->next = kept;
+      kept = t;
+    }
+  }
+  timerlist = merge_pairs(kept);
+  update_time();
+}
+/*---------------------------------------------------------------------------*/
+static void
+expire_timers(void)
+{
+  struct etimer *t;
+
+  /* The root of the heap is the timer that expires first, so we can
+     stop at the first timer that has not yet expired. */
+  while(timerlist != NULL && timer_expired(&timerlist->timer)) {
+    t = timerlist;
+    if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
+      remove_timer(t);
+      /* Reset the process ID of the event timer, to signal that the
+         etimer has expired. This is later checked in the
+         etimer_expired() function. */
+      t->p = PROCESS_NONE;
+      update_time();
+    } else {
+      etimer_request_poll();
+      break;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+#else /* ETIMER_HEAP */
 static void
 update_time(void)
 {
@@ -77,65 +288,121 @@ update_time(void)
   }
 }
 /*---------------------------------------------------------------------------*/
-PROCESS_THREAD(etimer_process, ev, data)
+static int
+is_pending(struct etimer *timer)
 {
-  struct etimer *t, *u;
-	
-  PROCESS_BEGIN();
+  struct etimer *t;
 
-  timerlist = NULL;
-  
-  while(1) {
-    PROCESS_YIELD();
+  if(timer->p != PROCESS_NONE) {
+    for(t = timerlist; t != NULL; t = t->next) {
+      if(t == timer) {
+	return 1;
+      }
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+insert_timer(struct etimer *timer)
+{
+  timer->next = timerlist;
+  timerlist = timer;
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_timer(struct etimer *et)
+{
+  struct etimer *t;
 
-    if(ev == PROCESS_EVENT_EXITED) {
-      struct process *p = data;
+  /* First check if et is the first event timer on the list. */
+  if(et == timerlist) {
+    timerlist = timerlist->next;
+  } else {
+    /* Else walk through the list and try to find the item before the
+       et timer. */
+    for(t = timerlist; t != NULL && t->next != et; t = t->next);
 
-      while(timerlist != NULL && timerlist->p == p) {
-	timerlist = timerlist->next;
-      }
+    if(t != NULL) {
+      /* We've found the item before the event timer that we are about
+	 to remove. We point the items next pointer to the event after
+	 the removed item. */
+      t->next = et->next;
+    }
+  }
 
-      if(timerlist != NULL) {
-	t = timerlist;
-	while(t->next != NULL) {
-	  if(t->next->p == p) {
-	    t->next = t->next->next;
-	  } else
-	    t = t->next;
-	}
-      }
-      continue;
-    } else if(ev != PROCESS_EVENT_POLL) {
-      continue;
+  /* Remove the next pointer from the item to be removed. */
+  et->next = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_process_timers(struct process *p)
+{
+  struct etimer *t;
+
+  while(timerlist != NULL && timerlist->p == p) {
+    timerlist = timerlist->next;
+  }
+
+  if(timerlist != NULL) {
+    t = timerlist;
+    while(t->next != NULL) {
+      if(t->next->p == p) {
+	t->next = t->next->next;
+      } else
+	t = t->next;
     }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+expire_timers(void)
+{
+  struct etimer *t, *u;
 
-  again:
-    
-    u = NULL;
-    
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(timer_expired(&t->timer)) {
-	if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
-	  
-	  /* Reset the process ID of the event timer, to signal that the
-	     etimer has expired. This is later checked in the
-	     etimer_expired() function. */
-	  t->p = PROCESS_NONE;
-	  if(u != NULL) {
-	    u->next = t->next;
-	  } else {
-	    timerlist = t->next;
-	  }
-	  t->next = NULL;
-	  update_time();
-	  goto again;
+ again:
+
+  u = NULL;
+
+  for(t = timerlist; t != NULL; t = t->next) {
+    if(timer_expired(&t->timer)) {
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
+
+	/* Reset the process ID of the event timer, to signal that the
+	   etimer has expired. This is later checked in the
+	   etimer_expired() function. */
+	t->p = PROCESS_NONE;
+	if(u != NULL) {
+	  u->next = t->next;
 	} else {
-	  etimer_request_poll();
+	  timerlist = t->next;
 	}
+	t->next = NULL;
+	update_time();
+	goto again;
+      } else {
+	etimer_request_poll();
       }
-      u = t;
     }
-    
+    u = t;
+  }
+}
+#endif /* ETIMER_HEAP */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  timerlist = NULL;
+  
+  while(1) {
+    PROCESS_YIELD();
+
+    if(ev == PROCESS_EVENT_EXITED) {
+      remove_process_timers(data);
+    } else if(ev == PROCESS_EVENT_POLL) {
+      expire_timers();
+    }
   }
   
   PROCESS_END();
@@ -150,25 +417,23 @@ etimer_request_poll(void)
 static void
 add_timer(struct etimer *timer)
 {
-  struct etimer *t;
-
   etimer_request_poll();
 
-  if(timer->p != PROCESS_NONE) {
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(t == timer) {
-	/* Timer already on list, bail out. */
-        timer->p = PROCESS_CURRENT();
-	update_time();
-	return;
-      }
-    }
+  if(is_pending(timer)) {
+#if ETIMER_HEAP
+    /* Timer already in the heap. The heap is ordered by expiration
+       time, so the timer must be put back at its new place. */
+    remove_timer(timer);
+#else /* ETIMER_HEAP */
+    /* Timer already on list, bail out. */
+    timer->p = PROCESS_CURRENT();
+    update_time();
+    return;
+#endif /* ETIMER_HEAP */
   }
 
-  /* Timer not on list. */
   timer->p = PROCESS_CURRENT();
-  timer->next = timerlist;
-  timerlist = timer;
+  insert_timer(timer);
 
   update_time();
 }
@@ -205,7 +470,17 @@ etimer_restart(struct etimer *et)
 void
 etimer_adjust(struct etimer *et, int timediff)
 {
+#if ETIMER_HEAP
+  if(is_pending(et)) {
+    remove_timer(et);
+    et->timer.start += timediff;
+    insert_timer(et);
+  } else {
+    et->timer.start += timediff;
+  }
+#else /* ETIMER_HEAP */
   et->timer.start += timediff;
+#endif /* ETIMER_HEAP */
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -242,29 +517,16 @@ etimer_next_expiration_time(void)
 void
 etimer_stop(struct etimer *et)
 {
-  struct etimer *t;
-
-  /* First check if et is the first event timer on the list. */
-  if(et == timerlist) {
-    timerlist = timerlist->next;
+#if ETIMER_HEAP
+  if(is_pending(et)) {
+    remove_timer(et);
     update_time();
-  } else {
-    /* Else walk through the list and try to find the item before the
-       et timer. */
-    for(t = timerlist; t != NULL && t->next != et; t = t->next);
-
-    if(t != NULL) {
-      /* We've found the item before the event timer that we are about
-	 to remove. We point the items next pointer to the event after
-	 the removed item. */
-      t->next = et->next;
-
-      update_time();
-    }
   }
+#else /* ETIMER_HEAP */
+  remove_timer(et);
+  update_time();
+#endif /* ETIMER_HEAP */
 
-  /* Remove the next pointer from the item to be removed. */
-  et->next = NULL;
   /* Set the timer as expired */
   et->p = PROCESS_NONE;
 }
@@ -65,6 +65,27 @@
 #include "sys/timer.h"
 #include "sys/process.h"
 
+/**
+ * Select the pairing heap backend for pending event timers.
+ *
+ * By default, pending event timers are kept in an unsorted list,
+ * which makes setting a timer and polling for expired timers O(n) in
+ * the number of timers. With the heap backend, setting a timer is
+ * O(1), finding the next expiration time is O(1) and expiring or
+ * stopping a timer is O(log n) amortized, at the cost of two extra
+ * pointers per timer.
+ *
+ * \note With the heap backend, timers are ordered by their expiration
+ * time, so no timer can be set further into the future than half the
+ * range of clock_time_t. Event timers must also be zero-initialized
+ * (e.g. static or allocated from a memb) before they are first set.
+ */
+#ifdef ETIMER_CONF_HEAP
+#define ETIMER_HEAP ETIMER_CONF_HEAP
+#else /* ETIMER_CONF_HEAP */
+#define ETIMER_HEAP 0
+#endif /* ETIMER_CONF_HEAP */
+
 /**
  * A timer.
  *
@@ -77,6 +98,10 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_HEAP
+  struct etimer *child;
+  struct etimer *prev;
+#endif /* ETIMER_HEAP */
 };
 
 /**
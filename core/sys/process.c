@@ -44,9 +44,13 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "sys/process.h"
 #include "sys/arg.h"
+#if PROCESS_CONF_OVERFLOW_EVENTS
+#include "lib/memb.h"
+#endif /* PROCESS_CONF_OVERFLOW_EVENTS */
 
 /*
  * Pointer to the currently running process structure.
@@ -65,11 +69,37 @@ struct event_data {
   struct process *p;
 };
 
-static process_num_events_t nevents, fevent;
-static struct event_data events[PROCESS_CONF_NUMEVENTS];
+#if PROCESS_CONF_OVERFLOW_EVENTS
+/*
+ * Events that did not fit in the ring of their priority class are
+ * kept in a list allocated from a memb pool. They are moved into the
+ * ring, in order, as soon as the ring has room for them.
+ */
+struct overflow_event {
+  struct overflow_event *next;
+  struct event_data e;
+};
+MEMB(overflow_memb, struct overflow_event, PROCESS_CONF_OVERFLOW_EVENTS);
+#endif /* PROCESS_CONF_OVERFLOW_EVENTS */
+
+/*
+ * One event queue per priority class. Events are always dispatched
+ * from the highest priority class (lowest index) that is non-empty.
+ */
+struct event_queue {
+  process_num_events_t nevents, fevent;
+  struct event_data events[PROCESS_CONF_NUMEVENTS];
+#if PROCESS_CONF_OVERFLOW_EVENTS
+  struct overflow_event *overflow_head, *overflow_tail;
+#endif /* PROCESS_CONF_OVERFLOW_EVENTS */
+};
+
+static struct event_queue queues[PROCESS_PRIORITIES];
+static unsigned short nevents;
 
 #if PROCESS_CONF_STATS
-process_num_events_t process_maxevents;
+unsigned short process_maxevents;
+struct process_queue_stats process_queue_stats[PROCESS_PRIORITIES];
 #endif
 
 static volatile unsigned char poll_requested;
@@ -207,11 +237,23 @@ process_exit(struct process *p)
 void
 process_init(void)
 {
+  uint8_t i;
+
   lastevent = PROCESS_EVENT_MAX;
 
-  nevents = fevent = 0;
+  nevents = 0;
+  for(i = 0; i < PROCESS_PRIORITIES; i++) {
+    queues[i].nevents = queues[i].fevent = 0;
+#if PROCESS_CONF_OVERFLOW_EVENTS
+    queues[i].overflow_head = queues[i].overflow_tail = NULL;
+#endif /* PROCESS_CONF_OVERFLOW_EVENTS */
+  }
+#if PROCESS_CONF_OVERFLOW_EVENTS
+  memb_init(&overflow_memb);
+#endif /* PROCESS_CONF_OVERFLOW_EVENTS */
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
+  memset(process_queue_stats, 0, sizeof(process_queue_stats));
 #endif /* PROCESS_CONF_STATS */
 
   process_current = process_list = NULL;
@@ -249,6 +291,7 @@ do_event(void)
   process_data_t data;
   struct process *receiver;
   struct process *p;
+  struct event_queue *q;
   
   /*
    * If there are any events in the queue, take the first one and walk
@@ -259,18 +302,35 @@ do_event(void)
    */
 
   if(nevents > 0) {
-    
+
+    /* Find the highest priority class that has pending events. */
+    for(q = queues; q->nevents == 0; q++);
+
     /* There are events that we should deliver. */
-    ev = events[fevent].ev;
+    ev = q->events[q->fevent].ev;
     
-    data = events[fevent].data;
-    receiver = events[fevent].p;
+    data = q->events[q->fevent].data;
+    receiver = q->events[q->fevent].p;
 
     /* Since we have seen the new event, we move pointer upwards
        and decrease the number of events. */
-    fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
+    q->fevent = (q->fevent + 1) % PROCESS_CONF_NUMEVENTS;
+    --q->nevents;
     --nevents;
 
+#if PROCESS_CONF_OVERFLOW_EVENTS
+    /* Refill the ring with the oldest overflowed event of this class,
+       so that events are still delivered in the order they were
+       posted. */
+    if(q->overflow_head != NULL) {
+      struct overflow_event *o = q->overflow_head;
+      q->overflow_head = o->next;
+      q->events[(q->fevent + q->nevents) % PROCESS_CONF_NUMEVENTS] = o->e;
+      ++q->nevents;
+      memb_free(&overflow_memb, o);
+    }
+#endif /* PROCESS_CONF_OVERFLOW_EVENTS */
+
     /* If this is a broadcast event, we deliver it to all events, in
        order of their priority. */
     if(receiver == PROCESS_BROADCAST) {
@@ -320,8 +380,16 @@ process_nevents(void)
 /*---------------------------------------------------------------------------*/
 int
 process_post(struct process *p, process_event_t ev, process_data_t data)
+{
+  return process_post_prio(p, ev, data, PROCESS_EVENT_PRIORITY(p, ev));
+}
+/*---------------------------------------------------------------------------*/
+int
+process_post_prio(struct process *p, process_event_t ev, process_data_t data,
+                  uint8_t prio)
 {
   process_num_events_t snum;
+  struct event_queue *q;
 
   if(PROCESS_CURRENT() == NULL) {
     PRINTF("process_post: NULL process posts event %d to process '%s', nevents %d\n",
@@ -331,25 +399,65 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
 	   PROCESS_NAME_STRING(PROCESS_CURRENT()), ev,
 	   p == PROCESS_BROADCAST? "<broadcast>": PROCESS_NAME_STRING(p), nevents);
   }
-  
-  if(nevents == PROCESS_CONF_NUMEVENTS) {
+
+  if(prio >= PROCESS_PRIORITIES) {
+    prio = PROCESS_PRIORITIES - 1;
+  }
+  q = &queues[prio];
+
+#if PROCESS_CONF_OVERFLOW_EVENTS
+  /* Once a class has overflowed, later events must queue up behind
+     the overflowed ones to keep the class in FIFO order. */
+  if(q->nevents == PROCESS_CONF_NUMEVENTS || q->overflow_head != NULL) {
+    struct overflow_event *o = memb_alloc(&overflow_memb);
+    if(o != NULL) {
+      o->e.ev = ev;
+      o->e.data = data;
+      o->e.p = p;
+      o->next = NULL;
+      if(q->overflow_head == NULL) {
+        q->overflow_head = o;
+      } else {
+        q->overflow_tail->next = o;
+      }
+      q->overflow_tail = o;
+      ++nevents;
+#if PROCESS_CONF_STATS
+      process_queue_stats[prio].overflows++;
+      if(nevents > process_maxevents) {
+        process_maxevents = nevents;
+      }
+#endif /* PROCESS_CONF_STATS */
+      return PROCESS_ERR_OK;
+    }
+  }
+#endif /* PROCESS_CONF_OVERFLOW_EVENTS */
+
+  if(q->nevents == PROCESS_CONF_NUMEVENTS) {
 #if DEBUG
     if(p == PROCESS_BROADCAST) {
-      printf("soft panic: event queue is full when broadcast event %d was posted from %s\n", ev, PROCESS_NAME_STRING(process_current));
+      printf("soft panic: event queue %u is full when broadcast event %d was posted from %s\n", prio, ev, PROCESS_NAME_STRING(process_current));
     } else {
-      printf("soft panic: event queue is full when event %d was posted to %s from %s\n", ev, PROCESS_NAME_STRING(p), PROCESS_NAME_STRING(process_current));
+      printf("soft panic: event queue %u is full when event %d was posted to %s from %s\n", prio, ev, PROCESS_NAME_STRING(p), PROCESS_NAME_STRING(process_current));
     }
 #endif /* DEBUG */
+#if PROCESS_CONF_STATS
+    process_queue_stats[prio].drops++;
+#endif /* PROCESS_CONF_STATS */
     return PROCESS_ERR_FULL;
   }
   
-  snum = (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
-  events[snum].ev = ev;
-  events[snum].data = data;
-  events[snum].p = p;
+  snum = (process_num_events_t)(q->fevent + q->nevents) % PROCESS_CONF_NUMEVENTS;
+  q->events[snum].ev = ev;
+  q->events[snum].data = data;
+  q->events[snum].p = p;
+  ++q->nevents;
   ++nevents;
 
 #if PROCESS_CONF_STATS
+  if(q->nevents > process_queue_stats[prio].maxevents) {
+    process_queue_stats[prio].maxevents = q->nevents;
+  }
   if(nevents > process_maxevents) {
     process_maxevents = nevents;
   }
@@ -88,6 +88,61 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/**
+ * \name Event priorities
+ *
+ * The event queue can be split into several priority classes, each
+ * with its own ring of PROCESS_CONF_NUMEVENTS entries. Pending events
+ * of a higher priority class (lower number) are always dispatched
+ * before events of a lower class. By default there is a single class
+ * and all events are dispatched in the order they were posted.
+ *
+ * Events that do not fit in the ring of their class can optionally be
+ * kept in an overflow pool of PROCESS_CONF_OVERFLOW_EVENTS entries,
+ * shared by all classes, instead of being dropped.
+ * @{
+ */
+#define PROCESS_PRIO_HIGH     0
+#define PROCESS_PRIO_NORMAL   1
+#define PROCESS_PRIO_LOW      2
+
+#ifdef PROCESS_CONF_PRIORITIES
+#define PROCESS_PRIORITIES PROCESS_CONF_PRIORITIES
+#else /* PROCESS_CONF_PRIORITIES */
+#define PROCESS_PRIORITIES 1
+#endif /* PROCESS_CONF_PRIORITIES */
+
+#ifndef PROCESS_CONF_OVERFLOW_EVENTS
+#define PROCESS_CONF_OVERFLOW_EVENTS 0
+#endif /* PROCESS_CONF_OVERFLOW_EVENTS */
+
+/**
+ * The priority class used by process_post(). Timer events go to the
+ * high priority class, everything else to the normal class.
+ */
+#ifdef PROCESS_CONF_EVENT_PRIORITY
+#define PROCESS_EVENT_PRIORITY(p, ev) PROCESS_CONF_EVENT_PRIORITY(p, ev)
+#else /* PROCESS_CONF_EVENT_PRIORITY */
+#define PROCESS_EVENT_PRIORITY(p, ev) \
+  ((ev) == PROCESS_EVENT_TIMER ? PROCESS_PRIO_HIGH : PROCESS_PRIO_NORMAL)
+#endif /* PROCESS_CONF_EVENT_PRIORITY */
+
+#if PROCESS_CONF_STATS
+/** Per-priority event queue statistics */
+struct process_queue_stats {
+  /** Highest number of events waiting in the ring of the class */
+  process_num_events_t maxevents;
+  /** Number of events that were put in the overflow pool */
+  unsigned short overflows;
+  /** Number of events that were dropped because the class was full */
+  unsigned short drops;
+};
+
+extern struct process_queue_stats process_queue_stats[PROCESS_PRIORITIES];
+extern unsigned short process_maxevents;
+#endif /* PROCESS_CONF_STATS */
+/** @} */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -364,6 +419,32 @@ CCIF void process_start(struct process *p, process_data_t data);
  */
 CCIF int process_post(struct process *p, process_event_t ev, process_data_t data);
 
+/**
+ * Post an asynchronous event with an explicit priority.
+ *
+ * This function works like process_post(), but puts the event in the
+ * queue of the given priority class instead of the class chosen by
+ * PROCESS_EVENT_PRIORITY(). With a single priority class, this is
+ * the same as process_post().
+ *
+ * \param p The process to which the event should be posted, or
+ * PROCESS_BROADCAST.
+ *
+ * \param ev The event to be posted.
+ *
+ * \param data The auxiliary data to be sent with the event
+ *
+ * \param prio The priority class, e.g. PROCESS_PRIO_HIGH. Classes
+ * beyond the configured number are mapped to the lowest class.
+ *
+ * \retval PROCESS_ERR_OK The event could be posted.
+ *
+ * \retval PROCESS_ERR_FULL The queue of the class and the overflow pool
+ * were full and the event could not be posted.
+ */
+CCIF int process_post_prio(struct process *p, process_event_t ev,
+                           process_data_t data, uint8_t prio);
+
 /**
  * Post a synchronous event to a process.
  *
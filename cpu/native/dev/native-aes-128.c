@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         AES-128 driver for the native platform. Expanded keys are cached
+ *         (see AES_128_CONF_KEY_CACHE) and blocks are encrypted with AES-NI
+ *         when the host supports it; otherwise everything is handed to the
+ *         software aes_128_driver.
+ */
+
+#include "dev/native-aes-128.h"
+#include <string.h>
+
+#ifdef NATIVE_AES_128_CONF_WITH_AESNI
+#define WITH_AESNI NATIVE_AES_128_CONF_WITH_AESNI
+#elif defined(__x86_64__) || defined(__i386__)
+#define WITH_AESNI 1
+#else
+#define WITH_AESNI 0
+#endif
+
+#if WITH_AESNI
+#include <emmintrin.h>
+#include <wmmintrin.h>
+
+#define AESNI_FUNCTION __attribute__((target("sse2,aes")))
+
+#if AES_128_KEY_CACHE
+#define KEY_CACHE_SIZE AES_128_KEY_CACHE
+#else
+#define KEY_CACHE_SIZE 1
+#endif
+
+static struct {
+  uint8_t key[AES_128_KEY_LENGTH];
+  __m128i round_keys[11];
+} key_cache[KEY_CACHE_SIZE];
+static uint8_t key_cache_len;
+static uint8_t key_cache_next;
+static const __m128i *round_keys = key_cache[0].round_keys;
+
+/* -1 until the CPU has been probed */
+static int aesni = -1;
+
+/*---------------------------------------------------------------------------*/
+AESNI_FUNCTION static __m128i
+expand_step(__m128i key, __m128i assist)
+{
+  assist = _mm_shuffle_epi32(assist, 0xff);
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, assist);
+}
+/*---------------------------------------------------------------------------*/
+/* The round constant of aeskeygenassist must be an immediate */
+#define EXPAND(rk, i, rcon) \
+  rk[i] = expand_step(rk[i - 1], _mm_aeskeygenassist_si128(rk[i - 1], rcon))
+
+AESNI_FUNCTION static void
+expand_key(__m128i *rk, const uint8_t *key)
+{
+  rk[0] = _mm_loadu_si128((const __m128i *)key);
+  EXPAND(rk, 1, 0x01);
+  EXPAND(rk, 2, 0x02);
+  EXPAND(rk, 3, 0x04);
+  EXPAND(rk, 4, 0x08);
+  EXPAND(rk, 5, 0x10);
+  EXPAND(rk, 6, 0x20);
+  EXPAND(rk, 7, 0x40);
+  EXPAND(rk, 8, 0x80);
+  EXPAND(rk, 9, 0x1b);
+  EXPAND(rk, 10, 0x36);
+}
+/*---------------------------------------------------------------------------*/
+AESNI_FUNCTION static void
+encrypt_blocks(uint8_t *blocks, unsigned count)
+{
+  __m128i b0, b1, b2, b3;
+  int round;
+
+  /* Independent blocks go through the pipelined AES unit together */
+  while(count >= 4) {
+    b0 = _mm_xor_si128(_mm_loadu_si128((__m128i *)blocks), round_keys[0]);
+    b1 = _mm_xor_si128(_mm_loadu_si128((__m128i *)blocks + 1), round_keys[0]);
+    b2 = _mm_xor_si128(_mm_loadu_si128((__m128i *)blocks + 2), round_keys[0]);
+    b3 = _mm_xor_si128(_mm_loadu_si128((__m128i *)blocks + 3), round_keys[0]);
+    for(round = 1; round < 10; round++) {
+      b0 = _mm_aesenc_si128(b0, round_keys[round]);
+      b1 = _mm_aesenc_si128(b1, round_keys[round]);
+      b2 = _mm_aesenc_si128(b2, round_keys[round]);
+      b3 = _mm_aesenc_si128(b3, round_keys[round]);
+    }
+    _mm_storeu_si128((__m128i *)blocks, _mm_aesenclast_si128(b0, round_keys[10]));
+    _mm_storeu_si128((__m128i *)blocks + 1, _mm_aesenclast_si128(b1, round_keys[10]));
+    _mm_storeu_si128((__m128i *)blocks + 2, _mm_aesenclast_si128(b2, round_keys[10]));
+    _mm_storeu_si128((__m128i *)blocks + 3, _mm_aesenclast_si128(b3, round_keys[10]));
+    blocks += 4 * AES_128_BLOCK_SIZE;
+    count -= 4;
+  }
+
+  while(count > 0) {
+    b0 = _mm_xor_si128(_mm_loadu_si128((__m128i *)blocks), round_keys[0]);
+    for(round = 1; round < 10; round++) {
+      b0 = _mm_aesenc_si128(b0, round_keys[round]);
+    }
+    _mm_storeu_si128((__m128i *)blocks, _mm_aesenclast_si128(b0, round_keys[10]));
+    blocks += AES_128_BLOCK_SIZE;
+    count--;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+native_aes_128_has_aesni(void)
+{
+  if(aesni < 0) {
+    __builtin_cpu_init();
+    aesni = __builtin_cpu_supports("aes") ? 1 : 0;
+  }
+  return aesni;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_key(const uint8_t *key)
+{
+  uint8_t i;
+
+  if(!native_aes_128_has_aesni()) {
+    aes_128_driver.set_key(key);
+    return;
+  }
+
+  for(i = 0; i < key_cache_len; i++) {
+    if(memcmp(key_cache[i].key, key, AES_128_KEY_LENGTH) == 0) {
+      round_keys = key_cache[i].round_keys;
+      return;
+    }
+  }
+
+  i = key_cache_next;
+  key_cache_next = (key_cache_next + 1) % KEY_CACHE_SIZE;
+  if(key_cache_len < KEY_CACHE_SIZE) {
+    key_cache_len++;
+  }
+  memcpy(key_cache[i].key, key, AES_128_KEY_LENGTH);
+  expand_key(key_cache[i].round_keys, key);
+  round_keys = key_cache[i].round_keys;
+}
+/*---------------------------------------------------------------------------*/
+void
+native_aes_128_encrypt_blocks(uint8_t *blocks, unsigned count)
+{
+  if(native_aes_128_has_aesni()) {
+    encrypt_blocks(blocks, count);
+    return;
+  }
+
+  while(count > 0) {
+    aes_128_driver.encrypt(blocks);
+    blocks += AES_128_BLOCK_SIZE;
+    count--;
+  }
+}
+/*---------------------------------------------------------------------------*/
+#else /* WITH_AESNI */
+/*---------------------------------------------------------------------------*/
+int
+native_aes_128_has_aesni(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_key(const uint8_t *key)
+{
+  aes_128_driver.set_key(key);
+}
+/*---------------------------------------------------------------------------*/
+void
+native_aes_128_encrypt_blocks(uint8_t *blocks, unsigned count)
+{
+  while(count > 0) {
+    aes_128_driver.encrypt(blocks);
+    blocks += AES_128_BLOCK_SIZE;
+    count--;
+  }
+}
+/*---------------------------------------------------------------------------*/
+#endif /* WITH_AESNI */
+/*---------------------------------------------------------------------------*/
+static void
+encrypt(uint8_t *plaintext_and_result)
+{
+  native_aes_128_encrypt_blocks(plaintext_and_result, 1);
+}
+/*---------------------------------------------------------------------------*/
+const struct aes_128_driver native_aes_128_driver = {
+  set_key,
+  encrypt
+};
+/*---------------------------------------------------------------------------*/
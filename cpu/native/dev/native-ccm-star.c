@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         AES-CCM* driver for the native platform. The CTR key stream of a
+ *         frame, including the block that encrypts the MIC, is generated
+ *         with a single bulk call to native_aes_128_encrypt_blocks(), so
+ *         with AES-NI those blocks are encrypted in parallel. CBC-MAC is
+ *         inherently sequential and runs block by block.
+ */
+
+#include "dev/native-ccm-star.h"
+#include "dev/native-aes-128.h"
+#include <string.h>
+
+/* see RFC 3610 */
+#define CCM_STAR_AUTH_FLAGS(Adata, M) ((Adata ? (1u << 6) : 0) | (((M - 2u) >> 1) << 3) | 1u)
+#define CCM_STAR_ENCRYPTION_FLAGS     1
+
+/* m_len is a uint8_t, so a frame has at most 16 CTR blocks plus A_0 */
+#define MAX_CTR_BLOCKS ((255 + AES_128_BLOCK_SIZE - 1) / AES_128_BLOCK_SIZE + 1)
+
+/*---------------------------------------------------------------------------*/
+static void
+set_iv(uint8_t *iv,
+    uint8_t flags,
+    const uint8_t *nonce,
+    uint8_t counter)
+{
+  iv[0] = flags;
+  memcpy(iv + 1, nonce, CCM_STAR_NONCE_LENGTH);
+  iv[14] = 0;
+  iv[15] = counter;
+}
+/*---------------------------------------------------------------------------*/
+static void
+xor_block(uint8_t *dst, const uint8_t *src, uint8_t len)
+{
+  uint8_t i;
+
+  for(i = 0; i < len; i++) {
+    dst[i] ^= src[i];
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+ctr(uint8_t s[][AES_128_BLOCK_SIZE], uint8_t *m, uint8_t m_len)
+{
+  uint8_t pos;
+  uint8_t len;
+  uint8_t counter;
+
+  pos = 0;
+  counter = 1;
+  while(pos < m_len) {
+    len = m_len - pos < AES_128_BLOCK_SIZE ? m_len - pos : AES_128_BLOCK_SIZE;
+    xor_block(m + pos, s[counter++], len);
+    pos += len;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Computes the unencrypted CBC-MAC X_{n+1} */
+static void
+cbc_mac(const uint8_t *nonce,
+    const uint8_t *m, uint8_t m_len,
+    const uint8_t *a, uint8_t a_len,
+    uint8_t mic_len,
+    uint8_t *x)
+{
+  uint8_t pos;
+  uint8_t len;
+
+  set_iv(x, CCM_STAR_AUTH_FLAGS(a_len, mic_len), nonce, m_len);
+  native_aes_128_encrypt_blocks(x, 1);
+
+  if(a_len) {
+    x[1] ^= a_len;
+    len = a_len < AES_128_BLOCK_SIZE - 2 ? a_len : AES_128_BLOCK_SIZE - 2;
+    xor_block(x + 2, a, len);
+    native_aes_128_encrypt_blocks(x, 1);
+
+    pos = len;
+    while(pos < a_len) {
+      len = a_len - pos < AES_128_BLOCK_SIZE ? a_len - pos : AES_128_BLOCK_SIZE;
+      xor_block(x, a + pos, len);
+      pos += len;
+      native_aes_128_encrypt_blocks(x, 1);
+    }
+  }
+
+  pos = 0;
+  while(pos < m_len) {
+    len = m_len - pos < AES_128_BLOCK_SIZE ? m_len - pos : AES_128_BLOCK_SIZE;
+    xor_block(x, m + pos, len);
+    pos += len;
+    native_aes_128_encrypt_blocks(x, 1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_key(const uint8_t *key)
+{
+  native_aes_128_driver.set_key(key);
+}
+/*---------------------------------------------------------------------------*/
+static void
+aead(const uint8_t *nonce,
+    uint8_t *m, uint8_t m_len,
+    const uint8_t *a, uint8_t a_len,
+    uint8_t *result, uint8_t mic_len,
+    int forward)
+{
+  uint8_t s[MAX_CTR_BLOCKS][AES_128_BLOCK_SIZE];
+  uint8_t x[AES_128_BLOCK_SIZE];
+  uint8_t blocks;
+  uint8_t i;
+
+  /* S_0 ... S_n: A_0 encrypts the MIC, A_1 onwards the message */
+  blocks = (m_len + AES_128_BLOCK_SIZE - 1) / AES_128_BLOCK_SIZE + 1;
+  for(i = 0; i < blocks; i++) {
+    set_iv(s[i], CCM_STAR_ENCRYPTION_FLAGS, nonce, i);
+  }
+  native_aes_128_encrypt_blocks(s[0], blocks);
+
+  if(!forward) {
+    /* decrypt */
+    ctr(s, m, m_len);
+  }
+
+  cbc_mac(nonce, m, m_len, a, a_len, mic_len, x);
+
+  if(forward) {
+    /* encrypt */
+    ctr(s, m, m_len);
+  }
+
+  xor_block(x, s[0], mic_len);
+  memcpy(result, x, mic_len);
+}
+/*---------------------------------------------------------------------------*/
+const struct ccm_star_driver native_ccm_star_driver = {
+  set_key,
+  aead
+};
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Internet checksum for the native platform.
+ *
+ *         The one's complement sum does not depend on byte order
+ *         (RFC 1071), so words are added in host order with wide
+ *         accumulators, using AVX2 or SSE2 when the host supports them,
+ *         and the result is swapped back once.
+ */
+
+#include "net/ip/ip-chksum.h"
+#include "net/ip/uip.h"
+#include <string.h>
+
+#if IP_CHKSUM_ARCH
+
+#if defined(__x86_64__) || defined(__i386__)
+#define WITH_SIMD 1
+#include <immintrin.h>
+#define SSE2_FUNCTION __attribute__((target("sse2")))
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#else
+#define WITH_SIMD 0
+#endif
+
+/* Shorter buffers, such as pseudo headers, are not worth a vector loop */
+#define SIMD_MIN_LEN 64
+
+/*---------------------------------------------------------------------------*/
+static uint64_t
+sum_scalar(const uint8_t *data, uint16_t len)
+{
+  uint64_t acc;
+  uint32_t w[4];
+  uint16_t h;
+
+  acc = 0;
+  while(len >= 16) {
+    memcpy(w, data, 16);
+    acc += (uint64_t)w[0] + w[1] + w[2] + w[3];
+    data += 16;
+    len -= 16;
+  }
+  while(len >= 4) {
+    memcpy(w, data, 4);
+    acc += w[0];
+    data += 4;
+    len -= 4;
+  }
+  if(len >= 2) {
+    memcpy(&h, data, 2);
+    acc += h;
+    data += 2;
+    len -= 2;
+  }
+  if(len) {
+    /* Pad the odd byte with zero, in host order */
+    h = 0;
+    memcpy(&h, data, 1);
+    acc += h;
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+#if WITH_SIMD
+SSE2_FUNCTION static uint64_t
+sum_sse2(const uint8_t *data, uint16_t len)
+{
+  __m128i zero, acc0, acc1, v;
+  uint32_t lanes[4];
+
+  /* Each 32-bit lane gets at most 2 words per 16 bytes, which cannot
+     overflow for a uint16_t length */
+  zero = _mm_setzero_si128();
+  acc0 = acc1 = zero;
+  while(len >= 16) {
+    v = _mm_loadu_si128((const __m128i *)data);
+    acc0 = _mm_add_epi32(acc0, _mm_unpacklo_epi16(v, zero));
+    acc1 = _mm_add_epi32(acc1, _mm_unpackhi_epi16(v, zero));
+    data += 16;
+    len -= 16;
+  }
+  _mm_storeu_si128((__m128i *)lanes, _mm_add_epi32(acc0, acc1));
+  return (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+    sum_scalar(data, len);
+}
+/*---------------------------------------------------------------------------*/
+AVX2_FUNCTION static uint64_t
+sum_avx2(const uint8_t *data, uint16_t len)
+{
+  __m256i zero, acc0, acc1, v;
+  uint32_t lanes[8];
+  uint64_t acc;
+  int i;
+
+  zero = _mm256_setzero_si256();
+  acc0 = acc1 = zero;
+  while(len >= 32) {
+    v = _mm256_loadu_si256((const __m256i *)data);
+    acc0 = _mm256_add_epi32(acc0, _mm256_unpacklo_epi16(v, zero));
+    acc1 = _mm256_add_epi32(acc1, _mm256_unpackhi_epi16(v, zero));
+    data += 32;
+    len -= 32;
+  }
+  _mm256_storeu_si256((__m256i *)lanes, _mm256_add_epi32(acc0, acc1));
+  acc = 0;
+  for(i = 0; i < 8; i++) {
+    acc += lanes[i];
+  }
+  return acc + sum_scalar(data, len);
+}
+#endif /* WITH_SIMD */
+/*---------------------------------------------------------------------------*/
+static uint64_t (*sum_bulk)(const uint8_t *data, uint16_t len);
+
+static void
+select_sum_bulk(void)
+{
+  sum_bulk = sum_scalar;
+#if WITH_SIMD
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2")) {
+    sum_bulk = sum_avx2;
+  } else if(__builtin_cpu_supports("sse2")) {
+    sum_bulk = sum_sse2;
+  }
+#endif /* WITH_SIMD */
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+ip_chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint64_t acc;
+
+  acc = uip_htons(sum);
+  if(len < SIMD_MIN_LEN) {
+    acc += sum_scalar(data, len);
+  } else {
+    if(sum_bulk == NULL) {
+      select_sum_bulk();
+    }
+    acc += sum_bulk(data, len);
+  }
+
+  /* Fold the carries back in; a nonzero sum never folds to zero */
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+
+  /* Return sum in host byte order. */
+  return uip_ntohs((uint16_t)acc);
+}
+/*---------------------------------------------------------------------------*/
+#endif /* IP_CHKSUM_ARCH */
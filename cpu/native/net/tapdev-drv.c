@@ -59,10 +59,8 @@ tapdev_output(void)
 #endif
 /*---------------------------------------------------------------------------*/
 static void
-pollhandler(void)
+input(void)
 {
-  uip_len = tapdev_poll();
-
   if(uip_len > 0) {
 #if NETSTACK_CONF_WITH_IPV6
     if(BUF->type == uip_htons(UIP_ETHTYPE_IPV6)) {
@@ -88,6 +86,47 @@ pollhandler(void)
   }
 }
 /*---------------------------------------------------------------------------*/
+static void
+pollhandler(void)
+{
+  int i;
+
+  for(i = 0; i < TAPDEV_BATCH; i++) {
+    uip_len = tapdev_poll();
+    if(uip_len == 0) {
+      return;
+    }
+    input();
+  }
+
+  /* There may be more frames waiting: let the other processes run
+     before reading the next batch. */
+  process_poll(&tapdev_process);
+}
+/*---------------------------------------------------------------------------*/
+#ifdef CONTIKI_TARGET_NATIVE
+/* On the native platform, the main loop polls the driver when the tap
+   device has frames to read. */
+static int
+set_fd(fd_set *rset, fd_set *wset)
+{
+  FD_SET(tapdev_fd(), rset);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_fd(fd_set *rset, fd_set *wset)
+{
+  if(FD_ISSET(tapdev_fd(), rset)) {
+    process_poll(&tapdev_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static const struct select_callback tapdev_select_callback = {
+  set_fd, handle_fd
+};
+#endif /* CONTIKI_TARGET_NATIVE */
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(tapdev_process, ev, data)
 {
   PROCESS_POLLHANDLER(pollhandler());
@@ -100,10 +139,16 @@ PROCESS_THREAD(tapdev_process, ev, data)
 #else
   tcpip_set_outputfunc(tapdev_send);
 #endif
+#ifdef CONTIKI_TARGET_NATIVE
+  select_set_callback(tapdev_fd(), &tapdev_select_callback);
+#endif /* CONTIKI_TARGET_NATIVE */
   process_poll(&tapdev_process);
 
   PROCESS_WAIT_UNTIL(ev == PROCESS_EVENT_EXIT);
 
+#ifdef CONTIKI_TARGET_NATIVE
+  select_set_callback(tapdev_fd(), NULL);
+#endif /* CONTIKI_TARGET_NATIVE */
   tapdev_exit();
 
   PROCESS_END();
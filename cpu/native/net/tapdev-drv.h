@@ -35,6 +35,15 @@
 
 #include "contiki.h"
 
+/* Number of frames the driver reads from the tap device each time it
+   is polled. Reading a batch saves a main loop wakeup per frame when
+   traffic is high; the driver polls itself again if frames are left. */
+#ifdef TAPDEV_CONF_BATCH
+#define TAPDEV_BATCH TAPDEV_CONF_BATCH
+#else
+#define TAPDEV_BATCH 1
+#endif
+
 PROCESS_NAME(tapdev_process);
 
 uint8_t tapdev_output(void);
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Antelope B+-tree index benchmark.
+ *
+ *         Inserts tuples in a shuffled key order into a relation
+ *         with an indexed attribute, and checks that range selections
+ *         return the right tuples. Then measures insertions and range
+ *         selections of different widths. Build with BASELINE=1 to
+ *         measure the MaxHeap index instead.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "cfs/cfs-coffee.h"
+#include "lib/random.h"
+
+#include "antelope.h"
+#include "index.h"
+#include "bench.h"
+
+#define TUPLES       10007
+#define ROUNDS       200
+
+#if BENCH_CONF_BASELINE
+#define INDEX_NAME   "MAXHEAP"
+#else
+#define INDEX_NAME   "BTREE"
+#endif
+
+PROCESS(antelope_btree_bench_process, "Antelope B+-tree benchmark");
+AUTOSTART_PROCESSES(&antelope_btree_bench_process);
+/*---------------------------------------------------------------------------*/
+static void
+query(const char *q)
+{
+  db_result_t result;
+
+  result = db_query(NULL, q);
+  check(DB_SUCCESS(result), q, result);
+}
+/*---------------------------------------------------------------------------*/
+/* Visits the keys 0..TUPLES-1 in a shuffled order. */
+static long
+key(long i)
+{
+  return (i * 7919) % TUPLES;
+}
+/*---------------------------------------------------------------------------*/
+/* Selects the keys in [low, high) and checks that each is found once. */
+static void
+select_range(long low, long high)
+{
+  db_handle_t handle;
+  attribute_value_t value;
+  db_result_t result;
+  long count, sum, t;
+
+  result = db_query(&handle, "SELECT t, v FROM samples WHERE t >= %ld AND t < %ld;",
+                    low, high);
+  check(DB_SUCCESS(result), "select", low);
+  if(DB_ERROR(result)) {
+    return;
+  }
+
+  count = sum = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      check(db_get_value(&value, &handle, 0) == DB_OK, "value", low);
+      t = db_value_to_long(&value);
+      check(db_get_value(&value, &handle, 1) == DB_OK, "value", low);
+      check(key(db_value_to_long(&value)) == t, "tuple", t);
+      sum += t;
+      count++;
+    } else if(result != DB_OK) {
+      check(result == DB_FINISHED, "process", result);
+      break;
+    }
+  }
+  db_free(&handle);
+
+  check(count == high - low, "count", count);
+  check(sum == (low + high - 1) * (high - low) / 2, "sum", low);
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_select(long width)
+{
+  unsigned long long t0, t1;
+  long low;
+  int i;
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    low = random_rand() % (TUPLES - width);
+    select_range(low, low + width);
+  }
+  t1 = now_ns();
+  printf("antelope-btree-bench: select range %ld, %d tuples: %llu ns\n",
+         width, TUPLES, (t1 - t0) / ROUNDS);
+}
+/*---------------------------------------------------------------------------*/
+#if !BENCH_CONF_BASELINE
+static void
+reload_index(void)
+{
+  relation_t *rel;
+  attribute_t *attr;
+
+  rel = relation_load("samples");
+  check(rel != NULL, "load relation", 0);
+  if(rel == NULL) {
+    return;
+  }
+  attr = relation_attribute_get(rel, "t");
+  check(attr != NULL && attr->index != NULL, "index", 0);
+  if(attr != NULL && attr->index != NULL) {
+    check(index_release(attr->index) == DB_OK, "release index", 0);
+    check(index_load(rel, attr) == DB_OK, "load index", 0);
+  }
+  relation_release(rel);
+}
+#endif /* !BENCH_CONF_BASELINE */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(antelope_btree_bench_process, ev, data)
+{
+  unsigned long long t0, t1;
+  long i;
+
+  PROCESS_BEGIN();
+
+  cfs_coffee_format();
+  db_init();
+
+  query("CREATE RELATION samples;");
+  query("CREATE ATTRIBUTE t DOMAIN LONG IN samples;");
+  query("CREATE ATTRIBUTE v DOMAIN INT IN samples;");
+  query("CREATE INDEX samples.t TYPE " INDEX_NAME ";");
+
+  t0 = now_ns();
+  for(i = 0; i < TUPLES; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%ld, %ld) INTO samples;",
+                         key(i), i))) {
+      check(0, "insert", i);
+      break;
+    }
+  }
+  t1 = now_ns();
+  printf("antelope-btree-bench: insert, %s index: %llu ns\n", INDEX_NAME,
+         (t1 - t0) / TUPLES);
+
+  select_range(0, 1);
+  select_range(TUPLES - 1, TUPLES);
+  select_range(1234, 5678);
+  select_range(0, TUPLES);
+
+#if !BENCH_CONF_BASELINE
+  reload_index();
+  select_range(4321, 8765);
+#endif
+
+  bench_select(1);
+  bench_select(10);
+  bench_select(100);
+  bench_select(1000);
+
+  printf("antelope-btree-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
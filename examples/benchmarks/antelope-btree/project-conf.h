@@ -0,0 +1,9 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define DB_FEATURE_BTREE        1
+
+/* Room for more than 10000 tuples in the index */
+#define DB_BTREE_NODE_LIMIT     2048
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Antelope join benchmark.
+ *
+ *         Joins a relation of sensor samples with a smaller relation
+ *         that maps sensors to rooms, in both orders. Checks the joined
+ *         tuples, and that a join on a string without an index fails.
+ *         Then measures the time per join. Without an index on
+ *         the join attribute of the right relation, Antelope uses a
+ *         hash join. Build with BASELINE=1 to index the join attributes,
+ *         so that Antelope uses an index nested-loop join.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "contiki.h"
+#include "cfs/cfs-coffee.h"
+
+#include "antelope.h"
+#include "bench.h"
+
+#define SAMPLES      5000
+#define SENSORS      200
+#define ROUNDS       5
+
+PROCESS(antelope_join_bench_process, "Antelope join benchmark");
+AUTOSTART_PROCESSES(&antelope_join_bench_process);
+/*---------------------------------------------------------------------------*/
+static void
+query(const char *q)
+{
+  db_result_t result;
+
+  result = db_query(NULL, q);
+  check(DB_SUCCESS(result), q, result);
+}
+/*---------------------------------------------------------------------------*/
+/* Runs a join that projects a value and a room, and returns the number
+   of rows and the sums of both attributes in them. The value is in the
+   given column, and the room is in the other one. */
+static long
+join_rows(const char *q, int value_column, long *value_sum, long *room_sum)
+{
+  db_handle_t handle;
+  attribute_value_t value;
+  db_result_t result;
+  long count;
+
+  result = db_query(&handle, q);
+  check(DB_SUCCESS(result), q, result);
+  if(DB_ERROR(result)) {
+    return -1;
+  }
+
+  count = *value_sum = *room_sum = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      check(db_get_value(&value, &handle, value_column) == DB_OK,
+            "value", count);
+      *value_sum += db_value_to_long(&value);
+      check(db_get_value(&value, &handle, !value_column) == DB_OK,
+            "room", count);
+      *room_sum += db_value_to_long(&value);
+      count++;
+    } else if(result != DB_OK) {
+      check(result == DB_FINISHED, "process", result);
+      break;
+    }
+  }
+  db_free(&handle);
+
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test(const char *q, int value_column)
+{
+  long i, count, value_sum, room_sum;
+  long expected_value_sum, expected_room_sum;
+
+  expected_value_sum = expected_room_sum = 0;
+  for(i = 0; i < SAMPLES; i++) {
+    expected_value_sum += i % 13;
+    expected_room_sum += i % SENSORS % 10;
+  }
+
+  count = join_rows(q, value_column, &value_sum, &room_sum);
+  check(count == SAMPLES, q, count);
+  check(value_sum == expected_value_sum, "value sum", value_sum);
+  check(room_sum == expected_room_sum, "room sum", room_sum);
+}
+/*---------------------------------------------------------------------------*/
+/* The hash join only handles integer keys, so a join on a string
+   attribute without an index must fail rather than match every pair. */
+static void
+test_string_key(void)
+{
+  db_handle_t handle;
+  db_result_t result;
+
+  query("CREATE RELATION rooms;");
+  query("CREATE ATTRIBUTE name DOMAIN STRING(8) IN rooms;");
+  query("CREATE ATTRIBUTE floor DOMAIN INT IN rooms;");
+  query("INSERT ('hall', 0) INTO rooms;");
+  query("INSERT ('lab', 1) INTO rooms;");
+
+  query("CREATE RELATION desks;");
+  query("CREATE ATTRIBUTE name DOMAIN STRING(8) IN desks;");
+  query("CREATE ATTRIBUTE desk DOMAIN INT IN desks;");
+  query("INSERT ('hall', 1) INTO desks;");
+  query("INSERT ('lab', 2) INTO desks;");
+  query("INSERT ('lab', 3) INTO desks;");
+
+  result = db_query(&handle, "JOIN desks, rooms ON name PROJECT desk, floor;");
+  check(result == DB_INDEX_ERROR, "join on a string", result);
+  db_free(&handle);
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(const char *what, const char *q, int value_column)
+{
+  unsigned long long t0, t1;
+  long value_sum, room_sum;
+  int i;
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    join_rows(q, value_column, &value_sum, &room_sum);
+  }
+  t1 = now_ns();
+  printf("antelope-join-bench: %s: %llu us\n", what,
+         (t1 - t0) / ROUNDS / 1000);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(antelope_join_bench_process, ev, data)
+{
+  long i;
+
+  PROCESS_BEGIN();
+
+  cfs_coffee_format();
+  db_init();
+
+  query("CREATE RELATION samples;");
+  query("CREATE ATTRIBUTE id DOMAIN INT IN samples;");
+  query("CREATE ATTRIBUTE value DOMAIN INT IN samples;");
+
+  query("CREATE RELATION sensors;");
+  query("CREATE ATTRIBUTE id DOMAIN INT IN sensors;");
+  query("CREATE ATTRIBUTE room DOMAIN INT IN sensors;");
+
+#if BENCH_CONF_BASELINE
+  query("CREATE INDEX samples.id TYPE BTREE;");
+  query("CREATE INDEX sensors.id TYPE MAXHEAP;");
+#endif /* BENCH_CONF_BASELINE */
+
+  for(i = 0; i < SAMPLES; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%ld, %ld) INTO samples;",
+                         i % SENSORS, i % 13))) {
+      check(0, "insert sample", i);
+      break;
+    }
+  }
+  for(i = 0; i < SENSORS; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%ld, %ld) INTO sensors;",
+                         i, i % 10))) {
+      check(0, "insert sensor", i);
+      break;
+    }
+  }
+
+  test("JOIN samples, sensors ON id PROJECT value, room;", 0);
+  test("JOIN sensors, samples ON id PROJECT room, value;", 1);
+  test_string_key();
+
+  bench("samples with sensors, 5000 x 200 tuples",
+        "JOIN samples, sensors ON id PROJECT value, room;", 0);
+  bench("sensors with samples, 200 x 5000 tuples",
+        "JOIN sensors, samples ON id PROJECT room, value;", 1);
+
+  printf("antelope-join-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
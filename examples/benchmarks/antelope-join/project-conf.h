@@ -0,0 +1,12 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+/* Keep all the sensors in one hash table */
+#define DB_JOIN_HASH_ENTRIES 256
+
+#if BENCH_CONF_BASELINE
+/* The baseline indexes the samples with a B+-tree */
+#define DB_FEATURE_BTREE 1
+#endif /* BENCH_CONF_BASELINE */
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Antelope selection benchmark.
+ *
+ *         Fills a relation with a data log, and checks the results of
+ *         selections that scan the whole relation, with and without a
+ *         predicate and an aggregator. Then measures these selections.
+ *         Build with BASELINE=1 to read one row at a time.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "cfs/cfs-coffee.h"
+
+#include "antelope.h"
+#include "bench.h"
+
+#define TUPLES       10000
+#define ROUNDS       20
+
+PROCESS(antelope_select_bench_process, "Antelope selection benchmark");
+AUTOSTART_PROCESSES(&antelope_select_bench_process);
+/*---------------------------------------------------------------------------*/
+static void
+query(const char *q)
+{
+  db_result_t result;
+
+  result = db_query(NULL, q);
+  check(DB_SUCCESS(result), q, result);
+}
+/*---------------------------------------------------------------------------*/
+static long
+level(long i)
+{
+  return (i * 37) % 1000;
+}
+/*---------------------------------------------------------------------------*/
+/* Runs a selection, and returns the number of rows and the sum of the
+   first attribute in them. */
+static long
+select_rows(const char *q, long *sum)
+{
+  db_handle_t handle;
+  attribute_value_t value;
+  db_result_t result;
+  long count;
+
+  result = db_query(&handle, q);
+  check(DB_SUCCESS(result), q, result);
+  if(DB_ERROR(result)) {
+    return -1;
+  }
+
+  count = *sum = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      check(db_get_value(&value, &handle, 0) == DB_OK, "value", count);
+      *sum += db_value_to_long(&value);
+      count++;
+    } else if(result != DB_OK) {
+      check(result == DB_FINISHED, "process", result);
+      break;
+    }
+  }
+  db_free(&handle);
+
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test(void)
+{
+  long i, count, sum;
+  long expected_count, expected_sum;
+
+  count = select_rows("SELECT t FROM log;", &sum);
+  check(count == TUPLES, "all", count);
+  check(sum == (long)TUPLES * (TUPLES - 1) / 2, "all sum", sum);
+
+  expected_count = expected_sum = 0;
+  for(i = 0; i < TUPLES; i++) {
+    if(level(i) > 900) {
+      expected_count++;
+      expected_sum += i;
+    }
+  }
+  count = select_rows("SELECT t, v FROM log WHERE v > 900;", &sum);
+  check(count == expected_count, "v > 900", count);
+  check(sum == expected_sum, "v > 900 sum", sum);
+
+  expected_count = 0;
+  for(i = 0; i < TUPLES; i++) {
+    if(level(i) < 500 && i % 7 == 3) {
+      expected_count++;
+    }
+  }
+  count = select_rows("SELECT COUNT(t) FROM log WHERE v < 500 AND w = 3;", &sum);
+  check(count == 1, "count rows", count);
+  check(sum == expected_count, "count", sum);
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(const char *what, const char *q)
+{
+  unsigned long long t0, t1;
+  long sum;
+  int i;
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    select_rows(q, &sum);
+  }
+  t1 = now_ns();
+  printf("antelope-select-bench: %s, %d tuples: %llu ns\n", what, TUPLES,
+         (t1 - t0) / ROUNDS);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(antelope_select_bench_process, ev, data)
+{
+  long i;
+
+  PROCESS_BEGIN();
+
+  cfs_coffee_format();
+  db_init();
+
+  query("CREATE RELATION log;");
+  query("CREATE ATTRIBUTE t DOMAIN LONG IN log;");
+  query("CREATE ATTRIBUTE v DOMAIN INT IN log;");
+  query("CREATE ATTRIBUTE w DOMAIN INT IN log;");
+
+  for(i = 0; i < TUPLES; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%ld, %ld, %ld) INTO log;",
+                         i, level(i), i % 7))) {
+      check(0, "insert", i);
+      break;
+    }
+  }
+
+  test();
+
+  bench("select all", "SELECT t FROM log;");
+  bench("select 10%", "SELECT t, v FROM log WHERE v > 900;");
+  bench("select 50%", "SELECT t, v FROM log WHERE v < 500;");
+  bench("count", "SELECT COUNT(t) FROM log WHERE v < 500 AND w = 3;");
+
+  printf("antelope-select-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,9 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#if BENCH_CONF_BASELINE
+/* Read a single row at a time */
+#define DB_SCAN_BUFFER_SIZE 1
+#endif /* BENCH_CONF_BASELINE */
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         AES-CCM* throughput benchmark.
+ *
+ *         Checks the AES_128 and CCM_STAR drivers against the FIPS-197,
+ *         IEEE 802.15.4-2006 and RFC 3610 test vectors, then measures
+ *         authenticated encryption of 802.15.4-sized frames with the key
+ *         set before every frame, as the link-layer security code does.
+ *         Build with BASELINE=1 to measure the software drivers without
+ *         the key cache.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lib/aes-128.h"
+#include "lib/ccm-star.h"
+#include "dev/native-aes-128.h"
+#include "bench.h"
+
+#define FRAMES 200000
+#define KEYS   4
+#define MIC_LEN 8
+
+PROCESS(ccm_star_bench_process, "CCM* benchmark");
+AUTOSTART_PROCESSES(&ccm_star_bench_process);
+/*---------------------------------------------------------------------------*/
+static void
+check_driver(int cond, const char *driver, const char *what)
+{
+  if(!cond) {
+    printf("%s: error: %s\n", driver, what);
+    errors++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static const uint8_t key_c0[16] = {
+  0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7,
+  0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF };
+/*---------------------------------------------------------------------------*/
+/* FIPS-197, appendix C.1 */
+static void
+test_aes_128(const struct aes_128_driver *aes, const char *name)
+{
+  static const uint8_t key[16] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F };
+  static const uint8_t oracle[16] = {
+    0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+    0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A };
+  uint8_t data[16] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF };
+
+  aes->set_key(key);
+  aes->encrypt(data);
+  check_driver(memcmp(data, oracle, 16) == 0, name, "FIPS-197 C.1");
+
+  /* Switching keys and back must give the same result */
+  memcpy(data, oracle, 16);
+  aes->set_key(key_c0);
+  aes->encrypt(data);
+  aes->set_key(key);
+  memcpy(data, (const uint8_t []){
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF }, 16);
+  aes->encrypt(data);
+  check_driver(memcmp(data, oracle, 16) == 0,
+               name, "FIPS-197 C.1 after key switch");
+}
+/*---------------------------------------------------------------------------*/
+/* IEEE 802.15.4-2006, C.2.1.1 (MIC-64) and C.2.1.2 (ENC-MIC-64) */
+static void
+test_802154(const struct ccm_star_driver *ccm, const char *name)
+{
+  static const uint8_t nonce2[13] = {
+    0xAC, 0xDE, 0x48, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x05, 0x02 };
+  static const uint8_t a2[26] = {
+    0x08, 0xD0, 0x84, 0x21, 0x43,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x48, 0xDE, 0xAC,
+    0x02,
+    0x05, 0x00, 0x00, 0x00,
+    0x55, 0xCF, 0x00, 0x00, 0x51, 0x52, 0x53, 0x54 };
+  static const uint8_t mic2[MIC_LEN] = {
+    0x22, 0x3B, 0xC1, 0xEC, 0x84, 0x1A, 0xB5, 0x53 };
+  static const uint8_t nonce6[13] = {
+    0xAC, 0xDE, 0x48, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x05, 0x06 };
+  static const uint8_t a6[29] = {
+    0x2B, 0xDC, 0x84, 0x21, 0x43,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x48, 0xDE, 0xAC,
+    0xFF, 0xFF,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x48, 0xDE, 0xAC,
+    0x06,
+    0x05, 0x00, 0x00, 0x00,
+    0x01 };
+  static const uint8_t mic6[MIC_LEN] = {
+    0x4F, 0xDE, 0x52, 0x90, 0x61, 0xF9, 0xC6, 0xF1 };
+  uint8_t mic[MIC_LEN];
+  uint8_t m;
+
+  ccm->set_key(key_c0);
+  ccm->aead(nonce2, NULL, 0, a2, sizeof(a2), mic, MIC_LEN, 1);
+  check_driver(memcmp(mic, mic2, MIC_LEN) == 0, name, "802.15.4 C.2.1.1 MIC");
+
+  m = 0xCE;
+  ccm->aead(nonce6, &m, 1, a6, sizeof(a6), mic, MIC_LEN, 1);
+  check_driver(memcmp(mic, mic6, MIC_LEN) == 0, name, "802.15.4 C.2.1.2 MIC");
+  check_driver(m == 0xD8, name, "802.15.4 C.2.1.2 encryption");
+  ccm->aead(nonce6, &m, 1, a6, sizeof(a6), mic, MIC_LEN, 0);
+  check_driver(memcmp(mic, mic6, MIC_LEN) == 0,
+               name, "802.15.4 C.2.1.2 verification");
+  check_driver(m == 0xCE, name, "802.15.4 C.2.1.2 decryption");
+}
+/*---------------------------------------------------------------------------*/
+/* RFC 3610, packet vector #1 */
+static void
+test_rfc3610(const struct ccm_star_driver *ccm, const char *name)
+{
+  static const uint8_t nonce[13] = {
+    0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00,
+    0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5 };
+  static const uint8_t a[8] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 };
+  static const uint8_t ciphertext[23] = {
+    0x58, 0x8C, 0x97, 0x9A, 0x61, 0xC6, 0x63, 0xD2,
+    0xF0, 0x66, 0xD0, 0xC2, 0xC0, 0xF9, 0x89, 0x80,
+    0x6D, 0x5F, 0x6B, 0x61, 0xDA, 0xC3, 0x84 };
+  static const uint8_t oracle[MIC_LEN] = {
+    0x17, 0xE8, 0xD1, 0x2C, 0xFD, 0xF9, 0x26, 0xE0 };
+  uint8_t m[23];
+  uint8_t mic[MIC_LEN];
+  uint8_t i;
+
+  for(i = 0; i < sizeof(m); i++) {
+    m[i] = 0x08 + i;
+  }
+  ccm->set_key(key_c0);
+  ccm->aead(nonce, m, sizeof(m), a, sizeof(a), mic, MIC_LEN, 1);
+  check_driver(memcmp(m, ciphertext, sizeof(m)) == 0,
+               name, "RFC 3610 #1 encryption");
+  check_driver(memcmp(mic, oracle, MIC_LEN) == 0, name, "RFC 3610 #1 MIC");
+}
+/*---------------------------------------------------------------------------*/
+/* Both drivers must agree on every length, including partial blocks */
+static void
+test_lengths(const struct ccm_star_driver *ccm, const char *name)
+{
+  static const uint8_t nonce[13] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 };
+  uint8_t a[40];
+  uint8_t m1[120], m2[120];
+  uint8_t mic1[16], mic2[16];
+  int a_len, m_len, i;
+
+  for(i = 0; i < sizeof(a); i++) {
+    a[i] = i * 3;
+  }
+  for(a_len = 0; a_len <= sizeof(a); a_len += 7) {
+    for(m_len = 0; m_len <= sizeof(m1); m_len += 5) {
+      for(i = 0; i < m_len; i++) {
+        m1[i] = m2[i] = i ^ a_len;
+      }
+      ccm_star_driver.set_key(key_c0);
+      ccm_star_driver.aead(nonce, m1, m_len, a, a_len, mic1, 16, 1);
+      ccm->set_key(key_c0);
+      ccm->aead(nonce, m2, m_len, a, a_len, mic2, 16, 1);
+      if(memcmp(m1, m2, m_len) != 0 || memcmp(mic1, mic2, 16) != 0) {
+        check_driver(0, name, "differs from ccm_star_driver");
+        return;
+      }
+      ccm->aead(nonce, m2, m_len, a, a_len, mic2, 16, 0);
+      for(i = 0; i < m_len; i++) {
+        if(m2[i] != (uint8_t)(i ^ a_len)) {
+          check_driver(0, name, "decryption does not invert encryption");
+          return;
+        }
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+measure(uint8_t a_len, uint8_t m_len, int keys)
+{
+  static uint8_t key[KEYS][16];
+  uint8_t nonce[13];
+  uint8_t a[64];
+  uint8_t m[128];
+  uint8_t mic[MIC_LEN];
+  unsigned long long t0, t;
+  uint32_t i;
+
+  memset(nonce, 0x5A, sizeof(nonce));
+  memset(a, 0xA5, sizeof(a));
+  memset(m, 0x3C, sizeof(m));
+  for(i = 0; i < KEYS; i++) {
+    memcpy(key[i], key_c0, 16);
+    key[i][0] ^= i;
+  }
+
+  t0 = now_ns();
+  for(i = 0; i < FRAMES; i++) {
+    nonce[11] = i;
+    CCM_STAR.set_key(key[i % keys]);
+    CCM_STAR.aead(nonce, m, m_len, a, a_len, mic, MIC_LEN, 1);
+  }
+  t = now_ns() - t0;
+
+  printf("a %2u m %3u, %d key%s: %6llu ns/frame, %6.1f MB/s\n",
+         a_len, m_len, keys, keys > 1 ? "s" : " ", t / FRAMES,
+         (double)FRAMES * (a_len + m_len) * 1000.0 / t);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(ccm_star_bench_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("ccm-star-bench: %s drivers, AES-NI %s, key cache %d\n",
+#if BENCH_CONF_BASELINE
+         "software",
+#else
+         "native",
+#endif
+         native_aes_128_has_aesni() ? "available" : "unavailable",
+         AES_128_KEY_CACHE);
+
+  test_aes_128(&aes_128_driver, "aes_128_driver");
+  test_aes_128(&AES_128, "AES_128");
+  test_802154(&ccm_star_driver, "ccm_star_driver");
+  test_802154(&CCM_STAR, "CCM_STAR");
+  test_rfc3610(&ccm_star_driver, "ccm_star_driver");
+  test_rfc3610(&CCM_STAR, "CCM_STAR");
+  test_lengths(&CCM_STAR, "CCM_STAR");
+
+  /* Acknowledgement, data frame, full frame */
+  measure(13, 0, 1);
+  measure(23, 32, 1);
+  measure(23, 32, KEYS);
+  measure(23, 96, 1);
+  measure(23, 96, KEYS);
+
+  printf("ccm-star-bench: %d errors\n", errors);
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,13 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#if BENCH_CONF_BASELINE
+#undef AES_128_CONF
+#define AES_128_CONF aes_128_driver
+#undef CCM_STAR_CONF
+#define CCM_STAR_CONF ccm_star_driver
+#undef AES_128_CONF_KEY_CACHE
+#define AES_128_CONF_KEY_CACHE 0
+#endif /* BENCH_CONF_BASELINE */
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Internet checksum benchmark.
+ *
+ *         Checks ip_chksum() against the byte-at-a-time reference for
+ *         every length and alignment, checks ip_chksum_adjust(), and
+ *         checks that packets translated by ip64 carry valid transport
+ *         checksums. Then measures the checksum of IPv6-sized buffers
+ *         and the translation of a UDP packet. Build with BASELINE=1
+ *         to measure the portable C checksum.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ip/uip.h"
+#include "net/ip/ip-chksum.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "ip64.h"
+#include "ip64-addrmap.h"
+#include "lib/random.h"
+#include "bench.h"
+
+#define MAX_LEN    1500
+#define ROUNDS     100000
+#define IPV6_HDRLEN 40
+#define IPV4_HDRLEN 20
+#define UDP_HDRLEN  8
+
+static uint8_t buf[MAX_LEN + 8];
+static uint8_t packet6[UIP_BUFSIZE];
+static uint8_t packet4[UIP_BUFSIZE];
+static uint8_t reply6[UIP_BUFSIZE];
+
+PROCESS(chksum_bench_process, "Checksum benchmark");
+AUTOSTART_PROCESSES(&chksum_bench_process);
+/*---------------------------------------------------------------------------*/
+/* The byte-at-a-time loop that uip6.c used */
+static uint16_t
+ref_chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint16_t t;
+  const uint8_t *dataptr;
+  const uint8_t *last_byte;
+
+  dataptr = data;
+  last_byte = data + len - 1;
+
+  while(dataptr < last_byte) {
+    t = (dataptr[0] << 8) + dataptr[1];
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+    dataptr += 2;
+  }
+
+  if(dataptr == last_byte) {
+    t = (dataptr[0] << 8) + 0;
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+  }
+
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill_random(uint8_t *p, int len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    p[i] = random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_chksum(void)
+{
+  uint16_t sum;
+  int len, offset;
+
+  fill_random(buf, sizeof(buf));
+  for(offset = 0; offset < 8; offset++) {
+    for(len = 0; len <= MAX_LEN; len++) {
+      sum = random_rand();
+      if(ip_chksum(sum, buf + offset, len) != ref_chksum(sum, buf + offset, len)) {
+        check(0, "ip_chksum differs from reference, length", len);
+        return;
+      }
+    }
+  }
+
+  /* Sums that end on 0xffff and all-zero data */
+  memset(buf, 0xff, sizeof(buf));
+  check(ip_chksum(0, buf, 1280) == ref_chksum(0, buf, 1280), "all ones", 1280);
+  check(ip_chksum(1, buf, 1279) == ref_chksum(1, buf, 1279), "all ones", 1279);
+  memset(buf, 0, sizeof(buf));
+  check(ip_chksum(0, buf, 1280) == 0, "all zeros", 1280);
+  check(ip_chksum(0xffff, buf, 1280) == 0xffff, "all zeros", 1280);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_adjust(void)
+{
+  uint16_t field, old_sum, new_sum;
+  int i, pos, n;
+
+  for(i = 0; i < 10000; i++) {
+    fill_random(buf, 256);
+    /* uIP stores the complement of the sum */
+    field = ~ip_chksum(0, buf, 256);
+
+    pos = (random_rand() % 120) * 2;
+    n = 2 + (random_rand() % 8) * 2;
+    old_sum = ip_chksum(0, buf + pos, n);
+    fill_random(buf + pos, n);
+    new_sum = ip_chksum(0, buf + pos, n);
+    field = ip_chksum_adjust(field, old_sum, new_sum);
+
+    /* The data plus a correct checksum sums to 0xffff */
+    if(ip_chksum(field, buf, 256) != 0xffff) {
+      check(0, "adjusted checksum does not verify, round", i);
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+transport_sum(const uint8_t *packet, int ipv6, uint16_t len)
+{
+  uint16_t sum;
+  uint8_t proto;
+  int hdrlen;
+
+  if(ipv6) {
+    hdrlen = IPV6_HDRLEN;
+    proto = packet[6];
+    sum = ref_chksum(len - hdrlen + proto, packet + 8, 32);
+  } else {
+    hdrlen = IPV4_HDRLEN;
+    proto = packet[9];
+    sum = proto == UIP_PROTO_ICMP ? 0 :
+      ref_chksum(len - hdrlen + proto, packet + 12, 8);
+  }
+  return ref_chksum(sum, packet + hdrlen, len - hdrlen);
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+make_packet6(uint8_t proto, uint16_t payload_len)
+{
+  static const uint8_t src[16] = {
+    0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0x02, 0x12, 0x74, 0x01, 0, 1, 1, 1 };
+  static const uint8_t dst[16] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 10, 0, 0, 2 };
+  uint8_t *t = packet6 + IPV6_HDRLEN;
+  uint16_t tlen, sum;
+  int ck;
+
+  tlen = (proto == UIP_PROTO_TCP ? 20 : UDP_HDRLEN) + payload_len;
+  memset(packet6, 0, IPV6_HDRLEN + tlen);
+  packet6[0] = 0x60;
+  packet6[4] = tlen >> 8;
+  packet6[5] = tlen & 0xff;
+  packet6[6] = proto;
+  packet6[7] = 64;
+  memcpy(packet6 + 8, src, 16);
+  memcpy(packet6 + 24, dst, 16);
+  fill_random(t, tlen);
+
+  if(proto == UIP_PROTO_ICMP6) {
+    t[0] = ICMP6_ECHO_REPLY;
+    t[1] = 0;
+    ck = 2;
+  } else {
+    t[0] = 0xc3;                /* source port 50000 */
+    t[1] = 0x50;
+    t[2] = 0x16;                /* destination port 5683 */
+    t[3] = 0x33;
+    if(proto == UIP_PROTO_UDP) {
+      t[4] = tlen >> 8;
+      t[5] = tlen & 0xff;
+      ck = 6;
+    } else {
+      ck = 16;
+    }
+  }
+  t[ck] = t[ck + 1] = 0;
+  sum = ~transport_sum(packet6, 1, IPV6_HDRLEN + tlen);
+  t[ck] = sum >> 8;
+  t[ck + 1] = sum & 0xff;
+  return IPV6_HDRLEN + tlen;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_ip64(uint8_t proto, const char *name)
+{
+  uint16_t len6, len4;
+  uint8_t *t;
+  uint8_t tmp[4];
+  int n;
+
+  for(n = 0; n < 20; n++) {
+    len6 = make_packet6(proto, random_rand() % 1000);
+    len4 = ip64_6to4(packet6, len6, packet4);
+    if(len4 == 0) {
+      printf("error: %s: 6to4 failed\n", name);
+      errors++;
+      return;
+    }
+    if(transport_sum(packet4, 0, len4) != 0xffff) {
+      printf("error: %s: bad IPv4 checksum\n", name);
+      errors++;
+      return;
+    }
+    if(proto == UIP_PROTO_ICMP6) {
+      continue;
+    }
+
+    /* Reply from the IPv4 host to the mapped port */
+    memcpy(tmp, packet4 + 12, 4);
+    memcpy(packet4 + 12, packet4 + 16, 4);
+    memcpy(packet4 + 16, tmp, 4);
+    t = packet4 + IPV4_HDRLEN;
+    memcpy(tmp, t, 2);
+    memcpy(t, t + 2, 2);
+    memcpy(t + 2, tmp, 2);
+    t[proto == UIP_PROTO_UDP ? 6 : 16] = 0;
+    t[proto == UIP_PROTO_UDP ? 7 : 17] = 0;
+    tmp[0] = ~transport_sum(packet4, 0, len4) >> 8;
+    tmp[1] = ~transport_sum(packet4, 0, len4) & 0xff;
+    t[proto == UIP_PROTO_UDP ? 6 : 16] = tmp[0];
+    t[proto == UIP_PROTO_UDP ? 7 : 17] = tmp[1];
+    len6 = ip64_4to6(packet4, len4, reply6);
+    if(len6 == 0) {
+      printf("error: %s: 4to6 failed\n", name);
+      errors++;
+      return;
+    }
+    if(transport_sum(reply6, 1, len6) != 0xffff) {
+      printf("error: %s: bad IPv6 checksum\n", name);
+      errors++;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+measure(uint16_t len)
+{
+  unsigned long long t0, fast, ref;
+  volatile uint16_t sink;
+  int i;
+
+  fill_random(buf, len);
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    sink = ip_chksum(i, buf, len);
+  }
+  fast = now_ns() - t0;
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    sink = ref_chksum(i, buf, len);
+  }
+  ref = now_ns() - t0;
+  (void)sink;
+
+  printf("%4u bytes: ip_chksum %5llu ns (%5.2f GB/s), byte loop %5llu ns\n",
+         len, fast / ROUNDS, (double)len * ROUNDS / fast, ref / ROUNDS);
+}
+/*---------------------------------------------------------------------------*/
+static void
+measure_ip64(void)
+{
+  unsigned long long t0, t;
+  uint16_t len6;
+  int i;
+
+  len6 = make_packet6(UIP_PROTO_UDP, 1024);
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    ip64_6to4(packet6, len6, packet4);
+  }
+  t = now_ns() - t0;
+  printf("ip64_6to4, %u byte UDP: %llu ns\n", len6, t / ROUNDS);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(chksum_bench_process, ev, data)
+{
+  static const uip_ip4addr_t hostaddr = {{ 10, 0, 0, 1 }};
+  static const uip_ip4addr_t netmask = {{ 255, 255, 255, 0 }};
+
+  PROCESS_BEGIN();
+
+  printf("chksum-bench: %s checksum\n",
+         IP_CHKSUM_ARCH ? "native" : "portable");
+
+  ip64_addrmap_init();
+  ip64_set_ipv4_address(&hostaddr, &netmask);
+
+  test_chksum();
+  test_adjust();
+  test_ip64(UIP_PROTO_UDP, "UDP");
+  test_ip64(UIP_PROTO_TCP, "TCP");
+  test_ip64(UIP_PROTO_ICMP6, "ICMPv6");
+
+  measure(40);
+  measure(128);
+  measure(1280);
+  measure(1500);
+  measure_ip64();
+
+  printf("chksum-bench: %d errors\n", errors);
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,12 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#if BENCH_CONF_BASELINE
+#undef IP_CHKSUM_CONF_ARCH
+#define IP_CHKSUM_CONF_ARCH 0
+#endif /* BENCH_CONF_BASELINE */
+
+#undef UIP_CONF_BUFFER_SIZE
+#define UIP_CONF_BUFFER_SIZE 1280
+
+#endif /* PROJECT_CONF_H_ */
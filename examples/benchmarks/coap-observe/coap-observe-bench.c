@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         CoAP observe benchmark.
+ *
+ *         Registers many observers of one resource, from different ports
+ *         of a neighbor, and measures the time to notify them all, to
+ *         match acknowledgements to transactions, and to cancel
+ *         observations by token and by reset. The sent notifications are
+ *         captured below 6LoWPAN and checked against messages serialized
+ *         one by one. Confirmable messages that are never acknowledged
+ *         are retransmitted until they time out. Build with BASELINE=1 to
+ *         keep transactions and observers in a single hash bucket.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/mac/mac.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "rest-engine.h"
+#include "er-coap.h"
+#include "er-coap-observe.h"
+#include "er-coap-transactions.h"
+#include "bench.h"
+
+#define OBSERVERS    COAP_MAX_OBSERVERS
+#define ROUNDS       200
+#define FIRST_PORT   6000
+
+PROCESS(coap_observe_bench_process, "CoAP observe benchmark");
+AUTOSTART_PROCESSES(&coap_observe_bench_process);
+
+struct frame {
+  uint16_t len;
+  uint8_t data[PACKETBUF_SIZE];
+};
+
+static struct frame frames[OBSERVERS];
+static int num_frames;
+
+static uip_ipaddr_t client;
+static linkaddr_t client_lladdr;
+static long reading;
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+/* Capture the frames from 6LoWPAN instead of sending them */
+static void
+send(mac_callback_t sent, void *ptr)
+{
+  struct frame *f;
+
+  if(num_frames < OBSERVERS) {
+    f = &frames[num_frames];
+    f->len = packetbuf_datalen();
+    memcpy(f->data, packetbuf_dataptr(), f->len);
+  }
+  num_frames++;
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+input(void)
+{
+  NETSTACK_NETWORK.input();
+}
+/*---------------------------------------------------------------------------*/
+const struct llsec_driver bench_llsec_driver = {
+  "bench-llsec",
+  init,
+  send,
+  input
+};
+/*---------------------------------------------------------------------------*/
+static void
+res_get_handler(void *request, void *response, uint8_t *buffer,
+                uint16_t preferred_size, int32_t *offset)
+{
+  int len;
+
+  len = snprintf((char *)buffer, preferred_size,
+                 "{\"reading\":%ld,\"unit\":\"cel\"}", reading);
+  coap_set_header_content_format(response, APPLICATION_JSON);
+  coap_set_header_max_age(response, 30);
+  coap_set_payload(response, buffer, len);
+}
+EVENT_RESOURCE(res_sensor, "title=\"Sensor\";obs", res_get_handler,
+               NULL, NULL, NULL, NULL);
+/*---------------------------------------------------------------------------*/
+static void
+make_token(int n, uint8_t *token, size_t *token_len)
+{
+  size_t i;
+
+  *token_len = 1 + n % COAP_TOKEN_LEN;
+  for(i = 0; i < *token_len; i++) {
+    token[i] = n * 13 + i;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Handle an observe request from a port of the client */
+static void
+observe(int n, uint32_t observe)
+{
+  coap_packet_t request[1];
+  coap_packet_t response[1];
+  uint8_t token[COAP_TOKEN_LEN];
+  size_t token_len;
+
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &client);
+  UIP_UDP_BUF->srcport = UIP_HTONS(FIRST_PORT + n);
+
+  make_token(n, token, &token_len);
+  coap_init_message(request, COAP_TYPE_CON, COAP_GET, n);
+  coap_set_token(request, token, token_len);
+  coap_set_header_uri_path(request, "sensor");
+  coap_set_header_observe(request, observe);
+  coap_init_message(response, COAP_TYPE_ACK, CONTENT_2_05, n);
+  coap_observe_handler(&res_sensor, request, response);
+}
+/*---------------------------------------------------------------------------*/
+/* Acknowledge the confirmable notifications */
+static void
+acknowledge(void)
+{
+  coap_observer_t *obs;
+  coap_transaction_t *t;
+
+  for(obs = list_head(coap_get_observers()); obs != NULL; obs = obs->next) {
+    t = coap_get_transaction_by_mid(obs->last_mid);
+    if(t != NULL) {
+      coap_clear_transaction(t);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Check that a captured notification ends with the message that
+   serializing the notification of each observer would give. The
+   notifications may be sent in any order. */
+static void
+check_frames(void)
+{
+  coap_packet_t notification[1];
+  uint8_t message[COAP_MAX_PACKET_SIZE + 1];
+  coap_observer_t *obs;
+  uint32_t observe;
+  size_t len;
+  int i, n;
+
+  check(num_frames == OBSERVERS, "notifications sent", num_frames);
+  i = 0;
+  for(obs = list_head(coap_get_observers()); obs != NULL;
+      obs = obs->next, i++) {
+    observe = (obs->obs_counter - 1) & 0xffffff;
+    coap_init_message(notification,
+                      observe % COAP_OBSERVE_REFRESH_INTERVAL == 0 ?
+                      COAP_TYPE_CON : COAP_TYPE_NON,
+                      CONTENT_2_05, obs->last_mid);
+    res_get_handler(NULL, notification, message + COAP_MAX_HEADER_SIZE,
+                    REST_MAX_CHUNK_SIZE, NULL);
+    coap_set_header_observe(notification, observe);
+    coap_set_token(notification, obs->token, obs->token_len);
+    len = coap_serialize_message(notification, message);
+    for(n = 0; n < num_frames; n++) {
+      if(len > 0 && len <= frames[n].len &&
+         memcmp(&frames[n].data[frames[n].len - len], message, len) == 0) {
+        break;
+      }
+    }
+    check(n < num_frames, "notification", i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Send confirmable messages to every other observer and let them time
+   out, which frees each transaction while the transactions are walked
+   and cancels the observations of its port */
+static void
+time_out(void)
+{
+  coap_transaction_t *transactions[OBSERVERS / 2];
+  uint16_t mids[OBSERVERS / 2];
+  coap_packet_t message[1];
+  int i, n;
+
+  num_frames = 0;
+  for(i = 0; i < OBSERVERS / 2; i++) {
+    transactions[i] = coap_new_transaction(coap_get_mid(), &client,
+                                           UIP_HTONS(FIRST_PORT + 2 * i));
+    check(transactions[i] != NULL, "transaction", i);
+    if(transactions[i] == NULL) {
+      return;
+    }
+    mids[i] = transactions[i]->mid;
+    coap_init_message(message, COAP_TYPE_CON, CONTENT_2_05, mids[i]);
+    transactions[i]->packet_len =
+      coap_serialize_message(message, transactions[i]->packet);
+    coap_send_transaction(transactions[i]);
+  }
+  check(num_frames == OBSERVERS / 2, "messages sent", num_frames);
+
+  /* Expire the retransmission timers instead of waiting for them. The
+     last retransmission times out. */
+  for(n = 1; n <= COAP_MAX_RETRANSMIT; n++) {
+    for(i = 0; i < OBSERVERS / 2; i++) {
+      etimer_stop(&transactions[i]->retrans_timer);
+    }
+    num_frames = 0;
+    coap_check_transactions();
+    check(num_frames == OBSERVERS / 2, "retransmissions", n);
+  }
+
+  for(i = 0; i < OBSERVERS / 2; i++) {
+    check(coap_get_transaction_by_mid(mids[i]) == NULL,
+          "timed out", i);
+  }
+  check(list_length(coap_get_observers()) == OBSERVERS / 2,
+        "observers after timeout", list_length(coap_get_observers()));
+}
+/*---------------------------------------------------------------------------*/
+static void
+test(void)
+{
+  uint8_t token[COAP_TOKEN_LEN];
+  size_t token_len;
+  int i;
+
+  for(i = 0; i < OBSERVERS; i++) {
+    observe(i, 0);
+  }
+  check(list_length(coap_get_observers()) == OBSERVERS, "observers",
+        list_length(coap_get_observers()));
+
+  /* Enough rounds for confirmable notifications */
+  for(i = 0; i < COAP_OBSERVE_REFRESH_INTERVAL + 2; i++) {
+    reading++;
+    num_frames = 0;
+    coap_notify_observers(&res_sensor);
+    check_frames();
+    acknowledge();
+  }
+
+  /* Cancel observations by token and by reset, and observe again */
+  make_token(5, token, &token_len);
+  check(coap_remove_observer_by_token(&client, UIP_HTONS(FIRST_PORT + 4),
+                                      token, token_len) == 0,
+        "cancel with another port", 5);
+  check(coap_remove_observer_by_token(&client, UIP_HTONS(FIRST_PORT + 5),
+                                      token, token_len) == 1,
+        "cancel by token", 5);
+  observe(6, 1);
+  check(list_length(coap_get_observers()) == OBSERVERS - 2,
+        "observers after cancel", list_length(coap_get_observers()));
+  for(i = 0; i < 2; i++) {
+    coap_observer_t *obs = list_head(coap_get_observers());
+    check(coap_remove_observer_by_mid(&client, obs->port, obs->last_mid) == 1,
+          "reset", i);
+  }
+  check(list_length(coap_get_observers()) == OBSERVERS - 4,
+        "observers after reset", list_length(coap_get_observers()));
+  check(coap_remove_observer_by_client(&client, 0) == 0, "no client", 0);
+
+  for(i = 0; i < OBSERVERS; i++) {
+    observe(i, 0);
+  }
+  check(list_length(coap_get_observers()) == OBSERVERS,
+        "observers again", list_length(coap_get_observers()));
+
+  time_out();
+  for(i = 0; i < OBSERVERS; i += 2) {
+    observe(i, 0);
+  }
+  check(list_length(coap_get_observers()) == OBSERVERS,
+        "observers after timeout", list_length(coap_get_observers()));
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(void)
+{
+  coap_transaction_t *transactions[OBSERVERS];
+  unsigned long long t0, t1;
+  uint16_t mid;
+  int i, j;
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    reading++;
+    num_frames = 0;
+    coap_notify_observers(&res_sensor);
+    acknowledge();
+    check(num_frames == OBSERVERS, "notifications sent", i);
+  }
+  t1 = now_ns();
+  printf("coap-observe-bench: notify %d observers: %llu ns per observer\n",
+         OBSERVERS, (t1 - t0) / ROUNDS / OBSERVERS);
+
+  /* Match acknowledgements with all transactions open */
+  for(i = 0; i < OBSERVERS; i++) {
+    transactions[i] = coap_new_transaction(coap_get_mid(), &client,
+                                           UIP_HTONS(FIRST_PORT + i));
+    check(transactions[i] != NULL, "transaction", i);
+  }
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    for(j = 0; j < OBSERVERS; j++) {
+      mid = transactions[j]->mid;
+      check(coap_get_transaction_by_mid(mid) == transactions[j], "match", j);
+    }
+  }
+  t1 = now_ns();
+  for(i = 0; i < OBSERVERS; i++) {
+    coap_clear_transaction(transactions[i]);
+  }
+  printf("coap-observe-bench: match an acknowledgement, %d transactions: "
+         "%llu ns\n", OBSERVERS, (t1 - t0) / ROUNDS / OBSERVERS);
+
+  /* Resets that do not cancel an observation */
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    for(j = 0; j < OBSERVERS; j++) {
+      check(coap_remove_observer_by_mid(&client, UIP_HTONS(FIRST_PORT + j),
+                                        mid + 1 + j) == 0, "reset", j);
+    }
+  }
+  t1 = now_ns();
+  printf("coap-observe-bench: match a reset, %d observers: %llu ns\n",
+         OBSERVERS, (t1 - t0) / ROUNDS / OBSERVERS);
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    observe(i % OBSERVERS, 1);
+    observe(i % OBSERVERS, 0);
+  }
+  t1 = now_ns();
+  printf("coap-observe-bench: cancel and observe again: %llu ns\n",
+         (t1 - t0) / ROUNDS);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coap_observe_bench_process, ev, data)
+{
+  uip_lladdr_t lladdr;
+
+  PROCESS_BEGIN();
+
+  memset(&client_lladdr, 0, sizeof(client_lladdr));
+  client_lladdr.u8[0] = 0x02;
+  client_lladdr.u8[sizeof(client_lladdr) - 1] = 2;
+  uip_ip6addr(&client, 0xfe80, 0, 0, 0, 0, 0, 0, 2);
+  memcpy(&lladdr, &client_lladdr, sizeof(lladdr));
+  uip_ds6_nbr_add(&client, &lladdr, 0, NBR_REACHABLE,
+                  NBR_TABLE_REASON_UNDEFINED, NULL);
+
+  rest_init_engine();
+  rest_activate_resource(&res_sensor, "sensor");
+
+  test();
+  bench();
+
+  printf("coap-observe-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,20 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define COAP_MAX_OBSERVERS 64
+#define COAP_MAX_OPEN_TRANSACTIONS (COAP_MAX_OBSERVERS + 1)
+
+#if BENCH_CONF_BASELINE
+#define COAP_HASH_BUCKETS 1
+#else /* BENCH_CONF_BASELINE */
+#define COAP_HASH_BUCKETS 16
+#endif /* BENCH_CONF_BASELINE */
+
+#define MEMB_CONF_WITH_FREELIST 1
+
+#define REST_MAX_CHUNK_SIZE 48
+
+/* Frames are captured below the 6LoWPAN layer */
+#define NETSTACK_CONF_LLSEC bench_llsec_driver
+
+#endif /* PROJECT_CONF_H_ */
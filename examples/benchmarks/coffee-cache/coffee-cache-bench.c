@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Coffee page cache benchmark.
+ *
+ *         Appends small records to a file and reads them back, one
+ *         record at a time, in order and at random, with the emulated
+ *         flash taking 5 us per access. Checks the records, also when
+ *         they are read before the writer has closed the file, and
+ *         prints the cache counters. Build with BASELINE=1 to measure
+ *         Coffee without its page cache.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "lib/random.h"
+#include "bench.h"
+
+#define RECORD_SIZE 16
+#define RECORDS     1000
+#define ROUNDS      10000
+
+PROCESS(coffee_cache_bench_process, "Coffee cache benchmark");
+AUTOSTART_PROCESSES(&coffee_cache_bench_process);
+/*---------------------------------------------------------------------------*/
+static void
+fill(unsigned char *record, int n)
+{
+  int i;
+
+  for(i = 0; i < RECORD_SIZE; i++) {
+    record[i] = n * 7 + i + 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+read_record(int fd, int n)
+{
+  unsigned char record[RECORD_SIZE], expected[RECORD_SIZE];
+
+  fill(expected, n);
+  return cfs_seek(fd, n * RECORD_SIZE, CFS_SEEK_SET) == n * RECORD_SIZE &&
+    cfs_read(fd, record, RECORD_SIZE) == RECORD_SIZE &&
+    memcmp(record, expected, RECORD_SIZE) == 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_pending(void)
+{
+  unsigned char record[RECORD_SIZE];
+  int wfd, rfd, n;
+
+  /* Records that are not yet on storage are read back all the same */
+  wfd = cfs_open("pending", CFS_WRITE | CFS_APPEND);
+  check(wfd >= 0, "open pending", 0);
+  for(n = 0; n < 3; n++) {
+    fill(record, n);
+    check(cfs_write(wfd, record, RECORD_SIZE) == RECORD_SIZE,
+          "write pending", n);
+    rfd = cfs_open("pending", CFS_READ);
+    check(rfd >= 0 && read_record(rfd, n), "read pending", n);
+    cfs_close(rfd);
+  }
+  cfs_coffee_flush();
+  cfs_close(wfd);
+  check(cfs_remove("pending") == 0, "remove pending", 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_stats(void)
+{
+  static struct cfs_coffee_cache_stats last;
+  struct cfs_coffee_cache_stats stats;
+
+  cfs_coffee_get_cache_stats(&stats);
+  printf("coffee-cache-bench:   cache %lu hits, %lu misses, "
+         "%lu writes, %lu flushes\n",
+         stats.hits - last.hits, stats.misses - last.misses,
+         stats.writes - last.writes, stats.flushes - last.flushes);
+  last = stats;
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(void)
+{
+  unsigned char record[RECORD_SIZE];
+  unsigned long long t0, t1;
+  int fd, n;
+
+  print_stats();
+
+  fd = cfs_open("log", CFS_WRITE | CFS_APPEND);
+  check(fd >= 0, "open log", 0);
+  t0 = now_ns();
+  for(n = 0; n < RECORDS; n++) {
+    fill(record, n);
+    check(cfs_write(fd, record, RECORD_SIZE) == RECORD_SIZE, "append", n);
+  }
+  cfs_close(fd);
+  t1 = now_ns();
+  printf("coffee-cache-bench: append %d bytes: %llu ns\n", RECORD_SIZE,
+         (t1 - t0) / RECORDS);
+  print_stats();
+
+  fd = cfs_open("log", CFS_READ);
+  check(fd >= 0, "open log for reading", 0);
+  t0 = now_ns();
+  for(n = 0; n < RECORDS; n++) {
+    check(read_record(fd, n), "read in order", n);
+  }
+  t1 = now_ns();
+  printf("coffee-cache-bench: read %d bytes in order: %llu ns\n",
+         RECORD_SIZE, (t1 - t0) / RECORDS);
+  print_stats();
+
+  t0 = now_ns();
+  for(n = 0; n < ROUNDS; n++) {
+    /* Mostly recent records, as when looking up log entries */
+    check(read_record(fd, RECORDS - 1 - random_rand() % 32), "read", n);
+  }
+  t1 = now_ns();
+  cfs_close(fd);
+  printf("coffee-cache-bench: read %d bytes of recent records: %llu ns\n",
+         RECORD_SIZE, (t1 - t0) / ROUNDS);
+  print_stats();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_cache_bench_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  cfs_coffee_format();
+  test_pending();
+  bench();
+
+  printf("coffee-cache-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,11 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#if BENCH_CONF_BASELINE
+#define COFFEE_CONF_CACHE_PAGES 0
+#endif /* BENCH_CONF_BASELINE */
+
+/* A command to a serial flash memory takes a few microseconds */
+#define XMEM_CONF_ACCESS_TIME 5
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Coffee garbage collection latency benchmark.
+ *
+ *         Logs to a ring of files at a steady rate: every few
+ *         milliseconds a new file is written and the oldest one is
+ *         removed. Prints a histogram of the time each step takes,
+ *         with the emulated flash taking 10 ms per sector erase.
+ *         Then checks the last files and that all obsolete sectors
+ *         are erased on request. Build with BASELINE=1 to measure
+ *         Coffee collecting garbage when a file cannot be reserved.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "bench.h"
+
+#define STEPS       1000
+#define RING        24
+#define RECORD_SIZE 4096
+#define INTERVAL    (CLOCK_SECOND / 500)
+#define BINS        6
+
+static unsigned char record[RECORD_SIZE];
+static unsigned long histogram[BINS];
+static unsigned long long max_ns;
+
+PROCESS(coffee_gc_bench_process, "Coffee GC benchmark");
+AUTOSTART_PROCESSES(&coffee_gc_bench_process);
+/*---------------------------------------------------------------------------*/
+static const char *
+name(int n)
+{
+  static char buf[16];
+
+  snprintf(buf, sizeof(buf), "log-%d", n);
+  return buf;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(int n)
+{
+  int i;
+
+  for(i = 0; i < RECORD_SIZE; i++) {
+    record[i] = n + i + 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+log_step(int n)
+{
+  int fd;
+
+  fill(n);
+  fd = cfs_open(name(n), CFS_WRITE);
+  check(fd >= 0, "open", n);
+  if(fd >= 0) {
+    check(cfs_write(fd, record, RECORD_SIZE) == RECORD_SIZE, "write", n);
+    cfs_close(fd);
+  }
+  if(n >= RING) {
+    check(cfs_remove(name(n - RING)) == 0, "remove", n - RING);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+record_latency(unsigned long long ns)
+{
+  unsigned long long limit;
+  int bin;
+
+  for(bin = 0, limit = 10000; bin < BINS - 1 && ns >= limit; bin++) {
+    limit *= 10;
+  }
+  histogram[bin]++;
+  if(ns > max_ns) {
+    max_ns = ns;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+verify(int n)
+{
+  unsigned char buf[RECORD_SIZE];
+  int fd;
+
+  fill(n);
+  fd = cfs_open(name(n), CFS_READ);
+  check(fd >= 0, "open for reading", n);
+  if(fd >= 0) {
+    check(cfs_read(fd, buf, sizeof(buf)) == RECORD_SIZE &&
+          memcmp(buf, record, RECORD_SIZE) == 0, "content", n);
+    cfs_close(fd);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_gc_bench_process, ev, data)
+{
+  static struct etimer et;
+  static int n;
+  static const char *bins[BINS] = {
+    "< 10 us", "< 100 us", "< 1 ms", "< 10 ms", "< 100 ms", ">= 100 ms"
+  };
+  unsigned long long t0;
+  unsigned long free_bytes, reclaimable_bytes;
+  int i;
+
+  PROCESS_BEGIN();
+
+  cfs_coffee_format();
+
+  for(n = 0; n < STEPS; n++) {
+    t0 = now_ns();
+    log_step(n);
+    record_latency(now_ns() - t0);
+
+    etimer_set(&et, INTERVAL);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  }
+
+  for(i = 0; i < BINS; i++) {
+    printf("coffee-gc-bench: %9s: %lu\n", bins[i], histogram[i]);
+  }
+  printf("coffee-gc-bench: %d steps, max %llu us\n", STEPS, max_ns / 1000);
+
+  for(i = STEPS - RING; i < STEPS; i++) {
+    verify(i);
+  }
+  check(cfs_open(name(STEPS - RING - 1), CFS_READ) < 0, "open removed",
+        STEPS - RING - 1);
+
+  cfs_coffee_gc_start();
+  etimer_set(&et, CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  cfs_coffee_get_space(&free_bytes, &reclaimable_bytes);
+  check(reclaimable_bytes == 0, "reclaimable after collection",
+        (int)reclaimable_bytes);
+  check(free_bytes > 0, "free after collection", (int)free_bytes);
+  check(cfs_coffee_gc_step() == 0, "nothing left to collect", 0);
+
+  printf("coffee-gc-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,11 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#if !BENCH_CONF_BASELINE
+#define COFFEE_CONF_GC_PROCESS 1
+#endif /* !BENCH_CONF_BASELINE */
+
+/* A 64 KB sector erase of a NOR flash takes tens of milliseconds */
+#define XMEM_CONF_ERASE_TIME 10000
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Coffee file system benchmark.
+ *
+ *         Creates files of different sizes and checks that they are
+ *         found, have the right size and content, and can be removed
+ *         and created again, also when there are more files than the
+ *         name index holds. Then measures opening, appending to and
+ *         listing files. Finally boots again, keeping the storage,
+ *         and checks the files that are listed. Build with BASELINE=1
+ *         to measure Coffee without its name index.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "cfs-coffee-arch.h"
+#include "dev/xmem.h"
+#include "lib/random.h"
+#include "bench.h"
+
+#define FILES        64
+#define MORE_FILES   64
+#define FILE_SIZE    512
+#define ROUNDS       20000
+#define LIST_ROUNDS  200
+#define CHUNK_SIZE   4096
+
+extern int contiki_argc;
+extern char **contiki_argv;
+
+PROCESS(coffee_bench_process, "Coffee benchmark");
+AUTOSTART_PROCESSES(&coffee_bench_process);
+/*---------------------------------------------------------------------------*/
+static const char *
+name(int n)
+{
+  static char buf[16];
+
+  snprintf(buf, sizeof(buf), "file-%d", n);
+  return buf;
+}
+/*---------------------------------------------------------------------------*/
+static int
+size(int n)
+{
+  return 1 + n % (FILE_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+create(int n)
+{
+  unsigned char buf[FILE_SIZE];
+  int fd, i;
+
+  check(cfs_coffee_reserve(name(n), FILE_SIZE) == 0, "reserve", n);
+  fd = cfs_open(name(n), CFS_WRITE);
+  check(fd >= 0, "open for writing", n);
+  for(i = 0; i < size(n); i++) {
+    buf[i] = n + i + 1;
+  }
+  check(cfs_write(fd, buf, size(n)) == size(n), "write", n);
+  cfs_close(fd);
+}
+/*---------------------------------------------------------------------------*/
+static void
+verify(int n)
+{
+  unsigned char buf[FILE_SIZE];
+  int fd, i;
+
+  fd = cfs_open(name(n), CFS_READ);
+  check(fd >= 0, "open for reading", n);
+  if(fd < 0) {
+    return;
+  }
+  check(cfs_seek(fd, 0, CFS_SEEK_END) == size(n), "size", n);
+  cfs_seek(fd, 0, CFS_SEEK_SET);
+  check(cfs_read(fd, buf, sizeof(buf)) == size(n), "read", n);
+  for(i = 0; i < size(n); i++) {
+    if(buf[i] != (unsigned char)(n + i + 1)) {
+      check(0, "content", n);
+      break;
+    }
+  }
+  cfs_close(fd);
+}
+/*---------------------------------------------------------------------------*/
+static int
+list(int *total)
+{
+  struct cfs_dir dir;
+  struct cfs_dirent dirent;
+  int count;
+
+  count = 0;
+  *total = 0;
+  if(cfs_opendir(&dir, "/") == 0) {
+    while(cfs_readdir(&dir, &dirent) == 0) {
+      count++;
+      *total += dirent.size;
+    }
+    cfs_closedir(&dir);
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_files(void)
+{
+  int i, total, expected;
+
+  cfs_coffee_format();
+  for(i = 0; i < FILES; i++) {
+    create(i);
+  }
+  check(cfs_coffee_reserve(name(0), FILE_SIZE) < 0, "duplicate", 0);
+  for(i = 0; i < FILES; i++) {
+    verify(i);
+  }
+
+  /* Remove every fourth file and create it again, with another size */
+  for(i = 0; i < FILES; i += 4) {
+    check(cfs_remove(name(i)) == 0, "remove", i);
+    check(cfs_open(name(i), CFS_READ) < 0, "open removed", i);
+    check(cfs_remove(name(i)) < 0, "remove twice", i);
+  }
+  for(i = 0; i < FILES; i++) {
+    if(i % 4 != 0) {
+      verify(i);
+    }
+  }
+  for(i = 0; i < FILES; i += 4) {
+    create(i + FILES + MORE_FILES);
+  }
+  for(i = 0; i < FILES; i += 4) {
+    verify(i + FILES + MORE_FILES);
+  }
+
+  expected = 0;
+  for(i = 0; i < FILES; i++) {
+    expected += size(i % 4 ? i : i + FILES + MORE_FILES);
+  }
+  check(list(&total) == FILES, "list", FILES);
+  check(total == expected, "list sizes", total);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_more_files(void)
+{
+  int i, total;
+
+  /* More files than the name index has room for */
+  for(i = FILES; i < FILES + MORE_FILES; i++) {
+    create(i);
+  }
+  for(i = FILES; i < FILES + MORE_FILES; i++) {
+    verify(i);
+  }
+  check(cfs_remove(name(FILES + MORE_FILES - 1)) == 0, "remove",
+        FILES + MORE_FILES - 1);
+  check(cfs_open(name(FILES + MORE_FILES - 1), CFS_READ) < 0, "open removed",
+        FILES + MORE_FILES - 1);
+  check(list(&total) == FILES + MORE_FILES - 1, "list",
+        FILES + MORE_FILES - 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(void)
+{
+  unsigned long long t0, t1;
+  int i, n, fd, total;
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    n = random_rand() % FILES;
+    fd = cfs_open(name(n % 4 ? n : n + FILES + MORE_FILES), CFS_READ);
+    check(fd >= 0, "bench open", n);
+    cfs_close(fd);
+  }
+  t1 = now_ns();
+  printf("coffee-bench: open, %d files: %llu ns\n", FILES, (t1 - t0) / ROUNDS);
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    fd = cfs_open(name(FILES + MORE_FILES + 1000 + i), CFS_READ);
+    check(fd < 0, "bench open missing", i);
+  }
+  t1 = now_ns();
+  printf("coffee-bench: open missing, %d files: %llu ns\n", FILES,
+         (t1 - t0) / ROUNDS);
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    n = 4 * (random_rand() % (FILES / 4)) + 1;
+    fd = cfs_open(name(n), CFS_WRITE | CFS_APPEND);
+    check(fd >= 0 && cfs_seek(fd, 0, CFS_SEEK_CUR) == size(n),
+          "bench append", n);
+    cfs_close(fd);
+  }
+  t1 = now_ns();
+  printf("coffee-bench: open for append, %d files: %llu ns\n", FILES,
+         (t1 - t0) / ROUNDS);
+
+  t0 = now_ns();
+  for(i = 0; i < LIST_ROUNDS; i++) {
+    check(list(&total) == FILES, "bench list", i);
+  }
+  t1 = now_ns();
+  printf("coffee-bench: list, %d files: %llu ns\n", FILES,
+         (t1 - t0) / LIST_ROUNDS);
+}
+/*---------------------------------------------------------------------------*/
+/* Runs the benchmark again, with the storage saved to a file and the
+   number of errors so far as arguments. Coffee then starts with
+   nothing in RAM, as after a reboot. */
+static void
+reboot(void)
+{
+  static char buf[CHUNK_SIZE];
+  char path[] = "/tmp/coffee-bench-XXXXXX";
+  char count[16];
+  unsigned long offset;
+  FILE *f;
+  int fd;
+
+  fd = mkstemp(path);
+  f = fd >= 0 ? fdopen(fd, "w") : NULL;
+  if(f == NULL) {
+    check(0, "save storage", fd);
+    return;
+  }
+  for(offset = 0; offset < COFFEE_SIZE; offset += CHUNK_SIZE) {
+    xmem_pread(buf, CHUNK_SIZE, COFFEE_START + offset);
+    fwrite(buf, 1, CHUNK_SIZE, f);
+  }
+  fclose(f);
+
+  snprintf(count, sizeof(count), "%d", errors);
+  fflush(stdout);
+  execl("/proc/self/exe", contiki_argv[0], path, count, (char *)NULL);
+  unlink(path);
+  check(0, "reboot", 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+restore(const char *path)
+{
+  static char buf[CHUNK_SIZE];
+  unsigned long offset;
+  FILE *f;
+
+  f = fopen(path, "r");
+  check(f != NULL, "open saved storage", 0);
+  if(f == NULL) {
+    return;
+  }
+  for(offset = 0; offset < COFFEE_SIZE; offset += CHUNK_SIZE) {
+    check(fread(buf, 1, CHUNK_SIZE, f) == CHUNK_SIZE, "read saved storage",
+          offset);
+    xmem_pwrite(buf, CHUNK_SIZE, COFFEE_START + offset);
+  }
+  fclose(f);
+  unlink(path);
+}
+/*---------------------------------------------------------------------------*/
+/* The files that test_more_files() left behind, listed before they
+   are opened */
+static void
+test_after_boot(void)
+{
+  struct cfs_dir dir;
+  struct cfs_dirent dirent;
+  int count, n;
+
+  count = 0;
+  if(cfs_opendir(&dir, "/") == 0) {
+    while(cfs_readdir(&dir, &dirent) == 0) {
+      count++;
+      if(sscanf(dirent.name, "file-%d", &n) != 1) {
+        check(0, "list after boot name", count);
+      } else {
+        check(dirent.size == size(n), "list after boot size", n);
+      }
+    }
+    cfs_closedir(&dir);
+  }
+  check(count == FILES + MORE_FILES - 1, "list after boot", count);
+  for(n = 1; n < FILES + MORE_FILES - 1; n++) {
+    if(n >= FILES || n % 4 != 0) {
+      verify(n);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_bench_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  if(contiki_argc == 3) {
+    errors = atoi(contiki_argv[2]);
+    restore(contiki_argv[1]);
+    test_after_boot();
+  } else {
+    test_files();
+    bench();
+    test_more_files();
+    reboot();
+  }
+
+  printf("coffee-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
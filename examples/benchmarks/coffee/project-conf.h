@@ -0,0 +1,8 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#if BENCH_CONF_BASELINE
+#define COFFEE_CONF_NAME_INDEX 0
+#endif /* BENCH_CONF_BASELINE */
+
+#endif /* PROJECT_CONF_H_ */
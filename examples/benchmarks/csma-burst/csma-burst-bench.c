@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         CSMA burst benchmark.
+ *
+ *         Runs CSMA over an RDC driver that sends the first packet of
+ *         the list it is given, as most RDC layers do, and acknowledges
+ *         it at once. Checks the order of the packets and the frame
+ *         pending bit, also when a packet is not acknowledged in the
+ *         middle of a burst. Then keeps the queue of a neighbor full
+ *         and measures the packets sent per second, which is bounded
+ *         by the backoff before each transmission. Build with
+ *         BASELINE=1 to send one packet per backoff.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/mac/csma.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "bench.h"
+
+#define QUEUE_LEN  8
+#define PACKETS    500
+#define MAX_TX     32
+
+/* The transmissions of the RDC driver, in order */
+static uint8_t tx_seqno[MAX_TX];
+static uint8_t tx_pending[MAX_TX];
+static int tx_count;
+/* The packet that is not acknowledged the first time, or -1 */
+static int rdc_noack;
+
+static int done[MAC_TX_ERR_FATAL + 1];
+
+PROCESS(csma_burst_bench_process, "CSMA burst benchmark");
+AUTOSTART_PROCESSES(&csma_burst_bench_process);
+/*---------------------------------------------------------------------------*/
+static void
+rdc_send_list(mac_callback_t sent, void *ptr, struct rdc_buf_list *list)
+{
+  uint8_t seqno;
+  int status;
+
+  queuebuf_to_packetbuf(list->buf);
+  seqno = *(uint8_t *)packetbuf_dataptr();
+  if(tx_count < MAX_TX) {
+    tx_seqno[tx_count] = seqno;
+    tx_pending[tx_count] = packetbuf_attr(PACKETBUF_ATTR_PENDING);
+  }
+  tx_count++;
+
+  status = MAC_TX_OK;
+  if(seqno == rdc_noack) {
+    rdc_noack = -1;
+    status = MAC_TX_NOACK;
+  }
+  mac_call_sent_callback(sent, ptr, status, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+rdc_send(mac_callback_t sent, void *ptr)
+{
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+rdc_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+rdc_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+rdc_on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+rdc_off(int keep_radio_on)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned short
+rdc_channel_check_interval(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+const struct rdc_driver bench_rdc_driver = {
+  "bench-rdc",
+  rdc_init,
+  rdc_send,
+  rdc_send_list,
+  rdc_input,
+  rdc_on,
+  rdc_off,
+  rdc_channel_check_interval,
+};
+/*---------------------------------------------------------------------------*/
+static int
+done_count(void)
+{
+  int i, n;
+
+  n = 0;
+  for(i = 0; i <= MAC_TX_ERR_FATAL; i++) {
+    n += done[i];
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static void
+sent(void *ptr, int status, int transmissions)
+{
+  if(status >= 0 && status <= MAC_TX_ERR_FATAL) {
+    done[status]++;
+  }
+  process_poll(&csma_burst_bench_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+send(int seqno)
+{
+  linkaddr_t addr;
+
+  memset(&addr, 0, sizeof(linkaddr_t));
+  addr.u8[0] = 0x02;
+  addr.u8[LINKADDR_SIZE - 1] = 1;
+  packetbuf_clear();
+  memset(packetbuf_dataptr(), 0, 40);
+  *(uint8_t *)packetbuf_dataptr() = seqno;
+  packetbuf_set_datalen(40);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &addr);
+  NETSTACK_MAC.send(sent, NULL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+start(int noack)
+{
+  int i;
+
+  memset(done, 0, sizeof(done));
+  tx_count = 0;
+  rdc_noack = noack;
+  for(i = 0; i < QUEUE_LEN; i++) {
+    send(i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Checks that the packets were sent in order, once each, apart from
+   the one that was not acknowledged. In a burst, all but the last
+   packet have the frame pending bit set. */
+static void
+check_transmissions(const char *what, int noack)
+{
+  int i, n, seqno;
+
+  check(done[MAC_TX_OK] == QUEUE_LEN, what, done[MAC_TX_OK]);
+  check(tx_count == QUEUE_LEN + (noack >= 0), what, tx_count);
+  i = 0;
+  for(seqno = 0; seqno < QUEUE_LEN; seqno++) {
+    for(n = seqno == noack ? 2 : 1; n > 0; n--, i++) {
+      check(i < tx_count && tx_seqno[i] == seqno, what, i);
+    }
+  }
+  for(i = 0; i < tx_count && i < MAX_TX; i++) {
+    check(tx_pending[i] == (CSMA_BURST && i < tx_count - 1), what, i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(csma_burst_bench_process, ev, data)
+{
+  static struct etimer et;
+  static unsigned long long t0, t1;
+  static clock_time_t ticks;
+  static int queued;
+
+  PROCESS_BEGIN();
+
+  /* Let the stack settle, and send what it wants to send at startup */
+  etimer_set(&et, CLOCK_SECOND / 4);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  start(-1);
+  etimer_set(&et, CLOCK_SECOND / 4);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  check_transmissions("queue", -1);
+
+  /* The burst ends with a packet that is not acknowledged, which is
+     sent again after a backoff, and the rest with it */
+  start(3);
+  etimer_set(&et, CLOCK_SECOND / 4);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  check_transmissions("not acknowledged", 3);
+
+  /* Keep the queue full */
+  memset(done, 0, sizeof(done));
+  queued = 0;
+  t0 = now_ns();
+  ticks = clock_time();
+  while(done_count() < PACKETS) {
+    while(queued < PACKETS && queued - done_count() < QUEUE_LEN) {
+      send(queued++);
+    }
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  }
+  t1 = now_ns();
+  ticks = clock_time() - ticks;
+  check(done[MAC_TX_OK] == PACKETS, "sent", done[MAC_TX_OK]);
+  printf("csma-burst-bench: %d packets in %lu clock ticks: %llu packets/s\n",
+         PACKETS, (unsigned long)ticks,
+         PACKETS * 1000000000ULL / (t1 - t0));
+
+  printf("csma-burst-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,20 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+/* CSMA over the RDC driver of the benchmark */
+#undef NETSTACK_CONF_MAC
+#define NETSTACK_CONF_MAC csma_driver
+#undef NETSTACK_CONF_RDC
+#define NETSTACK_CONF_RDC bench_rdc_driver
+
+/* The initial backoff exponent of IEEE 802.15.4, so that every
+   transmission waits 0 to 6 backoff periods */
+#define CSMA_CONF_MIN_BE 3
+#define CSMA_CONF_MAX_PACKET_PER_NEIGHBOR 8
+#define QUEUEBUF_CONF_NUM 16
+
+#if !BENCH_CONF_BASELINE
+#define CSMA_CONF_BURST 1
+#endif /* !BENCH_CONF_BASELINE */
+
+#endif /* PROJECT_CONF_H_ */
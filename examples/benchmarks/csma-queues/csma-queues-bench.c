@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         CSMA neighbor queue benchmark.
+ *
+ *         Runs CSMA over an RDC driver that either acknowledges frames
+ *         after a given number of transmissions or holds on to them.
+ *         Checks the per-neighbor statistics, then fills the queues of
+ *         64 neighbors and measures sending to them, which is mostly
+ *         finding the queue of the neighbor. Build with BASELINE=1 to
+ *         look for queues in a list, without statistics.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/mac/csma.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "bench.h"
+
+#define NEIGHBORS          64
+#define PACKETS_PER_QUEUE  4
+#define ROUNDS             200000
+
+/* What the RDC driver does with a frame */
+enum {
+  RDC_ACK,    /* Acknowledge it after rdc_failures transmissions */
+  RDC_HOLD    /* Keep it, as if the neighbor were asleep */
+};
+
+static int rdc_mode;
+static int rdc_failures;
+static int rdc_attempts;
+
+static int done[MAC_TX_ERR_FATAL + 1];
+
+PROCESS(csma_queues_bench_process, "CSMA queue benchmark");
+AUTOSTART_PROCESSES(&csma_queues_bench_process);
+/*---------------------------------------------------------------------------*/
+static void
+rdc_send_list(mac_callback_t sent, void *ptr, struct rdc_buf_list *list)
+{
+  int status;
+
+  if(rdc_mode == RDC_HOLD) {
+    return;
+  }
+
+  queuebuf_to_packetbuf(list->buf);
+  rdc_attempts++;
+  if(rdc_attempts > rdc_failures) {
+    rdc_attempts = 0;
+    status = MAC_TX_OK;
+  } else {
+    status = MAC_TX_NOACK;
+  }
+  mac_call_sent_callback(sent, ptr, status, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+rdc_send(mac_callback_t sent, void *ptr)
+{
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+rdc_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+rdc_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+rdc_on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+rdc_off(int keep_radio_on)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned short
+rdc_channel_check_interval(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+const struct rdc_driver bench_rdc_driver = {
+  "bench-rdc",
+  rdc_init,
+  rdc_send,
+  rdc_send_list,
+  rdc_input,
+  rdc_on,
+  rdc_off,
+  rdc_channel_check_interval,
+};
+/*---------------------------------------------------------------------------*/
+static void
+sent(void *ptr, int status, int transmissions)
+{
+  if(status >= 0 && status <= MAC_TX_ERR_FATAL) {
+    done[status]++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+neighbor(linkaddr_t *addr, int i)
+{
+  memset(addr, 0, sizeof(linkaddr_t));
+  addr->u8[0] = 0x02;
+  addr->u8[LINKADDR_SIZE - 2] = i >> 8;
+  addr->u8[LINKADDR_SIZE - 1] = i;
+}
+/*---------------------------------------------------------------------------*/
+static void
+send(int i, int max_transmissions)
+{
+  linkaddr_t addr;
+
+  neighbor(&addr, i);
+  packetbuf_clear();
+  memset(packetbuf_dataptr(), i, 40);
+  packetbuf_set_datalen(40);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &addr);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS, max_transmissions);
+  NETSTACK_MAC.send(sent, NULL);
+}
+/*---------------------------------------------------------------------------*/
+#if CSMA_STATS
+static const struct csma_neighbor_stats *
+stats_of(int i)
+{
+  const struct csma_neighbor_stats *s;
+  linkaddr_t addr;
+
+  neighbor(&addr, i);
+  for(s = csma_stats_head(); s != NULL; s = csma_stats_next(s)) {
+    if(linkaddr_cmp(csma_stats_addr(s), &addr)) {
+      return s;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_stats(void)
+{
+  const struct csma_neighbor_stats *s;
+
+  /* Three packets that each take three transmissions */
+  s = stats_of(1);
+  check(s != NULL, "stats of 1", 0);
+  if(s != NULL) {
+    check(s->queue_len == 0, "queue length of 1", s->queue_len);
+    check(s->max_queue_len == 3, "max queue length of 1", s->max_queue_len);
+    check(s->sent == 3, "sent to 1", s->sent);
+    check(s->failed == 0, "failed to 1", s->failed);
+    check(s->retransmissions == 6, "retransmissions to 1",
+          s->retransmissions);
+    check(s->max_delay <= s->total_delay, "delay to 1", s->max_delay);
+  }
+
+  /* One packet given up on after two transmissions */
+  s = stats_of(2);
+  check(s != NULL, "stats of 2", 0);
+  if(s != NULL) {
+    check(s->sent == 0 && s->failed == 1, "failed to 2", s->failed);
+    check(s->retransmissions == 1, "retransmissions to 2",
+          s->retransmissions);
+  }
+
+  /* A full queue, and a packet dropped */
+  s = stats_of(3);
+  check(s != NULL, "stats of 3", 0);
+  if(s != NULL) {
+    check(s->queue_len == PACKETS_PER_QUEUE, "queue length of 3",
+          s->queue_len);
+    check(s->dropped == 1, "dropped to 3", s->dropped);
+  }
+
+  csma_stats_reset();
+  s = stats_of(3);
+  check(s != NULL && s->dropped == 0 && s->queue_len == PACKETS_PER_QUEUE,
+        "reset", 0);
+}
+#endif /* CSMA_STATS */
+/*---------------------------------------------------------------------------*/
+static void
+bench(void)
+{
+  unsigned long long t0, t1;
+  int i, dropped;
+
+  /* Every neighbor has a full queue, so every packet is dropped */
+  dropped = done[MAC_TX_ERR];
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    send(3 + i % NEIGHBORS, 0);
+  }
+  t1 = now_ns();
+  check(done[MAC_TX_ERR] - dropped == ROUNDS, "dropped",
+        done[MAC_TX_ERR] - dropped);
+  printf("csma-queues-bench: send to one of %d full queues: %llu ns\n",
+         NEIGHBORS, (t1 - t0) / ROUNDS);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(csma_queues_bench_process, ev, data)
+{
+  static struct etimer et;
+  int i, j;
+
+  PROCESS_BEGIN();
+
+  /* Let the stack settle, and send what it wants to send at startup */
+  etimer_set(&et, CLOCK_SECOND / 4);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  memset(done, 0, sizeof(done));
+
+  rdc_mode = RDC_ACK;
+  rdc_failures = 2;
+  for(i = 0; i < 3; i++) {
+    send(1, 0);
+  }
+  etimer_set(&et, CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  check(done[MAC_TX_OK] == 3, "acknowledged", done[MAC_TX_OK]);
+
+  rdc_failures = 100;
+  send(2, 2);
+  etimer_set(&et, CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  check(done[MAC_TX_NOACK] == 1, "not acknowledged", done[MAC_TX_NOACK]);
+
+  rdc_mode = RDC_HOLD;
+  for(i = 3; i < 3 + NEIGHBORS; i++) {
+    for(j = 0; j < PACKETS_PER_QUEUE; j++) {
+      send(i, 0);
+    }
+  }
+  check(done[MAC_TX_ERR] == 0, "queued", done[MAC_TX_ERR]);
+  send(3, 0);
+  check(done[MAC_TX_ERR] == 1, "queue full", done[MAC_TX_ERR]);
+
+#if CSMA_STATS
+  test_stats();
+#endif /* CSMA_STATS */
+
+  bench();
+
+  printf("csma-queues-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
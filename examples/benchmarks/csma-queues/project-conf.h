@@ -0,0 +1,22 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+/* CSMA over the RDC driver of the benchmark */
+#undef NETSTACK_CONF_MAC
+#define NETSTACK_CONF_MAC csma_driver
+#undef NETSTACK_CONF_RDC
+#define NETSTACK_CONF_RDC bench_rdc_driver
+
+/* Queues for 64 neighbors, and room for a few more */
+#undef NBR_TABLE_CONF_MAX_NEIGHBORS
+#define NBR_TABLE_CONF_MAX_NEIGHBORS 72
+#define CSMA_CONF_MAX_NEIGHBOR_QUEUES 72
+#define CSMA_CONF_MAX_PACKET_PER_NEIGHBOR 4
+#define QUEUEBUF_CONF_NUM 272
+
+#if !BENCH_CONF_BASELINE
+#define NBR_TABLE_CONF_WITH_HASH 1
+#define CSMA_CONF_STATS 1
+#endif /* !BENCH_CONF_BASELINE */
+
+#endif /* PROJECT_CONF_H_ */
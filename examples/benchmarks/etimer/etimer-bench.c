@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Event timer microbenchmark.
+ *
+ *         Measures the cost of setting, polling, expiring and
+ *         stopping event timers, and of removing the timers of a
+ *         process that exits, with a growing number of pending
+ *         timers. Build with BASELINE=1 to measure the list backend
+ *         instead of the heap backend.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "bench.h"
+
+#define MAX_TIMERS  2000
+#define POLLS       1000
+
+PROCESS(etimer_bench_process, "Etimer benchmark");
+PROCESS(owner_process, "Timer owner");
+AUTOSTART_PROCESSES(&etimer_bench_process);
+
+static struct etimer timers[MAX_TIMERS];
+static const int sizes[] = { 10, 100, 500, 1000, 2000 };
+/*---------------------------------------------------------------------------*/
+static void
+poll_etimer_process(void)
+{
+  process_post_synch(&etimer_process, PROCESS_EVENT_POLL, NULL);
+}
+/*---------------------------------------------------------------------------*/
+/* Owns every other timer in the exit test, until it is made to exit */
+PROCESS_THREAD(owner_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  PROCESS_WAIT_UNTIL(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+/* Sets n timers, every other one owned by owner_process, and measures
+   removing the timers of owner_process when it exits. Returns the time
+   per removed timer. */
+static unsigned long long
+run_exit(int n)
+{
+  unsigned long long t0, t1;
+  clock_time_t before, next;
+  int i;
+
+  /* The timers of the system processes */
+  before = next = etimer_next_expiration_time();
+
+  process_start(&owner_process, NULL);
+  for(i = 0; i < n; i++) {
+    if(i % 2) {
+      PROCESS_CONTEXT_BEGIN(&owner_process);
+      etimer_set(&timers[i], 10 * CLOCK_SECOND +
+                 random_rand() % (50 * CLOCK_SECOND));
+      PROCESS_CONTEXT_END(&owner_process);
+    } else {
+      etimer_set(&timers[i], 10 * CLOCK_SECOND +
+                 random_rand() % (50 * CLOCK_SECOND));
+      if(next == 0 || etimer_expiration_time(&timers[i]) < next) {
+        next = etimer_expiration_time(&timers[i]);
+      }
+    }
+  }
+
+  t0 = now_ns();
+  process_exit(&owner_process);
+  t1 = now_ns();
+
+  /* Only the timers of this process are left */
+  check(etimer_next_expiration_time() == next, "next expiration after exit",
+        n);
+  for(i = 0; i < n; i += 2) {
+    etimer_stop(&timers[i]);
+  }
+  check(etimer_next_expiration_time() == before, "timers left after exit", n);
+
+  return (t1 - t0) / (n / 2);
+}
+/*---------------------------------------------------------------------------*/
+/* Must be called from etimer_bench_process, which owns the timers. */
+static void
+run(int n)
+{
+  unsigned long long t0, insert, next, poll, stop, expire, exited;
+  clock_time_t deadline;
+  int i;
+
+  /* Insert: n timers between 10 and 60 seconds into the future. */
+  t0 = now_ns();
+  for(i = 0; i < n; i++) {
+    etimer_set(&timers[i], 10 * CLOCK_SECOND +
+               random_rand() % (50 * CLOCK_SECOND));
+  }
+  insert = now_ns() - t0;
+
+  /* Next expiration: re-set one timer and ask for the next expiration
+     time, as the native main loop does before it sleeps. */
+  t0 = now_ns();
+  for(i = 0; i < POLLS; i++) {
+    etimer_set(&timers[i % n], 10 * CLOCK_SECOND +
+               random_rand() % (50 * CLOCK_SECOND));
+    etimer_next_expiration_time();
+  }
+  next = now_ns() - t0;
+
+  /* Poll: the etimer process runs with no expired timers. */
+  t0 = now_ns();
+  for(i = 0; i < POLLS; i++) {
+    poll_etimer_process();
+  }
+  poll = now_ns() - t0;
+
+  /* Stop every timer, in an order unrelated to insertion order. */
+  t0 = now_ns();
+  for(i = 0; i < n; i++) {
+    etimer_stop(&timers[(i * 7919) % n]);
+  }
+  stop = now_ns() - t0;
+
+  /* Expire: all n timers expire during a single poll. */
+  for(i = 0; i < n; i++) {
+    etimer_set(&timers[i], 1);
+  }
+  deadline = clock_time() + 2;
+  /* The clock may skip a tick while we are not scheduled */
+  while(clock_time() < deadline);
+  t0 = now_ns();
+  poll_etimer_process();
+  expire = now_ns() - t0;
+
+  exited = run_exit(n);
+
+  printf("%5d timers: insert %7llu ns, set+next %7llu ns, idle poll %7llu ns, "
+         "stop %7llu ns, expire %7llu ns, exit %7llu ns\n", n,
+         insert / n, next / POLLS, poll / POLLS, stop / n, expire / n,
+         exited);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_bench_process, ev, data)
+{
+  static struct etimer drain;
+  static unsigned i;
+
+  PROCESS_BEGIN();
+
+  printf("etimer-bench: %s backend, times per operation\n",
+         ETIMER_HEAP ? "heap" : "list");
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i]);
+
+    /* Let the expiration events of this round be delivered. */
+    etimer_set(&drain, CLOCK_SECOND / 2);
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER && data == &drain);
+  }
+
+  printf("etimer-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,11 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#if !BENCH_CONF_BASELINE
+#define ETIMER_CONF_HEAP 1
+#endif /* !BENCH_CONF_BASELINE */
+
+/* Room for all timers to expire at once */
+#define PROCESS_CONF_OVERFLOW_EVENTS 2048
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         6LoWPAN fragment forwarding benchmark.
+ *
+ *         Feeds the fragments of UDP datagrams of different sizes to
+ *         the node, which routes them on to another neighbor, and
+ *         measures how many fragments arrive before the first one is
+ *         sent on and the processing time per datagram. The sent
+ *         fragments are checked against the original datagram. As the
+ *         root of a RPL DODAG, where the node inserts a hop-by-hop
+ *         option, the datagram must be reassembled instead. Build with
+ *         BASELINE=1 to measure reassembly and refragmentation instead
+ *         of fragment forwarding.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ip/tcpip.h"
+#include "net/ip/uip-udp-packet.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "net/mac/mac.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/rpl/rpl.h"
+#include "net/rpl/rpl-private.h"
+#include "bench.h"
+
+#define ROUNDS     2000
+#define MAX_FRAMES 16
+
+PROCESS(frag_forward_bench_process, "Fragment forwarding benchmark");
+AUTOSTART_PROCESSES(&frag_forward_bench_process);
+
+struct frame {
+  linkaddr_t receiver;
+  uint16_t len;
+  uint8_t data[PACKETBUF_SIZE];
+};
+
+static const int sizes[] = { 200, 600, 1200 };
+
+/* The fragments as sent by the previous hop, and as sent on by us */
+static struct frame in_frames[MAX_FRAMES];
+static struct frame out_frames[MAX_FRAMES];
+static struct frame *frames;
+static int num_frames;
+static int num_in, num_out;
+
+static uint8_t datagram[UIP_BUFSIZE];
+static linkaddr_t prev_hop, next_hop;
+static uip_ipaddr_t src, dest, next_hop_ipaddr;
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+/* Capture the frames from 6LoWPAN instead of sending them */
+static void
+send(mac_callback_t sent, void *ptr)
+{
+  struct frame *f;
+
+  if(num_frames < MAX_FRAMES) {
+    f = &frames[num_frames];
+    linkaddr_copy(&f->receiver, packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+    f->len = packetbuf_datalen();
+    memcpy(f->data, packetbuf_dataptr(), f->len);
+    if(frames == out_frames && num_frames == 0) {
+      num_out = num_in;
+    }
+  }
+  num_frames++;
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+input(void)
+{
+  NETSTACK_NETWORK.input();
+}
+/*---------------------------------------------------------------------------*/
+const struct llsec_driver bench_llsec_driver = {
+  "bench-llsec",
+  init,
+  send,
+  input
+};
+/*---------------------------------------------------------------------------*/
+/* Build a UDP datagram in uip_buf and fragment it as the previous hop
+   would have */
+static int
+make_fragments(int size)
+{
+  struct uip_ip_hdr *ip = (struct uip_ip_hdr *)uip_buf;
+  struct uip_udp_hdr *udp = (struct uip_udp_hdr *)&uip_buf[UIP_IPH_LEN];
+  int i;
+
+  memset(uip_buf, 0, UIP_IPH_LEN + UIP_UDPH_LEN);
+  ip->vtc = 0x60;
+  ip->len[0] = (size - UIP_IPH_LEN) >> 8;
+  ip->len[1] = (size - UIP_IPH_LEN) & 0xff;
+  ip->proto = UIP_PROTO_UDP;
+  ip->ttl = 64;
+  uip_ipaddr_copy(&ip->srcipaddr, &src);
+  uip_ipaddr_copy(&ip->destipaddr, &dest);
+  udp->srcport = UIP_HTONS(5678);
+  udp->destport = UIP_HTONS(8765);
+  udp->udplen = UIP_HTONS(size - UIP_IPH_LEN);
+  for(i = UIP_IPH_LEN + UIP_UDPH_LEN; i < size; i++) {
+    uip_buf[i] = i * 7;
+  }
+  uip_len = size;
+  udp->udpchksum = ~uip_udpchksum();
+
+  memcpy(datagram, uip_buf, size);
+  /* What we expect the next hop to receive */
+  datagram[7]--;
+
+  frames = in_frames;
+  num_frames = 0;
+  tcpip_output((uip_lladdr_t *)&linkaddr_node_addr);
+  return num_frames;
+}
+/*---------------------------------------------------------------------------*/
+/* Feed the fragments to the node as if they came from the previous
+   hop, and capture what it sends on */
+static void
+forward(int n)
+{
+  int i;
+
+  frames = out_frames;
+  num_frames = 0;
+  num_out = 0;
+  for(i = 0; i < n; i++) {
+    num_in = i + 1;
+    packetbuf_clear();
+    packetbuf_copyfrom(in_frames[i].data, in_frames[i].len);
+    packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &prev_hop);
+    packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_node_addr);
+    NETSTACK_LLSEC.input();
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Check that the subsequent fragments carry the datagram unchanged,
+   under a single tag, to the next hop. The datagram may have grown by
+   extra bytes of extension headers after the IP header. */
+static void
+check_fragments(int size, int extra)
+{
+  struct frame *f;
+  int covered;
+  int offset;
+  int i;
+
+  size += extra;
+  if(num_frames < 2 || num_frames > MAX_FRAMES) {
+    printf("%4d bytes: error: %d fragments sent\n", size, num_frames);
+    errors++;
+    return;
+  }
+  covered = 0;
+  for(i = 0; i < num_frames; i++) {
+    f = &out_frames[i];
+    if(!linkaddr_cmp(&f->receiver, &next_hop) ||
+       ((f->data[0] << 8 | f->data[1]) & 0x07ff) != size ||
+       memcmp(&f->data[2], &out_frames[0].data[2], 2) != 0) {
+      printf("%4d bytes: error: bad fragment header\n", size);
+      errors++;
+      return;
+    }
+    if(i > 0) {
+      offset = f->data[4] << 3;
+      if(offset < covered ||
+         memcmp(&f->data[5], &datagram[offset - extra], f->len - 5) != 0) {
+        printf("%4d bytes: error: fragment %d differs\n", size, i);
+        errors++;
+        return;
+      }
+      covered = offset + f->len - 5;
+    }
+  }
+  if(covered != size) {
+    printf("%4d bytes: error: %d of %d bytes sent\n", size, covered, size);
+    errors++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(int size)
+{
+  unsigned long long t0, t;
+  int n;
+  int i;
+
+  n = make_fragments(size);
+  if(n > MAX_FRAMES) {
+    printf("%4d bytes: error: too many fragments\n", size);
+    errors++;
+    return;
+  }
+
+  forward(n);
+  check_fragments(size, 0);
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    forward(n);
+  }
+  t = now_ns() - t0;
+
+  printf("%4d bytes: %2d fragments, first sent after %2d received, "
+         "%6llu ns per datagram\n", size, n, num_out, t / ROUNDS);
+}
+/*---------------------------------------------------------------------------*/
+/* As the root of a RPL DODAG, the node inserts a hop-by-hop option in
+   datagrams going down, so it cannot send on the fragments as they are
+   and must reassemble the datagram */
+static void
+run_root(int size)
+{
+  uip_ipaddr_t ipaddr;
+  rpl_dag_t *dag;
+  int n;
+
+  uip_ip6addr(&ipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&ipaddr, &uip_lladdr);
+  uip_ds6_addr_add(&ipaddr, 0, ADDR_AUTOCONF);
+  dag = rpl_set_root(RPL_DEFAULT_INSTANCE, &ipaddr);
+  if(dag == NULL) {
+    printf("%4d bytes: error: no DODAG\n", size);
+    errors++;
+    return;
+  }
+  rpl_set_prefix(dag, &ipaddr, 64);
+
+  n = make_fragments(size);
+  forward(n);
+  check_fragments(size, RPL_HOP_BY_HOP_LEN);
+  if(num_out != n) {
+    printf("%4d bytes: error: first sent after %d of %d received\n",
+           size, num_out, n);
+    errors++;
+  }
+  printf("%4d bytes: %2d fragments, first sent after %2d received, "
+         "as the RPL root\n", size, n, num_out);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(frag_forward_bench_process, ev, data)
+{
+  uip_lladdr_t lladdr;
+  unsigned i;
+
+  PROCESS_BEGIN();
+
+  printf("frag-forward-bench: %s\n",
+#if SICSLOWPAN_CONF_FRAG_FORWARD
+         "fragment forwarding"
+#else
+         "reassembly"
+#endif
+         );
+
+  memset(&prev_hop, 0, sizeof(prev_hop));
+  prev_hop.u8[0] = 0x02;
+  prev_hop.u8[sizeof(prev_hop) - 1] = 3;
+  memset(&next_hop, 0, sizeof(next_hop));
+  next_hop.u8[0] = 0x02;
+  next_hop.u8[sizeof(next_hop) - 1] = 2;
+
+  /* The datagrams go from fd00::50 behind the previous hop to
+     fd00::99 behind the next hop */
+  uip_ip6addr(&src, 0xfd00, 0, 0, 0, 0, 0, 0, 0x50);
+  uip_ip6addr(&dest, 0xfd00, 0, 0, 0, 0, 0, 0, 0x99);
+  uip_ip6addr(&next_hop_ipaddr, 0xfe80, 0, 0, 0, 0, 0, 0, 2);
+  memcpy(&lladdr, &next_hop, sizeof(lladdr));
+  uip_ds6_nbr_add(&next_hop_ipaddr, &lladdr, 0, NBR_REACHABLE,
+                  NBR_TABLE_REASON_UNDEFINED, NULL);
+  uip_ds6_route_add(&dest, 128, &next_hop_ipaddr);
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i]);
+  }
+  run_root(sizes[1]);
+  printf("frag-forward-bench: %d errors\n", errors);
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
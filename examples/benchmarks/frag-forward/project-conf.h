@@ -0,0 +1,21 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#if !BENCH_CONF_BASELINE
+#define SICSLOWPAN_CONF_FRAG_FORWARD 4
+#endif /* !BENCH_CONF_BASELINE */
+
+/* Fragment forwarding cannot be combined with packet queueing */
+#undef UIP_CONF_IPV6_QUEUE_PKT
+#define UIP_CONF_IPV6_QUEUE_PKT 0
+
+#undef UIP_CONF_BUFFER_SIZE
+#define UIP_CONF_BUFFER_SIZE 1280
+
+#define SICSLOWPAN_CONF_FRAGMENT_BUFFERS 16
+#define QUEUEBUF_CONF_NUM 16
+
+/* Frames are captured below the 6LoWPAN layer */
+#define NETSTACK_CONF_LLSEC bench_llsec_driver
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         IP64 address map benchmark.
+ *
+ *         Checks that mappings are found by tuple and by mapped port,
+ *         that mapped ports are unique, that expired mappings go away
+ *         and that the oldest recyclable mapping is the one recycled.
+ *         Then measures lookups and flow churn on a full table. Build
+ *         with BASELINE=1 to measure a single hash bucket and a single
+ *         aging queue.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ip/uip.h"
+#include "ip64-addrmap.h"
+#include "lib/random.h"
+#include "bench.h"
+
+#define ENTRIES  IP64_ADDRMAP_CONF_ENTRIES
+#define ROUNDS   200000
+#define LIFETIME (CLOCK_SECOND * 300)
+
+static struct ip64_addrmap_entry *entries[ENTRIES];
+
+PROCESS(ip64_addrmap_bench_process, "IP64 address map benchmark");
+AUTOSTART_PROCESSES(&ip64_addrmap_bench_process);
+/*---------------------------------------------------------------------------*/
+/* Flow number n: a host in 2001:db8::/64 talking to one of a few
+   servers on port 80 */
+static void
+flow(unsigned n, uip_ip6addr_t *ip6addr, uint16_t *ip6port,
+     uip_ip4addr_t *ip4addr, uint16_t *ip4port)
+{
+  uip_ip6addr(ip6addr, 0x2001, 0xdb8, 0, 0, 0, 0, n >> 16, n & 0xffff);
+  *ip6port = UIP_HTONS(40000 + (n % 1000));
+  uip_ipaddr(ip4addr, 192, 0, 2, n % 8);
+  *ip4port = UIP_HTONS(80);
+}
+/*---------------------------------------------------------------------------*/
+static struct ip64_addrmap_entry *
+lookup(unsigned n)
+{
+  uip_ip6addr_t ip6addr;
+  uip_ip4addr_t ip4addr;
+  uint16_t ip6port, ip4port;
+
+  flow(n, &ip6addr, &ip6port, &ip4addr, &ip4port);
+  return ip64_addrmap_lookup(&ip6addr, ip6port, &ip4addr, ip4port,
+                             UIP_PROTO_TCP);
+}
+/*---------------------------------------------------------------------------*/
+static struct ip64_addrmap_entry *
+create(unsigned n)
+{
+  uip_ip6addr_t ip6addr;
+  uip_ip4addr_t ip4addr;
+  uint16_t ip6port, ip4port;
+
+  flow(n, &ip6addr, &ip6port, &ip4addr, &ip4port);
+  return ip64_addrmap_create(&ip6addr, ip6port, &ip4addr, ip4port,
+                             UIP_PROTO_TCP);
+}
+/*---------------------------------------------------------------------------*/
+static int
+list_length(void)
+{
+  struct ip64_addrmap_entry *m, *prev;
+  int n;
+
+  n = 0;
+  prev = NULL;
+  for(m = ip64_addrmap_list(); m != NULL; m = m->next) {
+    check(m->prev == prev, "list links", n);
+    prev = m;
+    n++;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_lookup(void)
+{
+  static uint8_t used[65536 / 8];
+  int i;
+
+  ip64_addrmap_init();
+  memset(used, 0, sizeof(used));
+  for(i = 0; i < ENTRIES; i++) {
+    entries[i] = create(i);
+    check(entries[i] != NULL, "create", i);
+    if(entries[i] == NULL) {
+      return;
+    }
+    ip64_addrmap_set_lifetime(entries[i], LIFETIME);
+    check(!(used[entries[i]->mapped_port / 8] &
+            (1 << (entries[i]->mapped_port % 8))), "unique port", i);
+    used[entries[i]->mapped_port / 8] |= 1 << (entries[i]->mapped_port % 8);
+  }
+  check(create(ENTRIES) == NULL, "create in full table", ENTRIES);
+  check(list_length() == ENTRIES, "list length", ENTRIES);
+
+  for(i = 0; i < ENTRIES; i++) {
+    check(lookup(i) == entries[i], "lookup", i);
+    check(ip64_addrmap_lookup_port(entries[i]->mapped_port,
+                                   UIP_PROTO_TCP) == entries[i],
+          "lookup port", i);
+    check(ip64_addrmap_lookup_port(entries[i]->mapped_port,
+                                   UIP_PROTO_UDP) == NULL,
+          "lookup port protocol", i);
+  }
+  check(lookup(ENTRIES) == NULL, "lookup missing", ENTRIES);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_expiry(void)
+{
+  int i;
+
+  /* Every third mapping expires; the rest live on */
+  for(i = 0; i < ENTRIES; i += 3) {
+    ip64_addrmap_set_lifetime(entries[i], 0);
+  }
+  for(i = 0; i < ENTRIES; i++) {
+    check((lookup(i) == NULL) == (i % 3 == 0), "expiry", i);
+  }
+  check(list_length() == ENTRIES - (ENTRIES + 2) / 3, "list length",
+        ENTRIES);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_recycle(void)
+{
+  struct ip64_addrmap_entry *m;
+  int i;
+
+  ip64_addrmap_init();
+  for(i = 0; i < ENTRIES; i++) {
+    entries[i] = create(i);
+    ip64_addrmap_set_lifetime(entries[i], i % 2 ? LIFETIME : LIFETIME / 2);
+  }
+
+  /* Recyclable mappings in both queues, with the one that expires
+     soonest in the queue of the longer lifetime */
+  ip64_addrmap_set_recycleble(entries[1]);
+  ip64_addrmap_set_recycleble(entries[100]);
+  ip64_addrmap_set_lifetime(entries[1], LIFETIME / 4);
+
+  for(i = ENTRIES; i < ENTRIES + 2; i++) {
+    m = create(i);
+    check(m != NULL, "create after recycle", i);
+    ip64_addrmap_set_lifetime(m, LIFETIME);
+    check(lookup(1) == NULL, "oldest recycled", i);
+    check((lookup(100) == NULL) == (i > ENTRIES), "next oldest recycled", i);
+  }
+  check(create(ENTRIES + 2) == NULL, "nothing to recycle", ENTRIES + 2);
+  check(list_length() == ENTRIES, "list length", ENTRIES);
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(void)
+{
+  unsigned long long t0, t1;
+  struct ip64_addrmap_entry *m;
+  int i, found;
+
+  ip64_addrmap_init();
+  for(i = 0; i < ENTRIES; i++) {
+    m = create(i);
+    ip64_addrmap_set_lifetime(m, LIFETIME);
+    ip64_addrmap_set_recycleble(m);
+  }
+
+  found = 0;
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    found += lookup(random_rand() % ENTRIES) != NULL;
+  }
+  t1 = now_ns();
+  check(found == ROUNDS, "bench lookup", found);
+  printf("ip64-addrmap-bench: lookup, %d entries: %llu ns\n",
+         ENTRIES, (t1 - t0) / ROUNDS);
+
+  /* New flows keep arriving on a full table: each one misses, recycles
+     the oldest mapping and is set up the way ip64 does for a TCP
+     connection */
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    m = lookup(ENTRIES + i);
+    if(m == NULL) {
+      m = create(ENTRIES + i);
+    }
+    ip64_addrmap_set_lifetime(m, LIFETIME);
+    ip64_addrmap_set_recycleble(m);
+    found += ip64_addrmap_lookup_port(m->mapped_port, UIP_PROTO_TCP) == m;
+  }
+  t1 = now_ns();
+  check(found == 2 * ROUNDS, "bench churn", found);
+  printf("ip64-addrmap-bench: flow churn, %d entries: %llu ns\n",
+         ENTRIES, (t1 - t0) / ROUNDS);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(ip64_addrmap_bench_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  test_lookup();
+  test_expiry();
+  test_recycle();
+  bench();
+
+  printf("ip64-addrmap-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,11 @@
+#ifndef IP64_CONF_H
+#define IP64_CONF_H
+
+#include "ip64-eth-interface.h"
+#include "ip64-null-driver.h"
+
+#define IP64_CONF_UIP_FALLBACK_INTERFACE ip64_eth_interface
+#define IP64_CONF_INPUT                  ip64_eth_interface_input
+#define IP64_CONF_ETH_DRIVER             ip64_null_driver
+
+#endif /* IP64_CONF_H */
@@ -0,0 +1,18 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define IP64_ADDRMAP_CONF_ENTRIES 1024
+
+/* For ip64-dhcpc.c, which the module builds */
+#undef UIP_CONF_BUFFER_SIZE
+#define UIP_CONF_BUFFER_SIZE 600
+
+#if BENCH_CONF_BASELINE
+#define IP64_ADDRMAP_CONF_HASH_SIZE 1
+#define IP64_ADDRMAP_CONF_LIFETIMES 1
+#else /* BENCH_CONF_BASELINE */
+#define IP64_ADDRMAP_CONF_HASH_SIZE 256
+#define MEMB_CONF_WITH_FREELIST 1
+#endif /* BENCH_CONF_BASELINE */
+
+#endif /* PROJECT_CONF_H_ */
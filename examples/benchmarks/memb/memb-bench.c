@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Memory block allocator microbenchmark.
+ *
+ *         Measures the cost of memb_alloc(), memb_free() and
+ *         memb_numfree() on blocks of 16 to 1024 entries, and checks
+ *         that the allocator stays consistent. Build with BASELINE=1
+ *         to measure the scanning allocator instead of the free list.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lib/memb.h"
+#include "lib/random.h"
+#include "bench.h"
+
+#define CHURN 100000
+
+struct entry {
+  uint8_t data[32];
+};
+
+MEMB_FREELIST(pool16, struct entry, 16);
+MEMB_FREELIST(pool64, struct entry, 64);
+MEMB_FREELIST(pool256, struct entry, 256);
+MEMB_FREELIST(pool1024, struct entry, 1024);
+
+static struct memb *pools[] = { &pool16, &pool64, &pool256, &pool1024 };
+static struct entry *entries[1024];
+
+PROCESS(memb_bench_process, "Memb benchmark");
+AUTOSTART_PROCESSES(&memb_bench_process);
+/*---------------------------------------------------------------------------*/
+static int
+unchanged(const struct entry *e, uint8_t c)
+{
+  const uint8_t *p = (const uint8_t *)e;
+  unsigned i;
+
+  for(i = 0; i < sizeof(*e); i++) {
+    if(p[i] != c) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(struct memb *m)
+{
+  unsigned long long t0, alloc, churn, numfree, drain;
+  int n = m->num;
+  int used;
+  int i, j;
+  struct entry *e;
+
+  memb_init(m);
+
+  /* Fill the block completely. */
+  t0 = now_ns();
+  for(i = 0; i < n; i++) {
+    entries[i] = memb_alloc(m);
+  }
+  alloc = now_ns() - t0;
+  check(memb_alloc(m) == NULL, "allocated from a full block", n);
+  for(i = 0; i < n; i++) {
+    check(entries[i] != NULL, "allocation failed", n);
+    entries[i]->data[0] = (uint8_t)i;
+  }
+  for(i = 0; i < n; i++) {
+    check(entries[i]->data[0] == (uint8_t)i, "block handed out twice", n);
+  }
+
+  /* Free a tenth of the blocks, then free a random block and allocate
+     a new one, keeping the block 90% full. */
+  used = n;
+  for(i = 0; i < n / 10; i++) {
+    memb_free(m, entries[--used]);
+  }
+  t0 = now_ns();
+  for(i = 0; i < CHURN; i++) {
+    j = random_rand() % used;
+    memb_free(m, entries[j]);
+    entries[j] = memb_alloc(m);
+  }
+  churn = now_ns() - t0;
+  check(memb_numfree(m) == n - used, "wrong number of free blocks", n);
+
+  t0 = now_ns();
+  for(i = 0; i < CHURN; i++) {
+    memb_numfree(m);
+  }
+  numfree = now_ns() - t0;
+
+  /* Freeing and allocating a block leave its contents alone, so that
+     a list can still be followed through a block freed while it is
+     walked. */
+  e = entries[1];
+  memset(e, 0xa5, sizeof(*e));
+  memb_free(m, e);
+  check(unchanged(e, 0xa5), "free changed the block", n);
+  entries[1] = memb_alloc(m);
+  check(entries[1] != e || unchanged(e, 0xa5), "alloc changed the block", n);
+
+  /* Freeing a block twice must not hand it out twice. */
+  e = entries[0];
+  check(memb_free(m, e) == 0, "free failed", n);
+  check(memb_free(m, e) == 0, "double free counted", n);
+  check(memb_numfree(m) == n - used + 1, "double free changed free count", n);
+  entries[0] = memb_alloc(m);
+  check(memb_free(m, (char *)entries[0] + 1) == -1,
+        "freed a pointer inside a block", n);
+
+  /* Free the rest in a scattered order. */
+  t0 = now_ns();
+  for(i = 0; i < used; i++) {
+    memb_free(m, entries[(i * 7919) % used]);
+  }
+  drain = now_ns() - t0;
+  check(memb_numfree(m) == n, "blocks lost", n);
+  check(memb_high_water(m) == n, "wrong high-water mark", n);
+
+  printf("%5d blocks: alloc %5llu ns, free+alloc %5llu ns, "
+         "numfree %5llu ns, free %5llu ns\n", n,
+         alloc / n, churn / CHURN, numfree / CHURN, drain / used);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(memb_bench_process, ev, data)
+{
+  unsigned i;
+
+  PROCESS_BEGIN();
+
+  printf("memb-bench: %s allocator, times per operation\n",
+         MEMB_WITH_FREELIST ? "free-list" : "scanning");
+
+  for(i = 0; i < sizeof(pools) / sizeof(pools[0]); i++) {
+    run(pools[i]);
+  }
+  printf("memb-bench: %d errors\n", errors);
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,10 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#if !BENCH_CONF_BASELINE
+#define MEMB_CONF_WITH_FREELIST 1
+#endif /* !BENCH_CONF_BASELINE */
+
+#define MEMB_CONF_STATS 1
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Native main loop benchmark.
+ *
+ *         Runs a process that sleeps on event timers and measures how
+ *         late the timers fire and how much CPU time the otherwise
+ *         idle main loop uses. Then measures how late the process runs
+ *         after an rtimer polls it. Build with BASELINE=1 to measure the
+ *         old fixed 1 ms polling loop, or with EPOLL=1 to measure the
+ *         epoll backend.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "bench.h"
+
+#define ROUNDS    3
+#define WAKEUPS   20
+#define INTERVAL  (CLOCK_SECOND / 10)
+
+PROCESS(native_loop_bench_process, "Native loop benchmark");
+AUTOSTART_PROCESSES(&native_loop_bench_process);
+
+static struct rtimer rt;
+static unsigned long long fired;
+/*---------------------------------------------------------------------------*/
+static unsigned long long
+cpu_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+/* Runs from SIGALRM, like the rtimer of a radio driver */
+static void
+rtimer_callback(struct rtimer *t, void *ptr)
+{
+  fired = now_ns();
+  process_poll(&native_loop_bench_process);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(native_loop_bench_process, ev, data)
+{
+  static struct etimer et;
+  static unsigned long long t0, cpu0, now, due, late, worst;
+  static unsigned round, i;
+
+  PROCESS_BEGIN();
+
+  printf("native-loop-bench: %s, %d wakeups every %lu ms per round\n",
+#if SELECT_CONF_EPOLL
+         "epoll",
+#else
+         "select",
+#endif
+         WAKEUPS, (unsigned long)(INTERVAL * 1000 / CLOCK_SECOND));
+
+  for(round = 0; round < ROUNDS; round++) {
+    late = 0;
+    worst = 0;
+    cpu0 = cpu_ns();
+    t0 = now_ns();
+    etimer_set(&et, INTERVAL);
+    for(i = 1; i <= WAKEUPS; i++) {
+      PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+      now = now_ns();
+      due = t0 + i * (INTERVAL * 1000000000ULL / CLOCK_SECOND);
+      if(now > due) {
+        late += now - due;
+        if(now - due > worst) {
+          worst = now - due;
+        }
+      }
+      etimer_reset(&et);
+    }
+    printf("round %u: cpu %5llu us/s, late avg %5llu us, worst %5llu us\n",
+           round,
+           (cpu_ns() - cpu0) * 1000000 / (now_ns() - t0),
+           late / WAKEUPS / 1000, worst / 1000);
+  }
+
+  /* Polls from an rtimer, with no event timer to end the wait */
+  late = 0;
+  worst = 0;
+  for(i = 0; i < WAKEUPS; i++) {
+    fired = 0;
+    rtimer_set(&rt, RTIMER_NOW() + INTERVAL, 1, rtimer_callback, NULL);
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL && fired != 0);
+    now = now_ns() - fired;
+    late += now;
+    if(now > worst) {
+      worst = now;
+    }
+  }
+  printf("rtimer polls: late avg %5llu us, worst %5llu us\n",
+         late / WAKEUPS / 1000, worst / 1000);
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,13 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#if BENCH_CONF_BASELINE
+/* Wake up every millisecond, as the main loop used to */
+#define SELECT_CONF_MAX_SLEEP 1
+#endif /* BENCH_CONF_BASELINE */
+
+#if BENCH_CONF_EPOLL
+#define SELECT_CONF_EPOLL 1
+#endif /* BENCH_CONF_EPOLL */
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Neighbor table lookup benchmark.
+ *
+ *         Measures nbr_table_get_from_lladdr() for known and unknown
+ *         link-layer addresses with a growing number of neighbors.
+ *         Build with BASELINE=1 to measure the linear lookup instead
+ *         of the hash index.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/nbr-table.h"
+#include "bench.h"
+
+#define LOOKUPS 100000
+
+PROCESS(nbr_table_bench_process, "Neighbor table benchmark");
+AUTOSTART_PROCESSES(&nbr_table_bench_process);
+
+struct bench_nbr {
+  uint16_t id;
+};
+
+NBR_TABLE(struct bench_nbr, bench_table);
+
+static const int sizes[] = { 10, 50, 100, 250, NBR_TABLE_MAX_NEIGHBORS };
+/*---------------------------------------------------------------------------*/
+/* EUI-64 style addresses that differ only in the last bytes, as in a
+   deployment of nodes from one vendor */
+static void
+make_addr(linkaddr_t *addr, uint16_t n)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->u8[0] = 0x02;
+  addr->u8[1] = 0x12;
+  addr->u8[LINKADDR_SIZE - 2] = n >> 8;
+  addr->u8[LINKADDR_SIZE - 1] = n & 0xff;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(int n, int added)
+{
+  static linkaddr_t addrs[NBR_TABLE_MAX_NEIGHBORS];
+  linkaddr_t unknown;
+  unsigned long long t0, add, hit, miss;
+  int i, found;
+
+  t0 = now_ns();
+  for(i = added; i < n; i++) {
+    make_addr(&addrs[i], i + 1);
+    nbr_table_add_lladdr(bench_table, &addrs[i], NBR_TABLE_REASON_UNDEFINED,
+                         NULL);
+  }
+  add = now_ns() - t0;
+
+  found = 0;
+  t0 = now_ns();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += nbr_table_get_from_lladdr(bench_table, &addrs[i % n]) != NULL;
+  }
+  hit = now_ns() - t0;
+
+  make_addr(&unknown, 0xffff);
+  t0 = now_ns();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += nbr_table_get_from_lladdr(bench_table, &unknown) != NULL;
+  }
+  miss = now_ns() - t0;
+
+  printf("%4d neighbors: add %6llu ns, lookup hit %6llu ns, miss %6llu ns "
+         "(%d found)\n", n, n > added ? add / (n - added) : 0,
+         hit / LOOKUPS, miss / LOOKUPS, found);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(nbr_table_bench_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("nbr-table-bench: %s lookup, times per operation\n",
+         NBR_TABLE_WITH_HASH ? "hashed" : "linear");
+
+  nbr_table_register(bench_table, NULL);
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i], i > 0 ? sizes[i - 1] : 0);
+  }
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
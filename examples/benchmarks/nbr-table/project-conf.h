@@ -0,0 +1,11 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#undef NBR_TABLE_CONF_MAX_NEIGHBORS
+#define NBR_TABLE_CONF_MAX_NEIGHBORS 500
+
+#if !BENCH_CONF_BASELINE
+#define NBR_TABLE_CONF_WITH_HASH 1
+#endif /* !BENCH_CONF_BASELINE */
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Packet buffer copy benchmark.
+ *
+ *         Runs frames through the buffer operations that a forwarding
+ *         node performs for every hop: 6LoWPAN writes the frame into
+ *         the packetbuf, the MAC layer queues it in a queuebuf and
+ *         copies it back before transmission, the framer prepends the
+ *         MAC header and the radio driver copies the frame out.
+ *         Prints the time per frame and the packetbuf copy counters,
+ *         then checks that queued packets survive changes to the
+ *         packetbuf. Build with BASELINE=1 to measure without headroom
+ *         and with copied queuebufs.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "bench.h"
+
+#define FRAMES      1000000
+#define MAC_HDR_LEN 21
+
+PROCESS(packetbuf_bench_process, "Packetbuf benchmark");
+AUTOSTART_PROCESSES(&packetbuf_bench_process);
+
+static const int sizes[] = { 20, 60, PACKETBUF_SIZE - MAC_HDR_LEN };
+
+static uint8_t payload[PACKETBUF_SIZE];
+static uint8_t radio_buf[PACKETBUF_SIZE];
+/*---------------------------------------------------------------------------*/
+static int
+send_frame(int len)
+{
+  struct queuebuf *q;
+  int ok;
+
+  /* 6LoWPAN output */
+  packetbuf_clear();
+  memcpy(packetbuf_dataptr(), payload, len);
+  packetbuf_set_datalen(len);
+
+  /* MAC layer: queue, then restore for transmission */
+  q = queuebuf_new_from_packetbuf();
+  if(q == NULL) {
+    return 0;
+  }
+  queuebuf_to_packetbuf(q);
+
+  /* Framer */
+  if(!packetbuf_hdralloc(MAC_HDR_LEN)) {
+    queuebuf_free(q);
+    return 0;
+  }
+  memset(packetbuf_hdrptr(), 0x41, MAC_HDR_LEN);
+
+  /* Radio driver */
+  memcpy(radio_buf, packetbuf_hdrptr(), packetbuf_totlen());
+  ok = memcmp(radio_buf + MAC_HDR_LEN, payload, len) == 0;
+
+  queuebuf_free(q);
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(int len, int seed)
+{
+  packetbuf_clear();
+  memcpy(packetbuf_dataptr(), payload + seed, len);
+  packetbuf_set_datalen(len);
+}
+/*---------------------------------------------------------------------------*/
+static int
+holds(struct queuebuf *q, int len, int seed)
+{
+  return q != NULL && queuebuf_datalen(q) == len &&
+    memcmp(queuebuf_dataptr(q), payload + seed, len) == 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Checks that queued packets stay intact while the packetbuf is reused */
+static void
+test_queued(void)
+{
+  struct queuebuf *q[QUEUEBUF_NUM];
+  int before;
+  int i;
+
+  before = queuebuf_numfree();
+
+  /* The packetbuf is cleared and filled with another packet */
+  fill(60, 0);
+  q[0] = queuebuf_new_from_packetbuf();
+  q[1] = queuebuf_new_from_packetbuf();
+  fill(60, 1);
+  check(holds(q[0], 60, 0) && holds(q[1], 60, 0), "cleared", 0);
+
+  /* The packetbuf moves the packet for a header */
+  q[2] = queuebuf_new_from_packetbuf();
+  packetbuf_hdralloc(PACKETBUF_HEADROOM + 4);
+  memset(packetbuf_hdrptr(), 0x41, PACKETBUF_HEADROOM + 4);
+  check(holds(q[2], 60, 1), "header", 0);
+  check(memcmp(packetbuf_dataptr(), payload + 1, 60) == 0,
+        "header packetbuf", 0);
+
+  /* The packetbuf drops data and compacts the packet */
+  q[3] = queuebuf_new_from_packetbuf();
+  packetbuf_hdrreduce(10);
+  packetbuf_compact();
+  check(q[3] != NULL && queuebuf_datalen(q[3]) == PACKETBUF_HEADROOM + 64 &&
+        memcmp((uint8_t *)queuebuf_dataptr(q[3]) + PACKETBUF_HEADROOM + 4,
+               payload + 1, 60) == 0, "compact", 0);
+  check(memcmp(packetbuf_dataptr(), payload + 11, 50) == 0,
+        "compact packetbuf", 0);
+
+  /* A queued packet is copied back */
+  queuebuf_to_packetbuf(q[1]);
+  check(packetbuf_totlen() == 60 &&
+        memcmp(packetbuf_hdrptr(), payload, 60) == 0, "to packetbuf", 0);
+  for(i = 0; i < 4; i++) {
+    queuebuf_free(q[i]);
+  }
+
+  /* Every queuebuf holds its own packet */
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    fill(20, i);
+    q[i] = queuebuf_new_from_packetbuf();
+  }
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    check(holds(q[i], 20, i), "full", i);
+    queuebuf_free(q[i]);
+  }
+  check(queuebuf_numfree() == before, "numfree", queuebuf_numfree());
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(int len)
+{
+  unsigned long long t0, t;
+  int i, ok;
+
+  memset(&packetbuf_stats, 0, sizeof(packetbuf_stats));
+  ok = 0;
+  t0 = now_ns();
+  for(i = 0; i < FRAMES; i++) {
+    payload[0] = i;
+    ok += send_frame(len);
+  }
+  t = now_ns() - t0;
+
+  printf("%3d bytes: %4llu ns per frame, per frame: %lu copies, "
+         "%lu moves, %lu bytes (%d ok)\n", len, t / FRAMES,
+         (unsigned long)((packetbuf_stats.copyfrom + packetbuf_stats.copyto) / FRAMES),
+         (unsigned long)(packetbuf_stats.moves / FRAMES),
+         (unsigned long)(packetbuf_stats.bytes / FRAMES), ok);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(packetbuf_bench_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("packetbuf-bench: %d bytes headroom\n", PACKETBUF_HEADROOM);
+
+  for(i = 0; i < sizeof(payload); i++) {
+    payload[i] = i * 7;
+  }
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i]);
+  }
+
+  test_queued();
+  printf("packetbuf-bench: %d errors\n", errors);
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
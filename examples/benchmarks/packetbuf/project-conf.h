@@ -0,0 +1,13 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define PACKETBUF_CONF_STATS 1
+
+#if !BENCH_CONF_BASELINE
+/* Room for an IEEE 802.15.4 header with long addresses */
+#define PACKETBUF_CONF_HEADROOM 24
+/* Queue packets without copying them */
+#define QUEUEBUF_CONF_SHARE 1
+#endif /* !BENCH_CONF_BASELINE */
+
+#endif /* PROJECT_CONF_H_ */
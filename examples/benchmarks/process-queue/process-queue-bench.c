@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Event dispatch latency benchmark for the process event queue.
+ *
+ *         A producer posts bursts of normal priority events, larger
+ *         than the event ring, followed by a single high priority
+ *         event. The time from process_post() until the event is
+ *         delivered is measured for both classes, together with the
+ *         number of events that could not be posted.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "contiki.h"
+#include "bench.h"
+
+#define ROUNDS      50
+#define BURST       48
+#define NSAMPLES    (BURST + 1)
+
+PROCESS(producer_process, "Burst producer");
+PROCESS(app_process, "Normal priority consumer");
+PROCESS(urgent_process, "High priority consumer");
+AUTOSTART_PROCESSES(&producer_process, &app_process, &urgent_process);
+
+struct latency {
+  const char *name;
+  unsigned long count;
+  unsigned long drops;
+  unsigned long long total;
+  unsigned long long max;
+};
+
+static struct latency app_latency = { "normal" };
+static struct latency urgent_latency = { "high" };
+static unsigned long long post_time[NSAMPLES];
+static process_event_t bench_event;
+/*---------------------------------------------------------------------------*/
+static void
+record(struct latency *l, process_data_t data)
+{
+  unsigned long long d;
+
+  d = now_ns() - post_time[(uintptr_t)data];
+  l->count++;
+  l->total += d;
+  if(d > l->max) {
+    l->max = d;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+post(struct process *p, struct latency *l, uintptr_t i, uint8_t prio)
+{
+  post_time[i] = now_ns();
+  if(process_post_prio(p, bench_event, (process_data_t)i, prio)
+     != PROCESS_ERR_OK) {
+    l->drops++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+report(struct latency *l)
+{
+  printf("%-6s events %6lu dropped %6lu latency avg %8llu ns max %8llu ns\n",
+         l->name, l->count, l->drops,
+         l->count ? l->total / l->count : 0, l->max);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(producer_process, ev, data)
+{
+  static struct etimer et;
+  static int round;
+  uintptr_t i;
+
+  PROCESS_BEGIN();
+
+  bench_event = process_alloc_event();
+  printf("process-queue-bench: %u priority class(es), %u overflow events, "
+         "%u rounds of %u events\n", PROCESS_PRIORITIES,
+         PROCESS_CONF_OVERFLOW_EVENTS, ROUNDS, BURST + 1);
+
+  for(round = 0; round < ROUNDS; round++) {
+    etimer_set(&et, CLOCK_SECOND / 10);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+    for(i = 0; i < BURST; i++) {
+      post(&app_process, &app_latency, i, PROCESS_PRIO_NORMAL);
+    }
+    post(&urgent_process, &urgent_latency, BURST, PROCESS_PRIO_HIGH);
+  }
+
+  /* Let the last burst drain before reporting. */
+  etimer_set(&et, CLOCK_SECOND / 10);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  report(&urgent_latency);
+  report(&app_latency);
+  printf("max queued %u\n", process_maxevents);
+  for(i = 0; i < PROCESS_PRIORITIES; i++) {
+    printf("class %u: max ring %u overflows %u drops %u\n", (unsigned)i,
+           process_queue_stats[i].maxevents, process_queue_stats[i].overflows,
+           process_queue_stats[i].drops);
+  }
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(app_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == bench_event);
+    record(&app_latency, data);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(urgent_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == bench_event);
+    record(&urgent_latency, data);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,11 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define PROCESS_CONF_STATS 1
+
+#if !BENCH_CONF_BASELINE
+#define PROCESS_CONF_PRIORITIES      2
+#define PROCESS_CONF_OVERFLOW_EVENTS 64
+#endif /* !BENCH_CONF_BASELINE */
+
+#endif /* PROJECT_CONF_H_ */
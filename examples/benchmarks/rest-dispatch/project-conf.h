@@ -0,0 +1,10 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#if BENCH_CONF_BASELINE
+#define REST_RESOURCE_HASH_SIZE 1
+#else /* BENCH_CONF_BASELINE */
+#define REST_RESOURCE_HASH_SIZE 32
+#endif /* BENCH_CONF_BASELINE */
+
+#endif /* PROJECT_CONF_H_ */
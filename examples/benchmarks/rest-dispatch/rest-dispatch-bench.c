@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         REST engine dispatch benchmark.
+ *
+ *         Activates resources for the instances of a few IPSO objects,
+ *         as an LWM2M node would, and measures the time to dispatch
+ *         requests to them, to a parent resource, and to paths without
+ *         a resource. Checks which resource handles a request when a
+ *         parent resource and a sub-resource both match. Build with
+ *         BASELINE=1 to keep all resources in a single hash bucket.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "rest-engine.h"
+#include "er-coap.h"
+#include "bench.h"
+
+#define ROUNDS       20000
+#define PATH_LEN     20
+
+static const char *objects[] = { "3", "4", "3303", "3304", "3311", "3323" };
+static const char *items[] = { "5700", "5701", "5601", "5602", "5603",
+                               "5604" };
+#define OBJECTS      (sizeof(objects) / sizeof(objects[0]))
+#define ITEMS        (sizeof(items) / sizeof(items[0]))
+#define RESOURCES    (OBJECTS * ITEMS)
+
+static resource_t resources[RESOURCES];
+static char paths[RESOURCES][PATH_LEN];
+static int handled;
+
+PROCESS(rest_dispatch_bench_process, "REST dispatch benchmark");
+AUTOSTART_PROCESSES(&rest_dispatch_bench_process);
+/*---------------------------------------------------------------------------*/
+static void
+item_handler(void *request, void *response, uint8_t *buffer,
+             uint16_t preferred_size, int32_t *offset)
+{
+  handled = 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+parent_handler(void *request, void *response, uint8_t *buffer,
+               uint16_t preferred_size, int32_t *offset)
+{
+  handled = 2;
+}
+/*---------------------------------------------------------------------------*/
+static void
+child_handler(void *request, void *response, uint8_t *buffer,
+              uint16_t preferred_size, int32_t *offset)
+{
+  handled = 3;
+}
+/*---------------------------------------------------------------------------*/
+PARENT_RESOURCE(res_dev, "", parent_handler, NULL, NULL, NULL);
+RESOURCE(res_dev_info, "", child_handler, NULL, NULL, NULL);
+PARENT_RESOURCE(res_cfg, "", parent_handler, NULL, NULL, NULL);
+RESOURCE(res_cfg_net, "", child_handler, NULL, NULL, NULL);
+RESOURCE(res_dup_first, "", child_handler, NULL, NULL, NULL);
+RESOURCE(res_dup_second, "", parent_handler, NULL, NULL, NULL);
+RESOURCE(res_moved, "", item_handler, NULL, NULL, NULL);
+/*---------------------------------------------------------------------------*/
+/* Dispatches a GET request, and returns the handler that handled it, or
+   zero if there was no resource for the path */
+static int
+dispatch(const char *path)
+{
+  static uint8_t buffer[REST_MAX_CHUNK_SIZE];
+  coap_packet_t request[1];
+  coap_packet_t response[1];
+  int32_t offset = 0;
+
+  coap_init_message(request, COAP_TYPE_CON, COAP_GET, 0);
+  coap_set_header_uri_path(request, path);
+  coap_init_message(response, COAP_TYPE_ACK, CONTENT_2_05, 0);
+  handled = 0;
+  if(!rest_invoke_restful_service(request, response, buffer,
+                                  sizeof(buffer), &offset)) {
+    check(handled == 0 && response->code == NOT_FOUND_4_04,
+          path, response->code);
+  }
+  return handled;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test(void)
+{
+  int i;
+
+  for(i = 0; i < RESOURCES; i++) {
+    check(dispatch(paths[i]) == 1, paths[i], i);
+  }
+  check(dispatch("3303/0") == 0, "3303/0", 0);
+  check(dispatch("3303/0/57000") == 0, "3303/0/57000", 0);
+  check(dispatch("3303/0/5700/1") == 0, "3303/0/5700/1", 0);
+
+  /* A parent resource that was activated first handles its sub-resources */
+  check(dispatch("dev") == 2, "dev", 0);
+  check(dispatch("dev/info") == 2, "dev/info", 0);
+  check(dispatch("dev/a/b") == 2, "dev/a/b", 0);
+  check(dispatch("devx") == 0, "devx", 0);
+  check(dispatch("de") == 0, "de", 0);
+
+  /* A sub-resource that was activated first handles its own path */
+  check(dispatch("cfg/net") == 3, "cfg/net", 0);
+  check(dispatch("cfg/net/a") == 2, "cfg/net/a", 0);
+  check(dispatch("cfg/other") == 2, "cfg/other", 0);
+
+  check(dispatch("dup") == 3, "dup", 0);
+
+  check(dispatch("old") == 0, "old", 0);
+  check(dispatch("new") == 1, "new", 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(const char *what, const char *path)
+{
+  unsigned long long t0, t1;
+  int i;
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    dispatch(path);
+  }
+  t1 = now_ns();
+  printf("rest-dispatch-bench: %s: %llu ns\n", what, (t1 - t0) / ROUNDS);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(rest_dispatch_bench_process, ev, data)
+{
+  unsigned long long t0, t1;
+  int i;
+
+  PROCESS_BEGIN();
+
+  rest_init_engine();
+
+  rest_activate_resource(&res_dev, "dev");
+  rest_activate_resource(&res_dev_info, "dev/info");
+  rest_activate_resource(&res_cfg_net, "cfg/net");
+  rest_activate_resource(&res_cfg, "cfg");
+  rest_activate_resource(&res_dup_first, "dup");
+  rest_activate_resource(&res_dup_second, "dup");
+  rest_activate_resource(&res_moved, "old");
+  rest_activate_resource(&res_moved, "new");
+
+  for(i = 0; i < RESOURCES; i++) {
+    snprintf(paths[i], PATH_LEN, "%s/0/%s", objects[i / ITEMS],
+             items[i % ITEMS]);
+    resources[i].get_handler = item_handler;
+    rest_activate_resource(&resources[i], paths[i]);
+  }
+
+  test();
+
+  bench("first resource", paths[0]);
+  bench("last resource", paths[RESOURCES - 1]);
+  bench("sub-resource", "dev/a/b");
+  bench("no resource", "3303/0/5800");
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    dispatch(paths[i % RESOURCES]);
+  }
+  t1 = now_ns();
+  printf("rest-dispatch-bench: all %d resources: %llu ns\n",
+         (int)RESOURCES, (t1 - t0) / ROUNDS);
+
+  printf("rest-dispatch-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Route lookup benchmark.
+ *
+ *         Fills the routing table with 1000 to 10000 host routes, as
+ *         held by a storing-mode RPL root, and measures
+ *         uip_ds6_route_lookup() for host routes, for addresses
+ *         covered by a shorter prefix route and for addresses without
+ *         a route, and finally removes half of the routes. Build
+ *         with BASELINE=1 to measure the route list scan instead of
+ *         the trie.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "bench.h"
+
+#define LOOKUPS   20000
+#define NEXTHOPS  8
+#define PREFIXES  16
+
+PROCESS(route_lookup_bench_process, "Route lookup benchmark");
+AUTOSTART_PROCESSES(&route_lookup_bench_process);
+
+static const int sizes[] = { 1000, 2500, 5000, UIP_DS6_ROUTE_NB - PREFIXES };
+
+static uip_ipaddr_t hosts[UIP_DS6_ROUTE_NB];
+static uip_ipaddr_t nexthops[NEXTHOPS];
+/*---------------------------------------------------------------------------*/
+static uint32_t
+bench_rand(void)
+{
+  static uint32_t x = 2463534242UL;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+/*---------------------------------------------------------------------------*/
+/* Host addresses in fd00::/64 with EUI-64 based interface identifiers
+   from one vendor */
+static void
+make_host(uip_ipaddr_t *addr, uint32_t id)
+{
+  uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0x0212, 0x4b00, id >> 16, id & 0xffff);
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_nexthops(void)
+{
+  uip_lladdr_t lladdr;
+  int i;
+
+  for(i = 0; i < NEXTHOPS; i++) {
+    memset(&lladdr, 0, sizeof(lladdr));
+    lladdr.addr[0] = 0x02;
+    lladdr.addr[sizeof(lladdr) - 1] = i + 1;
+    uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0, 0, 0, i + 1);
+    uip_ds6_nbr_add(&nexthops[i], &lladdr, 0, NBR_REACHABLE,
+                    NBR_TABLE_REASON_UNDEFINED, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_prefixes(void)
+{
+  uip_ipaddr_t prefix;
+  int i;
+
+  for(i = 0; i < PREFIXES; i++) {
+    uip_ip6addr(&prefix, 0xfd01, 0, 0, i, 0, 0, 0, 0);
+    uip_ds6_route_add(&prefix, 64, &nexthops[i % NEXTHOPS]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Check every host route and a prefix route against the expected
+   result, so that the two implementations can be compared */
+static int
+verify(int n)
+{
+  uip_ds6_route_t *r;
+  uip_ipaddr_t addr;
+  int errors;
+  int i;
+
+  errors = 0;
+  for(i = 0; i < n; i++) {
+    r = uip_ds6_route_lookup(&hosts[i]);
+    if(r == NULL || r->length != 128 || !uip_ipaddr_cmp(&r->ipaddr, &hosts[i])) {
+      errors++;
+    }
+  }
+  for(i = 0; i < PREFIXES; i++) {
+    uip_ip6addr(&addr, 0xfd01, 0, 0, i, 0, 0, 0, i + 1);
+    r = uip_ds6_route_lookup(&addr);
+    if(r == NULL || r->length != 64) {
+      errors++;
+    }
+  }
+  return errors;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(int n, int added)
+{
+  uip_ipaddr_t addr;
+  unsigned long long t0, add, host, prefix, miss;
+  int i, found, errors;
+
+  t0 = now_ns();
+  for(i = added; i < n; i++) {
+    make_host(&hosts[i], bench_rand());
+    uip_ds6_route_add(&hosts[i], 128, &nexthops[i % NEXTHOPS]);
+  }
+  add = now_ns() - t0;
+
+  errors = verify(n);
+
+  found = 0;
+  t0 = now_ns();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += uip_ds6_route_lookup(&hosts[bench_rand() % n]) != NULL;
+  }
+  host = now_ns() - t0;
+
+  t0 = now_ns();
+  for(i = 0; i < LOOKUPS; i++) {
+    uip_ip6addr(&addr, 0xfd01, 0, 0, i % PREFIXES, 0, 0, 0, i);
+    found += uip_ds6_route_lookup(&addr) != NULL;
+  }
+  prefix = now_ns() - t0;
+
+  t0 = now_ns();
+  for(i = 0; i < LOOKUPS; i++) {
+    uip_ip6addr(&addr, 0xfd02, 0, 0, 0, 0, 0, 0, i);
+    found += uip_ds6_route_lookup(&addr) != NULL;
+  }
+  miss = now_ns() - t0;
+
+  printf("%5d routes: add %6llu ns, lookup host %6llu ns (%8llu/s), "
+         "prefix %6llu ns, miss %6llu ns (%d found, %d errors)\n",
+         uip_ds6_route_num_routes(), add / (n - added),
+         host / LOOKUPS, 1000000000ULL * LOOKUPS / (host ? host : 1),
+         prefix / LOOKUPS, miss / LOOKUPS, found, errors);
+}
+/*---------------------------------------------------------------------------*/
+/* Remove every other host route and check that exactly those are gone */
+static void
+remove_half(int n)
+{
+  uip_ds6_route_t *r;
+  unsigned long long t0, rm;
+  int i, errors;
+
+  t0 = now_ns();
+  for(i = 0; i < n; i += 2) {
+    uip_ds6_route_rm(uip_ds6_route_lookup(&hosts[i]));
+  }
+  rm = now_ns() - t0;
+
+  errors = 0;
+  for(i = 0; i < n; i++) {
+    r = uip_ds6_route_lookup(&hosts[i]);
+    if((i & 1) == 0 ? r != NULL : r == NULL) {
+      errors++;
+    }
+  }
+
+  printf("%5d routes: removed %d, %6llu ns per removal (%d errors)\n",
+         uip_ds6_route_num_routes(), (n + 1) / 2, rm / ((n + 1) / 2), errors);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(route_lookup_bench_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("route-lookup-bench: %s lookup, times per operation\n",
+         UIP_DS6_ROUTE_TRIE ? "trie" : "list");
+
+  add_nexthops();
+  add_prefixes();
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i], i > 0 ? sizes[i - 1] : 0);
+  }
+  remove_half(sizes[i - 1]);
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
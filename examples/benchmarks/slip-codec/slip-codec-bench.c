@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         SLIP codec benchmark.
+ *
+ *         Frames packets of random bytes, with a command header in
+ *         front of them as the border router sends them to the
+ *         slip-radio, and decodes them again. Checks every frame, and
+ *         measures the SLIP codec against the byte-at-a-time code that
+ *         it replaces, which is kept here for comparison.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "lib/slip-codec.h"
+#include "bench.h"
+
+#define PACKETS      64
+#define PACKET_SIZE  127
+#define HEADER_SIZE  10
+#define ROUNDS       2000
+
+static uint8_t packets[PACKETS][PACKET_SIZE];
+static uint8_t header[HEADER_SIZE];
+static uint8_t linear[HEADER_SIZE + PACKET_SIZE];
+static uint8_t stream[PACKETS * (SLIP_CODEC_ENCODED_MAX(HEADER_SIZE + PACKET_SIZE) + 1)];
+static uint8_t queue_buf[sizeof(stream)];
+static uint8_t decoded[HEADER_SIZE + PACKET_SIZE];
+static int stream_len;
+
+static struct slip_codec_queue queue;
+static struct slip_codec_decoder decoder;
+
+PROCESS(slip_codec_bench_process, "SLIP codec benchmark");
+AUTOSTART_PROCESSES(&slip_codec_bench_process);
+/*---------------------------------------------------------------------------*/
+/* The byte-at-a-time encoder, as in the border router before */
+static void
+old_write(const uint8_t *p, int len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    switch(p[i]) {
+    case SLIP_CODEC_END:
+      stream[stream_len++] = SLIP_CODEC_ESC;
+      stream[stream_len++] = SLIP_CODEC_ESC_END;
+      break;
+    case SLIP_CODEC_ESC:
+      stream[stream_len++] = SLIP_CODEC_ESC;
+      stream[stream_len++] = SLIP_CODEC_ESC_ESC;
+      break;
+    default:
+      stream[stream_len++] = p[i];
+      break;
+    }
+  }
+  stream[stream_len++] = SLIP_CODEC_END;
+}
+/*---------------------------------------------------------------------------*/
+/* Copies the header and the packet together, as the border router did */
+static void
+old_encode(void)
+{
+  int i;
+
+  stream_len = 0;
+  for(i = 0; i < PACKETS; i++) {
+    memcpy(linear, header, HEADER_SIZE);
+    memcpy(linear + HEADER_SIZE, packets[i], PACKET_SIZE);
+    old_write(linear, sizeof(linear));
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+new_encode(void)
+{
+  struct slip_codec_iov iov[2];
+  int i;
+
+  slip_codec_queue_init(&queue, queue_buf, sizeof(queue_buf));
+  iov[0].data = header;
+  iov[0].len = HEADER_SIZE;
+  iov[1].len = PACKET_SIZE;
+  for(i = 0; i < PACKETS; i++) {
+    iov[1].data = packets[i];
+    slip_codec_queue_putv(&queue, iov, 2, 0);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_frame(const uint8_t *frame, int len, int n)
+{
+  return len == HEADER_SIZE + PACKET_SIZE &&
+    memcmp(frame, header, HEADER_SIZE) == 0 &&
+    memcmp(frame + HEADER_SIZE, packets[n], PACKET_SIZE) == 0;
+}
+/*---------------------------------------------------------------------------*/
+/* The byte-at-a-time decoder, as in the border router before. Returns
+   the number of frames, and checks them if asked to. */
+static int
+old_decode(const uint8_t *in, int in_len, int verify)
+{
+  int i, len, frames, esc;
+  uint8_t c;
+
+  len = frames = esc = 0;
+  for(i = 0; i < in_len; i++) {
+    c = in[i];
+    if(esc) {
+      esc = 0;
+      if(c == SLIP_CODEC_ESC_END) {
+        c = SLIP_CODEC_END;
+      } else if(c == SLIP_CODEC_ESC_ESC) {
+        c = SLIP_CODEC_ESC;
+      }
+    } else if(c == SLIP_CODEC_ESC) {
+      esc = 1;
+      continue;
+    } else if(c == SLIP_CODEC_END) {
+      if(len > 0) {
+        if(verify) {
+          check(check_frame(decoded, len, frames), "old decode", frames);
+        }
+        frames++;
+        len = 0;
+      }
+      continue;
+    }
+    if(len < sizeof(decoded)) {
+      decoded[len++] = c;
+    }
+  }
+  return frames;
+}
+/*---------------------------------------------------------------------------*/
+static int
+new_decode(const uint8_t *in, int in_len, int verify)
+{
+  const uint8_t *p, *end;
+  int len, frames;
+
+  slip_codec_decoder_init(&decoder, decoded, sizeof(decoded));
+  frames = 0;
+  p = in;
+  end = in + in_len;
+  while(p < end) {
+    len = slip_codec_decode(&decoder, &p, end);
+    if(len != 0) {
+      if(verify) {
+        check(check_frame(decoded, len, frames), "new decode", frames);
+      }
+      frames++;
+    }
+  }
+  return frames;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test(void)
+{
+  int i, frames;
+
+  old_encode();
+  new_encode();
+  check(slip_codec_queue_len(&queue) == stream_len, "encoded length",
+        stream_len);
+  check(memcmp(slip_codec_queue_data(&queue), stream, stream_len) == 0,
+        "encoded data", 0);
+
+  frames = old_decode(stream, stream_len, 1);
+  check(frames == PACKETS, "old frames", frames);
+  frames = new_decode(stream, stream_len, 1);
+  check(frames == PACKETS, "new frames", frames);
+
+  /* Decoding a read() at a time gives the same frames */
+  slip_codec_decoder_init(&decoder, decoded, sizeof(decoded));
+  frames = 0;
+  for(i = 0; i < stream_len; i += 61) {
+    const uint8_t *p = stream + i;
+    const uint8_t *end = stream + (i + 61 < stream_len ? i + 61 : stream_len);
+    int len;
+
+    while(p < end) {
+      len = slip_codec_decode(&decoder, &p, end);
+      if(len != 0) {
+        check(check_frame(decoded, len, frames), "chunked decode", frames);
+        frames++;
+      }
+    }
+  }
+  check(frames == PACKETS, "chunked frames", frames);
+}
+/*---------------------------------------------------------------------------*/
+static void
+report(const char *what, unsigned long long ns, long bytes)
+{
+  printf("slip-codec-bench: %s: %llu ns per frame, %llu MB/s\n", what,
+         ns / ((unsigned long long)ROUNDS * PACKETS),
+         (unsigned long long)bytes * ROUNDS * 1000 / (ns ? ns : 1));
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(void)
+{
+  unsigned long long t0, t1;
+  long frames;
+  int i;
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    old_encode();
+  }
+  t1 = now_ns();
+  report("encode, copy and byte at a time", t1 - t0,
+         (long)PACKETS * sizeof(linear));
+
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    new_encode();
+  }
+  t1 = now_ns();
+  report("encode, codec with header and packet", t1 - t0,
+         (long)PACKETS * sizeof(linear));
+
+  frames = 0;
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    frames += old_decode(stream, stream_len, 0);
+  }
+  t1 = now_ns();
+  check(frames == (long)ROUNDS * PACKETS, "old decoded frames", frames);
+  report("decode, byte at a time", t1 - t0, (long)PACKETS * sizeof(linear));
+
+  frames = 0;
+  t0 = now_ns();
+  for(i = 0; i < ROUNDS; i++) {
+    frames += new_decode(stream, stream_len, 0);
+  }
+  t1 = now_ns();
+  check(frames == (long)ROUNDS * PACKETS, "new decoded frames", frames);
+  report("decode, codec", t1 - t0, (long)PACKETS * sizeof(linear));
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(slip_codec_bench_process, ev, data)
+{
+  int i, j;
+
+  PROCESS_BEGIN();
+
+  header[0] = '!';
+  header[1] = 'S';
+  for(i = 2; i < HEADER_SIZE; i++) {
+    header[i] = random_rand();
+  }
+  /* A SLIP_END in the header too */
+  header[HEADER_SIZE - 1] = SLIP_CODEC_END;
+  for(i = 0; i < PACKETS; i++) {
+    for(j = 0; j < PACKET_SIZE; j++) {
+      packets[i][j] = random_rand();
+    }
+  }
+
+  test();
+  bench();
+
+  printf("slip-codec-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
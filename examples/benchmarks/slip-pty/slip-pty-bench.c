@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         SLIP over pty benchmark.
+ *
+ *         Sends SLIP frames through a pseudo terminal in raw mode, the
+ *         way tunslip6 and tunslip send packets to a serial line, and
+ *         decodes them on the other side. Checks every frame, and
+ *         measures frames per second with as many frames in flight as
+ *         fit, and the latency of a single frame. Build with
+ *         BASELINE=1 to encode a byte at a time into a one-frame
+ *         buffer and to decode a byte at a time through stdio, as the
+ *         tools did before.
+ *
+ *         For the native platform only.
+ */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <sys/select.h>
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "lib/slip-codec.h"
+#include "bench.h"
+
+#define FRAMES        20000
+#define LATENCY_ROUNDS 2000
+#define MAX_FRAME     1280
+
+/* Frames are decoded into inbuf, and compared with the frame sent */
+static unsigned char inbuf[2000];
+static unsigned char frame[MAX_FRAME];
+static long received;
+
+PROCESS(slip_pty_bench_process, "SLIP pty benchmark");
+AUTOSTART_PROCESSES(&slip_pty_bench_process);
+/*---------------------------------------------------------------------------*/
+/* The frame with sequence number n. Its length varies between the
+   sizes of a 6LoWPAN fragment and of a full IPv6 packet, and its
+   bytes are random, so that about one in 128 needs escaping. */
+static int
+make_frame(unsigned char *buf, long n)
+{
+  int i, len;
+
+  len = 40 + (n * 97) % (MAX_FRAME - 40);
+  random_init(n);
+  for(i = 0; i < len; i++) {
+    buf[i] = random_rand();
+  }
+  buf[0] = n;
+  buf[1] = n >> 8;
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static void
+frame_received(const unsigned char *buf, int len)
+{
+  int expected_len;
+
+  expected_len = make_frame(frame, received);
+  check(len == expected_len && memcmp(buf, frame, len) == 0,
+        "frame", received);
+  received++;
+}
+/*---------------------------------------------------------------------------*/
+#if BENCH_CONF_BASELINE
+static unsigned char slip_buf[2000];
+static int slip_end, slip_begin;
+static FILE *inslip;
+/*---------------------------------------------------------------------------*/
+static void
+slip_send(unsigned char c)
+{
+  slip_buf[slip_end++] = c;
+}
+/*---------------------------------------------------------------------------*/
+static void
+out_init(int fd)
+{
+  slip_begin = slip_end = 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+out_empty(void)
+{
+  return slip_end == 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+out_has_room(int len)
+{
+  /* One frame at a time */
+  return out_empty();
+}
+/*---------------------------------------------------------------------------*/
+static void
+out_put(const unsigned char *p, int len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    switch(p[i]) {
+    case SLIP_CODEC_END:
+      slip_send(SLIP_CODEC_ESC);
+      slip_send(SLIP_CODEC_ESC_END);
+      break;
+    case SLIP_CODEC_ESC:
+      slip_send(SLIP_CODEC_ESC);
+      slip_send(SLIP_CODEC_ESC_ESC);
+      break;
+    default:
+      slip_send(p[i]);
+      break;
+    }
+  }
+  slip_send(SLIP_CODEC_END);
+}
+/*---------------------------------------------------------------------------*/
+static void
+out_flush(int fd)
+{
+  int n;
+
+  n = write(fd, slip_buf + slip_begin, slip_end - slip_begin);
+  check(n >= 0 || errno == EAGAIN, "write", n);
+  if(n > 0) {
+    slip_begin += n;
+    if(slip_begin == slip_end) {
+      slip_begin = slip_end = 0;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+in_init(int fd)
+{
+  inslip = fdopen(fd, "r");
+  check(inslip != NULL, "fdopen", 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+in_read(int fd)
+{
+  static int inbufptr;
+  unsigned char c;
+
+  while(fread(&c, 1, 1, inslip) == 1) {
+    switch(c) {
+    case SLIP_CODEC_END:
+      if(inbufptr > 0) {
+        frame_received(inbuf, inbufptr);
+        inbufptr = 0;
+      }
+      break;
+    case SLIP_CODEC_ESC:
+      if(fread(&c, 1, 1, inslip) != 1) {
+        clearerr(inslip);
+        ungetc(SLIP_CODEC_ESC, inslip);
+        return;
+      }
+      if(c == SLIP_CODEC_ESC_END) {
+        c = SLIP_CODEC_END;
+      } else if(c == SLIP_CODEC_ESC_ESC) {
+        c = SLIP_CODEC_ESC;
+      }
+      /* FALLTHROUGH */
+    default:
+      if(inbufptr < sizeof(inbuf)) {
+        inbuf[inbufptr++] = c;
+      }
+      break;
+    }
+  }
+  clearerr(inslip);
+}
+/*---------------------------------------------------------------------------*/
+#else /* BENCH_CONF_BASELINE */
+static unsigned char queue_buf[8 * sizeof(inbuf)];
+static struct slip_codec_queue queue;
+static struct slip_codec_decoder decoder;
+/*---------------------------------------------------------------------------*/
+static void
+out_init(int fd)
+{
+  slip_codec_queue_init(&queue, queue_buf, sizeof(queue_buf));
+}
+/*---------------------------------------------------------------------------*/
+static int
+out_empty(void)
+{
+  return slip_codec_queue_len(&queue) == 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+out_has_room(int len)
+{
+  return slip_codec_queue_has_room(&queue, len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+out_put(const unsigned char *p, int len)
+{
+  check(slip_codec_queue_put(&queue, p, len, 0), "put", len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+out_flush(int fd)
+{
+  int n;
+
+  n = write(fd, slip_codec_queue_data(&queue), slip_codec_queue_len(&queue));
+  check(n >= 0 || errno == EAGAIN, "write", n);
+  if(n > 0) {
+    slip_codec_queue_remove(&queue, n);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+in_init(int fd)
+{
+  slip_codec_decoder_init(&decoder, inbuf, sizeof(inbuf));
+}
+/*---------------------------------------------------------------------------*/
+static void
+in_read(int fd)
+{
+  unsigned char buf[4096];
+  const unsigned char *p;
+  int n, len;
+
+  n = read(fd, buf, sizeof(buf));
+  if(n <= 0) {
+    return;
+  }
+  p = buf;
+  while(p < buf + n) {
+    len = slip_codec_decode(&decoder, &p, buf + n);
+    check(len >= 0, "decode", received);
+    if(len > 0) {
+      frame_received(inbuf, len);
+    }
+  }
+}
+#endif /* BENCH_CONF_BASELINE */
+/*---------------------------------------------------------------------------*/
+static int
+open_pty(int *slave)
+{
+  struct termios tty;
+  int master;
+
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  if(master < 0 || grantpt(master) < 0 || unlockpt(master) < 0) {
+    return -1;
+  }
+  *slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+  if(*slave < 0) {
+    return -1;
+  }
+
+  /* Raw mode on both sides, as stty_telos() sets up the serial line */
+  tcgetattr(*slave, &tty);
+  cfmakeraw(&tty);
+  tty.c_cc[VTIME] = 0;
+  tty.c_cc[VMIN] = 0;
+  tcsetattr(*slave, TCSANOW, &tty);
+  tcgetattr(master, &tty);
+  cfmakeraw(&tty);
+  tcsetattr(master, TCSANOW, &tty);
+
+  fcntl(master, F_SETFL, O_NONBLOCK);
+  fcntl(*slave, F_SETFL, O_NONBLOCK);
+  return master;
+}
+/*---------------------------------------------------------------------------*/
+/* Sends count more frames, queueing as many as there is room for,
+   until all have been received. */
+static void
+run(int out, int in, long count)
+{
+  static unsigned char buf[MAX_FRAME];
+  fd_set rset, wset;
+  long sent;
+  int len;
+
+  sent = received;
+  count += received;
+  while(received < count) {
+    while(sent < count && out_has_room(MAX_FRAME)) {
+      len = make_frame(buf, sent++);
+      out_put(buf, len);
+    }
+
+    FD_ZERO(&rset);
+    FD_ZERO(&wset);
+    FD_SET(in, &rset);
+    if(!out_empty()) {
+      FD_SET(out, &wset);
+    }
+    if(select((out > in ? out : in) + 1, &rset, &wset, NULL, NULL) < 0) {
+      check(errno == EINTR, "select", errno);
+      continue;
+    }
+    if(FD_ISSET(out, &wset)) {
+      out_flush(out);
+    }
+    if(FD_ISSET(in, &rset)) {
+      in_read(in);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(slip_pty_bench_process, ev, data)
+{
+  unsigned long long t0, t1;
+  int master, slave;
+  long i;
+
+  PROCESS_BEGIN();
+
+  master = open_pty(&slave);
+  check(master >= 0, "pty", errno);
+  if(master >= 0) {
+    out_init(master);
+    in_init(slave);
+
+    /* A lone SLIP_END first, as the tools send */
+    check(write(master, "\300", 1) == 1, "write end", 0);
+
+    t0 = now_ns();
+    run(master, slave, FRAMES);
+    t1 = now_ns();
+    check(received == FRAMES, "received", received);
+    printf("slip-pty-bench: %d frames of 40 to %d bytes: %llu frames/s\n",
+           FRAMES, MAX_FRAME - 1, FRAMES * 1000000000ULL / (t1 - t0));
+
+    t0 = now_ns();
+    for(i = 0; i < LATENCY_ROUNDS; i++) {
+      run(master, slave, 1);
+    }
+    t1 = now_ns();
+    check(received == FRAMES + LATENCY_ROUNDS, "received", received);
+    printf("slip-pty-bench: latency of one frame: %llu ns\n",
+           (t1 - t0) / LATENCY_ROUNDS);
+  }
+
+  printf("slip-pty-bench: %d errors\n", errors);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
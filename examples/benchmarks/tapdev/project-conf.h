@@ -0,0 +1,10 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define UIP_CONF_STATISTICS 1
+
+#if !BENCH_CONF_BASELINE
+#define TAPDEV_CONF_BATCH 32
+#endif /* !BENCH_CONF_BASELINE */
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Tap device receive benchmark.
+ *
+ *         Opens the tap device through the tapdev driver and forks a
+ *         sender that queues IPv6 frames on the other side of the tap
+ *         interface through a packet socket. Then measures how fast
+ *         the frames reach the IP layer. Build with BASELINE=1 to
+ *         read one frame per poll.
+ *
+ *         For the native platform on Linux only. Needs the rights to
+ *         create a tap interface and a packet socket.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <linux/if_tun.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "tapdev-drv.h"
+#include "bench.h"
+
+#define FRAMES      50000
+#define PAYLOAD_LEN 64
+
+PROCESS(tapdev_bench_process, "Tap device benchmark");
+AUTOSTART_PROCESSES(&tapdev_bench_process);
+/*---------------------------------------------------------------------------*/
+static int
+set_up(const char *name)
+{
+  struct ifreq ifr;
+  int s, ok;
+
+  s = socket(AF_INET, SOCK_DGRAM, 0);
+  if(s == -1) {
+    return 0;
+  }
+  memset(&ifr, 0, sizeof(ifr));
+  strncpy(ifr.ifr_name, name, IFNAMSIZ - 1);
+  /* Make room for all frames, so that none are dropped while the
+     node is not reading */
+  ifr.ifr_qlen = FRAMES + 1000;
+  ok = ioctl(s, SIOCSIFTXQLEN, &ifr) != -1 &&
+    ioctl(s, SIOCGIFFLAGS, &ifr) != -1;
+  if(ok) {
+    ifr.ifr_flags |= IFF_UP;
+    ok = ioctl(s, SIOCSIFFLAGS, &ifr) != -1;
+  }
+  close(s);
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+/* Runs in the forked child: send UDP over IPv6 to the all-nodes
+   address, as seen by the node on the far side of the tap interface */
+static void
+send_frames(const char *name)
+{
+  static uint8_t frame[14 + 40 + 8 + PAYLOAD_LEN];
+  struct sockaddr_ll sll;
+  int s, i;
+
+  s = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_IPV6));
+  if(s == -1) {
+    perror("tapdev-bench: socket");
+    _exit(1);
+  }
+  memset(&sll, 0, sizeof(sll));
+  sll.sll_family = AF_PACKET;
+  sll.sll_protocol = htons(ETH_P_IPV6);
+  sll.sll_ifindex = if_nametoindex(name);
+  if(bind(s, (struct sockaddr *)&sll, sizeof(sll)) == -1) {
+    perror("tapdev-bench: bind");
+    _exit(1);
+  }
+
+  /* Ethernet: all-nodes multicast MAC, IPv6 ethertype */
+  memset(frame, 0, sizeof(frame));
+  frame[0] = frame[1] = 0x33;
+  frame[5] = 0x01;
+  frame[6] = 0x02;
+  frame[11] = 0x01;
+  frame[12] = 0x86;
+  frame[13] = 0xdd;
+  /* IPv6: fe80::1 to ff02::1, UDP */
+  frame[14] = 0x60;
+  frame[18] = 0;
+  frame[19] = 8 + PAYLOAD_LEN;
+  frame[20] = UIP_PROTO_UDP;
+  frame[21] = 64;
+  frame[22] = 0xfe;
+  frame[23] = 0x80;
+  frame[37] = 0x01;
+  frame[38] = 0xff;
+  frame[39] = 0x02;
+  frame[53] = 0x01;
+  /* UDP: port 9 (discard) */
+  frame[57] = 9;
+  frame[59] = 9;
+  frame[61] = 8 + PAYLOAD_LEN;
+
+  for(i = 0; i < FRAMES; i++) {
+    if(send(s, frame, sizeof(frame), 0) == -1) {
+      if(errno == ENOBUFS || errno == EAGAIN) {
+        i--;
+        usleep(10);
+        continue;
+      }
+      perror("tapdev-bench: send");
+      _exit(1);
+    }
+  }
+  close(s);
+  _exit(0);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(tapdev_bench_process, ev, data)
+{
+  static struct etimer et;
+  static pid_t child;
+  static uip_stats_t last;
+  static unsigned long received;
+  static unsigned long long start, end;
+  static int idle;
+  struct ifreq ifr;
+  uip_stats_t recv;
+
+  PROCESS_BEGIN();
+
+  printf("tapdev-bench: %d frames per poll\n", TAPDEV_BATCH);
+
+  process_start(&tapdev_process, NULL);
+  memset(&ifr, 0, sizeof(ifr));
+  if(tapdev_fd() <= 0 || ioctl(tapdev_fd(), TUNGETIFF, &ifr) == -1 ||
+     !set_up(ifr.ifr_name)) {
+    printf("tapdev-bench: could not set up the tap device\n");
+    exit(1);
+  }
+
+  /* Queue all frames before the node reads any, then measure how fast
+     the node drains the queue */
+  last = uip_stat.ip.recv;
+  child = fork();
+  if(child == 0) {
+    send_frames(ifr.ifr_name);
+  }
+  waitpid(child, NULL, 0);
+
+  received = 0;
+  idle = 0;
+  start = end = now_ns();
+  while(idle < 100) {
+    etimer_set(&et, 1);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+    /* The 16-bit counter wraps, so accumulate the differences */
+    recv = uip_stat.ip.recv;
+    if(recv != last) {
+      received += (uip_stats_t)(recv - last);
+      end = now_ns();
+      last = recv;
+      idle = 0;
+    } else {
+      idle++;
+    }
+  }
+
+  printf("tapdev-bench: %lu of %d frames received, %llu frames/s\n",
+         received, FRAMES,
+         end > start ? received * 1000000000ULL / (end - start) : 0);
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
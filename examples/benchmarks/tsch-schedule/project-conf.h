@@ -0,0 +1,16 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#if !BENCH_CONF_BASELINE
+#define TSCH_SCHEDULE_CONF_WITH_INDEX 1
+#endif /* !BENCH_CONF_BASELINE */
+
+#define TSCH_SCHEDULE_CONF_STATS 1
+
+#define TSCH_SCHEDULE_CONF_MAX_SLOTFRAMES 4
+#define TSCH_SCHEDULE_CONF_MAX_LINKS 256
+
+/* Do not install the minimal schedule */
+#define TSCH_SCHEDULE_CONF_WITH_6TISCH_MINIMAL 0
+
+#endif /* PROJECT_CONF_H_ */
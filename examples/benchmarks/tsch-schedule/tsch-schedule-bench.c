@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         TSCH schedule lookup benchmark.
+ *
+ *         Builds an Orchestra-like schedule with slotframes of
+ *         different lengths and a growing number of links, then
+ *         walks the schedule from active slot to active slot as the
+ *         slot operation does, timing the calls to
+ *         tsch_schedule_get_next_active_link(). Every result is
+ *         checked against a slot-by-slot search. Build with
+ *         BASELINE=1 to measure the scan of all links instead of the
+ *         schedule index.
+ *
+ *         For the native platform only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-schedule.h"
+#include "bench.h"
+
+#define STEPS 100000
+
+PROCESS(tsch_schedule_bench_process, "TSCH schedule benchmark");
+AUTOSTART_PROCESSES(&tsch_schedule_bench_process);
+
+/* EB, broadcast/shared and unicast slotframes, as in Orchestra, and a
+   long slotframe for scheduled traffic */
+static const uint16_t sf_sizes[] = { 397, 31, 17, 101 };
+#define NUM_SF (sizeof(sf_sizes) / sizeof(sf_sizes[0]))
+static struct tsch_slotframe *sf[NUM_SF];
+
+static const int sizes[] = { 8, 32, 128, 240 };
+
+/* Stubs for the parts of TSCH used by the schedule. TSCH is not
+   running, so the lock is always free. */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff,
+                                              0xff, 0xff, 0xff, 0xff } };
+struct tsch_link *current_link;
+static int locked;
+/*---------------------------------------------------------------------------*/
+int
+tsch_is_locked(void)
+{
+  return locked;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  if(locked) {
+    return 0;
+  }
+  locked = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+  locked = 0;
+}
+/*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_add_nbr(const linkaddr_t *addr)
+{
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Installs n links: one EB link and one shared link, the rest spread
+   over the unicast and long slotframes */
+static void
+build(int n)
+{
+  linkaddr_t addr;
+  unsigned i;
+  int k;
+
+  tsch_schedule_remove_all_slotframes();
+  for(i = 0; i < NUM_SF; i++) {
+    sf[i] = tsch_schedule_add_slotframe(i, sf_sizes[i]);
+  }
+  tsch_schedule_add_link(sf[0], LINK_OPTION_TX, LINK_TYPE_ADVERTISING_ONLY,
+                         &tsch_broadcast_address, 0, 0);
+  tsch_schedule_add_link(sf[1], LINK_OPTION_RX | LINK_OPTION_TX |
+                         LINK_OPTION_SHARED, LINK_TYPE_ADVERTISING,
+                         &tsch_broadcast_address, 0, 1);
+  for(k = 2; k < n; k++) {
+    linkaddr_copy(&addr, &linkaddr_null);
+    addr.u8[LINKADDR_SIZE - 1] = k;
+    if(k % 4 == 0) {
+      tsch_schedule_add_link(sf[2], LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                             &addr, (k * 7) % sf_sizes[2], 2);
+    } else {
+      tsch_schedule_add_link(sf[3], LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                             &addr, (k * 13) % sf_sizes[3], 3);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The distance to the next active slot, found slot by slot */
+static uint16_t
+next_slot(struct tsch_asn_t *asn)
+{
+  uint16_t d;
+  unsigned i;
+
+  for(d = 1; d <= 397; d++) {
+    struct tsch_asn_t next = *asn;
+    TSCH_ASN_INC(next, d);
+    for(i = 0; i < NUM_SF; i++) {
+      if(tsch_schedule_get_link_by_timeslot(sf[i],
+           TSCH_ASN_MOD(next, sf[i]->size)) != NULL) {
+        return d;
+      }
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(int n)
+{
+  struct tsch_asn_t asn;
+  struct tsch_link *l, *backup;
+  unsigned long long t0, t;
+  uint16_t offset;
+  int i;
+
+  build(n);
+
+  /* Check the walk against the slot by slot search */
+  TSCH_ASN_INIT(asn, 0, 0);
+  for(i = 0; i < 5000; i++) {
+    l = tsch_schedule_get_next_active_link(&asn, &offset, &backup);
+    if(l == NULL || offset != next_slot(&asn)) {
+      printf("%4d links: error at asn %lu\n", n, (unsigned long)asn.ls4b);
+      errors++;
+      break;
+    }
+    TSCH_ASN_INC(asn, offset);
+  }
+
+  memset(&tsch_schedule_stats, 0, sizeof(tsch_schedule_stats));
+  TSCH_ASN_INIT(asn, 0, 0);
+  t0 = now_ns();
+  for(i = 0; i < STEPS; i++) {
+    l = tsch_schedule_get_next_active_link(&asn, &offset, &backup);
+    TSCH_ASN_INC(asn, offset);
+  }
+  t = now_ns() - t0;
+
+  printf("%4d links: %5llu ns per lookup (%lu lookups, "
+         "longest %u rtimer ticks)\n", n, t / STEPS,
+         (unsigned long)tsch_schedule_stats.lookups,
+         (unsigned)tsch_schedule_stats.lookup_max);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(tsch_schedule_bench_process, ev, data)
+{
+  unsigned i;
+
+  PROCESS_BEGIN();
+
+  printf("tsch-schedule-bench: %s\n",
+         TSCH_SCHEDULE_WITH_INDEX ? "schedule index" : "link scan");
+
+  tsch_schedule_init();
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i]);
+  }
+  printf("tsch-schedule-bench: %d errors\n", errors);
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
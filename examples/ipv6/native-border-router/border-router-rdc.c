@@ -101,8 +101,10 @@ static void
 send_packet(mac_callback_t sent, void *ptr)
 {
   int size;
-  /* 3 bytes per packet attribute is required for serialization */
-  uint8_t buf[PACKETBUF_NUM_ATTRS * 3 + PACKETBUF_SIZE + 3];
+  /* 3 bytes per packet attribute and a count are required for
+     serialization, after the 3 byte command */
+  uint8_t buf[3 + 1 + PACKETBUF_NUM_ATTRS * 3];
+  struct slip_codec_iov iov[2];
   uint8_t sid;
 
   packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
@@ -121,7 +123,7 @@ send_packet(mac_callback_t sent, void *ptr)
 #if SERIALIZE_ATTRIBUTES
     size = packetutils_serialize_atts(&buf[3], sizeof(buf) - 3);
 #endif
-    if(size < 0 || size + packetbuf_totlen() + 3 > sizeof(buf)) {
+    if(size < 0) {
       PRINTF("br-rdc: send failed, too large header\n");
       mac_call_sent_callback(sent, ptr, MAC_TX_ERR_FATAL, 1);
     } else {
@@ -131,10 +133,13 @@ send_packet(mac_callback_t sent, void *ptr)
       buf[1] = 'S';
       buf[2] = sid; /* sequence or session number for this packet */
 
-      /* Copy packet data */
-      memcpy(&buf[3 + size], packetbuf_hdrptr(), packetbuf_totlen());
+      /* The packet data follows the attributes without being copied */
+      iov[0].data = buf;
+      iov[0].len = size + 3;
+      iov[1].data = packetbuf_hdrptr();
+      iov[1].len = packetbuf_totlen();
 
-      write_to_slip(buf, packetbuf_totlen() + size + 3);
+      write_to_slip_iov(iov, 2);
     }
   }
 }
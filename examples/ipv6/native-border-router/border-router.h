@@ -39,11 +39,13 @@
 
 #include "contiki.h"
 #include "net/ip/uip.h"
+#include "lib/slip-codec.h"
 #include <stdio.h>
 
 int border_router_cmd_handler(const uint8_t *data, int len);
 int slip_config_handle_arguments(int argc, char **argv);
 void write_to_slip(const uint8_t *buf, int len);
+void write_to_slip_iov(const struct slip_codec_iov *iov, int iovcnt);
 
 void border_router_set_prefix_64(const uip_ipaddr_t *prefix_64);
 void border_router_set_mac(const uint8_t *data);
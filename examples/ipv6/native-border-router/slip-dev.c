@@ -53,6 +53,7 @@
 
 #include "net/netstack.h"
 #include "net/packetbuf.h"
+#include "lib/slip-codec.h"
 #include "cmd.h"
 #include "border-router-cmds.h"
 
@@ -72,8 +73,6 @@ extern speed_t slip_config_b_rate;
 
 int devopen(const char *dev, int flags);
 
-static FILE *inslip;
-
 /* for statistics */
 long slip_sent = 0;
 long slip_received = 0;
@@ -83,11 +82,6 @@ int slipfd = 0;
 //#define PROGRESS(s) fprintf(stderr, s)
 #define PROGRESS(s) do { } while(0)
 
-#define SLIP_END     0300
-#define SLIP_ESC     0333
-#define SLIP_ESC_END 0334
-#define SLIP_ESC_ESC 0335
-
 /*---------------------------------------------------------------------------*/
 static void *
 get_in_addr(struct sockaddr *sa)
@@ -169,196 +163,182 @@ slip_packet_input(unsigned char *data, int len)
   NETSTACK_RDC.input();
 }
 /*---------------------------------------------------------------------------*/
+/* Echoes the lines at the start of buf as they are received, for
+   verbose=2,3,5+, and returns the length of what is left. */
+static uint16_t
+echo_lines(uint8_t *buf, uint16_t len)
+{
+  uint8_t *nl;
+  uint16_t n;
+
+  while((nl = memchr(buf, '\n', len)) != NULL) {
+    n = nl - buf + 1;
+    if(!is_sensible_string(buf, n)) {
+      break;
+    }
+    fwrite(buf, n, 1, stdout);
+    len -= n;
+    memmove(buf, buf + n, len);
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static void
+frame_input(unsigned char *inbuf, int inbufptr)
+{
+  int i;
+
+  if(inbuf[0] == '!') {
+    command_context = CMD_CONTEXT_RADIO;
+    cmd_input(inbuf, inbufptr);
+  } else if(inbuf[0] == '?') {
+#define DEBUG_LINE_MARKER '\r'
+  } else if(inbuf[0] == DEBUG_LINE_MARKER) {
+    fwrite(inbuf + 1, inbufptr - 1, 1, stdout);
+  } else if(is_sensible_string(inbuf, inbufptr)) {
+    if(slip_config_verbose == 1) {   /* strings already echoed below for verbose>1 */
+      fwrite(inbuf, inbufptr, 1, stdout);
+    }
+  } else {
+    if(slip_config_verbose > 2) {
+      printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
+      if(slip_config_verbose > 4) {
+#if WIRESHARK_IMPORT_FORMAT
+        printf("0000");
+        for(i = 0; i < inbufptr; i++) printf(" %02x", inbuf[i]);
+#else
+        printf("         ");
+        for(i = 0; i < inbufptr; i++) {
+          printf("%02x", inbuf[i]);
+          if((i & 3) == 3) printf(" ");
+          if((i & 15) == 15) printf("\n         ");
+        }
+#endif
+        printf("\n");
+      }
+    }
+    slip_packet_input(inbuf, inbufptr);
+  }
+}
+/*---------------------------------------------------------------------------*/
 /*
- * Read from serial, when we have a packet call slip_packet_input. No output
- * buffering, input buffered by stdio.
+ * Read from serial, a block at a time, and call slip_packet_input for
+ * each packet in it.
  */
 void
-serial_input(FILE *inslip)
+serial_input(int fd)
 {
   static unsigned char inbuf[2048];
-  static int inbufptr = 0;
-  int ret,i;
-  unsigned char c;
-
-#ifdef linux
-  ret = fread(&c, 1, 1, inslip);
-  if(ret == -1 || ret == 0) err(1, "serial_input: read");
-  goto after_fread;
-#endif
+  static struct slip_codec_decoder decoder;
+  static uint8_t initialized;
+  unsigned char readbuf[4096];
+  const uint8_t *p, *end;
+  int n, len;
+
+  if(!initialized) {
+    slip_codec_decoder_init(&decoder, inbuf, sizeof(inbuf));
+    initialized = 1;
+  }
 
- read_more:
-  if(inbufptr >= sizeof(inbuf)) {
-     fprintf(stderr, "*** dropping large %d byte packet\n", inbufptr);
-     inbufptr = 0;
+  n = read(fd, readbuf, sizeof(readbuf));
+  if(n == -1 && (errno == EAGAIN || errno == EINTR)) {
+    return;
   }
-  ret = fread(&c, 1, 1, inslip);
-#ifdef linux
- after_fread:
-#endif
-  if(ret == -1) {
+  if(n <= 0) {
     err(1, "serial_input: read");
   }
-  if(ret == 0) {
-    clearerr(inslip);
-    return;
-  }
-  slip_received++;
-  switch(c) {
-  case SLIP_END:
-    if(inbufptr > 0) {
-      if(inbuf[0] == '!') {
-	command_context = CMD_CONTEXT_RADIO;
-	cmd_input(inbuf, inbufptr);
-      } else if(inbuf[0] == '?') {
-#define DEBUG_LINE_MARKER '\r'
-      } else if(inbuf[0] == DEBUG_LINE_MARKER) {
-	fwrite(inbuf + 1, inbufptr - 1, 1, stdout);
-      } else if(is_sensible_string(inbuf, inbufptr)) {
-        if(slip_config_verbose == 1) {   /* strings already echoed below for verbose>1 */
-          fwrite(inbuf, inbufptr, 1, stdout);
-        }
-      } else {
-        if(slip_config_verbose > 2) {
-          printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
-          if(slip_config_verbose > 4) {
-#if WIRESHARK_IMPORT_FORMAT
-            printf("0000");
-	    for(i = 0; i < inbufptr; i++) printf(" %02x", inbuf[i]);
-#else
-            printf("         ");
-            for(i = 0; i < inbufptr; i++) {
-              printf("%02x", inbuf[i]);
-              if((i & 3) == 3) printf(" ");
-              if((i & 15) == 15) printf("\n         ");
-            }
-#endif
-            printf("\n");
-          }
-        }
-	slip_packet_input(inbuf, inbufptr);
+  slip_received += n;
+
+  /* Echo all printable characters for verbose==4 */
+  if(slip_config_verbose == 4) {
+    for(p = readbuf; p < readbuf + n; p++) {
+      if(*p == 0 || *p == '\r' || *p == '\n' || *p == '\t' ||
+         (*p >= ' ' && *p <= '~')) {
+        fwrite(p, 1, 1, stdout);
       }
-      inbufptr = 0;
     }
-    break;
+  }
 
-  case SLIP_ESC:
-    if(fread(&c, 1, 1, inslip) != 1) {
-      clearerr(inslip);
-      /* Put ESC back and give up! */
-      ungetc(SLIP_ESC, inslip);
-      return;
+  p = readbuf;
+  end = readbuf + n;
+  while(p < end) {
+    len = slip_codec_decode(&decoder, &p, end);
+    if(len == SLIP_CODEC_TOO_LONG) {
+      fprintf(stderr, "*** dropping large packet\n");
+      continue;
     }
-
-    switch(c) {
-    case SLIP_ESC_END:
-      c = SLIP_END;
-      break;
-    case SLIP_ESC_ESC:
-      c = SLIP_ESC;
-      break;
+    if(len > 0 && slip_config_verbose >= 2 && slip_config_verbose != 4) {
+      len = echo_lines(inbuf, len);
     }
-    /* FALLTHROUGH */
-  default:
-    inbuf[inbufptr++] = c;
-
-    /* Echo lines as they are received for verbose=2,3,5+ */
-    /* Echo all printable characters for verbose==4 */
-    if(slip_config_verbose == 4) {
-      if(c == 0 || c == '\r' || c == '\n' || c == '\t' || (c >= ' ' && c <= '~')) {
-	fwrite(&c, 1, 1, stdout);
-      }
-    } else if(slip_config_verbose >= 2) {
-      if(c == '\n' && is_sensible_string(inbuf, inbufptr)) {
-        fwrite(inbuf, inbufptr, 1, stdout);
-        inbufptr = 0;
-      }
+    if(len > 0) {
+      frame_input(inbuf, len);
     }
-    break;
   }
 
-  goto read_more;
+  /* Echo lines as they are received for verbose=2,3,5+ */
+  if(slip_config_verbose >= 2 && slip_config_verbose != 4 &&
+     decoder.len > 0 && decoder.len <= decoder.size) {
+    decoder.len = echo_lines(inbuf, decoder.len);
+  }
 }
-
-unsigned char slip_buf[2048];
-int slip_end, slip_begin, slip_packet_end, slip_packet_count;
+/*---------------------------------------------------------------------------*/
+static uint8_t slip_buf[16384];
+static struct slip_codec_queue slip_queue;
 static struct timer send_delay_timer;
 /* delay between slip packets */
 static clock_time_t send_delay = SEND_DELAY;
 /*---------------------------------------------------------------------------*/
-static void
-slip_send(int fd, unsigned char c)
-{
-  if(slip_end >= sizeof(slip_buf)) {
-    err(1, "slip_send overflow");
-  }
-  slip_buf[slip_end] = c;
-  slip_end++;
-  slip_sent++;
-  if(c == SLIP_END) {
-    /* Full packet received. */
-    slip_packet_count++;
-    if(slip_packet_end == 0) {
-      slip_packet_end = slip_end;
-    }
-  }
-}
-/*---------------------------------------------------------------------------*/
 int
-slip_empty()
+slip_empty(void)
 {
-  return slip_packet_end == 0;
+  return slip_codec_queue_len(&slip_queue) == 0;
 }
 /*---------------------------------------------------------------------------*/
 void
 slip_flushbuf(int fd)
 {
-  int n;
+  const uint8_t *packet_end;
+  int n, len;
 
   if(slip_empty()) {
     return;
   }
 
-  n = write(fd, slip_buf + slip_begin, slip_packet_end - slip_begin);
+  len = slip_codec_queue_len(&slip_queue);
+  packet_end = NULL;
+  if(send_delay > 0) {
+    /* Only up to the end of the next packet */
+    packet_end = memchr(slip_codec_queue_data(&slip_queue), SLIP_CODEC_END, len);
+    len = packet_end - slip_codec_queue_data(&slip_queue) + 1;
+  }
+
+  n = write(fd, slip_codec_queue_data(&slip_queue), len);
 
   if(n == -1 && errno != EAGAIN) {
     err(1, "slip_flushbuf write failed");
   } else if(n == -1) {
     PROGRESS("Q");		/* Outqueue is full! */
   } else {
-    slip_begin += n;
-    if(slip_begin == slip_packet_end) {
-      slip_packet_count--;
-      if(slip_end > slip_packet_end) {
-        memcpy(slip_buf, slip_buf + slip_packet_end,
-               slip_end - slip_packet_end);
-      }
-      slip_end -= slip_packet_end;
-      slip_begin = slip_packet_end = 0;
-      if(slip_end > 0) {
-        /* Find end of next slip packet */
-        for(n = 1; n < slip_end; n++) {
-          if(slip_buf[n] == SLIP_END) {
-            slip_packet_end = n + 1;
-            break;
-          }
-        }
-        /* a delay between slip packets to avoid losing data */
-        if(send_delay > 0) {
-          timer_set(&send_delay_timer, send_delay);
-        }
-      }
+    slip_codec_queue_remove(&slip_queue, n);
+    if(n == len && packet_end != NULL && !slip_empty()) {
+      /* a delay between slip packets to avoid losing data */
+      timer_set(&send_delay_timer, send_delay);
     }
   }
 }
 /*---------------------------------------------------------------------------*/
 static void
-write_to_serial(int outfd, const uint8_t *inbuf, int len)
+write_to_serial(int outfd, const struct slip_codec_iov *iov, int iovcnt)
 {
-  const uint8_t *p = inbuf;
-  int i;
+  uint16_t before;
+  const uint8_t *p;
+  int i, j, len;
 
   if(slip_config_verbose > 2) {
+    len = 0;
+    for(j = 0; j < iovcnt; j++) {
+      len += iov[j].len;
+    }
 #ifdef __CYGWIN__
     printf("Packet from WPCAP of length %d - write SLIP\n", len);
 #else
@@ -367,13 +347,20 @@ write_to_serial(int outfd, const uint8_t *inbuf, int len)
     if(slip_config_verbose > 4) {
 #if WIRESHARK_IMPORT_FORMAT
       printf("0000");
-      for(i = 0; i < len; i++) printf(" %02x", p[i]);
+      for(j = 0; j < iovcnt; j++) {
+        p = iov[j].data;
+        for(i = 0; i < iov[j].len; i++) printf(" %02x", p[i]);
+      }
 #else
       printf("         ");
-      for(i = 0; i < len; i++) {
-        printf("%02x", p[i]);
-        if((i & 3) == 3) printf(" ");
-        if((i & 15) == 15) printf("\n         ");
+      len = 0;
+      for(j = 0; j < iovcnt; j++) {
+        p = iov[j].data;
+        for(i = 0; i < iov[j].len; i++, len++) {
+          printf("%02x", p[i]);
+          if((len & 3) == 3) printf(" ");
+          if((len & 15) == 15) printf("\n         ");
+        }
       }
 #endif
       printf("\n");
@@ -383,36 +370,34 @@ write_to_serial(int outfd, const uint8_t *inbuf, int len)
   /* It would be ``nice'' to send a SLIP_END here but it's not
    * really necessary.
    */
-  /* slip_send(outfd, SLIP_END); */
-
-  for(i = 0; i < len; i++) {
-    switch(p[i]) {
-    case SLIP_END:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_END);
-      break;
-    case SLIP_ESC:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_ESC);
-      break;
-    default:
-      slip_send(outfd, p[i]);
-      break;
-    }
+  before = slip_codec_queue_len(&slip_queue);
+  if(!slip_codec_queue_putv(&slip_queue, iov, iovcnt, 0)) {
+    err(1, "slip_send overflow");
   }
-  slip_send(outfd, SLIP_END);
+  slip_sent += slip_codec_queue_len(&slip_queue) - before;
   PROGRESS("t");
 }
 /*---------------------------------------------------------------------------*/
-/* writes an 802.15.4 packet to slip-radio */
+/* writes an 802.15.4 packet made of several pieces to slip-radio */
 void
-write_to_slip(const uint8_t *buf, int len)
+write_to_slip_iov(const struct slip_codec_iov *iov, int iovcnt)
 {
   if(slipfd > 0) {
-    write_to_serial(slipfd, buf, len);
+    write_to_serial(slipfd, iov, iovcnt);
   }
 }
 /*---------------------------------------------------------------------------*/
+/* writes an 802.15.4 packet to slip-radio */
+void
+write_to_slip(const uint8_t *buf, int len)
+{
+  struct slip_codec_iov iov;
+
+  iov.data = buf;
+  iov.len = len;
+  write_to_slip_iov(&iov, 1);
+}
+/*---------------------------------------------------------------------------*/
 static void
 stty_telos(int fd)
 {
@@ -475,7 +460,7 @@ static void
 handle_fd(fd_set *rset, fd_set *wset)
 {
   if(FD_ISSET(slipfd, rset)) {
-    serial_input(inslip);
+    serial_input(slipfd);
   }
 
   if(FD_ISSET(slipfd, wset)) {
@@ -537,10 +522,9 @@ slip_init(void)
   }
 
   timer_set(&send_delay_timer, 0);
-  slip_send(slipfd, SLIP_END);
-  inslip = fdopen(slipfd, "r");
-  if(inslip == NULL) {
-    err(1, "main: fdopen");
-  }
+  slip_codec_queue_init(&slip_queue, slip_buf, sizeof(slip_buf));
+  /* An empty frame, which sends SLIP_END alone */
+  slip_codec_queue_put(&slip_queue, NULL, 0, 0);
+  slip_sent++;
 }
 /*---------------------------------------------------------------------------*/
@@ -34,11 +34,6 @@
 #include "dev/slip.h"
 #include <stdio.h>
 
-#define SLIP_END     0300
-#define SLIP_ESC     0333
-#define SLIP_ESC_END 0334
-#define SLIP_ESC_ESC 0335
-
 #define DEBUG 0
 
 /*---------------------------------------------------------------------------*/
@@ -50,49 +45,37 @@ slipnet_init(void)
 void
 slip_send_packet(const uint8_t *ptr, int len)
 {
-  uint16_t i;
-  uint8_t c;
-
-  slip_arch_writeb(SLIP_END);
-  for(i = 0; i < len; ++i) {
-    c = *ptr++;
-    if(c == SLIP_END) {
-      slip_arch_writeb(SLIP_ESC);
-      c = SLIP_ESC_END;
-    } else if(c == SLIP_ESC) {
-      slip_arch_writeb(SLIP_ESC);
-      c = SLIP_ESC_ESC;
-    }
-    slip_arch_writeb(c);
-  }
-  slip_arch_writeb(SLIP_END);
+  slip_write(ptr, len);
 }
 /*---------------------------------------------------------------------------*/
 void
 slipnet_input(void)
 {
+  struct slip_codec_iov iov[2];
   int i;
   /* radio should be configured for filtering so this should be simple */
   /* this should be sent over SLIP! */
-  /* so just copy into uip-but and send!!! */
+  /* so just send the header and data of packetbuf as they are */
   /* Format: !R<data> ? */
-  uip_len = packetbuf_datalen();
-  i = packetbuf_copyto(uip_buf);
+  iov[0].data = packetbuf_hdrptr();
+  iov[0].len = packetbuf_hdrlen();
+  iov[1].data = packetbuf_dataptr();
+  iov[1].len = packetbuf_datalen();
 
   if(DEBUG) {
-    printf("Slipnet got input of len: %d, copied: %d\n",
-	   packetbuf_datalen(), i);
+    const uint8_t *data = packetbuf_dataptr();
+    printf("Slipnet got input of len: %d, header: %d\n",
+	   packetbuf_datalen(), packetbuf_hdrlen());
 
-    for(i = 0; i < uip_len; i++) {
-      printf("%02x", (unsigned char) uip_buf[i]);
+    for(i = 0; i < packetbuf_datalen(); i++) {
+      printf("%02x", data[i]);
       if((i & 15) == 15) printf("\n");
       else if((i & 7) == 7) printf(" ");
     }
     printf("\n");
   }
 
-  /* printf("SUT: %u\n", uip_len); */
-  slip_send_packet(uip_buf, uip_len);
+  slip_writev(iov, 2);
 }
 /*---------------------------------------------------------------------------*/
 const struct network_driver slipnet_driver = {
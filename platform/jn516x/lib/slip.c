@@ -186,6 +186,16 @@ slip_write(const void *_ptr, int len)
   return len;
 }
 /*---------------------------------------------------------------------------*/
+void
+slip_writev(const struct slip_codec_iov *iov, uint8_t iovcnt)
+{
+#if UART_XONXOFF_FLOW_CTRL
+  slip_codec_write(slip_arch_writeb, iov, iovcnt, SLIP_CODEC_XONXOFF);
+#else /* UART_XONXOFF_FLOW_CTRL */
+  slip_codec_write(slip_arch_writeb, iov, iovcnt, 0);
+#endif /* UART_XONXOFF_FLOW_CTRL */
+}
+/*---------------------------------------------------------------------------*/
 /* slip_send: forward (IPv4) packets with {UIP_FW_NETIF(..., slip_send)}
  * was used in slip-bridge.c
  */
@@ -56,6 +56,23 @@
 #define COFFEE_LOG_TABLE_LIMIT		256
 #define COFFEE_MICRO_LOGS		0
 
+#ifdef COFFEE_CONF_NAME_INDEX
+#define COFFEE_NAME_INDEX		COFFEE_CONF_NAME_INDEX
+#else
+#define COFFEE_NAME_INDEX		1
+#endif
+#define COFFEE_NAME_INDEX_SIZE		128
+
+#ifdef COFFEE_CONF_CACHE_PAGES
+#define COFFEE_CACHE_PAGES		COFFEE_CONF_CACHE_PAGES
+#else
+#define COFFEE_CACHE_PAGES		4
+#endif
+
+#ifdef COFFEE_CONF_GC_PROCESS
+#define COFFEE_GC_PROCESS		COFFEE_CONF_GC_PROCESS
+#endif
+
 #define COFFEE_WRITE(buf, size, offset)				\
 		xmem_pwrite((char *)(buf), (size), COFFEE_START + (offset))
 
@@ -158,6 +158,22 @@ typedef unsigned short uip_stats_t;
 
 #endif /* NETSTACK_CONF_WITH_IPV6 */
 
+/* Link-layer security: AES-NI when the host has it, software otherwise */
+#ifndef AES_128_CONF
+#define AES_128_CONF native_aes_128_driver
+#endif /* AES_128_CONF */
+#ifndef CCM_STAR_CONF
+#define CCM_STAR_CONF native_ccm_star_driver
+#endif /* CCM_STAR_CONF */
+#ifndef AES_128_CONF_KEY_CACHE
+#define AES_128_CONF_KEY_CACHE 8
+#endif /* AES_128_CONF_KEY_CACHE */
+
+/* Internet checksum with wide accumulators and SIMD */
+#ifndef IP_CHKSUM_CONF_ARCH
+#define IP_CHKSUM_CONF_ARCH 1
+#endif /* IP_CHKSUM_CONF_ARCH */
+
 #include <ctype.h>
 #define ctk_arch_isprint isprint
 
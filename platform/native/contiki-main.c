@@ -43,8 +43,10 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <signal.h>
 #include <sys/select.h>
 #include <errno.h>
 
@@ -78,8 +80,37 @@
 #define SELECT_MAX 8
 #endif
 
+/* Wait for file descriptors with epoll instead of select (Linux only).
+   Only the callbacks of ready descriptors are called. */
+#ifdef SELECT_CONF_EPOLL
+#define SELECT_EPOLL SELECT_CONF_EPOLL
+#else
+#define SELECT_EPOLL 0
+#endif
+
+/* Longest time the main loop sleeps when no timer expires earlier */
+#ifdef SELECT_CONF_MAX_SLEEP
+#define SELECT_MAX_SLEEP SELECT_CONF_MAX_SLEEP
+#elif WITH_GUI
+/* The GUI checks for console resizes on every loop iteration */
+#define SELECT_MAX_SLEEP 1
+#else
+#define SELECT_MAX_SLEEP CLOCK_SECOND
+#endif
+
+#if SELECT_EPOLL
+#include <sys/epoll.h>
+
+static int epoll_fd = -1;
+/* The events each descriptor is registered for, and whether it is
+   always ready because epoll cannot wait for it (regular files) */
+static uint32_t select_events[SELECT_MAX];
+static uint8_t select_always[SELECT_MAX];
+#endif /* SELECT_EPOLL */
+
 static const struct select_callback *select_callback[SELECT_MAX];
 static int select_max = 0;
+static sigset_t alarm_set;
 
 SENSORS(&pir_sensor, &vib_sensor, &button_sensor);
 
@@ -100,6 +131,13 @@ select_set_callback(int fd, const struct select_callback *callback)
     }
 
     select_callback[fd] = callback;
+#if SELECT_EPOLL
+    if(select_events[fd] != 0) {
+      epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    }
+    select_events[fd] = 0;
+    select_always[fd] = 0;
+#endif /* SELECT_EPOLL */
 
     /* Update fd max */
     if(callback != NULL) {
@@ -249,19 +287,47 @@ main(int argc, char **argv)
   /* Make standard output unbuffered. */
   setvbuf(stdout, (char *)NULL, _IONBF, 0);
 
+#if SELECT_EPOLL
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if(epoll_fd < 0) {
+    perror("epoll_create1");
+    exit(1);
+  }
+#endif /* SELECT_EPOLL */
+
+  /* The rtimer interrupt is SIGALRM, which may poll a process */
+  sigemptyset(&alarm_set);
+  sigaddset(&alarm_set, SIGALRM);
+
   select_set_callback(STDIN_FILENO, &stdin_fd);
   while(1) {
     fd_set fdr;
     fd_set fdw;
     int maxfd;
     int i;
-    int retval;
-    struct timeval tv;
-
-    retval = process_run();
-
-    tv.tv_sec = 0;
-    tv.tv_usec = retval ? 1 : 1000;
+    clock_time_t timeout;
+    sigset_t wait_mask;
+
+    process_run();
+
+    /* Keep SIGALRM blocked from the check for more work until the wait
+       starts, so that a poll from an rtimer either is seen here or ends
+       the wait, instead of waiting for the next timer. */
+    sigprocmask(SIG_BLOCK, &alarm_set, &wait_mask);
+
+    /* Sleep until the next timer expires, unless there is more to do */
+    timeout = 0;
+    if(process_nevents() == 0) {
+      timeout = SELECT_MAX_SLEEP;
+      if(etimer_pending()) {
+        timeout = etimer_next_expiration_time() - clock_time();
+        if((long)timeout < 0) {
+          timeout = 0;
+        } else if(timeout > SELECT_MAX_SLEEP) {
+          timeout = SELECT_MAX_SLEEP;
+        }
+      }
+    }
 
     FD_ZERO(&fdr);
     FD_ZERO(&fdw);
@@ -272,19 +338,99 @@ main(int argc, char **argv)
       }
     }
 
-    retval = select(maxfd + 1, &fdr, &fdw, NULL, &tv);
-    if(retval < 0) {
-      if(errno != EINTR) {
-        perror("select");
+#if SELECT_EPOLL
+    {
+      struct epoll_event ev[SELECT_MAX];
+      uint32_t events;
+      int always;
+      int n;
+
+      /* Bring the epoll set in line with what the callbacks asked for */
+      always = 0;
+      for(i = 0; i <= select_max; i++) {
+        if(select_callback[i] == NULL) {
+          continue;
+        }
+        events = (FD_ISSET(i, &fdr) ? EPOLLIN : 0) |
+          (FD_ISSET(i, &fdw) ? EPOLLOUT : 0);
+        if(events != select_events[i] && !select_always[i]) {
+          ev[0].events = events;
+          ev[0].data.fd = i;
+          if(select_events[i] == 0) {
+            if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, i, &ev[0]) < 0 &&
+               errno == EPERM) {
+              /* Regular files are always ready, as with select() */
+              select_always[i] = 1;
+            }
+          } else if(events == 0) {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, i, NULL);
+          } else {
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, i, &ev[0]);
+          }
+          select_events[i] = events;
+        }
+        if(select_always[i] && events != 0) {
+          always = 1;
+        }
       }
-    } else if(retval > 0) {
-      /* timeout => retval == 0 */
-      for(i = 0; i <= maxfd; i++) {
-        if(select_callback[i] != NULL) {
-          select_callback[i]->handle_fd(&fdr, &fdw);
+
+      n = epoll_pwait(epoll_fd, ev, SELECT_MAX,
+                      always ? 0 : (int)(timeout * 1000 / CLOCK_SECOND),
+                      &wait_mask);
+      sigprocmask(SIG_SETMASK, &wait_mask, NULL);
+      if(n < 0) {
+        if(errno != EINTR) {
+          perror("epoll_pwait");
+        }
+      } else {
+        /* Pass the ready descriptors to their callbacks in the same
+           fd_set form that select() would have used */
+        for(i = 0; i <= maxfd; i++) {
+          if(!select_always[i]) {
+            FD_CLR(i, &fdr);
+            FD_CLR(i, &fdw);
+          }
+        }
+        for(i = 0; i < n; i++) {
+          if(ev[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+            FD_SET(ev[i].data.fd, &fdr);
+          }
+          if(ev[i].events & (EPOLLOUT | EPOLLERR)) {
+            FD_SET(ev[i].data.fd, &fdw);
+          }
+        }
+        for(i = 0; i <= maxfd; i++) {
+          if(select_callback[i] != NULL &&
+             (FD_ISSET(i, &fdr) || FD_ISSET(i, &fdw))) {
+            select_callback[i]->handle_fd(&fdr, &fdw);
+          }
+        }
+      }
+    }
+#else /* SELECT_EPOLL */
+    {
+      struct timespec ts;
+      int retval;
+
+      ts.tv_sec = timeout / CLOCK_SECOND;
+      ts.tv_nsec = (timeout % CLOCK_SECOND) * (1000000000 / CLOCK_SECOND);
+
+      retval = pselect(maxfd + 1, &fdr, &fdw, NULL, &ts, &wait_mask);
+      sigprocmask(SIG_SETMASK, &wait_mask, NULL);
+      if(retval < 0) {
+        if(errno != EINTR) {
+          perror("pselect");
+        }
+      } else if(retval > 0) {
+        /* timeout => retval == 0 */
+        for(i = 0; i <= maxfd; i++) {
+          if(select_callback[i] != NULL) {
+            select_callback[i]->handle_fd(&fdr, &fdw);
+          }
         }
       }
     }
+#endif /* SELECT_EPOLL */
 
     etimer_request_poll();
 
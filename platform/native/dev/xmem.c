@@ -40,11 +40,42 @@
 #include <unistd.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #define XMEM_SIZE 1024 * 1024
 
+/* Microseconds that an erase takes, to emulate flash memory */
+#ifdef XMEM_CONF_ERASE_TIME
+#define XMEM_ERASE_TIME XMEM_CONF_ERASE_TIME
+#else
+#define XMEM_ERASE_TIME 0
+#endif
+
+/* Microseconds that each read or write takes, to emulate a flash
+   memory behind a serial bus */
+#ifdef XMEM_CONF_ACCESS_TIME
+#define XMEM_ACCESS_TIME XMEM_CONF_ACCESS_TIME
+#else
+#define XMEM_ACCESS_TIME 0
+#endif
+
 static unsigned char xmem[XMEM_SIZE];
 /*---------------------------------------------------------------------------*/
+static void
+access_delay(void)
+{
+  struct timespec start, now;
+
+  if(XMEM_ACCESS_TIME > 0) {
+    /* Too short to sleep, so spin */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do {
+      clock_gettime(CLOCK_MONOTONIC, &now);
+    } while((now.tv_sec - start.tv_sec) * 1000000L +
+            (now.tv_nsec - start.tv_nsec) / 1000 < XMEM_ACCESS_TIME);
+  }
+}
+/*---------------------------------------------------------------------------*/
 int
 xmem_pwrite(const void *buf, int size, unsigned long offset)
 {
@@ -60,6 +91,7 @@ xmem_pwrite(const void *buf, int size, unsigned long offset)
   /*  printf("xmem_write(offset 0x%02x, buf %p, size %l);\n", offset, buf, size);*/
 
   memcpy(&xmem[offset], buf, size);
+  access_delay();
   return size;
 }
 /*---------------------------------------------------------------------------*/
@@ -68,6 +100,7 @@ xmem_pread(void *buf, int size, unsigned long offset)
 {
   /*  printf("xmem_read(addr 0x%02x, buf %p, size %d);\n", addr, buf, size);*/
   memcpy(buf, &xmem[offset], size);
+  access_delay();
   return size;
 }
 /*---------------------------------------------------------------------------*/
@@ -76,6 +109,9 @@ xmem_erase(long nbytes, unsigned long offset)
 {
   /*  printf("xmem_read(addr 0x%02x, buf %p, size %d);\n", addr, buf, size);*/
   memset(&xmem[offset], 0, nbytes);
+  if(XMEM_ERASE_TIME > 0) {
+    usleep(XMEM_ERASE_TIME);
+  }
   return nbytes;
 }
 /*---------------------------------------------------------------------------*/
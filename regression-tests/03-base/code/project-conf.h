@@ -34,4 +34,9 @@
 
 #define UNIT_TEST_PRINT_FUNCTION test_print_report
 
+/* Exercise the hashed neighbor lookup in test-nbr-table */
+#ifndef NBR_TABLE_CONF_WITH_HASH
+#define NBR_TABLE_CONF_WITH_HASH 1
+#endif
+
 #endif /* !_PROJECT_CONF_H_ */
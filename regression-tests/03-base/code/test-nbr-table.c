@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include "net/nbr-table.h"
+
+PROCESS(test_process, "nbr-table.c test");
+AUTOSTART_PROCESSES(&test_process);
+
+struct test_nbr {
+  uint16_t value;
+};
+
+NBR_TABLE(struct test_nbr, table_a);
+NBR_TABLE(struct test_nbr, table_b);
+
+/* The neighbor removed from table a, if any */
+static uint16_t evicted;
+
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+
+static void
+table_a_removed(nbr_table_item_t *item)
+{
+  evicted = ((struct test_nbr *)item)->value;
+}
+
+/* Neighbor addresses are numbered from 1, in order of insertion */
+static const linkaddr_t *
+addr(uint16_t n)
+{
+  static linkaddr_t a;
+
+  memset(&a, 0, sizeof(a));
+  a.u8[0] = 0x02;
+  a.u8[LINKADDR_SIZE - 2] = n >> 8;
+  a.u8[LINKADDR_SIZE - 1] = n & 0xff;
+  return &a;
+}
+
+static struct test_nbr *
+add(nbr_table_t *table, uint16_t n)
+{
+  struct test_nbr *nbr;
+
+  nbr = nbr_table_add_lladdr(table, addr(n), NBR_TABLE_REASON_UNDEFINED, NULL);
+  if(nbr != NULL) {
+    nbr->value = n;
+  }
+  return nbr;
+}
+
+static struct test_nbr *
+get(nbr_table_t *table, uint16_t n)
+{
+  return nbr_table_get_from_lladdr(table, addr(n));
+}
+
+static int
+count(nbr_table_t *table)
+{
+  nbr_table_item_t *item;
+  int n;
+
+  n = 0;
+  for(item = nbr_table_head(table); item != NULL;
+      item = nbr_table_next(table, item)) {
+    n++;
+  }
+  return n;
+}
+
+UNIT_TEST_REGISTER(test_nbr_table_add_get, "AddGet");
+UNIT_TEST(test_nbr_table_add_get)
+{
+  struct test_nbr *nbr;
+  uint16_t n;
+
+  UNIT_TEST_BEGIN();
+
+  for(n = 1; n <= NBR_TABLE_MAX_NEIGHBORS; n++) {
+    UNIT_TEST_ASSERT(add(table_a, n) != NULL);
+  }
+  UNIT_TEST_ASSERT(count(table_a) == NBR_TABLE_MAX_NEIGHBORS);
+
+  for(n = 1; n <= NBR_TABLE_MAX_NEIGHBORS; n++) {
+    nbr = get(table_a, n);
+    UNIT_TEST_ASSERT(nbr != NULL && nbr->value == n);
+    UNIT_TEST_ASSERT(linkaddr_cmp(nbr_table_get_lladdr(table_a, nbr), addr(n)));
+  }
+  UNIT_TEST_ASSERT(get(table_a, NBR_TABLE_MAX_NEIGHBORS + 1) == NULL);
+  UNIT_TEST_ASSERT(get(table_b, 1) == NULL);
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_nbr_table_evict_oldest, "EvictOldest");
+UNIT_TEST(test_nbr_table_evict_oldest)
+{
+  struct test_nbr *nbr;
+  uint16_t n;
+
+  UNIT_TEST_BEGIN();
+
+  /* The table is full: the oldest neighbor makes room for the new one */
+  n = NBR_TABLE_MAX_NEIGHBORS + 1;
+  evicted = 0;
+  nbr = add(table_a, n);
+  UNIT_TEST_ASSERT(nbr != NULL && evicted == 1);
+  UNIT_TEST_ASSERT(get(table_a, 1) == NULL);
+  UNIT_TEST_ASSERT(get(table_a, n) == nbr);
+  UNIT_TEST_ASSERT(get(table_a, 2) != NULL);
+  UNIT_TEST_ASSERT(count(table_a) == NBR_TABLE_MAX_NEIGHBORS);
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_nbr_table_evict_locked, "EvictSkipLocked");
+UNIT_TEST(test_nbr_table_evict_locked)
+{
+  struct test_nbr *nbr;
+  uint16_t n;
+
+  UNIT_TEST_BEGIN();
+
+  /* Neighbor 2 is now the oldest; a locked neighbor is never evicted */
+  UNIT_TEST_ASSERT(nbr_table_lock(table_a, get(table_a, 2)));
+  n = NBR_TABLE_MAX_NEIGHBORS + 2;
+  evicted = 0;
+  nbr = add(table_a, n);
+  UNIT_TEST_ASSERT(nbr != NULL && evicted == 3);
+  UNIT_TEST_ASSERT(get(table_a, 2) != NULL);
+  UNIT_TEST_ASSERT(get(table_a, 3) == NULL);
+  UNIT_TEST_ASSERT(get(table_a, n) == nbr);
+  UNIT_TEST_ASSERT(nbr_table_unlock(table_a, get(table_a, 2)));
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_nbr_table_evict_least_used, "EvictLeastUsed");
+UNIT_TEST(test_nbr_table_evict_least_used)
+{
+  struct test_nbr *nbr;
+  uint16_t n;
+
+  UNIT_TEST_BEGIN();
+
+  /* Neighbors 2 and 4 are also used by table b, so neighbor 5, the
+     oldest neighbor used by a single table, is evicted */
+  UNIT_TEST_ASSERT(add(table_b, 2) != NULL);
+  UNIT_TEST_ASSERT(add(table_b, 4) != NULL);
+  UNIT_TEST_ASSERT(count(table_b) == 2);
+  n = NBR_TABLE_MAX_NEIGHBORS + 3;
+  evicted = 0;
+  nbr = add(table_a, n);
+  UNIT_TEST_ASSERT(nbr != NULL && evicted == 5);
+  UNIT_TEST_ASSERT(get(table_a, 4) != NULL && get(table_b, 4) != NULL);
+  UNIT_TEST_ASSERT(get(table_a, 5) == NULL);
+  UNIT_TEST_ASSERT(get(table_a, n) == nbr);
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_nbr_table_update_lladdr, "UpdateLladdr");
+UNIT_TEST(test_nbr_table_update_lladdr)
+{
+  struct test_nbr *nbr;
+  linkaddr_t old_addr;
+  uint16_t n;
+
+  UNIT_TEST_BEGIN();
+
+  n = NBR_TABLE_MAX_NEIGHBORS + 4;
+  nbr = get(table_a, 6);
+  linkaddr_copy(&old_addr, addr(6));
+  UNIT_TEST_ASSERT(nbr_table_update_lladdr(&old_addr, addr(n), 0) == 1);
+  UNIT_TEST_ASSERT(get(table_a, 6) == NULL);
+  UNIT_TEST_ASSERT(get(table_a, n) == nbr && nbr->value == 6);
+
+  /* Changing to an address already in use removes the neighbor */
+  linkaddr_copy(&old_addr, addr(7));
+  UNIT_TEST_ASSERT(nbr_table_update_lladdr(&old_addr, addr(n), 1) == 0);
+  UNIT_TEST_ASSERT(get(table_a, 7) == NULL);
+  UNIT_TEST_ASSERT(get(table_a, n) == nbr);
+  UNIT_TEST_ASSERT(count(table_a) == NBR_TABLE_MAX_NEIGHBORS - 1);
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_nbr_table_remove, "Remove");
+UNIT_TEST(test_nbr_table_remove)
+{
+  struct test_nbr *nbr;
+
+  UNIT_TEST_BEGIN();
+
+  /* Removing a neighbor from one table keeps it in the other */
+  nbr = get(table_b, 4);
+  UNIT_TEST_ASSERT(nbr_table_remove(table_b, nbr));
+  UNIT_TEST_ASSERT(get(table_b, 4) == NULL);
+  UNIT_TEST_ASSERT(get(table_a, 4) != NULL);
+
+  /* Adding it again gives back the same entry */
+  UNIT_TEST_ASSERT(add(table_b, 4) == nbr);
+
+  UNIT_TEST_END();
+}
+
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  nbr_table_register(table_a, table_a_removed);
+  nbr_table_register(table_b, NULL);
+
+  UNIT_TEST_RUN(test_nbr_table_add_get);
+  UNIT_TEST_RUN(test_nbr_table_evict_oldest);
+  UNIT_TEST_RUN(test_nbr_table_evict_locked);
+  UNIT_TEST_RUN(test_nbr_table_evict_least_used);
+  UNIT_TEST_RUN(test_nbr_table_update_lladdr);
+  UNIT_TEST_RUN(test_nbr_table_remove);
+
+  printf("=check-me= DONE\n");
+  PROCESS_END();
+}
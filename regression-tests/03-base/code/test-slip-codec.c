@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2026, the Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include "lib/slip-codec.h"
+
+PROCESS(test_process, "slip-codec.c test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* A frame with all of the special characters, also next to each other */
+static const uint8_t frame[] = {
+  'a', SLIP_CODEC_END, 'b', SLIP_CODEC_ESC, SLIP_CODEC_ESC, SLIP_CODEC_END,
+  SLIP_CODEC_XON, 'c', SLIP_CODEC_XOFF, SLIP_CODEC_ESC_END, 'd', SLIP_CODEC_END
+};
+
+static uint8_t encoded[128];
+static uint8_t decoded[64];
+static uint8_t queue_buf[64];
+static struct slip_codec_decoder decoder;
+static struct slip_codec_queue queue;
+
+static uint8_t written[128];
+static int written_len;
+
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+
+static void
+writeb(unsigned char c)
+{
+  written[written_len++] = c;
+}
+
+/* Encodes frame with an END before and after it, as the nodes send it */
+static int
+encode_frame(uint8_t *out)
+{
+  int len;
+
+  out[0] = SLIP_CODEC_END;
+  len = 1 + slip_codec_encode(out + 1, frame, sizeof(frame), 0);
+  out[len++] = SLIP_CODEC_END;
+  return len;
+}
+
+UNIT_TEST_REGISTER(test_slip_codec_encode, "Encode");
+UNIT_TEST(test_slip_codec_encode)
+{
+  static const uint8_t expected[] = {
+    'a', SLIP_CODEC_ESC, SLIP_CODEC_ESC_END, 'b',
+    SLIP_CODEC_ESC, SLIP_CODEC_ESC_ESC, SLIP_CODEC_ESC, SLIP_CODEC_ESC_ESC,
+    SLIP_CODEC_ESC, SLIP_CODEC_ESC_END, SLIP_CODEC_XON, 'c', SLIP_CODEC_XOFF,
+    SLIP_CODEC_ESC_END, 'd', SLIP_CODEC_ESC, SLIP_CODEC_ESC_END
+  };
+  static const uint8_t expected_xonxoff[] = {
+    SLIP_CODEC_ESC, SLIP_CODEC_ESC_XON, 'c', SLIP_CODEC_ESC, SLIP_CODEC_ESC_XOFF
+  };
+  int len;
+
+  UNIT_TEST_BEGIN();
+
+  len = slip_codec_encode(encoded, frame, sizeof(frame), 0);
+  UNIT_TEST_ASSERT(len == sizeof(expected) &&
+                   memcmp(encoded, expected, len) == 0);
+
+  /* XON and XOFF are only escaped when asked to */
+  len = slip_codec_encode(encoded, frame + 6, 3, SLIP_CODEC_XONXOFF);
+  UNIT_TEST_ASSERT(len == sizeof(expected_xonxoff) &&
+                   memcmp(encoded, expected_xonxoff, len) == 0);
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_slip_codec_decode, "Decode");
+UNIT_TEST(test_slip_codec_decode)
+{
+  const uint8_t *p, *end;
+  int i, len, split, ret, frames;
+
+  UNIT_TEST_BEGIN();
+
+  len = encode_frame(encoded);
+
+  /* The input may be split anywhere, also inside an escape sequence */
+  for(split = 0; split <= len; split++) {
+    slip_codec_decoder_init(&decoder, decoded, sizeof(decoded));
+    frames = 0;
+
+    p = encoded;
+    for(i = 0; i < 2; i++) {
+      end = i == 0 ? encoded + split : encoded + len;
+      while(p < end) {
+        ret = slip_codec_decode(&decoder, &p, end);
+        if(ret != 0) {
+          UNIT_TEST_ASSERT(ret == sizeof(frame) &&
+                           memcmp(decoded, frame, ret) == 0);
+          frames++;
+        }
+      }
+    }
+    UNIT_TEST_ASSERT(frames == 1 && decoder.len == 0);
+  }
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_slip_codec_decode_xonxoff, "Decode XON/XOFF");
+UNIT_TEST(test_slip_codec_decode_xonxoff)
+{
+  const uint8_t *p;
+  int len, ret;
+
+  UNIT_TEST_BEGIN();
+
+  len = slip_codec_encode(encoded, frame, sizeof(frame), SLIP_CODEC_XONXOFF);
+  encoded[len++] = SLIP_CODEC_END;
+
+  slip_codec_decoder_init(&decoder, decoded, sizeof(decoded));
+  p = encoded;
+  ret = slip_codec_decode(&decoder, &p, encoded + len);
+  UNIT_TEST_ASSERT(ret == sizeof(frame) && p == encoded + len &&
+                   memcmp(decoded, frame, ret) == 0);
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_slip_codec_too_long, "Too long");
+UNIT_TEST(test_slip_codec_too_long)
+{
+  const uint8_t *p;
+  int len, ret;
+
+  UNIT_TEST_BEGIN();
+
+  /* A frame that is one byte too long, then one that fits */
+  slip_codec_decoder_init(&decoder, decoded, sizeof(frame) - 1);
+  len = encode_frame(encoded);
+  len += encode_frame(encoded + len - 1) - 1;
+
+  p = encoded;
+  ret = slip_codec_decode(&decoder, &p, encoded + len);
+  UNIT_TEST_ASSERT(ret == SLIP_CODEC_TOO_LONG);
+
+  decoder.size = sizeof(frame);
+  ret = slip_codec_decode(&decoder, &p, encoded + len);
+  UNIT_TEST_ASSERT(ret == sizeof(frame) && p == encoded + len &&
+                   memcmp(decoded, frame, ret) == 0);
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_slip_codec_empty, "Empty frames");
+UNIT_TEST(test_slip_codec_empty)
+{
+  static const uint8_t input[] = {
+    SLIP_CODEC_END, SLIP_CODEC_END, 'x', SLIP_CODEC_END, SLIP_CODEC_END
+  };
+  const uint8_t *p;
+  int ret;
+
+  UNIT_TEST_BEGIN();
+
+  slip_codec_decoder_init(&decoder, decoded, sizeof(decoded));
+  p = input;
+  ret = slip_codec_decode(&decoder, &p, input + sizeof(input));
+  UNIT_TEST_ASSERT(ret == 1 && decoded[0] == 'x' && p == input + 4);
+
+  ret = slip_codec_decode(&decoder, &p, input + sizeof(input));
+  UNIT_TEST_ASSERT(ret == 0 && p == input + sizeof(input));
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_slip_codec_queue, "Queue");
+UNIT_TEST(test_slip_codec_queue)
+{
+  int len, queued;
+
+  UNIT_TEST_BEGIN();
+
+  slip_codec_queue_init(&queue, queue_buf, sizeof(queue_buf));
+  UNIT_TEST_ASSERT(slip_codec_queue_len(&queue) == 0);
+
+  /* Queue frames until the queue is full */
+  len = slip_codec_encode(encoded, frame, sizeof(frame), 0);
+  queued = 0;
+  while(slip_codec_queue_put(&queue, frame, sizeof(frame), 0)) {
+    queued++;
+    UNIT_TEST_ASSERT(slip_codec_queue_len(&queue) == queued * (len + 1));
+  }
+  UNIT_TEST_ASSERT(queued == sizeof(queue_buf) / (len + 1));
+  UNIT_TEST_ASSERT(memcmp(slip_codec_queue_data(&queue), encoded, len) == 0 &&
+                   slip_codec_queue_data(&queue)[len] == SLIP_CODEC_END);
+
+  /* Part of a frame is written out, which makes room for another */
+  slip_codec_queue_remove(&queue, len / 2);
+  UNIT_TEST_ASSERT(!slip_codec_queue_put(&queue, frame, sizeof(frame), 0));
+  slip_codec_queue_remove(&queue, len + 1 - len / 2);
+  UNIT_TEST_ASSERT(memcmp(slip_codec_queue_data(&queue), encoded, len) == 0);
+  UNIT_TEST_ASSERT(slip_codec_queue_put(&queue, frame, sizeof(frame), 0));
+  UNIT_TEST_ASSERT(slip_codec_queue_len(&queue) == queued * (len + 1));
+
+  slip_codec_queue_remove(&queue, slip_codec_queue_len(&queue));
+  UNIT_TEST_ASSERT(slip_codec_queue_len(&queue) == 0);
+
+  /* An empty frame is an END alone */
+  UNIT_TEST_ASSERT(slip_codec_queue_put(&queue, NULL, 0, 0));
+  UNIT_TEST_ASSERT(slip_codec_queue_len(&queue) == 1 &&
+                   slip_codec_queue_data(&queue)[0] == SLIP_CODEC_END);
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_slip_codec_putv, "Scatter-gather");
+UNIT_TEST(test_slip_codec_putv)
+{
+  struct slip_codec_iov iov[3];
+  int len, split;
+
+  UNIT_TEST_BEGIN();
+
+  len = slip_codec_encode(encoded, frame, sizeof(frame), 0);
+  encoded[len++] = SLIP_CODEC_END;
+
+  /* The pieces are encoded as if they had been copied together */
+  for(split = 0; split <= sizeof(frame); split++) {
+    iov[0].data = frame;
+    iov[0].len = split;
+    iov[1].data = NULL;
+    iov[1].len = 0;
+    iov[2].data = frame + split;
+    iov[2].len = sizeof(frame) - split;
+
+    slip_codec_queue_init(&queue, queue_buf, sizeof(queue_buf));
+    UNIT_TEST_ASSERT(slip_codec_queue_putv(&queue, iov, 3, 0));
+    UNIT_TEST_ASSERT(slip_codec_queue_len(&queue) == len &&
+                     memcmp(slip_codec_queue_data(&queue), encoded, len) == 0);
+
+    written_len = 0;
+    slip_codec_write(writeb, iov, 3, 0);
+    UNIT_TEST_ASSERT(written_len == len + 1 &&
+                     written[0] == SLIP_CODEC_END &&
+                     memcmp(written + 1, encoded, len) == 0);
+  }
+
+  UNIT_TEST_END();
+}
+
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(test_slip_codec_encode);
+  UNIT_TEST_RUN(test_slip_codec_decode);
+  UNIT_TEST_RUN(test_slip_codec_decode_xonxoff);
+  UNIT_TEST_RUN(test_slip_codec_too_long);
+  UNIT_TEST_RUN(test_slip_codec_empty);
+  UNIT_TEST_RUN(test_slip_codec_queue);
+  UNIT_TEST_RUN(test_slip_codec_putv);
+
+  printf("=check-me= DONE\n");
+  PROCESS_END();
+}
@@ -51,6 +51,8 @@
 
 #include <err.h>
 
+#include "lib/slip-codec.h"
+
 int ssystem(const char *fmt, ...)
      __attribute__((__format__ (__printf__, 1, 2)));
 void write_to_serial(int outfd, void *inbuf, int len);
@@ -441,164 +443,145 @@ ssystem(const char *fmt, ...)
   return system(cmd);
 }
 
-#define SLIP_END     0300
-#define SLIP_ESC     0333
-#define SLIP_ESC_END 0334
-#define SLIP_ESC_ESC 0335
+/*
+ * Decoded frames from serial, and encoded frames waiting to be
+ * written to serial. The queue holds any number of frames.
+ */
+#define MAX_PACKET 2000
+union {
+  unsigned char inbuf[MAX_PACKET];
+  struct ip iphdr;
+} uip;
+struct slip_codec_decoder decoder;
+unsigned char slip_buf[8 * MAX_PACKET];
+struct slip_codec_queue slip_queue;
 
 /*
- * Read from serial, when we have a packet write it to tun. No output
- * buffering, input buffered by stdio.
+ * Handle a frame from serial: a command, debug output, or a packet
+ * that is written to tun.
  */
 void
-serial_to_tun(FILE *inslip, int outfd)
+frame_to_tun(int inbufptr, int outfd)
 {
-  static union {
-    unsigned char inbuf[2000];
-    struct ip iphdr;
-  } uip;
-  static int inbufptr = 0;
-
+  /*
+   * Sanity checks.
+   */
+#define DEBUG_LINE_MARKER '\r'
+  int ecode;
   int ret;
-  unsigned char c;
+  ecode = check_ip(&uip.iphdr, inbufptr);
+  if(ecode < 0 && inbufptr == 8 && strncmp((char *)uip.inbuf, "=IPA", 4) == 0) {
+    static struct in_addr ipa;
 
-#ifdef linux
-  ret = fread(&c, 1, 1, inslip);
-  if(ret == -1 || ret == 0) err(1, "serial_to_tun: read");
-  goto after_fread;
-#endif
+    if(memcmp(&ipa, &uip.inbuf[4], sizeof(ipa)) == 0) {
+      return;
+    }
 
- read_more:
-  if(inbufptr >= sizeof(uip.inbuf)) {
-     inbufptr = 0;
-  }
-  ret = fread(&c, 1, 1, inslip);
-#ifdef linux
- after_fread:
-#endif
-  if(ret == -1) {
-    err(1, "serial_to_tun: read");
-  }
-  if(ret == 0) {
-    clearerr(inslip);
-    return;
-    fprintf(stderr, "serial_to_tun: EOF\n");
-    exit(1);
-  }
-  /*  fprintf(stderr, ".");*/
-  switch(c) {
-  case SLIP_END:
-    if(inbufptr > 0) {
-      /*
-       * Sanity checks.
-       */
-#define DEBUG_LINE_MARKER '\r'
-      int ecode;
-      ecode = check_ip(&uip.iphdr, inbufptr);
-      if(ecode < 0 && inbufptr == 8 && strncmp(uip.inbuf, "=IPA", 4) == 0) {
-	static struct in_addr ipa;
-
-	inbufptr = 0;
-	if(memcmp(&ipa, &uip.inbuf[4], sizeof(ipa)) == 0) {
-	  break;
-	}
-
-	/* New address. */
-	if(ipa.s_addr != 0) {
+    /* New address. */
+    if(ipa.s_addr != 0) {
 #ifdef linux
-	  ssystem("route delete -net %s netmask %s dev %s",
-		  inet_ntoa(ipa), "255.255.255.255", tundev);
+      ssystem("route delete -net %s netmask %s dev %s",
+	      inet_ntoa(ipa), "255.255.255.255", tundev);
 #else
-	  ssystem("route delete -net %s -netmask %s -interface %s",
-		  inet_ntoa(ipa), "255.255.255.255", tundev);
+      ssystem("route delete -net %s -netmask %s -interface %s",
+	      inet_ntoa(ipa), "255.255.255.255", tundev);
 #endif
-	}
+    }
 
-	memcpy(&ipa, &uip.inbuf[4], sizeof(ipa));
-	if(ipa.s_addr != 0) {
+    memcpy(&ipa, &uip.inbuf[4], sizeof(ipa));
+    if(ipa.s_addr != 0) {
 #ifdef linux
-	  ssystem("route add -net %s netmask %s dev %s",
-		  inet_ntoa(ipa), "255.255.255.255", tundev);
+      ssystem("route add -net %s netmask %s dev %s",
+	      inet_ntoa(ipa), "255.255.255.255", tundev);
 #else
-	  ssystem("route add -net %s -netmask %s -interface %s",
-		  inet_ntoa(ipa), "255.255.255.255", tundev);
+      ssystem("route add -net %s -netmask %s -interface %s",
+	      inet_ntoa(ipa), "255.255.255.255", tundev);
 #endif
-	}
-	break;
-      } else if(ecode < 0) {
-	/*
-	 * If sensible ASCII string, print it as debug info!
-	 */
-	if(uip.inbuf[0] == DEBUG_LINE_MARKER) {
-	  fwrite(uip.inbuf + 1, inbufptr - 1, 1, stderr);
-	} else if(is_sensible_string(uip.inbuf, inbufptr)) {
-	  fwrite(uip.inbuf, inbufptr, 1, stderr);
-	} else {
-	  fprintf(stderr,
-		  "serial_to_tun: drop packet len=%d ecode=%d\n",
-		  inbufptr, ecode);
-	}
-	inbufptr = 0;
-	break;
-      }
-      PROGRESS("s");
-
-      if(dhsock != -1) {
-	struct ip *ip = (void *)uip.inbuf;
-	if(ip->ip_p == 17 && ip->ip_dst == 0xffffffff /* UDP and broadcast */
-	    && ip->uh_sport == ntohs(BOOTPC) && ip->uh_dport == ntohs(BOOTPS)) {
-	  relay_dhcp_to_server(ip, inbufptr);
-	  inbufptr = 0;
-	}
-      }
-      if(write(outfd, uip.inbuf, inbufptr) != inbufptr) {
-	err(1, "serial_to_tun: write");
-      }
-      inbufptr = 0;
     }
-    break;
+    return;
+  } else if(ecode < 0) {
+    /*
+     * If sensible ASCII string, print it as debug info!
+     */
+    if(uip.inbuf[0] == DEBUG_LINE_MARKER) {
+      fwrite(uip.inbuf + 1, inbufptr - 1, 1, stderr);
+    } else if(is_sensible_string(uip.inbuf, inbufptr)) {
+      fwrite(uip.inbuf, inbufptr, 1, stderr);
+    } else {
+      fprintf(stderr,
+	      "serial_to_tun: drop packet len=%d ecode=%d\n",
+	      inbufptr, ecode);
+    }
+    return;
+  }
+  PROGRESS("s");
 
-  case SLIP_ESC:
-    if(fread(&c, 1, 1, inslip) != 1) {
-      clearerr(inslip);
-      /* Put ESC back and give up! */
-      ungetc(SLIP_ESC, inslip);
+  if(dhsock != -1) {
+    struct ip *ip = (void *)uip.inbuf;
+    if(ip->ip_p == 17 && ip->ip_dst == 0xffffffff /* UDP and broadcast */
+	&& ip->uh_sport == ntohs(BOOTPC) && ip->uh_dport == ntohs(BOOTPS)) {
+      relay_dhcp_to_server(ip, inbufptr);
       return;
     }
+  }
+  ret = write(outfd, uip.inbuf, inbufptr);
+  if(ret == -1 && (errno == EAGAIN || errno == EINTR)) {
+    /* tun is non-blocking; drop the packet rather than stall serial */
+    fprintf(stderr, "*** dropping %d byte packet, tun is full\n",
+            inbufptr);
+  } else if(ret != inbufptr) {
+    err(1, "serial_to_tun: write");
+  }
+}
 
-    switch(c) {
-    case SLIP_ESC_END:
-      c = SLIP_END;
-      break;
-    case SLIP_ESC_ESC:
-      c = SLIP_ESC;
-      break;
-    }
-    /* FALLTHROUGH */
-  default:
-    uip.inbuf[inbufptr++] = c;
-    break;
+/*
+ * Read from serial, when we have a packet write it to tun. Reads
+ * whatever serial has to offer, and decodes all frames in it.
+ */
+void
+serial_to_tun(int infd, int outfd)
+{
+  unsigned char buf[4096];
+  const unsigned char *p, *end;
+  int ret, len;
+
+  ret = read(infd, buf, sizeof(buf));
+  if(ret == -1 && (errno == EAGAIN || errno == EINTR)) {
+    return;
+  }
+#ifdef linux
+  if(ret == -1 || ret == 0) err(1, "serial_to_tun: read");
+#else
+  if(ret == -1) {
+    err(1, "serial_to_tun: read");
   }
+#endif
 
-  goto read_more;
+  p = buf;
+  end = buf + ret;
+  while(p < end) {
+    len = slip_codec_decode(&decoder, &p, end);
+    if(len == SLIP_CODEC_TOO_LONG) {
+      fprintf(stderr, "serial_to_tun: drop packet larger than %d bytes\n",
+	      MAX_PACKET);
+    } else if(len > 0) {
+      frame_to_tun(len, outfd);
+    }
+  }
 }
 
-unsigned char slip_buf[2000];
-int slip_end, slip_begin;
-
 void
-slip_send(int fd, unsigned char c)
+slip_send(const void *data, int len)
 {
-  if (slip_end >= sizeof(slip_buf))
-    err(1, "slip_send overflow");
-  slip_buf[slip_end] = c;
-  slip_end++;
+  if(!slip_codec_queue_put(&slip_queue, data, len, 0)) {
+    fprintf(stderr, "slip_send: drop packet len=%d, output is full\n", len);
+  }
 }
 
 int
 slip_empty()
 {
-  return slip_end == 0;
+  return slip_codec_queue_len(&slip_queue) == 0;
 }
 
 void
@@ -609,25 +592,22 @@ slip_flushbuf(int fd)
   if (slip_empty())
     return;
   
-  n = write(fd, slip_buf + slip_begin, (slip_end - slip_begin));
+  n = write(fd, slip_codec_queue_data(&slip_queue),
+	    slip_codec_queue_len(&slip_queue));
 
   if(n == -1 && errno != EAGAIN) {
     err(1, "slip_flushbuf write failed");
   } else if(n == -1) {
     PROGRESS("Q");		/* Outqueueis full! */
   } else {
-    slip_begin += n;
-    if(slip_begin == slip_end) {
-      slip_begin = slip_end = 0;
-    }
+    slip_codec_queue_remove(&slip_queue, n);
   }
 }
 
 void
 write_to_serial(int outfd, void *inbuf, int len)
 {
-  u_int8_t *p = inbuf;
-  int i, ecode;
+  int ecode;
   struct ip *iphdr = inbuf;
 
   /*
@@ -654,47 +634,33 @@ write_to_serial(int outfd, void *inbuf, int len)
     }
   }
 
-  /* It would be ``nice'' to send a SLIP_END here but it's not
-   * really necessary.
-   */
-  /* slip_send(outfd, SLIP_END); */
-
-  for(i = 0; i < len; i++) {
-    switch(p[i]) {
-    case SLIP_END:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_END);
-      break;
-    case SLIP_ESC:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_ESC);
-      break;
-    default:
-      slip_send(outfd, p[i]);
-      break;
-    }
-    
-  }
-  slip_send(outfd, SLIP_END);
+  slip_send(inbuf, len);
   PROGRESS("t");
 }
 
 
 /*
- * Read from tun, write to slip.
+ * Read from tun, write to slip. Returns the size of the packet, or
+ * zero if there was none.
  */
-void
+int
 tun_to_serial(int infd, int outfd)
 {
   static union {
-    unsigned char inbuf[2000];
+    unsigned char inbuf[MAX_PACKET];
     struct ip iphdr;
   } uip;
   int size;
 
-  if((size = read(infd, uip.inbuf, 2000)) == -1) err(1, "tun_to_serial: read");
+  if((size = read(infd, uip.inbuf, MAX_PACKET)) == -1) {
+    if(errno == EAGAIN) {
+      return 0;
+    }
+    err(1, "tun_to_serial: read");
+  }
 
   write_to_serial(outfd, uip.inbuf, size);
+  return size;
 }
 
 #ifndef BAUDRATE
@@ -868,7 +834,6 @@ main(int argc, char **argv)
   int tunfd, slipfd, maxfd;
   int ret;
   fd_set rset, wset;
-  FILE *inslip;
   const char *siodev = NULL;
   const char *dhcp_server = NULL;
   u_int16_t myport = BOOTPS, dhport = BOOTPS;
@@ -1038,12 +1003,13 @@ main(int argc, char **argv)
   }
   fprintf(stderr, "slip started on ``/dev/%s''\n", siodev);
   stty_telos(slipfd);
-  slip_send(slipfd, SLIP_END);
-  inslip = fdopen(slipfd, "r");
-  if(inslip == NULL) err(1, "main: fdopen");
+  slip_codec_decoder_init(&decoder, uip.inbuf, sizeof(uip.inbuf));
+  slip_codec_queue_init(&slip_queue, slip_buf, sizeof(slip_buf));
+  slip_send(NULL, 0);
 
   tunfd = tun_alloc(tundev);
   if(tunfd == -1) err(1, "main: open");
+  if(fcntl(tunfd, F_SETFL, O_NONBLOCK) == -1) err(1, "main: fcntl");
   fprintf(stderr, "opened device ``/dev/%s''\n", tundev);
 
   atexit(cleanup);
@@ -1060,11 +1026,7 @@ main(int argc, char **argv)
 
     if(got_sigalarm) {
       /* Send "?IPA". */
-      slip_send(slipfd, '?');
-      slip_send(slipfd, 'I');
-      slip_send(slipfd, 'P');
-      slip_send(slipfd, 'A');
-      slip_send(slipfd, SLIP_END);
+      slip_send("?IPA", 4);
       got_sigalarm = 0;
     }
 
@@ -1075,8 +1037,8 @@ main(int argc, char **argv)
     FD_SET(slipfd, &rset);	/* Read from slip ASAP! */
     if(slipfd > maxfd) maxfd = slipfd;
     
-    /* We only have one packet at a time queued for slip output. */
-    if(slip_empty()) {
+    /* Read from tun while any packet fits in the slip output queue. */
+    if(slip_codec_queue_has_room(&slip_queue, MAX_PACKET)) {
       FD_SET(tunfd, &rset);
       if(tunfd > maxfd) maxfd = tunfd;
       if(dhsock != -1) {
@@ -1090,7 +1052,7 @@ main(int argc, char **argv)
       err(1, "select");
     } else if(ret > 0) {
       if(FD_ISSET(slipfd, &rset)) {
-        serial_to_tun(inslip, tunfd);
+        serial_to_tun(slipfd, tunfd);
       }
       
       if(FD_ISSET(slipfd, &wset)) {
@@ -1098,13 +1060,16 @@ main(int argc, char **argv)
 	sigalarm_reset();
       }
 
-      if(slip_empty() && FD_ISSET(tunfd, &rset)) {
-        tun_to_serial(tunfd, slipfd);
+      if(FD_ISSET(tunfd, &rset)) {
+	/* Queue all packets that are waiting */
+	while(slip_codec_queue_has_room(&slip_queue, MAX_PACKET) &&
+	      tun_to_serial(tunfd, slipfd) > 0);
 	slip_flushbuf(slipfd);
 	sigalarm_reset();
       }
 
-      if(dhsock != -1 && slip_empty() && FD_ISSET(dhsock, &rset)) {
+      if(dhsock != -1 && FD_ISSET(dhsock, &rset) &&
+	 slip_codec_queue_has_room(&slip_queue, MAX_PACKET)) {
 	relay_dhcp_to_client(slipfd);
 	slip_flushbuf(slipfd);
       }
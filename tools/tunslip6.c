@@ -57,6 +57,7 @@
 #include <err.h>
 
 #include "tools-utils.h"
+#include "lib/slip-codec.h"
 
 #ifndef BAUDRATE
 #define BAUDRATE B115200
@@ -75,9 +76,6 @@ int ssystem(const char *fmt, ...)
      __attribute__((__format__ (__printf__, 1, 2)));
 void write_to_serial(int outfd, void *inbuf, int len);
 
-void slip_send(int fd, unsigned char c);
-void slip_send_char(int fd, unsigned char c);
-
 #define PROGRESS(s) if(showprogress) fprintf(stderr, s)
 
 char tundev[1024] = { "" };
@@ -102,16 +100,6 @@ ssystem(const char *fmt, ...)
   return system(cmd);
 }
 
-#define SLIP_END      0300
-#define SLIP_ESC      0333
-#define SLIP_ESC_END  0334
-#define SLIP_ESC_ESC  0335
-
-#define SLIP_ESC_XON  0336
-#define SLIP_ESC_XOFF 0337
-#define XON           17
-#define XOFF          19
-
 /* get sockaddr, IPv4 or IPv6: */
 void *
 get_in_addr(struct sockaddr *sa)
@@ -165,162 +153,169 @@ is_sensible_string(const unsigned char *s, int len)
 }
 
 /*
- * Read from serial, when we have a packet write it to tun. No output
- * buffering, input buffered by stdio.
+ * Decoded frames from serial, and encoded frames waiting to be
+ * written to serial. The queue holds any number of frames.
  */
+#define MAX_PACKET 2000
+unsigned char inbuf[MAX_PACKET];
+struct slip_codec_decoder decoder;
+unsigned char slip_buf[8 * MAX_PACKET];
+struct slip_codec_queue slip_queue;
+
 void
-serial_to_tun(FILE *inslip, int outfd)
+slip_send(const void *data, int len)
 {
-  static union {
-    unsigned char inbuf[2000];
-  } uip;
-  static int inbufptr = 0;
-  int ret,i;
-  unsigned char c;
+  if(!slip_codec_queue_put(&slip_queue, data, len,
+                           flowcontrol_xonxoff ? SLIP_CODEC_XONXOFF : 0)) {
+    if(timestamp) stamptime();
+    fprintf(stderr, "*** dropping %d byte packet, serial output is full\n",
+            len);
+  }
+}
 
-#ifdef linux
-  ret = fread(&c, 1, 1, inslip);
-  if(ret == -1 || ret == 0) err(1, "serial_to_tun: read");
-  goto after_fread;
-#endif
+int
+slip_empty()
+{
+  return slip_codec_queue_len(&slip_queue) == 0;
+}
 
- read_more:
-  if(inbufptr >= sizeof(uip.inbuf)) {
-     if(timestamp) stamptime();
-     fprintf(stderr, "*** dropping large %d byte packet\n",inbufptr);
-	 inbufptr = 0;
-  }
-  ret = fread(&c, 1, 1, inslip);
-#ifdef linux
- after_fread:
-#endif
-  if(ret == -1) {
-    err(1, "serial_to_tun: read");
-  }
-  if(ret == 0) {
-    clearerr(inslip);
+void
+slip_flushbuf(int fd)
+{
+  int n;
+
+  if(slip_empty()) {
     return;
   }
-  PROGRESS(".");
-  switch(c) {
-  case SLIP_END:
-    if(inbufptr > 0) {
-      if(uip.inbuf[0] == '!') {
-	if(uip.inbuf[1] == 'M') {
-	  /* Read gateway MAC address and autoconfigure tap0 interface */
-	  char macs[24];
-	  int i, pos;
-	  for(i = 0, pos = 0; i < 16; i++) {
-	    macs[pos++] = uip.inbuf[2 + i];
-	    if((i & 1) == 1 && i < 14) {
-	      macs[pos++] = ':';
-	    }
-	  }
-          if(timestamp) stamptime();
-	  macs[pos] = '\0';
-//	  printf("*** Gateway's MAC address: %s\n", macs);
-	  fprintf(stderr,"*** Gateway's MAC address: %s\n", macs);
-          if (timestamp) stamptime();
-	  ssystem("ifconfig %s down", tundev);
-          if (timestamp) stamptime();
-	  ssystem("ifconfig %s hw ether %s", tundev, &macs[6]);
-          if (timestamp) stamptime();
-	  ssystem("ifconfig %s up", tundev);
+
+  n = write(fd, slip_codec_queue_data(&slip_queue),
+            slip_codec_queue_len(&slip_queue));
+
+  if(n == -1 && errno != EAGAIN) {
+    err(1, "slip_flushbuf write failed");
+  } else if(n == -1) {
+    PROGRESS("Q");		/* Outqueueis full! */
+  } else {
+    slip_codec_queue_remove(&slip_queue, n);
+  }
+}
+
+/*
+ * Handle a frame from serial: a command, debug output, or a packet
+ * that is written to tun.
+ */
+void
+frame_to_tun(unsigned char *inbuf, int inbufptr, int outfd)
+{
+  int i;
+  int ret;
+
+  if(inbuf[0] == '!') {
+    if(inbuf[1] == 'M') {
+      /* Read gateway MAC address and autoconfigure tap0 interface */
+      char macs[24];
+      int i, pos;
+      for(i = 0, pos = 0; i < 16; i++) {
+	macs[pos++] = inbuf[2 + i];
+	if((i & 1) == 1 && i < 14) {
+	  macs[pos++] = ':';
 	}
-      } else if(uip.inbuf[0] == '?') {
-	if(uip.inbuf[1] == 'P') {
-          /* Prefix info requested */
-          struct in6_addr addr;
-	  int i;
-	  char *s = strchr(ipaddr, '/');
-	  if(s != NULL) {
-	    *s = '\0';
-	  }
-          inet_pton(AF_INET6, ipaddr, &addr);
-          if(timestamp) stamptime();
-          fprintf(stderr,"*** Address:%s => %02x%02x:%02x%02x:%02x%02x:%02x%02x\n",
-		 ipaddr,
-		 addr.s6_addr[0], addr.s6_addr[1],
-		 addr.s6_addr[2], addr.s6_addr[3],
-		 addr.s6_addr[4], addr.s6_addr[5],
-		 addr.s6_addr[6], addr.s6_addr[7]);
-	  slip_send(slipfd, '!');
-	  slip_send(slipfd, 'P');
-	  for(i = 0; i < 8; i++) {
-	    /* need to call the slip_send_char for stuffing */
-	    slip_send_char(slipfd, addr.s6_addr[i]);
-	  }
-	  slip_send(slipfd, SLIP_END);
-        }
+      }
+      if(timestamp) stamptime();
+      macs[pos] = '\0';
+//    printf("*** Gateway's MAC address: %s\n", macs);
+      fprintf(stderr,"*** Gateway's MAC address: %s\n", macs);
+      if (timestamp) stamptime();
+      ssystem("ifconfig %s down", tundev);
+      if (timestamp) stamptime();
+      ssystem("ifconfig %s hw ether %s", tundev, &macs[6]);
+      if (timestamp) stamptime();
+      ssystem("ifconfig %s up", tundev);
+    }
+  } else if(inbuf[0] == '?') {
+    if(inbuf[1] == 'P') {
+      /* Prefix info requested */
+      struct in6_addr addr;
+      unsigned char reply[2 + 8];
+      char *s = strchr(ipaddr, '/');
+      if(s != NULL) {
+	*s = '\0';
+      }
+      inet_pton(AF_INET6, ipaddr, &addr);
+      if(timestamp) stamptime();
+      fprintf(stderr,"*** Address:%s => %02x%02x:%02x%02x:%02x%02x:%02x%02x\n",
+	      ipaddr,
+	      addr.s6_addr[0], addr.s6_addr[1],
+	      addr.s6_addr[2], addr.s6_addr[3],
+	      addr.s6_addr[4], addr.s6_addr[5],
+	      addr.s6_addr[6], addr.s6_addr[7]);
+      reply[0] = '!';
+      reply[1] = 'P';
+      memcpy(&reply[2], addr.s6_addr, 8);
+      slip_send(reply, sizeof(reply));
+    }
 #define DEBUG_LINE_MARKER '\r'
-      } else if(uip.inbuf[0] == DEBUG_LINE_MARKER) {
-	fwrite(uip.inbuf + 1, inbufptr - 1, 1, stdout);
-      } else if(is_sensible_string(uip.inbuf, inbufptr)) {
-        if(verbose==1) {   /* strings already echoed below for verbose>1 */
-          if (timestamp) stamptime();
-          fwrite(uip.inbuf, inbufptr, 1, stdout);
-        }
-      } else {
-        if(verbose>2) {
-          if (timestamp) stamptime();
-          printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
-          if (verbose>4) {
+  } else if(inbuf[0] == DEBUG_LINE_MARKER) {
+    fwrite(inbuf + 1, inbufptr - 1, 1, stdout);
+  } else if(is_sensible_string(inbuf, inbufptr)) {
+    if(verbose==1) {   /* strings already echoed below for verbose>1 */
+      if (timestamp) stamptime();
+      fwrite(inbuf, inbufptr, 1, stdout);
+    }
+  } else {
+    if(verbose>2) {
+      if (timestamp) stamptime();
+      printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
+      if (verbose>4) {
 #if WIRESHARK_IMPORT_FORMAT
-            printf("0000");
-	        for(i = 0; i < inbufptr; i++) printf(" %02x",uip.inbuf[i]);
+        printf("0000");
+	for(i = 0; i < inbufptr; i++) printf(" %02x",inbuf[i]);
 #else
-            printf("         ");
-            for(i = 0; i < inbufptr; i++) {
-              printf("%02x", uip.inbuf[i]);
-              if((i & 3) == 3) printf(" ");
-              if((i & 15) == 15) printf("\n         ");
-            }
-#endif
-            printf("\n");
-          }
+        printf("         ");
+        for(i = 0; i < inbufptr; i++) {
+          printf("%02x", inbuf[i]);
+          if((i & 3) == 3) printf(" ");
+          if((i & 15) == 15) printf("\n         ");
         }
-	if(write(outfd, uip.inbuf, inbufptr) != inbufptr) {
-	  err(1, "serial_to_tun: write");
-	}
+#endif
+        printf("\n");
       }
-      inbufptr = 0;
     }
-    break;
-
-  case SLIP_ESC:
-    if(fread(&c, 1, 1, inslip) != 1) {
-      clearerr(inslip);
-      /* Put ESC back and give up! */
-      ungetc(SLIP_ESC, inslip);
-      return;
+    ret = write(outfd, inbuf, inbufptr);
+    if(ret == -1 && (errno == EAGAIN || errno == EINTR)) {
+      /* tun is non-blocking; drop the packet rather than stall serial */
+      if(timestamp) stamptime();
+      fprintf(stderr, "*** dropping %d byte packet, tun is full\n",
+              inbufptr);
+    } else if(ret != inbufptr) {
+      err(1, "serial_to_tun: write");
     }
+  }
+}
 
-    switch(c) {
-    case SLIP_ESC_END:
-      c = SLIP_END;
-      break;
-    case SLIP_ESC_ESC:
-      c = SLIP_ESC;
-      break;
-    case SLIP_ESC_XON:
-      c = XON;
-      break;
-    case SLIP_ESC_XOFF:
-      c = XOFF;
-      break;
-    }
-    /* FALLTHROUGH */
-  default:
-    uip.inbuf[inbufptr++] = c;
+/*
+ * Echo what has been received of a frame, from start on. Returns the
+ * length of the frame, less any lines that were echoed.
+ */
+int
+echo_received(unsigned char *inbuf, int start, int inbufptr)
+{
+  int i;
+  unsigned char c;
+
+  for(i = start; i < inbufptr; i++) {
+    c = inbuf[i];
 
     /* Echo lines as they are received for verbose=2,3,5+ */
     /* Echo all printable characters for verbose==4 */
     if((verbose==2) || (verbose==3) || (verbose>4)) {
       if(c=='\n') {
-        if(is_sensible_string(uip.inbuf, inbufptr)) {
+        if(is_sensible_string(inbuf, i + 1)) {
           if (timestamp) stamptime();
-          fwrite(uip.inbuf, inbufptr, 1, stdout);
-          inbufptr=0;
+          fwrite(inbuf, i + 1, 1, stdout);
+          inbufptr -= i + 1;
+          memmove(inbuf, inbuf + i + 1, inbufptr);
+          i = -1;
         }
       }
     } else if(verbose==4) {
@@ -329,85 +324,54 @@ serial_to_tun(FILE *inslip, int outfd)
         if(c=='\n') if(timestamp) stamptime();
       }
     }
-
-    break;
   }
-
-  goto read_more;
-}
-
-unsigned char slip_buf[2000];
-int slip_end, slip_begin;
-
-void
-slip_send_char(int fd, unsigned char c)
-{
-  switch(c) {
-  case SLIP_END:
-    slip_send(fd, SLIP_ESC);
-    slip_send(fd, SLIP_ESC_END);
-    break;
-  case SLIP_ESC:
-    slip_send(fd, SLIP_ESC);
-    slip_send(fd, SLIP_ESC_ESC);
-    break;
-  case XON:
-    if(flowcontrol_xonxoff) {
-      slip_send(fd, SLIP_ESC);
-      slip_send(fd, SLIP_ESC_XON);
-    } else {
-      slip_send(fd, c);
-    }
-    break;
-  case XOFF:
-    if(flowcontrol_xonxoff) {
-      slip_send(fd, SLIP_ESC);
-      slip_send(fd, SLIP_ESC_XOFF);
-    } else {
-      slip_send(fd, c);
-    }
-    break;
-  default:
-    slip_send(fd, c);
-    break;
-  }
-}
-
-void
-slip_send(int fd, unsigned char c)
-{
-  if(slip_end >= sizeof(slip_buf)) {
-    err(1, "slip_send overflow");
-  }
-  slip_buf[slip_end] = c;
-  slip_end++;
-}
-
-int
-slip_empty()
-{
-  return slip_end == 0;
+  return inbufptr;
 }
 
+/*
+ * Read from serial, when we have a packet write it to tun. Reads
+ * whatever serial has to offer, and decodes all frames in it.
+ */
 void
-slip_flushbuf(int fd)
+serial_to_tun(int infd, int outfd)
 {
-  int n;
+  unsigned char buf[4096];
+  const unsigned char *p, *end;
+  int ret, len, start;
 
-  if(slip_empty()) {
+  ret = read(infd, buf, sizeof(buf));
+  if(ret == -1 && (errno == EAGAIN || errno == EINTR)) {
     return;
   }
+#ifdef linux
+  if(ret == -1 || ret == 0) err(1, "serial_to_tun: read");
+#else
+  if(ret == -1) {
+    err(1, "serial_to_tun: read");
+  }
+#endif
+  PROGRESS(".");
 
-  n = write(fd, slip_buf + slip_begin, (slip_end - slip_begin));
-
-  if(n == -1 && errno != EAGAIN) {
-    err(1, "slip_flushbuf write failed");
-  } else if(n == -1) {
-    PROGRESS("Q");		/* Outqueueis full! */
-  } else {
-    slip_begin += n;
-    if(slip_begin == slip_end) {
-      slip_begin = slip_end = 0;
+  p = buf;
+  end = buf + ret;
+  while(p < end) {
+    start = decoder.len;
+    len = slip_codec_decode(&decoder, &p, end);
+    if(len == SLIP_CODEC_TOO_LONG) {
+      if(timestamp) stamptime();
+      fprintf(stderr, "*** dropping packet larger than %d bytes\n",
+              (int)sizeof(inbuf));
+      continue;
+    }
+    if(verbose > 1) {
+      if(len > 0) {
+        len = echo_received(inbuf, start, len);
+      } else if(decoder.len <= sizeof(inbuf)) {
+        decoder.len = echo_received(inbuf, start, decoder.len);
+      }
+    }
+    if(len > 0) {
+      frame_to_tun(inbuf, len, outfd);
     }
   }
 }
@@ -437,59 +401,29 @@ write_to_serial(int outfd, void *inbuf, int len)
     }
   }
 
-  /* It would be ``nice'' to send a SLIP_END here but it's not
-   * really necessary.
-   */
-  /* slip_send(outfd, SLIP_END); */
-
-  for(i = 0; i < len; i++) {
-    switch(p[i]) {
-    case SLIP_END:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_END);
-      break;
-    case SLIP_ESC:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_ESC);
-      break;
-    case XON:
-      if(flowcontrol_xonxoff) {
-        slip_send(outfd, SLIP_ESC);
-        slip_send(outfd, SLIP_ESC_XON);
-      } else {
-        slip_send(outfd, p[i]);
-      }
-      break;
-    case XOFF:
-      if(flowcontrol_xonxoff) {
-        slip_send(outfd, SLIP_ESC);
-        slip_send(outfd, SLIP_ESC_XOFF);
-      } else {
-        slip_send(outfd, p[i]);
-      }
-      break;
-    default:
-      slip_send(outfd, p[i]);
-      break;
-    }
-  }
-  slip_send(outfd, SLIP_END);
+  slip_send(inbuf, len);
   PROGRESS("t");
 }
 
 
 /*
- * Read from tun, write to slip.
+ * Read from tun, write to slip. Returns the size of the packet, or
+ * zero if there was none.
  */
 int
 tun_to_serial(int infd, int outfd)
 {
   struct {
-    unsigned char inbuf[2000];
+    unsigned char inbuf[MAX_PACKET];
   } uip;
   int size;
 
-  if((size = read(infd, uip.inbuf, 2000)) == -1) err(1, "tun_to_serial: read");
+  if((size = read(infd, uip.inbuf, MAX_PACKET)) == -1) {
+    if(errno == EAGAIN) {
+      return 0;
+    }
+    err(1, "tun_to_serial: read");
+  }
 
   write_to_serial(outfd, uip.inbuf, size);
   return size;
@@ -749,7 +683,6 @@ main(int argc, char **argv)
   int tunfd, maxfd;
   int ret;
   fd_set rset, wset;
-  FILE *inslip;
   const char *siodev = NULL;
   const char *host = NULL;
   const char *port = NULL;
@@ -956,12 +889,13 @@ exit(1);
     fprintf(stderr, "********SLIP started on ``/dev/%s''\n", siodev);
     stty_telos(slipfd);
   }
-  slip_send(slipfd, SLIP_END);
-  inslip = fdopen(slipfd, "r");
-  if(inslip == NULL) err(1, "main: fdopen");
+  slip_codec_decoder_init(&decoder, inbuf, sizeof(inbuf));
+  slip_codec_queue_init(&slip_queue, slip_buf, sizeof(slip_buf));
+  slip_send(NULL, 0);
 
   tunfd = tun_alloc(tundev, tap);
   if(tunfd == -1) err(1, "main: open /dev/tun");
+  if(fcntl(tunfd, F_SETFL, O_NONBLOCK) == -1) err(1, "main: fcntl");
   if (timestamp) stamptime();
   fprintf(stderr, "opened %s device ``/dev/%s''\n",
           tap ? "tap" : "tun", tundev);
@@ -980,11 +914,7 @@ exit(1);
 
     if(got_sigalarm && ipa_enable) {
       /* Send "?IPA". */
-      slip_send(slipfd, '?');
-      slip_send(slipfd, 'I');
-      slip_send(slipfd, 'P');
-      slip_send(slipfd, 'A');
-      slip_send(slipfd, SLIP_END);
+      slip_send("?IPA", 4);
       got_sigalarm = 0;
     }
 
@@ -995,8 +925,10 @@ exit(1);
     FD_SET(slipfd, &rset);	/* Read from slip ASAP! */
     if(slipfd > maxfd) maxfd = slipfd;
 
-    /* We only have one packet at a time queued for slip output. */
-    if(slip_empty()) {
+    /* Read from tun while any packet fits in the slip output
+       queue. Delayed packets are queued one at a time. */
+    if(basedelay ? slip_empty() :
+       slip_codec_queue_has_room(&slip_queue, MAX_PACKET)) {
       FD_SET(tunfd, &rset);
       if(tunfd > maxfd) maxfd = tunfd;
     }
@@ -1006,7 +938,7 @@ exit(1);
       err(1, "select");
     } else if(ret > 0) {
       if(FD_ISSET(slipfd, &rset)) {
-        serial_to_tun(inslip, tunfd);
+        serial_to_tun(slipfd, tunfd);
       }
 
       if(FD_ISSET(slipfd, &wset)) {
@@ -1026,8 +958,12 @@ exit(1);
       }
       if(delaymsec==0) {
         int size;
-        if(slip_empty() && FD_ISSET(tunfd, &rset)) {
-          size=tun_to_serial(tunfd, slipfd);
+        if(FD_ISSET(tunfd, &rset)) {
+          /* Queue all packets that are waiting, unless delayed */
+          do {
+            size=tun_to_serial(tunfd, slipfd);
+          } while(size > 0 && !basedelay &&
+                  slip_codec_queue_has_room(&slip_queue, MAX_PACKET));
           slip_flushbuf(slipfd);
           if(ipa_enable) sigalarm_reset();
           if(basedelay) {